@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.max.elf;
+
+import java.io.*;
+import java.nio.*;
+import java.nio.channels.*;
+
+/**
+ * A read-only memory mapping of a file that may be too large to map with a single {@link MappedByteBuffer},
+ * such as a core dump. The file is mapped in windows of {@value #WINDOW_SIZE} bytes, each of which is only
+ * mapped when it is first accessed. Each window also maps the first {@value #WINDOW_OVERLAP} bytes of the
+ * next one, so that any range no longer than that can be served as a single slice of one window.
+ */
+public class ELFFileMapping {
+
+    /**
+     * Log2 of the size of the windows in which the file is mapped.
+     */
+    public static final int WINDOW_SHIFT = 30;
+
+    public static final long WINDOW_SIZE = 1L << WINDOW_SHIFT;
+
+    public static final int WINDOW_OVERLAP = 1 << 20;
+
+    private final FileChannel channel;
+    private final long size;
+    private final MappedByteBuffer[] windows;
+
+    public ELFFileMapping(FileChannel channel) throws IOException {
+        this.channel = channel;
+        this.size = channel.size();
+        this.windows = new MappedByteBuffer[(int) ((size + WINDOW_SIZE - 1) >>> WINDOW_SHIFT)];
+    }
+
+    /**
+     * Gets the size of the mapped file.
+     */
+    public long size() {
+        return size;
+    }
+
+    /**
+     * Gets the number of windows that have been mapped so far.
+     */
+    public synchronized int mappedWindows() {
+        int n = 0;
+        for (MappedByteBuffer window : windows) {
+            if (window != null) {
+                n++;
+            }
+        }
+        return n;
+    }
+
+    /**
+     * Gets the mapping of a given window of the file, mapping it if this is the first access.
+     */
+    public synchronized MappedByteBuffer window(int window) throws IOException {
+        MappedByteBuffer mapping = windows[window];
+        if (mapping == null) {
+            final long start = (long) window << WINDOW_SHIFT;
+            mapping = channel.map(FileChannel.MapMode.READ_ONLY, start, Math.min(WINDOW_SIZE + WINDOW_OVERLAP, size - start));
+            windows[window] = mapping;
+        }
+        return mapping;
+    }
+
+    /**
+     * Gets a slice of the mapped file.
+     *
+     * @return a buffer sharing the contents of the {@code length} bytes of the file at {@code fileOffset}, or
+     *         {@code null} if the range is not within a single window or extends past the end of the file
+     */
+    public ByteBuffer range(long fileOffset, int length) throws IOException {
+        if (fileOffset < 0 || fileOffset >= size) {
+            return null;
+        }
+        final MappedByteBuffer mapping = window((int) (fileOffset >>> WINDOW_SHIFT));
+        final int offset = (int) (fileOffset & (WINDOW_SIZE - 1));
+        if (offset + length > mapping.capacity()) {
+            return null;
+        }
+        final ByteBuffer slice = mapping.duplicate();
+        slice.limit(offset + length);
+        slice.position(offset);
+        return slice.slice();
+    }
+}
@@ -57,6 +57,7 @@ package com.oracle.max.elf;
 
 import java.io.RandomAccessFile;
 import java.io.IOException;
+import java.nio.ByteBuffer;
 import java.util.List;
 import java.util.LinkedList;
 
@@ -99,6 +100,20 @@ public final class ELFLoader {
         return pht;
     }
 
+    /**
+     * The <code>readPHT()</code> method reads the program header table from a buffer holding the file,
+     * typically a mapping of the file.
+     * @param buffer the buffer from which to read the program header table, with index 0 at the start of the file
+     * @param header the ELFHeader instance already loaded from this file
+     * @return a reference to a new object representing the program header table for this ELF file
+     * @throws IOException if an IO exception occurs
+     */
+    public static ELFProgramHeaderTable readPHT(ByteBuffer buffer, ELFHeader header) throws IOException {
+        final ELFProgramHeaderTable pht = new ELFProgramHeaderTable(header);
+        pht.read(buffer);
+        return pht;
+    }
+
     /**
      * The <code>readSHT()</code> method loads the section header table from the specified file.
      * @param fis the file from which to load the section header table
@@ -57,6 +57,7 @@ package com.oracle.max.elf;
 
 import java.io.IOException;
 import java.io.RandomAccessFile;
+import java.nio.ByteBuffer;
 
 /**
  * The <code>ELFProgramHeaderTable</code> class represents a program header table
@@ -207,6 +208,25 @@ public class ELFProgramHeaderTable {
         }
     }
 
+    /**
+     * Reads the program header table from a buffer holding (at least the start of) the ELF file.
+     * This avoids the per-byte file reads of {@link #read(RandomAccessFile)}, which matters for
+     * files such as core dumps that can have thousands of entries.
+     * @param buffer a buffer whose index 0 corresponds to the start of the ELF file
+     * @throws IOException if there is a problem reading the header table from the buffer
+     */
+    public void read(ByteBuffer buffer) throws IOException {
+        if (entries.length == 0) {
+            return;
+        }
+        final ByteBuffer table = buffer.duplicate();
+        table.position((int) header.e_phoff);
+        final ELFDataInputStream is = new ELFDataInputStream(header, table);
+        for (int cntr = 0; cntr < entries.length; cntr++) {
+            entries[cntr] = readEntry(null, is);
+        }
+    }
+
     private Entry readEntry(RandomAccessFile fis, ELFDataInputStream is) throws IOException {
         if (header.is32Bit()) {
             return readEntry32(fis, is);
@@ -226,13 +246,13 @@ public class ELFProgramHeaderTable {
         e.p_memsz  = is.read_Elf32_Word();
         e.p_flags  = is.read_Elf32_Word();
         e.p_align  = is.read_Elf32_Word();
-        readPadding(fis, ELF32_PHTENT_SIZE, header.e_phentsize);
+        readPadding(is, ELF32_PHTENT_SIZE, header.e_phentsize);
         return e;
     }
 
-    private void readPadding(RandomAccessFile fis, int read, short goal) throws IOException {
+    private void readPadding(ELFDataInputStream is, int read, short goal) throws IOException {
         for (int pad = read; pad < goal; pad++) {
-            fis.read();
+            is.read_Elf32_byte();
         }
     }
 
@@ -248,7 +268,7 @@ public class ELFProgramHeaderTable {
         e.p_memsz  = is.read_Elf64_XWord();
         e.p_align  = is.read_Elf64_XWord();
         // read the rest of the entry (padding)
-        readPadding(fis, ELF64_PHTENT_SIZE, header.e_phentsize);
+        readPadding(is, ELF64_PHTENT_SIZE, header.e_phentsize);
         return e;
     }
 
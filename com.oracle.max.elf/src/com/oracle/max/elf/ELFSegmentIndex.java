@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.oracle.max.elf;
+
+import java.util.*;
+
+/**
+ * An index of the loadable segments in a {@linkplain ELFProgramHeaderTable program header table} that have
+ * contents in the file, sorted by virtual address so that the segment containing a given address, and the file
+ * offset of that address, can be found by binary search. This is typically used to read the memory image
+ * recorded in a core file, which can contain many thousands of segments.
+ */
+public class ELFSegmentIndex {
+
+    private final long[] starts;
+    private final long[] ends;
+    private final long[] offsets;
+
+    /**
+     * Builds the index for the {@link ELFProgramHeaderTable#PT_LOAD} entries of a given program header table
+     * whose {@code p_filesz} is not zero. If two such segments overlap, the one with the lower address
+     * takes precedence for the overlapping addresses.
+     */
+    public ELFSegmentIndex(ELFProgramHeaderTable programHeaderTable) {
+        final List<long[]> segments = new ArrayList<long[]>(programHeaderTable.entries.length);
+        for (ELFProgramHeaderTable.Entry entry : programHeaderTable.entries) {
+            if (entry.p_type != ELFProgramHeaderTable.PT_LOAD) {
+                continue;
+            }
+            final long vaddr;
+            final long offset;
+            final long filesz;
+            if (entry.is64Bit()) {
+                final ELFProgramHeaderTable.Entry64 entry64 = (ELFProgramHeaderTable.Entry64) entry;
+                vaddr = entry64.p_vaddr;
+                offset = entry64.p_offset;
+                filesz = Math.min(entry64.p_filesz, entry64.p_memsz);
+            } else {
+                final ELFProgramHeaderTable.Entry32 entry32 = (ELFProgramHeaderTable.Entry32) entry;
+                vaddr = entry32.p_vaddr & 0xffffffffL;
+                offset = entry32.p_offset & 0xffffffffL;
+                filesz = Math.min(entry32.p_filesz & 0xffffffffL, entry32.p_memsz & 0xffffffffL);
+            }
+            if (filesz != 0) {
+                segments.add(new long[] {vaddr, vaddr + filesz, offset});
+            }
+        }
+        Collections.sort(segments, new Comparator<long[]>() {
+            public int compare(long[] a, long[] b) {
+                return compareUnsigned(a[0], b[0]);
+            }
+        });
+        final long[] sortedStarts = new long[segments.size()];
+        final long[] sortedEnds = new long[segments.size()];
+        final long[] sortedOffsets = new long[segments.size()];
+        int count = 0;
+        for (long[] segment : segments) {
+            long start = segment[0];
+            final long end = segment[1];
+            long offset = segment[2];
+            if (count > 0 && compareUnsigned(start, sortedEnds[count - 1]) < 0) {
+                // skip the part of this segment covered by the previous one
+                if (compareUnsigned(end, sortedEnds[count - 1]) <= 0) {
+                    continue;
+                }
+                offset += sortedEnds[count - 1] - start;
+                start = sortedEnds[count - 1];
+            }
+            sortedStarts[count] = start;
+            sortedEnds[count] = end;
+            sortedOffsets[count] = offset;
+            count++;
+        }
+        starts = Arrays.copyOf(sortedStarts, count);
+        ends = Arrays.copyOf(sortedEnds, count);
+        offsets = Arrays.copyOf(sortedOffsets, count);
+    }
+
+    private static int compareUnsigned(long a, long b) {
+        final long x = a + Long.MIN_VALUE;
+        final long y = b + Long.MIN_VALUE;
+        return x < y ? -1 : (x == y ? 0 : 1);
+    }
+
+    /**
+     * Gets the number of segments in this index.
+     */
+    public int size() {
+        return starts.length;
+    }
+
+    /**
+     * Finds the segment containing a given virtual address.
+     *
+     * @return the index of the segment containing {@code address} or -1 if no segment in this index contains it
+     */
+    public int find(long address) {
+        int low = 0;
+        int high = starts.length - 1;
+        while (low <= high) {
+            final int mid = (low + high) >>> 1;
+            if (compareUnsigned(address, starts[mid]) < 0) {
+                high = mid - 1;
+            } else if (compareUnsigned(address, ends[mid]) >= 0) {
+                low = mid + 1;
+            } else {
+                return mid;
+            }
+        }
+        return -1;
+    }
+
+    /**
+     * Gets the first virtual address of the segment at a given index.
+     */
+    public long start(int segment) {
+        return starts[segment];
+    }
+
+    /**
+     * Gets the virtual address just past the file-backed contents of the segment at a given index.
+     */
+    public long end(int segment) {
+        return ends[segment];
+    }
+
+    /**
+     * Gets the offset in the file of a virtual address in the segment at a given index.
+     */
+    public long fileOffset(int segment, long address) {
+        return offsets[segment] + (address - starts[segment]);
+    }
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.sun.max.ins.debug.vmlog;
+
+import java.util.*;
+
+import com.sun.max.ins.*;
+import com.sun.max.tele.debug.*;
+import com.sun.max.tele.object.*;
+import com.sun.max.unsafe.*;
+import com.sun.max.vm.log.nat.mapped.*;
+
+/**
+ * Model corresponds to {@link VMLogNativeMapped}.
+ * Fixed length records stored in a global native circular buffer, indexed by the masked id.
+ */
+class VMLogNativeMappedElementsTableModel extends VMLogNativeElementsTableModel {
+
+    VMLogNativeMappedElementsTableModel(Inspection inspection, TeleVMLog teleVMLog) {
+        super(inspection, teleVMLog);
+    }
+
+    @Override
+    protected Pointer getRecordAddress(long id) {
+        // the number of entries is a power of two
+        final int index = (int) id & (teleVMLogNative.logEntries() - 1);
+        return teleVMLogNative.logBuffer().plus(index * nativeRecordSize()).asPointer();
+    }
+
+    @Override
+    protected void offLineRefresh(ArrayList<String> records) {
+        // the decoder emits the records sorted by uuid
+        TeleHostedLogRecord[] logRecords = processThreadIds(records);
+        logRecordCache = Arrays.asList(logRecords);
+    }
+
+}
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.sun.max.ins.debug.vmlog;
+
+import java.util.*;
+
+import com.sun.max.ins.*;
+import com.sun.max.tele.*;
+import com.sun.max.tele.debug.*;
+import com.sun.max.tele.object.*;
+import com.sun.max.unsafe.*;
+import com.sun.max.vm.log.*;
+import com.sun.max.vm.log.nat.thread.var.std.*;
+
+/**
+ * Model corresponds to {@link VMLogNativeThreadVariableStdTimed}.
+ * The records carry timestamps rather than ids, and the VM's {@code nextId} does not change as records are
+ * logged, so every refresh merges the records that are newer than those already seen for each thread
+ * by timestamp and numbers them in that order. As the VM is stopped during a refresh, all the new records
+ * are newer than those seen before, so appending them preserves the order.
+ */
+class VMLogNativeThreadVariableStdTimedElementsTableModel extends VMLogNativeThreadVariableStdElementsTableModel {
+
+    private static class TimedRecord implements Comparable<TimedRecord> {
+        final long timestamp;
+        final Pointer address;
+
+        TimedRecord(long timestamp, Pointer address) {
+            this.timestamp = timestamp;
+            this.address = address;
+        }
+
+        public int compareTo(TimedRecord other) {
+            return timestamp < other.timestamp ? -1 : (timestamp == other.timestamp ? 0 : 1);
+        }
+    }
+
+    /**
+     * The timestamp of the newest record seen for each thread, including those that have died.
+     */
+    private final HashMap<MaxThreadVMLog, Long> threadLastTimestamps = new HashMap<MaxThreadVMLog, Long>();
+
+    private int nextRecordId;
+
+    VMLogNativeThreadVariableStdTimedElementsTableModel(Inspection inspection, TeleVMLog teleVMLog) {
+        super(inspection, teleVMLog);
+    }
+
+    @Override
+    public void refresh() {
+        modelSpecificRefresh();
+        super.refresh();
+    }
+
+    @Override
+    protected void modelSpecificRefresh() {
+        final ArrayList<TimedRecord> newRecords = new ArrayList<TimedRecord>();
+        for (MaxThread thread : vm().state().threads()) {
+            final MaxThreadVMLog threadVmLog = thread.vmLog();
+            if (threadVmLog.memoryRegion() == null) {
+                continue;
+            }
+            final Long lastTimestamp = threadLastTimestamps.get(threadVmLog);
+            long newestTimestamp = lastTimestamp == null ? -1 : lastTimestamp;
+
+            final Pointer logBuffer = threadVmLog.start().asPointer();
+            final int size = threadVmLog.size();
+            int offset = threadVmLog.firstOffset();
+            final int nextOffset = threadVmLog.nextOffset();
+            do {
+                final Pointer recordAddress = logBuffer.plus(offset);
+                final int header = vm().memoryIO().readInt(recordAddress);
+                if (!VMLog.Record.isFree(header)) {
+                    final long timestamp = teleVMLogNative.timestamp(recordAddress);
+                    if (lastTimestamp == null || timestamp > lastTimestamp) {
+                        newRecords.add(new TimedRecord(timestamp, recordAddress));
+                        newestTimestamp = Math.max(newestTimestamp, timestamp);
+                    }
+                }
+                offset = (offset + nativeRecordSize(recordAddress)) % size;
+            } while (offset != nextOffset);
+            threadLastTimestamps.put(threadVmLog, newestTimestamp);
+        }
+        Collections.sort(newRecords);
+        for (TimedRecord r : newRecords) {
+            logRecordCache.add(teleVMLogNative.getLogRecord(r.address, nextRecordId++));
+        }
+    }
+
+}
@@ -54,6 +54,19 @@ public interface TeleChannelProtocol extends TeleChannelDataIOProtocol {
      * @return number of bytes actually written
      */
     int writeBytes(long dst, ByteBuffer src, int srcOffset, int length);
+    /**
+     * Reads a number of ranges of bytes from the target VM into consecutive locations of a (likely direct)
+     * {@link java.nio.ByteBuffer}. The bytes of range {@code i} are written at {@code dstOffset} plus the sum of
+     * the lengths of the preceding ranges. If a range can only be partially read, {@code lengths[i]} is updated
+     * to the number of bytes actually read for it.
+     * @param srcs virtual addresses of the ranges to read
+     * @param lengths number of bytes in each range
+     * @param count number of ranges to read
+     * @param dst the byte buffer to write to
+     * @param dstOffset offset in the byte buffer where writing should begin
+     * @return the total number of bytes actually read
+     */
+    int readBytes(long[] srcs, int[] lengths, int count, ByteBuffer dst, int dstOffset);
     /**
      * Gathers the set of active threads in the target VM.
      * This avoids explicit types so that different versions of the Inspector types can be used on the two sides
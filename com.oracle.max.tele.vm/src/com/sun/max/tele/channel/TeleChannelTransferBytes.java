@@ -73,6 +73,26 @@ public class TeleChannelTransferBytes {
         return length;
     }
 
+    /**
+     * Reads a number of ranges of bytes one range at a time, for protocols that cannot read them in a single request.
+     *
+     * @see TeleChannelProtocol#readBytes(long[], int[], int, ByteBuffer, int)
+     */
+    public static int readBytes(TeleChannelProtocol protocol, long[] srcs, int[] lengths, int count, ByteBuffer dst, int dstOffset) {
+        int localOffset = dstOffset;
+        int result = 0;
+        for (int i = 0; i < count; i++) {
+            final int length = lengths[i];
+            if (readBytes(protocol, dst, localOffset, length, Address.fromLong(srcs[i])) == length) {
+                result += length;
+            } else {
+                lengths[i] = 0;
+            }
+            localOffset += length;
+        }
+        return result;
+    }
+
     private static void checkMaxByteBufferSize(TeleChannelProtocol protocol) {
         if (maxByteBufferSize == 0) {
             maxByteBufferSize = protocol.maxByteBufferSize();
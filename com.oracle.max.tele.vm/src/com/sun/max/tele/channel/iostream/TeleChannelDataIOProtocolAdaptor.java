@@ -70,6 +70,11 @@ public abstract class TeleChannelDataIOProtocolAdaptor extends TeleChannelDataIO
         return writeBytes(dst, bytes, src.arrayOffset() + srcOffset, length);
     }
 
+    @Override
+    public int readBytes(long[] srcs, int[] lengths, int count, ByteBuffer dst, int dstOffset) {
+        return TeleChannelTransferBytes.readBytes(this, srcs, lengths, count, dst, dstOffset);
+    }
+
     @SuppressWarnings("unchecked")
     @Override
     public boolean gatherThreads(Object teleDomainObject, Object threadList, long tlaList) {
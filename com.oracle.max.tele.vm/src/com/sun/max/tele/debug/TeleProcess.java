@@ -202,12 +202,12 @@ public abstract class TeleProcess extends AbstractVmHolder implements TeleVMCach
                                 break;
                             case WATCHPOINT:
                                 eventCauseFound = true;
-                                final Address triggeredWatchpointAddress = Address.fromLong(readWatchpointAddress());
+                                final Address triggeredWatchpointAddress = Address.fromLong(readWatchpointAddress(thread));
                                 final VmWatchpoint systemWatchpoint = vm().watchpointManager().findSystemWatchpoint(triggeredWatchpointAddress);
                                 if (systemWatchpoint != null && systemWatchpoint.handleTriggerEvent(thread)) {
                                     Trace.line(TRACE_VALUE + 1, tracePrefix() + " stopping thread [id=" + thread.id() + "] after triggering system watchpoint");
                                     // Case 4. At least one thread is at a memory watchpoint that specifies that execution should halt; record it and do not continue.
-                                    final int triggeredWatchpointCode = readWatchpointAccessCode();
+                                    final int triggeredWatchpointCode = readWatchpointAccessCode(thread);
                                     watchpointEvent = new VmWatchpointEvent(systemWatchpoint, thread, triggeredWatchpointAddress, triggeredWatchpointCode);
                                     resumeExecution = false;
                                     break;
@@ -216,7 +216,7 @@ public abstract class TeleProcess extends AbstractVmHolder implements TeleVMCach
                                 if (clientWatchpoint != null && clientWatchpoint.handleTriggerEvent(thread)) {
                                     Trace.line(TRACE_VALUE + 1, tracePrefix() + " stopping thread [id=" + thread.id() + "] after triggering client watchpoint");
                                     // Case 4. At least one thread is at a memory watchpoint that specifies that execution should halt; record it and do not continue.
-                                    final int triggeredWatchpointCode = readWatchpointAccessCode();
+                                    final int triggeredWatchpointCode = readWatchpointAccessCode(thread);
                                     watchpointEvent = new VmWatchpointEvent(clientWatchpoint, thread, triggeredWatchpointAddress, triggeredWatchpointCode);
                                     resumeExecution = false;
                                 }
@@ -748,6 +748,31 @@ public abstract class TeleProcess extends AbstractVmHolder implements TeleVMCach
         return bytesRead;
     }
 
+    public final int read(long[] addresses, int[] lengths, int count, ByteBuffer buffer, int offset) throws DataIOError, TerminatedProcessIOException {
+        if (count == 0) {
+            return 0;
+        }
+        if (processState == TERMINATED) {
+            final StringBuilder msg = new StringBuilder();
+            msg.append("Memory read @ ").append(Address.fromLong(addresses[0]).to0xHexString());
+            msg.append(" (process TERMINATED)");
+            throw new TerminatedProcessIOException(msg.toString());
+        }
+        if (processState != STOPPED && processState != null && Thread.currentThread() != requestHandlingThread) {
+            throw new DataIOError(Address.fromLong(addresses[0]), "Reading from process memory while processed not stopped [thread: " + Thread.currentThread().getName() + "]");
+        }
+        int length = 0;
+        for (int i = 0; i < count; i++) {
+            length += lengths[i];
+        }
+        DataIO.Static.checkRead(buffer, offset, length);
+        final int bytesRead = read0(addresses, lengths, count, buffer, offset);
+        if (bytesRead < 0) {
+            throw new DataIOError(Address.fromLong(addresses[0]));
+        }
+        return bytesRead;
+    }
+
     public final int write(ByteBuffer buffer, int offset, int length, Address address) throws DataIOError, IndexOutOfBoundsException, TerminatedProcessIOException {
         if (processState == TERMINATED) {
             final StringBuilder msg = new StringBuilder();
@@ -801,6 +826,17 @@ public abstract class TeleProcess extends AbstractVmHolder implements TeleVMCach
      */
     protected abstract int platformWatchpointCount();
 
+    /**
+     * Gets the number of the platform's {@linkplain #platformWatchpointCount() watchpoints} needed to watch a given
+     * memory region with given settings. A platform that can watch any region with one watchpoint needs just one.
+     *
+     * @return the number of platform watchpoints needed, which is more than {@link #platformWatchpointCount()} if the
+     *         platform cannot watch the region at all
+     */
+    protected int platformWatchpointCost(MaxMemoryRegion memoryRegion, MaxWatchpoint.WatchpointSettings settings) {
+        return 1;
+    }
+
     /**
      * @return tracing level of the underlying transportation
      * mechanism used for communication with this process.
@@ -1054,6 +1090,34 @@ public abstract class TeleProcess extends AbstractVmHolder implements TeleVMCach
      */
     protected abstract int read0(Address address, ByteBuffer buffer, int offset, int length);
 
+    /**
+     * Reads a number of ranges of bytes from process memory, platform-specific implementation.
+     * This implementation reads one range at a time; platforms that can read several ranges
+     * in a single request should override it.
+     *
+     * @see #read(long[], int[], int, ByteBuffer, int)
+     * @see TeleIO#read(long[], int[], int, ByteBuffer, int)
+     */
+    protected int read0(long[] addresses, int[] lengths, int count, ByteBuffer buffer, int offset) {
+        int result = 0;
+        int rangeOffset = offset;
+        for (int i = 0; i < count; i++) {
+            final int length = lengths[i];
+            int bytesRead;
+            try {
+                bytesRead = read0(Address.fromLong(addresses[i]), buffer, rangeOffset, length);
+            } catch (DataIOError dataIOError) {
+                bytesRead = 0;
+            }
+            if (bytesRead != length) {
+                lengths[i] = bytesRead < 0 ? 0 : bytesRead;
+            }
+            result += lengths[i];
+            rangeOffset += length;
+        }
+        return result;
+    }
+
 
     /**
      * Writes bytes to process memory, platform-specific implementation.
@@ -1107,6 +1171,22 @@ public abstract class TeleProcess extends AbstractVmHolder implements TeleVMCach
         return 0;
     }
 
+    /**
+     * Reads the address which triggered the watchpoint a given thread is stopped at. This is the
+     * {@linkplain #readWatchpointAddress() address recorded for the process} unless the platform records it for each thread.
+     */
+    protected long readWatchpointAddress(TeleNativeThread thread) {
+        return readWatchpointAddress();
+    }
+
+    /**
+     * Reads the access code of the watchpoint a given thread is stopped at. This is the
+     * {@linkplain #readWatchpointAccessCode() access code recorded for the process} unless the platform records it for each thread.
+     */
+    protected int readWatchpointAccessCode(TeleNativeThread thread) {
+        return readWatchpointAccessCode();
+    }
+
     private void updateWatchpointCaches() {
         if (vm().watchpointManager() != null) {
             vm().watchpointManager().updateWatchpointMemoryCaches();
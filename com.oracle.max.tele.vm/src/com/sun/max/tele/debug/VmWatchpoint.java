@@ -1083,6 +1083,38 @@ public abstract class VmWatchpoint extends AbstractVmHolder implements VMTrigger
             return clientWatchpoints.size() + systemWatchpoints.size();
         }
 
+        private int platformWatchpointCost(VmWatchpoint watchpoint) {
+            return teleProcess.platformWatchpointCost(watchpoint.memoryRegion(), watchpoint.settings);
+        }
+
+        /**
+         * Checks that there are enough of the watchpoints supported by the platform left for a new watchpoint,
+         * which may need more than one of them.
+         *
+         * @throws MaxWatchpointManager.MaxTooManyWatchpointsException if the platform cannot support the new watchpoint
+         * as well as the existing ones, or cannot support it at all
+         */
+        private void checkPlatformWatchpoints(VmWatchpoint watchpoint) throws MaxWatchpointManager.MaxTooManyWatchpointsException {
+            final int platformWatchpointCount = teleProcess.platformWatchpointCount();
+            final int cost = platformWatchpointCost(watchpoint);
+            if (cost > platformWatchpointCount) {
+                throw new MaxWatchpointManager.MaxTooManyWatchpointsException("Watching " + watchpoint.memoryRegion().nBytes() + " bytes at " +
+                    watchpoint.memoryRegion().start().toHexString() + " needs " + cost + " of the watchpoints supported by platform (" +
+                    platformWatchpointCount + ")");
+            }
+            int used = 0;
+            for (VmWatchpoint existing : clientWatchpoints) {
+                used += platformWatchpointCost(existing);
+            }
+            for (VmWatchpoint existing : systemWatchpoints) {
+                used += platformWatchpointCost(existing);
+            }
+            if (used > platformWatchpointCount - cost) {
+                throw new MaxWatchpointManager.MaxTooManyWatchpointsException("Number of watchpoints supported by platform (" +
+                    platformWatchpointCount + ") exceeded: " + (platformWatchpointCount - used) + " free, " + cost + " needed");
+            }
+        }
+
         private void updateAfterWatchpointChanges() {
             clientWatchpointsCache = Collections.unmodifiableList(new ArrayList<MaxWatchpoint>(clientWatchpoints));
             systemWatchpointsCache = new ArrayList<MaxWatchpoint>(systemWatchpoints);
@@ -1139,10 +1171,7 @@ public abstract class VmWatchpoint extends AbstractVmHolder implements VMTrigger
             assert watchpoint.isAlive();
             assert !watchpoint.isActive();
 
-            if (watchpointCount() >= teleProcess.platformWatchpointCount()) {
-                throw new MaxWatchpointManager.MaxTooManyWatchpointsException("Number of watchpoints supported by platform (" +
-                    teleProcess.platformWatchpointCount() + ") exceeded");
-            }
+            checkPlatformWatchpoints(watchpoint);
             if (!clientWatchpoints.add(watchpoint)) {
                 // TODO (mlvdv) call out special case where there's a hidden system watchpoint at the same location as this.
                 // An existing watchpoint starts at the same location
@@ -1183,10 +1212,7 @@ public abstract class VmWatchpoint extends AbstractVmHolder implements VMTrigger
          * @throws MaxWatchpointManager.MaxTooManyWatchpointsException
          */
         private VmWatchpoint addSystemWatchpoint(VmWatchpoint watchpoint) throws MaxWatchpointManager.MaxTooManyWatchpointsException {
-            if (watchpointCount() >= teleProcess.platformWatchpointCount()) {
-                throw new MaxWatchpointManager.MaxTooManyWatchpointsException("Number of watchpoints supported by platform (" +
-                    teleProcess.platformWatchpointCount() + ") exceeded");
-            }
+            checkPlatformWatchpoints(watchpoint);
             systemWatchpoints.add(watchpoint);
             updateAfterWatchpointChanges();
             return watchpoint;
@@ -25,8 +25,11 @@ package com.sun.max.tele.debug.dump;
 import static com.oracle.max.elf.ELFProgramHeaderTable.*;
 
 import java.io.*;
+import java.nio.*;
+import java.nio.channels.*;
 
 import com.oracle.max.elf.*;
+import com.sun.max.lang.*;
 import com.sun.max.program.*;
 import com.sun.max.tele.*;
 import com.sun.max.tele.channel.*;
@@ -34,16 +37,24 @@ import com.sun.max.tele.channel.iostream.*;
 import com.sun.max.tele.debug.*;
 import com.sun.max.tele.heap.*;
 import com.sun.max.tele.util.*;
-import com.sun.max.unsafe.*;
 import com.sun.max.vm.hosted.*;
 
+/**
+ * Channel protocol for reading an ELF core dump. The dump file is memory mapped, in windows that are only mapped
+ * when first accessed, and the loadable segments are {@linkplain ELFSegmentIndex indexed} by address so that a
+ * read of the VM's memory is a binary search followed by a copy out of (or a {@linkplain #readBuffer(long, int) slice
+ * of}) the mapping. This keeps the cost of opening a dump independent of its size.
+ */
 public class ELFDumpTeleChannelProtocolAdaptor extends TeleChannelDataIOProtocolAdaptor implements TeleChannelProtocol {
 
     protected int tlaSize;
     public boolean bigEndian;
     protected RandomAccessFile dumpRaf;
+    protected FileChannel dumpChannel;
+    private ELFFileMapping dumpMapping;
     protected ELFHeader header;
     protected ELFProgramHeaderTable programHeaderTable;
+    protected ELFSegmentIndex segmentIndex;
     protected ELFSymbolLookup symbolLookup;
     protected MaxVM teleVM;
     protected static final String HEAP_SYMBOL_NAME = "theHeap";  // defined in image.c, holds the base address of the boot heap
@@ -56,8 +67,12 @@ public class ELFDumpTeleChannelProtocolAdaptor extends TeleChannelDataIOProtocol
             // that are embedded in the NOTE sections of the dump file.
             Prototype.loadLibrary(TeleVM.TELE_LIBRARY_NAME);
             dumpRaf = new RandomAccessFile(dump, "r");
+            dumpChannel = dumpRaf.getChannel();
+            dumpMapping = new ELFFileMapping(dumpChannel);
             this.header = ELFLoader.readELFHeader(dumpRaf);
-            this.programHeaderTable = ELFLoader.readPHT(dumpRaf, header);
+            this.programHeaderTable = ELFLoader.readPHT(dumpMapping.window(0), header);
+            this.segmentIndex = new ELFSegmentIndex(programHeaderTable);
+            Trace.line(1, "[ELFDumpTeleChannelProtocolAdaptor] " + dump + ": " + dumpMapping.size() + " bytes, " + segmentIndex.size() + " loadable segments");
             // This is not needed currently as we cannot look up symbols from shared libraries.
             //symbolLookup = new ELFSymbolLookup(new File(vm.getParent(), "libjvm.so"));
         } catch (Exception ex) {
@@ -77,9 +92,10 @@ public class ELFDumpTeleChannelProtocolAdaptor extends TeleChannelDataIOProtocol
          * OS-specific processing a NOTE entry.
          * @param type type of NOTE entry
          * @param name name of NOTE entry
-         * @param desc byte array of NOTE contents
+         * @param desc the NOTE contents, a read-only direct buffer that is a slice of the mapped dump file
+         *            and so can be retained and passed to native code without copying
          */
-        protected void processNoteEntry(int type, String name, byte[] desc) {
+        protected void processNoteEntry(int type, String name, ByteBuffer desc) {
 
         }
     }
@@ -97,67 +113,53 @@ public class ELFDumpTeleChannelProtocolAdaptor extends TeleChannelDataIOProtocol
             }
         }
         try {
-            dumpRaf.seek(noteSectionEntry.p_offset);
-            final ELFDataInputStream dis = new ELFDataInputStream(header, dumpRaf);
-            final long size = noteSectionEntry.p_filesz;
-            long readLength = 0;
-            while (readLength < size) {
-                int namesz = dis.read_Elf64_Word();
-                final int descsz = dis.read_Elf64_Word();
-                final int type = dis.read_Elf64_Word();
-                final String name = readNoteString(dis, namesz);
-                readLength += 12 + namesz;
-                while (namesz % 8 != 0) {
-                    dis.read_Elf32_byte();
-                    readLength++;
-                    namesz++;
-                }
-                final byte[] desc = readNoteDesc(dis, descsz);
-                readLength += descsz;
-
-                entryHandler.processNoteEntry(type, name, desc);
+            final ByteBuffer notes = dumpChannel.map(FileChannel.MapMode.READ_ONLY, noteSectionEntry.p_offset, noteSectionEntry.p_filesz).order(byteOrder());
+            while (notes.remaining() >= 12) {
+                final int namesz = notes.getInt();
+                final int descsz = notes.getInt();
+                final int type = notes.getInt();
+                final byte[] nameBytes = new byte[namesz];
+                notes.get(nameBytes);
+                // the name is null terminated and padded to a multiple of 8 bytes, the descriptor to a multiple of 4
+                final String name = new String(nameBytes, 0, namesz == 0 ? 0 : namesz - 1);
+                notes.position(notes.position() + ((8 - namesz % 8) % 8));
+                final ByteBuffer desc = notes.slice();
+                desc.limit(descsz);
+                notes.position(notes.position() + ((descsz + 3) & ~3));
+                entryHandler.processNoteEntry(type, name, desc.asReadOnlyBuffer().order(byteOrder()));
             }
         } catch (IOException ex) {
             TeleError.unexpected("error reading dump file note section", ex);
+        } catch (IllegalArgumentException ex) {
+            TeleError.unexpected("malformed dump file note section", ex);
         }
 
     }
 
+    protected ByteOrder byteOrder() {
+        return header.isBigEndian() ? ByteOrder.BIG_ENDIAN : ByteOrder.LITTLE_ENDIAN;
+    }
+
     /**
-     * Read a string from a NOTE entry with length length. The returned string is of size length - 1 as java strings are
-     * not null terminated
+     * Gets the contents of a range of the VM's memory as recorded in the dump, without copying.
      *
-     * @param length
+     * @param src the address of the first byte in the range
+     * @param length the number of bytes in the range, which must not be more than {@value ELFFileMapping#WINDOW_OVERLAP}
+     *            to be sure the range can be served as a single slice
+     * @return a read-only buffer sharing the mapped dump file contents for the range, in the byte order of the dump,
+     *         or {@code null} if the range is not entirely within one segment recorded in the dump
      */
-    private String readNoteString(ELFDataInputStream dis, int length) throws IOException {
-        byte[] arr = new byte[length - 1];
-        for (int i = 0; i < arr.length; i++) {
-            arr[i] = dis.read_Elf64_byte();
+    public ByteBuffer readBuffer(long src, int length) {
+        final int segment = segmentIndex.find(src);
+        if (segment < 0 || segmentIndex.end(segment) - src < length) {
+            return null;
         }
-        dis.read_Elf64_byte();
-        return new String(arr);
-    }
-
-    private byte[] readNoteDesc(ELFDataInputStream dis, int length) throws IOException {
-        byte[] arr = new byte[length];
-        for (int i = 0; i < length; i++) {
-            arr[i] = dis.read_Elf64_byte();
-        }
-        return arr;
-    }
-
-    protected ELFProgramHeaderTable.Entry64 findAddress(long addr) {
-        final Address address = Address.fromLong(addr);
-        for (ELFProgramHeaderTable.Entry entry : programHeaderTable.entries) {
-            ELFProgramHeaderTable.Entry64 entry64 = (ELFProgramHeaderTable.Entry64) entry;
-            if (entry64.p_type == PT_LOAD && entry64.p_filesz != 0) {
-                final Address end = Address.fromLong(entry64.p_vaddr).plus(entry64.p_memsz);
-                if (address.greaterEqual(Address.fromLong(entry64.p_vaddr)) && address.lessThan(end)) {
-                    return entry64;
-                }
-            }
+        try {
+            final ByteBuffer slice = dumpMapping.range(segmentIndex.fileOffset(segment, src), length);
+            return slice == null ? null : slice.asReadOnlyBuffer().order(byteOrder());
+        } catch (IOException ex) {
+            return null;
         }
-        return null;
     }
 
     /**
@@ -194,15 +196,12 @@ public class ELFDumpTeleChannelProtocolAdaptor extends TeleChannelDataIOProtocol
             // This is the clean way to do it if you know how to get the absolute address of symbols loaded from shared libraries,
             // which is not trivial or documented.
             final long theHeapAddress = getBootHeapStartSymbolAddress();
-            ELFProgramHeaderTable.Entry64 entry64 = findAddress(theHeapAddress);
-            try {
-                dumpRaf.seek(entry64.p_offset + (theHeapAddress - entry64.p_vaddr));
-                ELFDataInputStream ds = new ELFDataInputStream(header, dumpRaf);
-                return ds.read_Elf64_Addr();
-            } catch (Throwable ex) {
-                TeleError.unexpected("failed to get boot heap address", ex);
+            final ByteBuffer theHeap = readBuffer(theHeapAddress, Longs.SIZE);
+            if (theHeap == null) {
+                TeleError.unexpected("failed to get boot heap address");
                 return 0;
             }
+            return theHeap.getLong(0);
         }
     }
 
@@ -241,19 +240,48 @@ public class ELFDumpTeleChannelProtocolAdaptor extends TeleChannelDataIOProtocol
         return Integer.MAX_VALUE;
     }
 
+    /**
+     * Copies a range of the VM's memory from the dump into a buffer, stopping at the first address
+     * that is not in a segment recorded in the dump.
+     *
+     * @return the number of bytes copied
+     */
+    private int copyBytes(long src, ByteBuffer dst, int length) {
+        int n = 0;
+        while (n < length) {
+            final long address = src + n;
+            final int segment = segmentIndex.find(address);
+            if (segment < 0) {
+                break;
+            }
+            final int chunk = (int) Math.min(Math.min(length - n, ELFFileMapping.WINDOW_OVERLAP), segmentIndex.end(segment) - address);
+            final ByteBuffer contents;
+            try {
+                contents = dumpMapping.range(segmentIndex.fileOffset(segment, address), chunk);
+            } catch (IOException ex) {
+                break;
+            }
+            if (contents == null) {
+                // the segment extends past the end of a truncated dump file
+                break;
+            }
+            dst.put(contents);
+            n += chunk;
+        }
+        return n;
+    }
+
     @Override
     public int readBytes(long src, byte[] dst, int dstOffset, int length) {
-        final ELFProgramHeaderTable.Entry64 entry64 = findAddress(src);
-        if (entry64 == null) {
-            return 0;
-        }
-        try {
-            dumpRaf.seek(entry64.p_offset + (src - entry64.p_vaddr));
-            return dumpRaf.read(dst, dstOffset, length);
-        } catch (IOException ex) {
-            return 0;
-        }
+        return copyBytes(src, ByteBuffer.wrap(dst, dstOffset, length), length);
+    }
 
+    @Override
+    public int readBytes(long src, ByteBuffer dst, int dstOffset, int length) {
+        final ByteBuffer target = dst.duplicate();
+        target.limit(dstOffset + length);
+        target.position(dstOffset);
+        return copyBytes(src, target, length);
     }
 
     @Override
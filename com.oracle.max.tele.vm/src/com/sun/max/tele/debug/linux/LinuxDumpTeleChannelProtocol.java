@@ -38,10 +38,14 @@ public class LinuxDumpTeleChannelProtocol extends ELFDumpTeleChannelProtocolAdap
     private ByteBuffer taskPsInfo;
     private LinuxDumpThreadAccess linuxDumpThreadAccess;
 
+    /**
+     * The NOTE entries describing a task. The buffers are slices of the mapped dump file;
+     * the registers they hold are only decoded when the task's registers are first needed.
+     */
     static class TaskData {
         ByteBuffer status;
         ByteBuffer fpreg;
-        ByteBuffer psinfo; // copy of taskPsInfo
+        ByteBuffer psinfo; // same as taskPsInfo
     }
 
     public LinuxDumpTeleChannelProtocol(MaxVM teleVM, File vm, File dump) {
@@ -54,14 +58,16 @@ public class LinuxDumpTeleChannelProtocol extends ELFDumpTeleChannelProtocolAdap
         private TaskData taskData;  // NT_PRSTATUS, NT_PRFPREG come in pairs, this holds the data across the callbacks
 
         @Override
-        protected void processNoteEntry(int type, String name, byte[] desc) {
+        protected void processNoteEntry(int type, String name, ByteBuffer desc) {
             final NoteType noteType = NoteType.get(type);
+            if (noteType == null) {
+                // e.g. NT_SIGINFO, NT_FILE or the extended register state written by newer kernels
+                return;
+            }
             switch (noteType) {
                 case NT_PRSTATUS:
                     checkCreate();
-                    final ByteBuffer status = ByteBuffer.allocateDirect(desc.length);
-                    status.put(desc);
-                    taskData.status = status;
+                    taskData.status = desc;
                     if (taskData.fpreg != null) {
                         taskData = null;
                     }
@@ -69,17 +75,14 @@ public class LinuxDumpTeleChannelProtocol extends ELFDumpTeleChannelProtocolAdap
 
                 case NT_PRFPREG:
                     checkCreate();
-                    final ByteBuffer fpreg = ByteBuffer.allocateDirect(desc.length);
-                    fpreg.put(desc);
-                    taskData.fpreg = fpreg;
+                    taskData.fpreg = desc;
                     if (taskData.status != null) {
                         taskData = null;
                     }
                     break;
 
                 case NT_PRPSINFO:
-                    taskPsInfo = ByteBuffer.allocateDirect(desc.length);
-                    taskPsInfo.put(desc);
+                    taskPsInfo = desc;
             }
         }
 
@@ -128,6 +131,7 @@ public class LinuxDumpTeleChannelProtocol extends ELFDumpTeleChannelProtocolAdap
     public boolean readRegisters(long threadId, byte[] integerRegisters, int integerRegistersSize, byte[] floatingPointRegisters, int floatingPointRegistersSize, byte[] stateRegisters,
                     int stateRegistersSize) {
         LinuxDumpThreadAccess.LinuxThreadInfo threadInfo = (LinuxDumpThreadAccess.LinuxThreadInfo) linuxDumpThreadAccess.getThreadInfo((int) threadId);
+        threadInfo.readRegisters();
         System.arraycopy(threadInfo.integerRegisters, 0, integerRegisters, 0, integerRegisters.length);
         System.arraycopy(threadInfo.floatingPointRegisters, 0, floatingPointRegisters, 0, floatingPointRegisters.length);
         System.arraycopy(threadInfo.stateRegisters, 0, stateRegisters, 0, stateRegisters.length);
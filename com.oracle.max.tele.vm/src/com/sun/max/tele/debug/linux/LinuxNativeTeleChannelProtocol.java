@@ -51,6 +51,12 @@ public class LinuxNativeTeleChannelProtocol extends UnixNativeTeleChannelProtoco
     private LinuxTask leaderTask;
     private Map<Integer, LinuxTask> taskMap = new HashMap<Integer, LinuxTask>();
 
+    /**
+     * The registers of all stopped tasks, taken when the registers of any task are first read after the process stops.
+     * This is {@code null} whenever the process or any of its tasks may have run since the snapshot was taken.
+     */
+    private volatile LinuxTask.RegisterSnapshot registerSnapshot;
+
     private LinuxTask task(long ltid) {
         final int tid = (int) ltid;
         LinuxTask result = taskMap.get(tid);
@@ -102,6 +108,14 @@ public class LinuxNativeTeleChannelProtocol extends UnixNativeTeleChannelProtoco
         return leaderTask.writeBytes(dst, src.array(), false, src.arrayOffset() + srcOffset, length);
     }
 
+    @Override
+    public int readBytes(long[] srcs, int[] lengths, int count, ByteBuffer dst, int dstOffset) {
+        if (dst.isDirect()) {
+            return leaderTask.readBytes(srcs, lengths, count, dst, dstOffset);
+        }
+        return super.readBytes(srcs, lengths, count, dst, dstOffset);
+    }
+
 
     @Override
     public boolean gatherThreads(final Object teleDomain, final Object threadList, final long tlaList) {
@@ -129,21 +143,32 @@ public class LinuxNativeTeleChannelProtocol extends UnixNativeTeleChannelProtoco
     @Override
     public boolean readRegisters(long threadId, byte[] integerRegisters, int integerRegistersSize, byte[] floatingPointRegisters, int floatingPointRegistersSize, byte[] stateRegisters,
                     int stateRegistersSize) {
+        LinuxTask.RegisterSnapshot snapshot = registerSnapshot;
+        if (snapshot == null) {
+            snapshot = leaderTask.snapshotRegisters();
+            registerSnapshot = snapshot;
+        }
+        if (snapshot.read((int) threadId, integerRegisters, floatingPointRegisters, stateRegisters)) {
+            return true;
+        }
         return task(threadId).readRegisters(integerRegisters, floatingPointRegisters, stateRegisters);
     }
 
     @Override
     public boolean setInstructionPointer(long threadId, long ip) {
+        registerSnapshot = null;
         return task(threadId).setInstructionPointer(ip);
     }
 
     @Override
     public boolean singleStep(long threadId) {
+        registerSnapshot = null;
         return task(threadId).singleStep();
     }
 
     @Override
     public boolean resumeAll() {
+        registerSnapshot = null;
         try {
             leaderTask.resume(true);
             return true;
@@ -180,7 +205,9 @@ public class LinuxNativeTeleChannelProtocol extends UnixNativeTeleChannelProtoco
 
     @Override
     public ProcessState waitUntilStopped() {
+        registerSnapshot = null;
         final ProcessState result = leaderTask.waitUntilStopped(true);
+        registerSnapshot = null;
         if (result != ProcessState.STOPPED) {
             leaderTask.close();
         }
@@ -197,6 +224,54 @@ public class LinuxNativeTeleChannelProtocol extends UnixNativeTeleChannelProtoco
         }
     }
 
+    @Override
+    public boolean activateWatchpoint(long start, long size, boolean after, boolean read, boolean write, boolean exec) {
+        // the debug registers trap after a data access, which is what all watchpoints are by default
+        return leaderTask.activateWatchpoint(start, size, read, write, exec);
+    }
+
+    @Override
+    public boolean deactivateWatchpoint(long start, long size) {
+        return leaderTask.deactivateWatchpoint(start, size);
+    }
+
+    /**
+     * Gets the start address of the watchpoint that the main thread is stopped at. The watchpoint triggered by each
+     * thread is recorded separately; see {@link #readWatchpointAddress(long)}.
+     */
+    @Override
+    public long readWatchpointAddress() {
+        return leaderTask.readWatchpointAddress();
+    }
+
+    /**
+     * Gets the kind of access that triggered the watchpoint the main thread is stopped at. The watchpoint triggered
+     * by each thread is recorded separately; see {@link #readWatchpointAccessCode(long)}.
+     */
+    @Override
+    public int readWatchpointAccessCode() {
+        return leaderTask.readWatchpointAccessCode();
+    }
+
+    /**
+     * Gets the start address of the watchpoint that a given thread is stopped at.
+     *
+     * @return 0 if the thread is not stopped as a result of triggering a watchpoint
+     */
+    public long readWatchpointAddress(long threadId) {
+        return task(threadId).readWatchpointAddress();
+    }
+
+    /**
+     * Gets the kind of access that triggered the watchpoint a given thread is stopped at.
+     *
+     * @return 0 if the thread is not stopped as a result of triggering a watchpoint
+     * @see LinuxTask#readWatchpointAccessCode()
+     */
+    public int readWatchpointAccessCode(long threadId) {
+        return task(threadId).readWatchpointAccessCode();
+    }
+
     private static native void nativeGatherThreads(long pid, Object teleProcess, Object threadList, long tlaList);
 
 
@@ -25,14 +25,15 @@ package com.sun.max.tele.debug.linux;
 import java.awt.*;
 import java.io.*;
 import java.nio.*;
+import java.util.*;
 import java.util.concurrent.locks.*;
 
 import com.sun.max.*;
 import com.sun.max.lang.*;
+import com.sun.max.program.*;
 import com.sun.max.tele.data.*;
 import com.sun.max.tele.debug.*;
 import com.sun.max.tele.util.*;
-import com.sun.max.unsafe.*;
 import com.sun.max.util.*;
 
 /**
@@ -44,6 +45,8 @@ import com.sun.max.util.*;
  */
 public final class LinuxTask {
 
+    private static final int TRACE_VALUE = 1;
+
     /**
      * The thread group identifier (TGID) of this task. This is the process identifier shared by all tasks in a
      * process and is the value returned by getpid(2) since Linux 2.4.
@@ -267,6 +270,12 @@ public final class LinuxTask {
 
     private static native int nativeWait(int tgid, int tid, boolean allTasks);
 
+    /**
+     * Gets the time in nanoseconds between the first task stopping and all tasks being stopped
+     * during the last {@linkplain #waitUntilStopped(boolean) wait}.
+     */
+    private static native long nativeLastStopLatency();
+
     public ProcessState waitUntilStopped(final boolean allTasks) {
         if (!allTasks) {
             TeleError.unimplemented();
@@ -274,7 +283,11 @@ public final class LinuxTask {
         return execute(new Function<ProcessState>() {
             public ProcessState call() throws Exception {
                 int result = nativeWait(tgid, tid, allTasks);
-                return ProcessState.VALUES[result];
+                final ProcessState state = ProcessState.VALUES[result];
+                if (state == ProcessState.STOPPED && Trace.hasLevel(TRACE_VALUE)) {
+                    Trace.line(TRACE_VALUE, "[LinuxTask] stopped all tasks in " + nativeLastStopLatency() / 1000 + " microseconds");
+                }
+                return state;
             }
         });
     }
@@ -304,16 +317,10 @@ public final class LinuxTask {
         }
     }
 
-    /**
-     * The file in /proc through which the memory of this task can be read. As Linux does not
-     * support writing to the memory of a process via /proc, it's still necessary to use
-     * ptrace for {@linkplain #writeBytes(long, Object, boolean, int, int) writing}.
-     */
-    private RandomAccessFile memory;
-
     /**
      * Copies bytes from the tele process into a given {@linkplain ByteBuffer#isDirect() direct ByteBuffer} or byte
-     * array.
+     * array. The native code uses process_vm_readv(2) when available and otherwise a /proc/&lt;pid&gt;/mem file
+     * that stays open until this task is {@linkplain #close() closed}.
      *
      * @param src the address in the tele process to copy from
      * @param dst the destination of the copy operation. This is a direct {@link ByteBuffer} or {@code byte[]}
@@ -332,23 +339,34 @@ public final class LinuxTask {
         assert src != 0;
         return execute(new Function<Integer>() {
             public Integer call() throws Exception {
-                final long addr = src;
-                if (addr < 0) {
-                    // RandomAccessFile.see() can't handle unsigned long offsets: have to resort to a JNI call
-                    return nativeReadBytes(tgid, tid, addr, dst, isDirectByteBuffer, offset, length);
-                } else {
-                    if (memory == null) {
-                        memory = new RandomAccessFile("/proc/" + tgid() + "/mem", "r");
-                    }
-                    try {
-                        final ByteBuffer dstDup = dst instanceof ByteBuffer ? ((ByteBuffer) dst).duplicate() : ByteBuffer.wrap((byte[]) dst);
-                        final ByteBuffer dstView = (ByteBuffer) dstDup.position(offset).limit(offset + length);
-                        dstView.position(offset);
-                        return memory.getChannel().read(dstView, addr);
-                    } catch (IOException ioException) {
-                        throw new DataIOError(Address.fromLong(src), ioException.toString());
-                    }
-                }
+                return nativeReadBytes(tgid, tid, src, dst, isDirectByteBuffer, offset, length);
+            }
+        });
+    }
+
+    /**
+     * Copies a number of ranges of bytes from the tele process into consecutive locations of a given
+     * {@linkplain ByteBuffer#isDirect() direct ByteBuffer} with as few system calls as possible.
+     *
+     * @param srcs the addresses in the tele process of the ranges to copy
+     * @param lengths the number of bytes in each range, updated to the number of bytes copied for any range
+     *            that could only be partially copied
+     * @param count the number of ranges
+     * @param dst the destination of the copy operation
+     * @param dstOffset the offset in {@code dst} at which to start writing
+     * @return the total number of bytes copied or -1 if there was an error, if {@code count} exceeds the length
+     *         of {@code srcs} or {@code lengths}, or if the ranges do not fit in {@code dst}
+     */
+    private static native int nativeReadBytesBatch(int tgid, int tid, long[] srcs, int[] lengths, int count, ByteBuffer dst, int dstOffset);
+
+    public int readBytes(final long[] srcs, final int[] lengths, final int count, final ByteBuffer dst, final int dstOffset) {
+        if (!isLeader()) {
+            return leader().readBytes(srcs, lengths, count, dst, dstOffset);
+        }
+        assert dst.isDirect();
+        return execute(new Function<Integer>() {
+            public Integer call() throws Exception {
+                return nativeReadBytesBatch(tgid, tid, srcs, lengths, count, dst, dstOffset);
             }
         });
     }
@@ -402,13 +420,218 @@ public final class LinuxTask {
         });
     }
 
-    public void close() {
-        if (memory != null) {
-            try {
-                memory.close();
-            } catch (IOException ioException) {
-                ioException.printStackTrace();
+    private static native int nativeWatchpointSlots();
+
+    /**
+     * Gets the number of hardware watchpoints (i.e. x86 debug registers) available for watching memory in a traced
+     * process. A watchpoint covering a region that is not a single naturally aligned 1, 2, 4 or 8 byte range uses
+     * more than one of them.
+     */
+    public static int watchpointSlots() {
+        return nativeWatchpointSlots();
+    }
+
+    /**
+     * The number of x86 debug registers that can watch memory, each of which watches a naturally aligned range of at
+     * most {@value #WATCHPOINT_SLOT_RANGE} bytes.
+     */
+    public static final int WATCHPOINT_SLOTS = 4;
+
+    public static final int WATCHPOINT_SLOT_RANGE = 8;
+
+    /**
+     * Gets the number of {@linkplain #watchpointSlots() slots} a watchpoint needs. A read or write watchpoint needs a
+     * slot for each naturally aligned 1, 2, 4 or 8 byte range covering the watched region and an exec watchpoint needs
+     * a slot for the instruction at the start of the region. This is the allocation made by
+     * {@link #activateWatchpoint(long, long, boolean, boolean, boolean)}.
+     *
+     * @return the number of slots needed, or {@link #WATCHPOINT_SLOTS} {@code + 1} if that is more than there are
+     */
+    public static int watchpointSlotsNeeded(long start, long size, boolean read, boolean write, boolean exec) {
+        int n = exec ? 1 : 0;
+        if (read || write) {
+            long address = start;
+            final long end = start + size;
+            while (address < end && n <= WATCHPOINT_SLOTS) {
+                int length = WATCHPOINT_SLOT_RANGE;
+                while ((address & (length - 1)) != 0 || address + length > end) {
+                    length /= 2;
+                }
+                n++;
+                address += length;
             }
         }
+        return Math.min(n, WATCHPOINT_SLOTS + 1);
+    }
+
+    private static native boolean nativeActivateWatchpoint(long start, long size, boolean read, boolean write, boolean exec);
+
+    /**
+     * Activates a hardware watchpoint for all tasks in this task's process, including tasks started later.
+     * The debug registers of each task are updated just before the task is next resumed.
+     *
+     * @return {@code false} if there are not enough free {@linkplain #watchpointSlots() slots} for the watchpoint
+     */
+    public boolean activateWatchpoint(final long start, final long size, final boolean read, final boolean write, final boolean exec) {
+        return execute(new Function<Boolean>() {
+            public Boolean call() throws Exception {
+                return nativeActivateWatchpoint(start, size, read, write, exec);
+            }
+        });
+    }
+
+    private static native boolean nativeDeactivateWatchpoint(long start, long size);
+
+    public boolean deactivateWatchpoint(final long start, final long size) {
+        return execute(new Function<Boolean>() {
+            public Boolean call() throws Exception {
+                return nativeDeactivateWatchpoint(start, size);
+            }
+        });
+    }
+
+    private static native long nativeReadWatchpointAddress(int tid);
+
+    /**
+     * Gets the start address of the watchpoint that this task is stopped at.
+     *
+     * @return 0 if this task is not stopped as a result of triggering a watchpoint
+     */
+    public long readWatchpointAddress() {
+        return execute(new Function<Long>() {
+            public Long call() throws Exception {
+                return nativeReadWatchpointAddress(tid);
+            }
+        });
+    }
+
+    private static native int nativeReadWatchpointAccessCode(int tid);
+
+    /**
+     * Gets the kind of access that triggered the watchpoint this task is stopped at, encoded as for Solaris: 3 for a
+     * read, 4 for a write and 5 for an execution. As the x86 debug registers do not distinguish a read from a write, a
+     * watchpoint that traps on reads always reports a read.
+     *
+     * @return 0 if this task is not stopped as a result of triggering a watchpoint
+     */
+    public int readWatchpointAccessCode() {
+        return execute(new Function<Integer>() {
+            public Integer call() throws Exception {
+                return nativeReadWatchpointAccessCode(tid);
+            }
+        });
+    }
+
+    private static native void nativeRegisterSnapshotLayout(int[] layout);
+
+    private static native int nativeSnapshotRegisters(ByteBuffer buffer, int capacity);
+
+    /**
+     * The size of a record in a register snapshot, followed by the offsets of the integer, state and
+     * floating point registers in a record and then the sizes of the canonical integer, state and
+     * floating point register structures.
+     */
+    private static int[] registerSnapshotLayout;
+
+    /**
+     * The buffer into which the register snapshots of this task's process are taken; it is reused for each snapshot.
+     */
+    private ByteBuffer registerSnapshotBuffer;
+
+    /**
+     * The registers of all the stopped tasks in a process, taken with a single native call. The record for a task
+     * is only located and decoded when the registers of the task are {@linkplain #read requested}. A snapshot is
+     * only valid until the next snapshot of the same process is taken.
+     */
+    public static final class RegisterSnapshot {
+
+        private final ByteBuffer records;
+        private final int count;
+        private Map<Integer, Integer> recordOffsets;
+
+        private RegisterSnapshot(ByteBuffer records, int count) {
+            this.records = records;
+            this.count = count;
+        }
+
+        /**
+         * Copies the registers of a given task from this snapshot. As for the per-task read, only as many bytes as
+         * fit in each array are copied.
+         *
+         * @return {@code false} if this snapshot does not contain the registers of task {@code tid} or an array is
+         *         larger than the canonical register structure it receives
+         */
+        public boolean read(int tid, byte[] integerRegisters, byte[] floatingPointRegisters, byte[] stateRegisters) {
+            if (recordOffsets == null) {
+                recordOffsets = new HashMap<Integer, Integer>(count * 2);
+                final int recordSize = registerSnapshotLayout[0];
+                for (int i = 0; i < count; i++) {
+                    final int offset = i * recordSize;
+                    // the 'valid' word follows the task id
+                    if (records.getLong(offset + Longs.SIZE) != 0) {
+                        recordOffsets.put((int) records.getLong(offset), offset);
+                    }
+                }
+            }
+            final Integer offset = recordOffsets.get(tid);
+            if (offset == null) {
+                return false;
+            }
+            // arrays larger than the canonical structures are left to the per-task read, which rejects them
+            if (integerRegisters.length > registerSnapshotLayout[4] || stateRegisters.length > registerSnapshotLayout[5] ||
+                floatingPointRegisters.length > registerSnapshotLayout[6]) {
+                return false;
+            }
+            copy(offset + registerSnapshotLayout[1], integerRegisters);
+            copy(offset + registerSnapshotLayout[2], stateRegisters);
+            copy(offset + registerSnapshotLayout[3], floatingPointRegisters);
+            return true;
+        }
+
+        private void copy(int offset, byte[] registers) {
+            final ByteBuffer record = records.duplicate();
+            record.position(offset);
+            record.get(registers);
+        }
+    }
+
+    /**
+     * Takes a snapshot of the registers of all the stopped tasks in this task's process.
+     */
+    public RegisterSnapshot snapshotRegisters() {
+        return execute(new Function<RegisterSnapshot>() {
+            public RegisterSnapshot call() throws Exception {
+                if (registerSnapshotLayout == null) {
+                    final int[] layout = new int[7];
+                    nativeRegisterSnapshotLayout(layout);
+                    registerSnapshotLayout = layout;
+                }
+                final int recordSize = registerSnapshotLayout[0];
+                if (registerSnapshotBuffer == null) {
+                    registerSnapshotBuffer = ByteBuffer.allocateDirect(64 * recordSize).order(ByteOrder.nativeOrder());
+                }
+                while (true) {
+                    final int capacity = registerSnapshotBuffer.capacity() / recordSize;
+                    final int count = nativeSnapshotRegisters(registerSnapshotBuffer, capacity);
+                    if (count < 0) {
+                        // an empty snapshot makes callers fall back to reading the registers of each task
+                        return new RegisterSnapshot(registerSnapshotBuffer, 0);
+                    }
+                    if (count <= capacity) {
+                        return new RegisterSnapshot(registerSnapshotBuffer, count);
+                    }
+                    // leave room for threads started before the next snapshot
+                    registerSnapshotBuffer = ByteBuffer.allocateDirect((count + count / 4 + 16) * recordSize).order(ByteOrder.nativeOrder());
+                }
+            }
+        });
+    }
+
+    private static native void nativeCloseMemory(int tgid);
+
+    public void close() {
+        if (isLeader()) {
+            nativeCloseMemory(tgid);
+        }
     }
 }
@@ -25,6 +25,7 @@ package com.sun.max.tele.debug.linux;
 import java.io.*;
 
 import com.sun.max.platform.*;
+import com.sun.max.tele.MaxWatchpoint.WatchpointSettings;
 import com.sun.max.tele.*;
 import com.sun.max.tele.debug.*;
 import com.sun.max.tele.debug.TeleNativeThread.Params;
@@ -50,6 +51,48 @@ public final class LinuxTeleProcess extends UnixTeleProcessAdaptor {
     LinuxTeleProcess(TeleVM teleVM, Platform platform, File programFile, int id) throws BootImageException {
         super(teleVM, platform, programFile, id);
     }
+
+    /**
+     * Memory watchpoints are implemented with the hardware debug registers when the VM is controlled
+     * directly with ptrace. This is called from the {@link TeleProcess} constructor and so cannot
+     * use the {@link #protocol} field.
+     */
+    @Override
+    public int platformWatchpointCount() {
+        if (TeleVM.teleChannelProtocol() instanceof LinuxNativeTeleChannelProtocol) {
+            return LinuxTask.watchpointSlots();
+        }
+        return 0;
+    }
+
+    /**
+     * A watchpoint needs a debug register for each naturally aligned range of up to 8 bytes covering the watched
+     * region, plus one to watch for execution, so no region larger than 32 bytes can be watched.
+     */
+    @Override
+    protected int platformWatchpointCost(MaxMemoryRegion memoryRegion, WatchpointSettings settings) {
+        return LinuxTask.watchpointSlotsNeeded(memoryRegion.start().toLong(), memoryRegion.nBytes(), settings.trapOnRead, settings.trapOnWrite, settings.trapOnExec);
+    }
+
+    /**
+     * The watchpoint triggered by each thread is recorded separately when the VM is controlled directly with ptrace.
+     */
+    @Override
+    protected long readWatchpointAddress(TeleNativeThread thread) {
+        if (protocol instanceof LinuxNativeTeleChannelProtocol) {
+            return ((LinuxNativeTeleChannelProtocol) protocol).readWatchpointAddress(thread.localHandle());
+        }
+        return super.readWatchpointAddress(thread);
+    }
+
+    @Override
+    protected int readWatchpointAccessCode(TeleNativeThread thread) {
+        if (protocol instanceof LinuxNativeTeleChannelProtocol) {
+            return toWatchpointAccessCode(((LinuxNativeTeleChannelProtocol) protocol).readWatchpointAccessCode(thread.localHandle()));
+        }
+        return super.readWatchpointAccessCode(thread);
+    }
+
     @Override
     protected TeleNativeThread createTeleNativeThread(Params params) {
         return new LinuxTeleNativeThread(this, params);
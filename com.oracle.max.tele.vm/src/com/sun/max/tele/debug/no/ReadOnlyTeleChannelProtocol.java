@@ -190,6 +190,12 @@ public class ReadOnlyTeleChannelProtocol implements TeleChannelProtocol {
         return 0;
     }
 
+    @Override
+    public int readBytes(long[] srcs, int[] lengths, int count, ByteBuffer dst, int dstOffset) {
+        unexpected();
+        return 0;
+    }
+
     @Override
     public boolean gatherThreads(Object teleDomain, Object threadList, long tlaList) {
         unexpected();
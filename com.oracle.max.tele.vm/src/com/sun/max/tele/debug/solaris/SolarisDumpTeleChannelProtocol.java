@@ -40,7 +40,7 @@ public class SolarisDumpTeleChannelProtocol extends ELFDumpTeleChannelProtocolAd
     private ByteBuffer pStatus;
 
     static class LwpData {
-        // direct buffers
+        // direct buffers (slices of the mapped dump file)
         ByteBuffer lwpStatus;
         ByteBuffer lwpInfo;
 
@@ -67,12 +67,14 @@ public class SolarisDumpTeleChannelProtocol extends ELFDumpTeleChannelProtocolAd
         LwpData lwpData;
 
         @Override
-        protected void processNoteEntry(int type, String name, byte[] desc) {
+        protected void processNoteEntry(int type, String name, ByteBuffer desc) {
             final NoteType noteType = NoteType.get(type);
+            if (noteType == null) {
+                return;
+            }
             switch (noteType) {
                 case NT_PSTATUS:
-                    pStatus = ByteBuffer.allocateDirect(desc.length);
-                    pStatus.put(desc);
+                    pStatus = desc;
                     @SuppressWarnings("unused")
                     final int numActiveLwps = numActiveLwps(pStatus);
                     @SuppressWarnings("unused")
@@ -81,8 +83,7 @@ public class SolarisDumpTeleChannelProtocol extends ELFDumpTeleChannelProtocolAd
 
                 case NT_LWPSINFO: {
                     // this comes before NT_LWPSTATUS
-                    ByteBuffer lwpInfo = ByteBuffer.allocateDirect(desc.length);
-                    lwpInfo.put(desc);
+                    ByteBuffer lwpInfo = desc;
                     if (!isZombieLwp(lwpInfo)) {
                         lwpData = new LwpData(lwpInfo);
                         lwpDataList.add(lwpData);
@@ -91,9 +92,7 @@ public class SolarisDumpTeleChannelProtocol extends ELFDumpTeleChannelProtocolAd
                 }
 
                 case NT_LWPSTATUS: {
-                    ByteBuffer lwpStatus = ByteBuffer.allocateDirect(desc.length);
-                    lwpStatus.put(desc);
-                    lwpData.lwpStatus = lwpStatus;
+                    lwpData.lwpStatus = desc;
                     lwpData = null;
                     break;
                 }
@@ -222,6 +222,11 @@ public class UnixNativeTeleChannelProtocolAdaptor implements TeleChannelProtocol
         return natives.writeBytes(processHandle, dst, src.array(), false, src.arrayOffset() + srcOffset, length);
     }
 
+    @Override
+    public int readBytes(long[] srcs, int[] lengths, int count, ByteBuffer dst, int dstOffset) {
+        return TeleChannelTransferBytes.readBytes(this, srcs, lengths, count, dst, dstOffset);
+    }
+
     @Override
     public boolean gatherThreads(Object teleDomain, Object threadList, long tlaList) {
         natives.gatherThreads(processHandle, teleDomain, threadList, tlaList);
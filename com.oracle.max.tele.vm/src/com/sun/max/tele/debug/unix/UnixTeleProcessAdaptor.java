@@ -128,6 +128,11 @@ public abstract class UnixTeleProcessAdaptor extends TeleProcess {
         return TeleChannelTransferBytes.readBytes(protocol, dst, offset, length, src);
     }
 
+    @Override
+    protected int read0(long[] srcs, int[] lengths, int count, ByteBuffer dst, int offset) {
+        return protocol.readBytes(srcs, lengths, count, dst, offset);
+    }
+
     @Override
     protected int write0(ByteBuffer src, int offset, int length, Address dst) {
         return TeleChannelTransferBytes.writeBytes(protocol, src, offset, length, dst);
@@ -166,7 +171,14 @@ public abstract class UnixTeleProcessAdaptor extends TeleProcess {
      */
     @Override
     protected int readWatchpointAccessCode() {
-        int code = protocol.readWatchpointAccessCode();
+        return toWatchpointAccessCode(protocol.readWatchpointAccessCode());
+    }
+
+    /**
+     * Converts a watchpoint access code reported by the native layer, encoded as the {@code si_code} of a Solaris
+     * watchpoint trap, to the code reported in a {@link VmWatchpointEvent}.
+     */
+    protected static int toWatchpointAccessCode(int code) {
         if (code == 3) {
             return 1;
         } else if (code == 4) {
@@ -53,14 +53,33 @@ public final class TeleVMLogNative extends TeleVMLog {
     }
 
     public int nativeRecordSize(Address address) {
-        final int argCount = Record.getArgCount(memory().readInt(address));
-        return VMLogNativeThread.ARGS_OFFSET + argCount * vm().platform().nBytesInWord();
+        final int header = memory().readInt(address);
+        final int nBytesInWord = vm().platform().nBytesInWord();
+        if (Record.isFree(header)) {
+            // holes are filled with one word records
+            return nBytesInWord;
+        }
+        return nativeRecordArgsOffset() + Record.getArgCount(header) * nBytesInWord;
+    }
+
+    /**
+     * The timestamp of a record in a {@linkplain VMLogNativeThread timestamped} per-thread log.
+     */
+    public long timestamp(Address address) {
+        return memory().readLong(address, VMLogNativeThread.TIMESTAMP_OFFSET);
     }
 
     public int logSize() {
         return fields().VMLogNative_logSize.readInt(reference());
     }
 
+    /**
+     * The current log buffer, which is not cached as a log may move it, e.g., into a file mapping.
+     */
+    public Address logBuffer() {
+        return fields().VMLogNative_logBuffer.readWord(reference()).asAddress();
+    }
+
     public TeleHostedLogRecord getLogRecord(Address recordAddress, int id) {
         if (recordAddress.isZero()) {
             return new TeleHostedLogRecord();
@@ -56,6 +56,10 @@ public class Page extends AbstractVmHolder {
 
     private final long index;
 
+    /**
+     * Whether the contents were last set by {@link #refresh(ByteBuffer, int)} and have not been read since.
+     */
+    private boolean refreshedInBatch;
 
     /**
      * The VM epoch the last time we reported a page refresh failure, used to avoid duplicate messages.
@@ -110,7 +114,7 @@ public class Page extends AbstractVmHolder {
      * Decide whether to use direct buffers.
      * It is counter-productive to use them if the target VM is remote.
      */
-    private static boolean useDirectBuffers() {
+    static boolean useDirectBuffers() {
         return TeleVM.targetLocation().kind != Kind.REMOTE;
     }
 
@@ -142,6 +146,40 @@ public class Page extends AbstractVmHolder {
         epoch = -1;
     }
 
+    /**
+     * @return whether the contents of this page need to be read again before use.
+     */
+    public boolean isStale() {
+        return epoch < teleIO.epoch();
+    }
+
+    /**
+     * Sets the contents of this page from a buffer into which they have already been read,
+     * for example by a batched read of several pages.
+     *
+     * @param src the buffer holding the contents of the page
+     * @param srcOffset the offset in {@code src} of the first byte of the page
+     */
+    public void refresh(ByteBuffer src, int srcOffset) {
+        final ByteBuffer srcSlice = src.duplicate();
+        final ByteBuffer dstSlice = buffer.duplicate();
+        srcSlice.position(srcOffset).limit(srcOffset + size());
+        dstSlice.position(0).limit(size());
+        dstSlice.put(srcSlice);
+        epoch = teleIO.epoch();
+        refreshedInBatch = true;
+    }
+
+    /**
+     * Determines whether the contents of this page were set by {@link #refresh(ByteBuffer, int)} since
+     * the last call to this method, i.e. whether they are about to be read for the first time.
+     */
+    public boolean clearRefreshedInBatch() {
+        final boolean result = refreshedInBatch;
+        refreshedInBatch = false;
+        return result;
+    }
+
     /**
      * Reads into the cache the contents of the remote memory page.
      *
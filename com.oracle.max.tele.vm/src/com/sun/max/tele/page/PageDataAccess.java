@@ -34,11 +34,39 @@ import com.sun.max.tele.util.*;
 import com.sun.max.unsafe.*;
 
 /**
+ * Access to VM memory through a cache of {@linkplain Page pages}. A page is read from the VM the first time it
+ * is accessed in each {@linkplain TeleIO#epoch() epoch} of the VM process, i.e. after each time the process stops,
+ * and after any write to it from here.
+ * <p>
+ * Misses on consecutive pages are taken to be a sequential scan, in response to which the following pages are
+ * prefetched with a single batched read. The prefetch window doubles with each further sequential miss, up to
+ * the value of the {@code "max.tele.page.prefetch"} property (16 pages by default; 0 disables prefetching).
+ * The first read of a page fetched by a batched read counts as a miss rather than a hit.
+ * Hit and miss counts are {@linkplain Trace traced} at level {@value #TRACE_VALUE} at the start of each epoch.
  */
 public class PageDataAccess extends DataAccessAdapter {
 
     private static final int TRACE_VALUE = 1;
 
+    private static final int DEFAULT_MAX_PREFETCH_PAGES = 16;
+
+    /**
+     * The maximum number of pages read ahead in response to a sequential scan.
+     */
+    public static final int maxPrefetchPages;
+    static {
+        int pages = DEFAULT_MAX_PREFETCH_PAGES;
+        final String value = System.getProperty("max.tele.page.prefetch");
+        if (value != null) {
+            try {
+                pages = Integer.parseInt(value);
+            } catch (NumberFormatException numberFormatException) {
+                TeleWarning.message("Malformed value for the \"max.tele.page.prefetch\" property", numberFormatException);
+            }
+        }
+        maxPrefetchPages = pages;
+    }
+
     protected String  tracePrefix() {
         return "[PageDataAccess] ";
     }
@@ -114,17 +142,153 @@ public class PageDataAccess extends DataAccessAdapter {
         return page;
     }
 
-    private Page getPage(Address address) {
-        return getPage(getIndex(address));
+    /**
+     * The page most recently returned by {@link #getPageForRead(long)}, saving a map lookup
+     * for the common case of several reads from one object.
+     */
+    private Page lastPage;
+    private long lastPageIndex = -1;
+
+    /**
+     * The index of the page most recently missed, or of the last page prefetched in response to it,
+     * used to detect sequential scans.
+     */
+    private long lastMissIndex = -1;
+
+    /**
+     * The number of pages to read for the next sequential miss.
+     */
+    private int prefetchPages = 1;
+
+    private long hits;
+    private long misses;
+    private long batchedPages;
+    private long epochHits;
+    private long epochMisses;
+    private long statisticsEpoch = -1;
+
+    /**
+     * Gets a page from which a read is about to be made, updating the statistics and prefetching
+     * the pages that follow it if it is the latest miss of a sequential scan.
+     */
+    private Page getPageForRead(long index) {
+        final Page page;
+        if (index == lastPageIndex) {
+            page = lastPage;
+        } else {
+            page = getPage(index);
+            lastPage = page;
+            lastPageIndex = index;
+        }
+        if (statisticsEpoch != teleIO.epoch()) {
+            if (epochHits + epochMisses != 0) {
+                Trace.line(TRACE_VALUE, tracePrefix() + "epoch " + statisticsEpoch + ": " + epochHits + " hits, " + epochMisses + " misses; " + statistics());
+            }
+            epochHits = 0;
+            epochMisses = 0;
+            statisticsEpoch = teleIO.epoch();
+        }
+        if (page.isStale()) {
+            misses++;
+            epochMisses++;
+            page.clearRefreshedInBatch();
+            if (maxPrefetchPages > 1 && index == lastMissIndex + 1) {
+                prefetchPages = Math.min(prefetchPages * 2, maxPrefetchPages);
+                refreshPages(index, index + prefetchPages - 1);
+                page.clearRefreshedInBatch();
+                lastMissIndex = index + prefetchPages - 1;
+            } else {
+                prefetchPages = 1;
+                lastMissIndex = index;
+            }
+        } else if (page.clearRefreshedInBatch()) {
+            // the first read of a page fetched by a batched read is still a read from the VM
+            misses++;
+            epochMisses++;
+        } else {
+            hits++;
+            epochHits++;
+        }
+        return page;
+    }
+
+    private Page getPageForRead(Address address) {
+        return getPageForRead(getIndex(address));
+    }
+
+    /**
+     * @return a summary of the cache statistics since this object was created
+     */
+    public synchronized String statistics() {
+        final long accesses = hits + misses;
+        return indexToPage.size() + " pages cached, " + hits + " hits, " + misses + " misses (" +
+            (accesses == 0 ? 0 : (100 * hits) / accesses) + "% hit rate), " + batchedPages + " pages read in batches";
+    }
+
+    /**
+     * The buffer into which {@link #refreshPages(Address, int)} reads several pages at once.
+     */
+    private ByteBuffer batchBuffer;
+
+    /**
+     * Refreshes the stale pages in a range of pages with a single batched read rather than
+     * one read per page. Pages that cannot be read are left stale so that reading them individually
+     * reports the failure as before.
+     *
+     * @param firstIndex the index of the first page in the range
+     * @param lastIndex the index of the last page in the range
+     */
+    private void refreshPages(long firstIndex, long lastIndex) {
+        if (firstIndex >= lastIndex) {
+            return;
+        }
+        final int numberOfPages = (int) (lastIndex - firstIndex + 1);
+        final Page[] stalePages = new Page[numberOfPages];
+        final long[] addresses = new long[numberOfPages];
+        final int[] lengths = new int[numberOfPages];
+        int count = 0;
+        for (long index = firstIndex; index <= lastIndex; index++) {
+            final Page page = getPage(index);
+            if (page.isStale()) {
+                stalePages[count] = page;
+                addresses[count] = page.address().toLong();
+                lengths[count] = pageSize();
+                count++;
+            }
+        }
+        if (count < 2) {
+            return;
+        }
+        final int batchSize = count * pageSize();
+        if (batchBuffer == null || batchBuffer.capacity() < batchSize) {
+            batchBuffer = Page.useDirectBuffers() ? ByteBuffer.allocateDirect(batchSize) : ByteBuffer.allocate(batchSize);
+            batchBuffer.order(byteOrder);
+        }
+        try {
+            teleIO.read(addresses, lengths, count, batchBuffer, 0);
+        } catch (DataIOError dataIOError) {
+            return;
+        } catch (TerminatedProcessIOException terminatedProcessIOException) {
+            return;
+        }
+        for (int i = 0; i < count; i++) {
+            if (lengths[i] == pageSize()) {
+                stalePages[i].refresh(batchBuffer, i * pageSize());
+                batchedPages++;
+            }
+        }
     }
 
     public synchronized int read(Address address, ByteBuffer buffer, int offset, int length) {
         final int toRead = Math.min(length, buffer.limit() - offset);
+        if (toRead > 0) {
+            refreshPages(getIndex(address), getIndex(address.plus(toRead - 1)));
+        }
         long pageIndex = getIndex(address);
         int pageOffset = getOffset(address);
         int i = 0;
         while (i < toRead) {
-            i += getPage(pageIndex).readBytes(pageOffset, buffer, i + offset);
+            i += getPageForRead(pageIndex).readBytes(pageOffset, buffer, i + offset);
             pageIndex++;
             pageOffset = 0;
         }
@@ -133,22 +297,22 @@ public class PageDataAccess extends DataAccessAdapter {
 
     public synchronized byte readByte(Address address) {
         checkNullPointer(address);
-        return getPage(address).readByte(getOffset(address));
+        return getPageForRead(address).readByte(getOffset(address));
     }
 
     public synchronized short readShort(Address address) {
         checkNullPointer(address);
-        return getPage(address).readShort(getOffset(address));
+        return getPageForRead(address).readShort(getOffset(address));
     }
 
     public synchronized int readInt(Address address) {
         checkNullPointer(address);
-        return getPage(address).readInt(getOffset(address));
+        return getPageForRead(address).readInt(getOffset(address));
     }
 
-    public long readLong(Address address) {
+    public synchronized long readLong(Address address) {
         checkNullPointer(address);
-        return getPage(address).readLong(getOffset(address));
+        return getPageForRead(address).readLong(getOffset(address));
     }
 
     public synchronized int write(ByteBuffer buffer, int offset, int length, Address address) {
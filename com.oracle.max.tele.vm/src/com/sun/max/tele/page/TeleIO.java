@@ -22,6 +22,8 @@
  */
 package com.sun.max.tele.page;
 
+import java.nio.*;
+
 import com.sun.max.tele.data.*;
 import com.sun.max.unsafe.*;
 
@@ -40,4 +42,20 @@ public interface TeleIO extends DataIO {
      * @return the number of times the I/O source/destination has been modified.
      */
     long epoch();
+
+    /**
+     * Reads a number of ranges of bytes into consecutive locations of a buffer, using as few requests
+     * to the I/O source as it supports. The bytes of range {@code i} are read into {@code dst} at {@code dstOffset}
+     * plus the sum of the lengths of the preceding ranges.
+     *
+     * @param srcs the addresses of the ranges to read
+     * @param lengths the number of bytes in each range; on return, the element for a range that could not be read
+     *            in full holds the number of bytes that were read for it
+     * @param count the number of ranges to read
+     * @param dst the buffer into which the bytes are read
+     * @param dstOffset the offset in {@code dst} at which the bytes are read
+     * @return the total number of bytes read
+     * @throws DataIOError if some IO error occurs
+     */
+    int read(long[] srcs, int[] lengths, int count, ByteBuffer dst, int dstOffset) throws DataIOError;
 }
@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2007, 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package test.com.sun.max.tele.debug.linux;
+
+import static com.sun.max.tele.debug.linux.LinuxTask.*;
+
+import com.sun.max.ide.*;
+import com.sun.max.tele.debug.linux.*;
+
+/**
+ * Tests the number of x86 debug registers {@link LinuxTask#watchpointSlotsNeeded} reports a watchpoint needs, which must
+ * match the allocation made by the native watchpoint support (see taskEngineTest.c).
+ */
+public class LinuxWatchpointSlotsTest extends MaxTestCase {
+
+    public LinuxWatchpointSlotsTest(String name) {
+        super(name);
+    }
+
+    public static void main(String[] args) {
+        junit.textui.TestRunner.run(LinuxWatchpointSlotsTest.class);
+    }
+
+    private static int dataSlots(long start, long size) {
+        return watchpointSlotsNeeded(start, size, true, true, false);
+    }
+
+    public void test_aligned() {
+        assertEquals(1, dataSlots(0x1000, 1));
+        assertEquals(1, dataSlots(0x1000, 2));
+        assertEquals(1, dataSlots(0x1000, 4));
+        assertEquals(1, dataSlots(0x1000, WATCHPOINT_SLOT_RANGE));
+        assertEquals(2, dataSlots(0x1000, 12));
+        assertEquals(WATCHPOINT_SLOTS, dataSlots(0x1000, WATCHPOINT_SLOTS * WATCHPOINT_SLOT_RANGE));
+    }
+
+    public void test_unaligned() {
+        // 0x1003, 0x1004-0x1005, 0x1006
+        assertEquals(3, dataSlots(0x1003, 4));
+        // 0x1004-0x1007, 0x1008-0x100f
+        assertEquals(2, dataSlots(0x1004, 12));
+        // 0x1006-0x1007, 0x1008-0x100f
+        assertEquals(2, dataSlots(0x1006, 10));
+        // 0x1001, 0x1002-0x1003, 0x1004-0x1007, 0x1008-0x100f, 0x1010
+        assertEquals(WATCHPOINT_SLOTS + 1, dataSlots(0x1001, 16));
+    }
+
+    public void test_tooLarge() {
+        assertEquals(WATCHPOINT_SLOTS + 1, dataSlots(0x1000, WATCHPOINT_SLOTS * WATCHPOINT_SLOT_RANGE + 1));
+        assertEquals(WATCHPOINT_SLOTS + 1, dataSlots(0x1000, 1L << 30));
+    }
+
+    public void test_exec() {
+        assertEquals(1, watchpointSlotsNeeded(0x1003, 100, false, false, true));
+        assertEquals(2, watchpointSlotsNeeded(0x1000, 8, false, true, true));
+        assertEquals(WATCHPOINT_SLOTS + 1, watchpointSlotsNeeded(0x1000, WATCHPOINT_SLOTS * WATCHPOINT_SLOT_RANGE, false, true, true));
+        assertEquals(0, watchpointSlotsNeeded(0x1000, 8, false, false, false));
+    }
+}
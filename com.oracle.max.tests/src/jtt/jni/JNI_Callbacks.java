@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package jtt.jni;
+
+/*
+ * @Harness: java
+ * @Runs: 1 = true; 10 = true
+ */
+public class JNI_Callbacks {
+
+    private static int noArgument() {
+        return 1;
+    }
+
+    private static int intArgument(int i) {
+        return i + 1;
+    }
+
+    private static long longArgument(long l) {
+        return l + 1;
+    }
+
+    private static int objectArgument(Object o) {
+        return o == null ? 0 : o.toString().length();
+    }
+
+    private static double manyArguments(int i, long l, Object o, float f, double d) {
+        return i + l + objectArgument(o) + f + d;
+    }
+
+    /**
+     * Calls each of the above methods {@code n} times through the varargs {@code CallStatic<type>Method}
+     * functions and returns the sum of the results.
+     */
+    private static native double callbacks(Class c, int n);
+
+    public static boolean test(int n) {
+        double expected = 0;
+        for (int i = 0; i < n; i++) {
+            expected += noArgument() + intArgument(i) + longArgument(i) + objectArgument("XXX") + manyArguments(i, i, "XXX", 0.5f, 0.25d);
+        }
+        return callbacks(JNI_Callbacks.class, n) == expected;
+    }
+}
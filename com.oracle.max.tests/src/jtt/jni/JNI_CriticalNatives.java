@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2009, 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package jtt.jni;
+
+/*
+ * Tests static native methods that have a JavaCritical_ implementation. Whichever implementation they are bound to,
+ * primitive arrays (including null ones) must reach it intact while objects are being allocated, and a method bound
+ * with RegisterNatives before it is first called must keep that binding.
+ *
+ * @Harness: java
+ * @Runs: 1 = true; 2 = true; 3 = true;
+ */
+public class JNI_CriticalNatives {
+
+    public static boolean test(int arg) {
+        if (arg == 1) {
+            final int[] values = new int[1000];
+            int expected = 0;
+            for (int i = 0; i < values.length; i++) {
+                values[i] = i * 7;
+                expected += values[i];
+            }
+            for (int round = 0; round < 1000; round++) {
+                // Allocate so that collections happen around the calls
+                final Object[] garbage = new Object[100];
+                garbage[round % garbage.length] = new int[round];
+                if (sum(values) != expected || sum(null) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        } else if (arg == 2) {
+            final byte[] a = {1, 2, 3};
+            final double[] b = {0.5, 0.25};
+            return combine(a, 10, b) == 3 * 10000 + 2 * 100 + 10;
+        } else if (arg == 3) {
+            return register() && registered() == 42;
+        }
+        return false;
+    }
+
+    private static native int sum(int[] values);
+
+    /**
+     * @return the lengths of both arrays and the value of {@code scale}, encoded in decimal digits
+     */
+    private static native int combine(byte[] a, int scale, double[] b);
+
+    /**
+     * Binds {@link #registered()} to a function returning 42 with RegisterNatives.
+     */
+    private static native boolean register();
+
+    /**
+     * Has a JavaCritical_ implementation returning 7, which must not be used once the method has been registered.
+     */
+    private static native int registered();
+}
@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2007, 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package jtt.jvmni;
+
+/*
+ * @Harness: java
+ * @Runs: 0 = true;
+ */
+public class JMM_GetLongAttributes01 {
+    // JMM_CLASS_LOADED_COUNT, JMM_THREAD_LIVE_COUNT, JMM_GC_EXT_ATTRIBUTE_INFO_SIZE and an unknown attribute
+    private static final int[] ATTRIBUTES = {1, 4, 401, 9999};
+
+    public static boolean test(int arg) {
+        if (arg == 0) {
+            final long[] values = new long[ATTRIBUTES.length];
+            final int supported = call(ATTRIBUTES, values);
+            return supported == 3 && values[0] > 0 && values[1] >= 1 && values[2] == 0 && values[3] == -1;
+        }
+        return false;
+    }
+
+    public static native int call(int[] attributes, long[] values);
+
+}
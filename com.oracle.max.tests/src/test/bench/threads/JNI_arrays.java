@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+/*
+ * @Harness: java
+ * @Runs: 0 = true
+ */
+package test.bench.threads;
+
+import test.bench.util.*;
+
+/**
+ * Measures the cost of transferring primitive arrays to and from native code. Each run passes an array
+ * to a native method that reads and updates every element through one of the JNI array access paths.
+ * The following system properties control the benchmark:
+ * <ul>
+ * <li>{@value SIZE_PROPERTY}: the length of the {@code int} array, default {@value DEFAULT_SIZE}
+ * <li>{@value MODE_PROPERTY}: the access path, one of {@code elements} (Get/ReleaseIntArrayElements),
+ * {@code region} (Get/SetIntArrayRegion) or {@code critical} (Get/ReleasePrimitiveArrayCritical), default {@code elements}
+ * </ul>
+ */
+public class JNI_arrays extends RunBench {
+
+    protected JNI_arrays() {
+        super(new Bench());
+    }
+
+    public static boolean test() {
+        return new JNI_arrays().runBench();
+    }
+
+    static {
+        System.loadLibrary("javatest");
+    }
+
+    /**
+     * Increments every element of {@code array} and returns their sum.
+     */
+    private static native long elements(int[] array);
+
+    private static native long region(int[] array);
+
+    private static native long critical(int[] array);
+
+    static class Bench extends MicroBenchmark {
+        private static final int DEFAULT_SIZE = 1024 * 1024;
+        private static final String SIZE_PROPERTY = "test.bench.threads.jni.arrays.size";
+        private static final String MODE_PROPERTY = "test.bench.threads.jni.arrays.mode";
+        private final int[] array;
+        private final int mode;
+
+        Bench() {
+            final String size = System.getProperty(SIZE_PROPERTY);
+            array = new int[size == null ? DEFAULT_SIZE : Integer.parseInt(size)];
+            final String modeName = System.getProperty(MODE_PROPERTY, "elements");
+            if (modeName.equals("elements")) {
+                mode = 0;
+            } else if (modeName.equals("region")) {
+                mode = 1;
+            } else if (modeName.equals("critical")) {
+                mode = 2;
+            } else {
+                throw new IllegalArgumentException("unknown mode: " + modeName);
+            }
+        }
+
+        @Override
+        public long run() {
+            switch (mode) {
+                case 0: return elements(array);
+                case 1: return region(array);
+                default: return critical(array);
+            }
+        }
+    }
+
+    public static void main(String[] args) {
+        RunBench.runTest(JNI_arrays.class, args);
+    }
+}
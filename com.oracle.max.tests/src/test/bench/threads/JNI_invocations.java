@@ -41,7 +41,12 @@ import test.bench.util.*;
  * <li>{@value WORKLOAD_PROPERTY}: a value designating the amount of work the JNI call does, default {@value DEFAULT_WORKLOAD}
  * <li>{@value GC_PROPERTY}: if set, create a GC thread
  * <li>{@value GC_INTERVAL_PROPERTY}: interval between garbage collections, default {@value DEFAULT_GC_INTERVAL}
+ * <li>{@value MODE_PROPERTY}: the native method called, one of {@code jni} (a standard JNI method),
+ * {@code critical} (a method with a {@code JavaCritical_} implementation) or {@code checksum} (a critical method
+ * that checksums a byte array of {@value WORKLOAD_PROPERTY} elements), default {@code jni}
  * </ul>
+ * Running the {@code critical} and {@code checksum} modes with {@code -XX:-CriticalJNINatives} measures the
+ * same native work through the standard JNI stub.
  */
 
 public class JNI_invocations extends RunBench {
@@ -60,6 +65,16 @@ public class JNI_invocations extends RunBench {
      */
     private static native long nativework(long workload);
 
+    /**
+     * As {@link #nativework(long)} but also implemented by a critical native function.
+     */
+    private static native long criticalwork(long workload);
+
+    /**
+     * Computes a checksum of {@code data}. Also implemented by a critical native function.
+     */
+    private static native long checksum(byte[] data);
+
     static class Bench extends MicroBenchmark {
         private static Barrier barrier1;
         private static Barrier barrier2;
@@ -72,12 +87,14 @@ public class JNI_invocations extends RunBench {
         private static int workload;
         private static int gcInterval;
         private static boolean gc;
+        private static int mode;
         private static boolean trace = System.getProperty("trace") != null;
         private static final String THREADS_PROPERTY = "test.bench.threads.jni.threads";
         private static final String JNICALLS_PROPERTY = "test.bench.threads.jni.calls";
         private static final String WORKLOAD_PROPERTY = "test.bench.threads.jni.work";
         private static final String GC_PROPERTY = "test.bench.threads.jni.gc";
         private static final String GC_INTERVAL_PROPERTY = "test.bench.threads.jni.gc.interval";
+        private static final String MODE_PROPERTY = "test.bench.threads.jni.mode";
 
         Bench() {
             nrThreads = getIntProperty(THREADS_PROPERTY, DEFAULT_THREADS);
@@ -87,6 +104,16 @@ public class JNI_invocations extends RunBench {
             if (gc) {
                 gcInterval = getIntProperty(GC_INTERVAL_PROPERTY, DEFAULT_GC_INTERVAL);
             }
+            final String modeName = System.getProperty(MODE_PROPERTY, "jni");
+            if (modeName.equals("jni")) {
+                mode = 0;
+            } else if (modeName.equals("critical")) {
+                mode = 1;
+            } else if (modeName.equals("checksum")) {
+                mode = 2;
+            } else {
+                throw new IllegalArgumentException("unknown mode: " + modeName);
+            }
         }
 
         private static int getIntProperty(String propName, int defaultValue) {
@@ -132,9 +159,14 @@ public class JNI_invocations extends RunBench {
             }
 
             public void run() {
+                final byte[] data = new byte[workload];
                 barrier1.waitForRelease();
                 for (int i = 0; i < nrJNIcalls; i++) {
-                    nativework(workload);
+                    switch (mode) {
+                        case 0: nativework(workload); break;
+                        case 1: criticalwork(workload); break;
+                        default: checksum(data); break;
+                    }
                 }
                 barrier2.waitForRelease();
             }
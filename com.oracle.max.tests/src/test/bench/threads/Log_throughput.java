@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+/*
+ * @Harness: java
+ * @Runs: 0 = true
+ */
+package test.bench.threads;
+
+import test.bench.util.*;
+
+/**
+ * Measures the throughput of the VM's native log output when several threads log concurrently. Each run
+ * starts worker threads that each write a number of multi-line records to the VM log. Run with
+ * {@code -XX:LogFile=<file>} and compare {@code -XX:+LogBuffered} against the default unbuffered output.
+ * The following system properties control the benchmark:
+ * <ul>
+ * <li>{@value THREADS_PROPERTY}: the number of worker threads, default {@value DEFAULT_THREADS}
+ * <li>{@value RECORDS_PROPERTY}: the number of records written by each thread, default {@value DEFAULT_RECORDS}
+ * <li>{@value LINES_PROPERTY}: the number of lines in each record, default {@value DEFAULT_LINES}
+ * </ul>
+ */
+public class Log_throughput extends RunBench {
+
+    protected Log_throughput() {
+        super(new Bench());
+    }
+
+    public static boolean test() {
+        return new Log_throughput().runBench();
+    }
+
+    /**
+     * Writes {@code records} records of {@code lines} lines each to the VM log, holding the log lock for each record.
+     */
+    private static native void logRecords(int records, int lines);
+
+    static class Bench extends MicroBenchmark {
+        private static final int DEFAULT_THREADS = 4;
+        private static final int DEFAULT_RECORDS = 1000;
+        private static final int DEFAULT_LINES = 4;
+        private static final String THREADS_PROPERTY = "test.bench.threads.log.threads";
+        private static final String RECORDS_PROPERTY = "test.bench.threads.log.records";
+        private static final String LINES_PROPERTY = "test.bench.threads.log.lines";
+        private final int nrThreads;
+        private final int nrRecords;
+        private final int nrLines;
+
+        Bench() {
+            nrThreads = Integer.getInteger(THREADS_PROPERTY, DEFAULT_THREADS);
+            nrRecords = Integer.getInteger(RECORDS_PROPERTY, DEFAULT_RECORDS);
+            nrLines = Integer.getInteger(LINES_PROPERTY, DEFAULT_LINES);
+        }
+
+        @Override
+        public long run() {
+            final Barrier start = new Barrier(nrThreads);
+            final Thread[] threads = new Thread[nrThreads];
+            for (int i = 0; i < nrThreads; i++) {
+                threads[i] = new Thread() {
+                    @Override
+                    public void run() {
+                        start.waitForRelease();
+                        logRecords(nrRecords, nrLines);
+                    }
+                };
+                threads[i].start();
+            }
+            for (Thread thread : threads) {
+                try {
+                    thread.join();
+                } catch (InterruptedException e) {
+                    throw new RuntimeException(e);
+                }
+            }
+            return defaultResult;
+        }
+    }
+
+    public static void main(String[] args) {
+        RunBench.runTest(Log_throughput.class, args);
+    }
+}
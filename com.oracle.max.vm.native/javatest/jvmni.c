@@ -31,6 +31,7 @@
 #include <string.h>
 
 #include "jni.h"
+#include "jmm.h"
 
 JNIEXPORT jobjectArray JNICALL
 JVM_GetClassContext(JNIEnv *env);
@@ -51,6 +52,8 @@ JNIEXPORT void JNICALL
 JVM_ArrayCopy(JNIEnv *env, jclass ignored, jobject src, jint src_pos,
                jobject dst, jint dst_pos, jint length);
 
+void *JVM_GetManagement(jint version);
+
 JNIEXPORT jobject JNICALL
 Java_jtt_jvmni_JVM_1GetClassContext01_call(JNIEnv *env, jclass c)
 {
@@ -113,3 +116,26 @@ Java_jtt_jvmni_JVM_1ArrayCopy01_call(JNIEnv *env, jclass jc, jobject src, jint s
 	JVM_ArrayCopy(env, jc, src, src_pos, dest, dest_pos, len);
 }
 
+#define MAX_LONG_ATTRIBUTES 16
+
+JNIEXPORT jint JNICALL
+Java_jtt_jvmni_JMM_1GetLongAttributes01_call(JNIEnv *env, jclass c, jintArray attributes, jlongArray values)
+{
+    JmmInterface *jmm = (JmmInterface *) JVM_GetManagement(JMM_VERSION_1_0);
+    jint atts[MAX_LONG_ATTRIBUTES];
+    jlong result[MAX_LONG_ATTRIBUTES];
+    jint count;
+    jint supported;
+
+    if (jmm == NULL) {
+        return -2;
+    }
+    count = (*env)->GetArrayLength(env, attributes);
+    if (count > MAX_LONG_ATTRIBUTES) {
+        count = MAX_LONG_ATTRIBUTES;
+    }
+    (*env)->GetIntArrayRegion(env, attributes, 0, count, atts);
+    supported = jmm->GetLongAttributes(env, NULL, (jmmLongAttribute *) atts, count, result);
+    (*env)->SetLongArrayRegion(env, values, 0, count, result);
+    return supported;
+}
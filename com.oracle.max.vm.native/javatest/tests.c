@@ -26,6 +26,7 @@
 #include "os.h"
 
 #include <pthread.h>
+#include <stdlib.h>
 #include "jni.h"
 
 JNIEXPORT void JNICALL
@@ -116,3 +117,54 @@ Java_test_output_AttachThread_callHelloWorldOnAttachedThread(JNIEnv *env, jclass
     pthread_create(&thread_id, &attributes, thread_function, arguments);
     pthread_attr_destroy(&attributes);
 }
+
+/*
+ * Native methods for test.bench.threads.JNI_arrays, each of which increments every element of an int array
+ * and returns their sum, using a different JNI array access path.
+ */
+static jlong updateElements(jint *elements, jsize length) {
+    jlong sum = 0;
+    jsize i;
+    for (i = 0; i < length; i++) {
+        sum += ++elements[i];
+    }
+    return sum;
+}
+
+JNIEXPORT jlong JNICALL
+Java_test_bench_threads_JNI_1arrays_elements(JNIEnv *env, jclass c, jintArray array) {
+    jsize length = (*env)->GetArrayLength(env, array);
+    jint *elements = (*env)->GetIntArrayElements(env, array, NULL);
+    if (elements == NULL) {
+        return 0;
+    }
+    jlong sum = updateElements(elements, length);
+    (*env)->ReleaseIntArrayElements(env, array, elements, 0);
+    return sum;
+}
+
+JNIEXPORT jlong JNICALL
+Java_test_bench_threads_JNI_1arrays_region(JNIEnv *env, jclass c, jintArray array) {
+    jsize length = (*env)->GetArrayLength(env, array);
+    jint *elements = (jint *) malloc(length * sizeof(jint));
+    if (elements == NULL) {
+        return 0;
+    }
+    (*env)->GetIntArrayRegion(env, array, 0, length, elements);
+    jlong sum = updateElements(elements, length);
+    (*env)->SetIntArrayRegion(env, array, 0, length, elements);
+    free(elements);
+    return sum;
+}
+
+JNIEXPORT jlong JNICALL
+Java_test_bench_threads_JNI_1arrays_critical(JNIEnv *env, jclass c, jintArray array) {
+    jsize length = (*env)->GetArrayLength(env, array);
+    jint *elements = (jint *) (*env)->GetPrimitiveArrayCritical(env, array, NULL);
+    if (elements == NULL) {
+        return 0;
+    }
+    jlong sum = updateElements(elements, length);
+    (*env)->ReleasePrimitiveArrayCritical(env, array, elements, 0);
+    return sum;
+}
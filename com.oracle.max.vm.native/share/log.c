@@ -25,6 +25,13 @@
 #include <stdio.h>
 #include <string.h>
 #include <dlfcn.h>
+#include <errno.h>
+#if !os_MAXVE
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#endif
 
 #include "log.h"
 #include "jni.h"
@@ -44,6 +51,331 @@ void log_assert(boolean condition, char *conditionString, char *fileName, int li
 
 static mutex_Struct log_mutexStruct;
 
+#if !os_MAXVE
+/*
+ * Buffered logging.
+ *
+ * When enabled, output is formatted into a buffer private to the current thread instead of
+ * going straight to the output stream. A buffer is published as one record when it ends
+ * with a newline or, for output bracketed by log_lock() and log_unlock(), when the outermost
+ * log_unlock() is called. Records are appended to a ring shared by all threads: a producer
+ * reserves space by advancing 'ringReserved' with a compare-and-swap, copies its record in and
+ * then marks the record complete by storing its position in the record's header. A background
+ * writer thread removes complete records in order and writes them with a single writev() per batch.
+ * Records are therefore never interleaved with each other and no thread performs I/O while holding
+ * the log lock. The writer sleeps on a condition variable while the ring holds no complete record and
+ * is woken by the producer that publishes the next one.
+ *
+ * log_lock() still takes a mutex shared by all threads even though buffering alone keeps a bracketed
+ * message together: Log.lock() in Java relies on it for exclusive ownership of the log (see Log.lockOwner()).
+ * As the lock is only held while output is formatted into the thread's own buffer, it is held only briefly.
+ *
+ * log_flush() publishes the current thread's buffer and drains the ring synchronously. It is also
+ * registered with atexit() so that pending output is written when the VM exits or crashes. Paths that
+ * exit because of a fatal error call log_flushOnFatalError() instead, which does not wait indefinitely
+ * for a thread that may have crashed while writing.
+ */
+#define LOG_BUFFER_SIZE 4096
+#define LOG_RING_SIZE (1024 * 1024)
+#define LOG_RECORD_ALIGNMENT 16
+#define LOG_RECORD_MAX (LOG_RING_SIZE / 4)
+#define LOG_IOV_MAX 64
+#define LOG_RING_FULL_RETRIES 1000
+
+typedef struct {
+    /* The position of the record plus one once the record is complete */
+    jlong sequence;
+    jint length;
+    jint unused;
+} LogRecordHeader;
+
+typedef struct {
+    int lockDepth;
+    int length;
+    char data[LOG_BUFFER_SIZE];
+} LogBuffer;
+
+static boolean buffered = false;
+static int fileDescriptor = -1;
+static char ring[LOG_RING_SIZE] __attribute__((aligned(LOG_RECORD_ALIGNMENT)));
+static jlong ringReserved = 0;
+static jlong ringReleased = 0;
+static pthread_mutex_t drainMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t writerMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t writerWakeup = PTHREAD_COND_INITIALIZER;
+/* Set while the writer thread waits (or is about to wait) on 'writerWakeup'. */
+static boolean writerIdle = false;
+static __thread LogBuffer logBuffer;
+
+static jlong recordSize(int length) {
+    return (sizeof(LogRecordHeader) + length + LOG_RECORD_ALIGNMENT - 1) & ~((jlong) LOG_RECORD_ALIGNMENT - 1);
+}
+
+static void writeFully(const char *data, size_t length) {
+    while (length > 0) {
+        ssize_t n = write(fileDescriptor, data, length);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        data += n;
+        length -= n;
+    }
+}
+
+static void writevFully(struct iovec *iov, int count) {
+    while (count > 0) {
+        ssize_t n = writev(fileDescriptor, iov, count);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return;
+        }
+        while (count > 0 && (size_t) n >= iov->iov_len) {
+            n -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = (char *) iov->iov_base + n;
+            iov->iov_len -= n;
+        }
+    }
+}
+
+/**
+ * Writes all complete records at the head of the ring. The caller must hold 'drainMutex'
+ * unless the VM is exiting because of a fatal error (see lockDrain()).
+ */
+static void drainLocked(void) {
+    struct iovec iov[LOG_IOV_MAX];
+    jlong position = ringReleased;
+    while (true) {
+        jlong reserved = __atomic_load_n(&ringReserved, __ATOMIC_ACQUIRE);
+        jlong end = position;
+        int count = 0;
+        while (end < reserved && count <= LOG_IOV_MAX - 2) {
+            LogRecordHeader *header = (LogRecordHeader *) &ring[end & (LOG_RING_SIZE - 1)];
+            if (__atomic_load_n(&header->sequence, __ATOMIC_ACQUIRE) != end + 1) {
+                break;
+            }
+            int length = header->length;
+            int start = (end + sizeof(LogRecordHeader)) & (LOG_RING_SIZE - 1);
+            int first = length < LOG_RING_SIZE - start ? length : LOG_RING_SIZE - start;
+            iov[count].iov_base = &ring[start];
+            iov[count].iov_len = first;
+            count++;
+            if (first < length) {
+                iov[count].iov_base = ring;
+                iov[count].iov_len = length - first;
+                count++;
+            }
+            end += recordSize(length);
+        }
+        if (end == position) {
+            return;
+        }
+        writevFully(iov, count);
+        __atomic_store_n(&ringReleased, end, __ATOMIC_RELEASE);
+        position = end;
+    }
+}
+
+/**
+ * Set once the VM is exiting because of a fatal error, after which the ring may be drained without the drain lock.
+ */
+static volatile boolean fatalError = false;
+
+/**
+ * Acquires the drain lock before the current thread writes output. Normally this waits for the lock. When the VM
+ * is exiting because of a fatal error, the thread that holds it may have crashed, so it is only waited on for a
+ * bounded time after which output is written without it. Output may then be duplicated or garbled, which is
+ * preferable to losing it or hanging in a dying VM.
+ *
+ * @return true if the lock was acquired and must be released with pthread_mutex_unlock()
+ */
+static boolean lockDrain(void) {
+    if (!fatalError) {
+        pthread_mutex_lock(&drainMutex);
+        return true;
+    }
+    int attempts = 0;
+    while (attempts++ < LOG_RING_FULL_RETRIES) {
+        if (pthread_mutex_trylock(&drainMutex) == 0) {
+            return true;
+        }
+        sched_yield();
+    }
+    return false;
+}
+
+static void drainSynchronously(void) {
+    boolean locked = lockDrain();
+    drainLocked();
+    if (locked) {
+        pthread_mutex_unlock(&drainMutex);
+    }
+}
+
+/**
+ * Appends a record to the ring.
+ *
+ * @return false if the ring stayed full for LOG_RING_FULL_RETRIES attempts
+ */
+static boolean ringPublish(const char *data, int length) {
+    jlong size = recordSize(length);
+    jlong position;
+    int attempts = 0;
+    while (true) {
+        position = __atomic_load_n(&ringReserved, __ATOMIC_RELAXED);
+        if (position + size - __atomic_load_n(&ringReleased, __ATOMIC_ACQUIRE) > LOG_RING_SIZE) {
+            if (++attempts > LOG_RING_FULL_RETRIES) {
+                return false;
+            }
+            sched_yield();
+            continue;
+        }
+        if (__sync_bool_compare_and_swap(&ringReserved, position, position + size)) {
+            break;
+        }
+    }
+    LogRecordHeader *header = (LogRecordHeader *) &ring[position & (LOG_RING_SIZE - 1)];
+    int start = (position + sizeof(LogRecordHeader)) & (LOG_RING_SIZE - 1);
+    int first = length < LOG_RING_SIZE - start ? length : LOG_RING_SIZE - start;
+    header->length = length;
+    memcpy(&ring[start], data, first);
+    if (first < length) {
+        memcpy(ring, data + first, length - first);
+    }
+    /* Sequentially consistent with respect to the writer setting and then testing 'writerIdle' (see logWriter()) */
+    __atomic_store_n(&header->sequence, position + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&writerIdle, __ATOMIC_SEQ_CST)) {
+        pthread_mutex_lock(&writerMutex);
+        pthread_cond_signal(&writerWakeup);
+        pthread_mutex_unlock(&writerMutex);
+    }
+    return true;
+}
+
+static void publish(const char *data, int length) {
+    if (length == 0) {
+        return;
+    }
+    if (length > LOG_RECORD_MAX || !ringPublish(data, length)) {
+        /* Write directly, after the records already in the ring */
+        boolean locked = lockDrain();
+        drainLocked();
+        writeFully(data, length);
+        if (locked) {
+            pthread_mutex_unlock(&drainMutex);
+        }
+    }
+}
+
+static void flushBuffer(LogBuffer *buffer) {
+    publish(buffer->data, buffer->length);
+    buffer->length = 0;
+}
+
+static void bufferFormat(const char *format, va_list ap) {
+    LogBuffer *buffer = &logBuffer;
+    va_list copy;
+    va_copy(copy, ap);
+    int available = LOG_BUFFER_SIZE - buffer->length;
+    int n = vsnprintf(buffer->data + buffer->length, available, format, ap);
+    if (n >= available) {
+        /* The output did not fit: publish what precedes it and format it again */
+        flushBuffer(buffer);
+        if (n < LOG_BUFFER_SIZE) {
+            vsnprintf(buffer->data, LOG_BUFFER_SIZE, format, copy);
+            buffer->length = n;
+        } else {
+            char *large = (char *) malloc(n + 1);
+            if (large != NULL) {
+                vsnprintf(large, n + 1, format, copy);
+                publish(large, n);
+                free(large);
+            }
+        }
+    } else if (n > 0) {
+        buffer->length += n;
+    }
+    va_end(copy);
+    if (buffer->lockDepth == 0 && buffer->length > 0 && buffer->data[buffer->length - 1] == '\n') {
+        flushBuffer(buffer);
+    }
+}
+
+/**
+ * Determines if the record at the head of the ring is complete and can be written.
+ */
+static boolean ringHeadComplete(void) {
+    jlong position = __atomic_load_n(&ringReleased, __ATOMIC_ACQUIRE);
+    if (position == __atomic_load_n(&ringReserved, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    LogRecordHeader *header = (LogRecordHeader *) &ring[position & (LOG_RING_SIZE - 1)];
+    return __atomic_load_n(&header->sequence, __ATOMIC_SEQ_CST) == position + 1;
+}
+
+static void *logWriter(void *arg) {
+    while (true) {
+        pthread_mutex_lock(&drainMutex);
+        drainLocked();
+        pthread_mutex_unlock(&drainMutex);
+
+        /* Either the producer completing the head record sees 'writerIdle' set and signals,
+         * or the writer sees the record complete and does not wait. */
+        pthread_mutex_lock(&writerMutex);
+        __atomic_store_n(&writerIdle, true, __ATOMIC_SEQ_CST);
+        if (!ringHeadComplete()) {
+            pthread_cond_wait(&writerWakeup, &writerMutex);
+        }
+        __atomic_store_n(&writerIdle, false, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&writerMutex);
+    }
+    return NULL;
+}
+
+void log_threadTerminated(void) {
+    if (buffered) {
+        flushBuffer(&logBuffer);
+    }
+}
+
+static void drainAtExit(void) {
+    log_flush();
+}
+
+void log_enableBuffering(void) {
+    pthread_t writer;
+    pthread_attr_t attributes;
+    if (buffered || fileStream == NULL) {
+        return;
+    }
+    fflush(fileStream);
+    fileDescriptor = fileno(fileStream);
+    pthread_attr_init(&attributes);
+    pthread_attr_setdetachstate(&attributes, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&writer, &attributes, logWriter, NULL) != 0) {
+        pthread_attr_destroy(&attributes);
+        return;
+    }
+    pthread_attr_destroy(&attributes);
+    atexit(drainAtExit);
+    buffered = true;
+}
+#else
+void log_enableBuffering(void) {
+}
+
+void log_threadTerminated(void) {
+}
+#endif
+
 void log_initialize(const char *path) {
     mutex_initialize(&log_mutexStruct);
 #if !os_MAXVE
@@ -73,10 +405,18 @@ void log_lock(void) {
 	if ((result = mutex_enter_nolog(&log_mutexStruct)) != 0) {
 	    log_exit(-1, "Thread %p could not lock mutex %p: %s", thread_self(), &log_mutexStruct, strerror(result));
 	}
+#if !os_MAXVE
+	logBuffer.lockDepth++;
+#endif
 }
 
 void log_unlock(void) {
     int result;
+#if !os_MAXVE
+    if (--logBuffer.lockDepth == 0 && buffered) {
+        flushBuffer(&logBuffer);
+    }
+#endif
 	if ((result = mutex_exit_nolog(&log_mutexStruct)) != 0) {
         log_exit(-1, "Thread %p could not unlock mutex %p: %s", thread_self(), &log_mutexStruct, strerror(result));
 	}
@@ -85,24 +425,35 @@ void log_unlock(void) {
 void log_print_format(const char *format, ...) {
     va_list ap;
     va_start(ap, format);
-#if !os_MAXVE
-    FILE* out = fileStream == NULL ? stdout : fileStream;
-    vfprintf(out, format, ap);
-#else
-    vprintf(format, ap);
-#endif
+    log_print_vformat(format, ap);
     va_end(ap);
 }
 
 void log_flush() {
 #if !os_MAXVE
+    if (buffered) {
+        flushBuffer(&logBuffer);
+        drainSynchronously();
+        return;
+    }
     FILE* out = fileStream == NULL ? stdout : fileStream;
     fflush(out);
 #endif
 }
 
+void log_flushOnFatalError() {
+#if !os_MAXVE
+    fatalError = true;
+#endif
+    log_flush();
+}
+
 void log_print_vformat(const char *format, va_list ap) {
 #if !os_MAXVE
+    if (buffered) {
+        bufferFormat(format, ap);
+        return;
+    }
     FILE* out = fileStream == NULL ? stdout : fileStream;
     vfprintf(out, format, ap);
 #else
@@ -37,6 +37,19 @@
  */
 extern void log_initialize(const char *path);
 
+/**
+ * Switches the logging facility to buffered mode, in which each thread formats its output into a
+ * private buffer that is published as a whole record and written by a background thread.
+ * Output of a thread is published when it ends with a newline, at the outermost log_unlock()
+ * and by log_flush(). This must be called before any other thread uses the logging facility.
+ */
+extern void log_enableBuffering(void);
+
+/**
+ * Publishes the output buffered by the current thread. Called when a thread terminates.
+ */
+extern void log_threadTerminated(void);
+
 extern void log_lock(void);
 extern void log_unlock(void);
 
@@ -55,6 +68,12 @@ extern void log_print_float(float f);
 extern void log_print_double(double d);
 extern void log_flush(void);
 
+/**
+ * Flushes the log output when the VM is exiting because of a fatal error. From then on, draining the
+ * buffered output waits only a bounded time for another thread that is writing it, as that thread may have crashed.
+ */
+extern void log_flushOnFatalError(void);
+
 #if os_WINDOWS
 #define NEWLINE_STRING "\r\n"
 #else
@@ -69,6 +88,7 @@ extern void log_flush(void);
 #define log_exit(code, ...) do {\
     log_print_format(__VA_ARGS__); \
     log_print_format(NEWLINE_STRING); \
+    log_flushOnFatalError(); \
     exit(code); \
 } while(0)
 
@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+#include "os.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "log.h"
+#include "memory.h"
+#include "nativeMemory.h"
+
+/*
+ * The counters are signed so that an unbalanced release shows up as a negative value in a
+ * product build rather than wrapping around. Debug builds assert that this never happens.
+ */
+typedef struct Counters {
+    volatile jlong reserved;
+    volatile jlong committed;
+    volatile jlong count;
+    volatile jlong peakCommitted;
+    volatile jlong total;
+    char pad[64 - 5 * sizeof(jlong)];
+} Counters;
+
+typedef struct Snapshot {
+    jlong reserved;
+    jlong committed;
+    jlong count;
+} Snapshot;
+
+static Counters categories[NATIVE_MEMORY_CATEGORIES];
+static Counters mallocTags[MEMORY_TAG_COUNT];
+
+static Snapshot categoriesBaseline[NATIVE_MEMORY_CATEGORIES];
+static Snapshot mallocTagsBaseline[MEMORY_TAG_COUNT];
+
+static const char *categoryNames[NATIVE_MEMORY_CATEGORIES] = {
+    "Heap", "Stack", "Code", "Data", "Malloc", "Thread stacks", "Thread locals", "Mapped files"
+};
+
+static const char *mallocTagNames[MEMORY_TAG_COUNT] = {
+    "Unknown", "JNI", "String", "Monitor", "IO", "Unsafe", "Log", "GC", "VM", "Test"
+};
+
+static void add(volatile jlong *counter, jlong delta) {
+    __sync_add_and_fetch(counter, delta);
+}
+
+static void subtract(volatile jlong *counter, jlong delta) {
+    jlong value = __sync_sub_and_fetch(counter, delta);
+    c_ASSERT(value >= 0);
+}
+
+static void addCommitted(Counters *counters, jlong delta) {
+    jlong committed = __sync_add_and_fetch(&counters->committed, delta);
+    jlong peak = counters->peakCommitted;
+    while (committed > peak && !__sync_bool_compare_and_swap(&counters->peakCommitted, peak, committed)) {
+        peak = counters->peakCommitted;
+    }
+}
+
+static Counters *category(int c) {
+    c_ASSERT(c >= 0 && c < NATIVE_MEMORY_CATEGORIES);
+    return &categories[c];
+}
+
+void nativeMemory_reserve(int c, Size size, jboolean committed) {
+    Counters *counters = category(c);
+    add(&counters->reserved, (jlong) size);
+    add(&counters->count, 1);
+    add(&counters->total, 1);
+    if (committed) {
+        addCommitted(counters, (jlong) size);
+    }
+}
+
+void nativeMemory_release(int c, Size size, Size committed) {
+    Counters *counters = category(c);
+    subtract(&counters->reserved, (jlong) size);
+    subtract(&counters->committed, (jlong) committed);
+}
+
+void nativeMemory_commit(int c, Size size) {
+    addCommitted(category(c), (jlong) size);
+}
+
+void nativeMemory_uncommit(int c, Size size) {
+    subtract(&category(c)->committed, (jlong) size);
+}
+
+void nativeMemory_recordMalloc(int tag, Size size) {
+    Counters *counters = &mallocTags[tag];
+    add(&counters->count, 1);
+    add(&counters->total, 1);
+    addCommitted(counters, (jlong) size);
+}
+
+void nativeMemory_recordFree(int tag, Size size) {
+    Counters *counters = &mallocTags[tag];
+    subtract(&counters->count, 1);
+    subtract(&counters->committed, (jlong) size);
+}
+
+void nativeMemory_recordRealloc(int tag, Size oldSize, Size newSize) {
+    addCommitted(&mallocTags[tag], (jlong) newSize - (jlong) oldSize);
+}
+
+Size nativeMemory_mallocBytes(int tag) {
+    if (tag < 0 || tag >= MEMORY_TAG_COUNT) {
+        return 0;
+    }
+    return (Size) mallocTags[tag].committed;
+}
+
+Size nativeMemory_totalCommitted(void) {
+    jlong total = 0;
+    int i;
+    for (i = 0; i < NATIVE_MEMORY_CATEGORIES; i++) {
+        total += categories[i].committed;
+    }
+    return (Size) total;
+}
+
+static void snapshot(Counters *counters, Snapshot *snapshot) {
+    snapshot->reserved = counters->reserved;
+    snapshot->committed = counters->committed;
+    snapshot->count = counters->count;
+}
+
+void nativeMemory_baseline(void) {
+    int i;
+    for (i = 0; i < NATIVE_MEMORY_CATEGORIES; i++) {
+        snapshot(&categories[i], &categoriesBaseline[i]);
+    }
+    for (i = 0; i < MEMORY_TAG_COUNT; i++) {
+        snapshot(&mallocTags[i], &mallocTagsBaseline[i]);
+    }
+}
+
+#define KB(bytes) ((long) ((bytes) / 1024))
+
+/*
+ * Gets the resident set size of the process, for comparison with the tracked memory.
+ */
+static jlong residentSetSize(void) {
+#if os_LINUX
+    char line[256];
+    jlong result = -1;
+    FILE *file = fopen("/proc/self/status", "r");
+    if (file == NULL) {
+        return -1;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strncmp(line, "VmRSS:", 6) == 0) {
+            result = (jlong) strtoll(line + 6, NULL, 10) * 1024;
+            break;
+        }
+    }
+    fclose(file);
+    return result;
+#else
+    return -1;
+#endif
+}
+
+static void printTotals(void) {
+    jlong reserved = 0;
+    int i;
+    for (i = 0; i < NATIVE_MEMORY_CATEGORIES; i++) {
+        reserved += categories[i].reserved;
+    }
+    log_println("  Total: reserved=%ldKB, committed=%ldKB", KB(reserved), KB((jlong) nativeMemory_totalCommitted()));
+    jlong rss = residentSetSize();
+    if (rss >= 0) {
+        log_println("  Process resident set: %ldKB", KB(rss));
+    }
+}
+
+void nativeMemory_printSummary(void) {
+    int i;
+    log_lock();
+    log_println("Native Memory Tracking:");
+    for (i = 0; i < NATIVE_MEMORY_CATEGORIES; i++) {
+        Counters *c = &categories[i];
+        log_println("  %-14s reserved=%ldKB, committed=%ldKB, peak committed=%ldKB, reservations=%ld",
+                        categoryNames[i], KB(c->reserved), KB(c->committed), KB(c->peakCommitted), (long) c->count);
+    }
+    log_println("  Malloc by tag:");
+    for (i = 0; i < MEMORY_TAG_COUNT; i++) {
+        Counters *c = &mallocTags[i];
+        log_println("    %-12s allocated=%ldKB in %ld blocks, peak=%ldKB, allocations=%ld",
+                        mallocTagNames[i], KB(c->committed), (long) c->count, KB(c->peakCommitted), (long) c->total);
+    }
+    printTotals();
+    log_unlock();
+}
+
+void nativeMemory_printDiff(void) {
+    int i;
+    log_lock();
+    log_println("Native Memory Tracking (change since baseline):");
+    for (i = 0; i < NATIVE_MEMORY_CATEGORIES; i++) {
+        Counters *c = &categories[i];
+        Snapshot *b = &categoriesBaseline[i];
+        log_println("  %-14s reserved=%ldKB %+ldKB, committed=%ldKB %+ldKB, reservations=%ld %+ld",
+                        categoryNames[i], KB(c->reserved), KB(c->reserved - b->reserved),
+                        KB(c->committed), KB(c->committed - b->committed), (long) c->count, (long) (c->count - b->count));
+    }
+    log_println("  Malloc by tag:");
+    for (i = 0; i < MEMORY_TAG_COUNT; i++) {
+        Counters *c = &mallocTags[i];
+        Snapshot *b = &mallocTagsBaseline[i];
+        log_println("    %-12s allocated=%ldKB %+ldKB, blocks=%ld %+ld",
+                        mallocTagNames[i], KB(c->committed), KB(c->committed - b->committed), (long) c->count, (long) (c->count - b->count));
+    }
+    printTotals();
+    log_unlock();
+}
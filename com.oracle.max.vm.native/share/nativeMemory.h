@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+/**
+ * Native memory tracking: cheap, always-on accounting of the memory the VM obtains from the OS,
+ * so that the resident set of the process can be attributed to VM subsystems.
+ *
+ * Virtual memory is recorded as reserved under the type it is given. virtualMemory.c follows the committed
+ * parts of it by address, so that memory committed twice is counted once and uncommitted memory is taken
+ * away from the type it was committed as. Thread stacks and thread locals blocks are recorded by threadLocals.c.
+ * The arena chunks and large blocks of the native allocator (memory.c) are recorded as MALLOC_VM and the
+ * live bytes it hands out are additionally broken down by their MEMORY_TAG_*. The counters are updated
+ * atomically; recording itself allocates nothing and takes no lock.
+ */
+#ifndef __nativeMemory_h__
+#define __nativeMemory_h__ 1
+
+#include "word.h"
+#include "jni.h"
+#include "virtualMemory.h"
+
+/* Categories 0 to 4 are the virtual memory types (HEAP_VM, STACK_VM, CODE_VM, DATA_VM and MALLOC_VM). */
+#define NATIVE_MEMORY_THREAD_STACKS 5
+#define NATIVE_MEMORY_THREAD_LOCALS 6
+#define NATIVE_MEMORY_MAPPED_FILES 7
+#define NATIVE_MEMORY_CATEGORIES 8
+
+/**
+ * Records a reservation of virtual space. If {@code committed} is true, the space is also committed.
+ */
+extern void nativeMemory_reserve(int category, Size size, jboolean committed);
+
+/**
+ * Records the release of virtual space. As space can be released piecemeal, this does not change the number
+ * of reservations recorded for the category.
+ *
+ * @param size the size of the released space, which must have been reserved under {@code category}
+ * @param committed the number of bytes of the released space that were recorded as committed and have not been uncommitted
+ */
+extern void nativeMemory_release(int category, Size size, Size committed);
+
+extern void nativeMemory_commit(int category, Size size);
+extern void nativeMemory_uncommit(int category, Size size);
+
+extern void nativeMemory_recordMalloc(int tag, Size size);
+extern void nativeMemory_recordFree(int tag, Size size);
+extern void nativeMemory_recordRealloc(int tag, Size oldSize, Size newSize);
+
+/**
+ * Gets the number of bytes currently allocated by memory_allocate and accounted to a given tag.
+ */
+extern Size nativeMemory_mallocBytes(int tag);
+
+/**
+ * Gets the number of bytes currently committed in all categories.
+ */
+extern Size nativeMemory_totalCommitted(void);
+
+/**
+ * Records the current state as the baseline for nativeMemory_printDiff().
+ */
+extern void nativeMemory_baseline(void);
+
+/**
+ * Prints the reserved and committed memory of every category to the log.
+ */
+extern void nativeMemory_printSummary(void);
+
+/**
+ * Prints the change of every category since the last call to nativeMemory_baseline().
+ */
+extern void nativeMemory_printDiff(void);
+
+#endif /*__nativeMemory_h__*/
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "c.h"
+#include "log.h"
+#include "resources.h"
+
+#if os_SOLARIS
+#   include <sys/types.h>
+#   include <sys/pset.h>
+#elif os_MAXVE
+#   include <maxve.h>
+#elif os_LINUX
+#   include <sched.h>
+#endif
+
+static jint activeProcessorCountOverride = 0;
+
+void resources_setActiveProcessorCount(jint count) {
+    activeProcessorCountOverride = count;
+}
+
+#if os_LINUX
+
+#define CGROUP_ROOT "/sys/fs/cgroup"
+
+/*
+ * Gets the path of this process's cgroup in the hierarchy with the given controller, relative to
+ * the hierarchy's mount point. For cgroup v2, whose single hierarchy line is "0::/path", the controller is NULL.
+ * If the process is in a cgroup namespace (as in most containers) this path is "/".
+ */
+static boolean getCgroupPath(const char *controller, char *result, size_t resultLength) {
+    char line[MAX_PATH_LENGTH];
+    boolean found = false;
+    FILE *file = fopen("/proc/self/cgroup", "r");
+    if (file == NULL) {
+        return false;
+    }
+    while (!found && fgets(line, sizeof(line), file) != NULL) {
+        /* Each line is "hierarchy-ID:controller-list:path" */
+        char *controllers = strchr(line, ':');
+        char *path = controllers == NULL ? NULL : strchr(controllers + 1, ':');
+        if (path == NULL) {
+            continue;
+        }
+        *path++ = '\0';
+        controllers++;
+        path[strcspn(path, "\n")] = '\0';
+        if (controller == NULL) {
+            found = *controllers == '\0';
+        } else {
+            char *c;
+            for (c = strtok(controllers, ","); c != NULL && !found; c = strtok(NULL, ",")) {
+                found = strcmp(c, controller) == 0;
+            }
+        }
+        if (found) {
+            strncpy(result, path, resultLength - 1);
+            result[resultLength - 1] = '\0';
+        }
+    }
+    fclose(file);
+    return found;
+}
+
+/*
+ * Reads the first line of a cgroup control file, first in this process's own cgroup and then,
+ * for when the cgroup path is not visible (e.g. a container without a cgroup namespace), at the hierarchy root.
+ */
+static boolean readCgroupFile(const char *hierarchy, const char *controller, const char *name, char *result, size_t resultLength) {
+    char cgroupPath[MAX_PATH_LENGTH];
+    char path[MAX_PATH_LENGTH * 2];
+    FILE *file = NULL;
+    if (getCgroupPath(controller, cgroupPath, sizeof(cgroupPath))) {
+        snprintf(path, sizeof(path), "%s%s%s/%s", CGROUP_ROOT, hierarchy, strcmp(cgroupPath, "/") == 0 ? "" : cgroupPath, name);
+        file = fopen(path, "r");
+    }
+    if (file == NULL) {
+        snprintf(path, sizeof(path), "%s%s/%s", CGROUP_ROOT, hierarchy, name);
+        file = fopen(path, "r");
+        if (file == NULL) {
+            return false;
+        }
+    }
+    boolean ok = fgets(result, resultLength, file) != NULL;
+    fclose(file);
+    return ok;
+}
+
+static boolean isCgroupV2(void) {
+    return access(CGROUP_ROOT "/cgroup.controllers", F_OK) == 0;
+}
+
+/*
+ * Gets the cgroup CPU quota rounded up to whole processors, or 0 if there is no quota.
+ */
+static jint getCgroupCpuQuota(void) {
+    char buffer[128];
+    long long quota = -1;
+    long long period = 0;
+    if (isCgroupV2()) {
+        /* "max 100000" or "<quota> <period>" */
+        if (readCgroupFile("", NULL, "cpu.max", buffer, sizeof(buffer)) && strncmp(buffer, "max", 3) != 0) {
+            sscanf(buffer, "%lld %lld", &quota, &period);
+        }
+    } else if (readCgroupFile("/cpu", "cpu", "cpu.cfs_quota_us", buffer, sizeof(buffer))) {
+        quota = strtoll(buffer, NULL, 10);
+        if (readCgroupFile("/cpu", "cpu", "cpu.cfs_period_us", buffer, sizeof(buffer))) {
+            period = strtoll(buffer, NULL, 10);
+        }
+    }
+    if (quota <= 0 || period <= 0) {
+        return 0;
+    }
+    return (jint) ((quota + period - 1) / period);
+}
+
+/*
+ * Gets the number of processors in this process's affinity mask, or 0 if it cannot be determined.
+ * The kernel already restricts the affinity mask to the processors of the cgroup's cpuset.
+ */
+static jint getAffinityProcessorCount(jint onlineProcessors) {
+    int n;
+    /* The mask must be large enough for all configured processors, which may exceed CPU_SETSIZE. */
+    for (n = onlineProcessors > CPU_SETSIZE ? onlineProcessors : CPU_SETSIZE; n <= 64 * 1024; n *= 2) {
+        cpu_set_t *mask = CPU_ALLOC(n);
+        size_t size = CPU_ALLOC_SIZE(n);
+        if (mask == NULL) {
+            return 0;
+        }
+        CPU_ZERO_S(size, mask);
+        if (sched_getaffinity(0, size, mask) == 0) {
+            jint count = CPU_COUNT_S(size, mask);
+            CPU_FREE(mask);
+            return count;
+        }
+        CPU_FREE(mask);
+    }
+    return 0;
+}
+
+static jint cpuQuota = -1;
+
+jint resources_getActiveProcessorCount(void) {
+    if (activeProcessorCountOverride > 0) {
+        return activeProcessorCountOverride;
+    }
+    jint result = (jint) sysconf(_SC_NPROCESSORS_ONLN);
+    c_ASSERT(result > 0);
+    /* The affinity mask can change at any time, so it is queried on every call. */
+    jint affinity = getAffinityProcessorCount(result);
+    if (affinity > 0 && affinity < result) {
+        result = affinity;
+    }
+    /* Cgroup limits are assumed to be fixed for the lifetime of the process and only read once. */
+    if (cpuQuota < 0) {
+        cpuQuota = getCgroupCpuQuota();
+    }
+    if (cpuQuota > 0 && cpuQuota < result) {
+        result = cpuQuota;
+    }
+    return result;
+}
+
+static Size memoryLimit = (Size) -1;
+
+Size resources_getMemoryLimit(void) {
+    if (memoryLimit == (Size) -1) {
+        char buffer[128];
+        Size limit = 0;
+        if (isCgroupV2()) {
+            if (readCgroupFile("", NULL, "memory.max", buffer, sizeof(buffer)) && strncmp(buffer, "max", 3) != 0) {
+                limit = (Size) strtoull(buffer, NULL, 10);
+            }
+        } else if (readCgroupFile("/memory", "memory", "memory.limit_in_bytes", buffer, sizeof(buffer))) {
+            limit = (Size) strtoull(buffer, NULL, 10);
+            /* An unlimited v1 cgroup reports a huge page-rounded value rather than a marker. */
+            Size physicalMemory = (Size) sysconf(_SC_PHYS_PAGES) * (Size) sysconf(_SC_PAGESIZE);
+            if (limit >= physicalMemory) {
+                limit = 0;
+            }
+        }
+        memoryLimit = limit;
+    }
+    return memoryLimit;
+}
+
+#else
+
+jint resources_getActiveProcessorCount(void) {
+    if (activeProcessorCountOverride > 0) {
+        return activeProcessorCountOverride;
+    }
+#if os_SOLARIS
+    int online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    pid_t pid = getpid();
+    psetid_t pset = PS_NONE;
+    // Are we running in a processor set or is there any processor set around?
+    if (pset_bind(PS_QUERY, P_PID, pid, &pset) == 0 && pset != PS_NONE) {
+        uint_t pset_cpus;
+        // Query the number of cpus available to us.
+        if (pset_info(pset, NULL, &pset_cpus, NULL) == 0) {
+            c_ASSERT(pset_cpus > 0 && pset_cpus <= online_cpus);
+            return pset_cpus;
+        }
+    }
+    // Otherwise return number of online cpus
+    return online_cpus;
+#elif os_DARWIN
+    int online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    c_ASSERT(online_cpus > 0);
+    return online_cpus;
+#elif os_MAXVE
+    return maxve_numProcessors();
+#else
+    c_UNIMPLEMENTED();
+    return 0;
+#endif
+}
+
+Size resources_getMemoryLimit(void) {
+    return 0;
+}
+
+#endif
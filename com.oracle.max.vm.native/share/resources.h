@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+/**
+ * Queries of the processor and memory resources actually available to the VM process,
+ * as opposed to those of the whole machine. On Linux, these honour the CPU affinity mask
+ * and the limits of the cgroup (v1 or v2) the process runs in, e.g. in a container.
+ */
+#ifndef __resources_h__
+#define __resources_h__ 1
+
+#include "word.h"
+#include "jni.h"
+
+/**
+ * Overrides the number of processors reported by resources_getActiveProcessorCount().
+ *
+ * @param count the number of processors to report, or 0 to compute it from the environment
+ */
+extern void resources_setActiveProcessorCount(jint count);
+
+/**
+ * Gets the number of processors this process can actually use. This is the least of the number of
+ * online processors, the number of processors in the affinity mask (which reflects any cpuset) and
+ * the cgroup CPU quota rounded up to whole processors.
+ */
+extern jint resources_getActiveProcessorCount(void);
+
+/**
+ * Gets the memory limit imposed on this process by its cgroup.
+ *
+ * @return the limit in bytes or 0 if there is none
+ */
+extern Size resources_getMemoryLimit(void);
+
+#endif /*__resources_h__*/
@@ -28,10 +28,12 @@
 #include "jni.h"
 #include "word.h"
 #include "image.h"
+#include "memory.h"
 
 #include "threads.h"
 #include "threadLocals.h"
 #include "virtualMemory.h"
+#include "nativeMemory.h"
 #include "mutex.h"
 
 #if (os_DARWIN || os_LINUX)
@@ -60,12 +62,17 @@ int theTLASize = -1;
 static ThreadLocalsKey theThreadLocalsKey;
 
 static Address allocateThreadLocalBlock(size_t tlBlockSize) {
+    Address tlBlock;
 #if os_MAXVE
-	return (Address) maxve_virtualMemory_allocate(tlBlockSize, DATA_VM);
+	tlBlock = (Address) maxve_virtualMemory_allocate(tlBlockSize, DATA_VM);
 #else
 	c_ASSERT(tlBlockSize < 100000000);
-	return (Address) valloc(tlBlockSize);
+	tlBlock = (Address) valloc(tlBlockSize);
 #endif
+    if (tlBlock != 0) {
+        nativeMemory_reserve(NATIVE_MEMORY_THREAD_LOCALS, tlBlockSize, JNI_TRUE);
+    }
+    return tlBlock;
 }
 
 static void deallocateThreadLocalBlock(Address tlBlock, Size tlBlockSize) {
@@ -74,6 +81,7 @@ static void deallocateThreadLocalBlock(Address tlBlock, Size tlBlockSize) {
 #else
 	free ((void *) tlBlock);
 #endif
+    nativeMemory_release(NATIVE_MEMORY_THREAD_LOCALS, tlBlockSize, tlBlockSize);
 }
 
 /**
@@ -167,6 +175,9 @@ Address threadLocalsBlock_create(jint id, Address tlBlock, Size stackSize) {
     ntl->tlBlock = tlBlock;
     ntl->tlBlockSize = tlBlockSize;
 
+    /* The thread library commits the stack lazily, so only its reservation is recorded. */
+    nativeMemory_reserve(NATIVE_MEMORY_THREAD_STACKS, stackSize, JNI_FALSE);
+
     Address startGuardZone;
     int guardZonePages;
     if (!attaching || haveRedZone) {
@@ -334,11 +345,20 @@ void threadLocalsBlock_destroy(Address tlBlock) {
     threadLocalsBlock_setCurrent(0);
 
     /* Release the memory of the TL block. */
+    nativeMemory_release(NATIVE_MEMORY_THREAD_STACKS, ntl->stackSize, 0);
     deallocateThreadLocalBlock(tlBlock, ntl->tlBlockSize);
 
+#if !TELE
+    /* Return the native memory blocks cached by this thread to the shared arenas. */
+    memory_threadTerminated();
+#endif
+
 #if log_THREADS
     log_println("threadLocalsBlock_destroy: END t=%p", nativeThread);
 #endif
+
+    /* Publish any buffered log output of this thread that was not terminated by a newline. */
+    log_threadTerminated();
 }
 
 void tla_initialize(int tlaSize) {
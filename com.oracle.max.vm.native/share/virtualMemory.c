@@ -22,6 +22,8 @@
  */
 #include "virtualMemory.h"
 #include "log.h"
+#include "resources.h"
+#include "nativeMemory.h"
 
 #if defined(MAXVE)
 #include <maxve.h>
@@ -30,7 +32,9 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <string.h>
+#include <sched.h>
 #include <sys/mman.h>
+#include <fcntl.h>
 
 #include "jni.h"
 #include "unistd.h"
@@ -68,18 +72,387 @@ static Address check_mmap_result(void *result) {
     return ((Address) (result == (void *) MAP_FAILED ? ALLOC_FAILED : result));
 }
 
+#if os_LINUX
+#   ifndef MAP_HUGETLB
+#       define MAP_HUGETLB      0x40000
+#   endif
+#   ifndef MAP_HUGE_SHIFT
+#       define MAP_HUGE_SHIFT   26
+#   endif
+#   ifndef MADV_HUGEPAGE
+#       define MADV_HUGEPAGE    14
+#   endif
+#endif
+
+/*
+ * Large page support. The mode and page size are fixed once by virtualMemory_initializeLargePages()
+ * before the boot image is mapped. Only HEAP_VM and CODE_VM memory is backed by large pages.
+ */
+static int largePageMode = LARGE_PAGES_NONE;
+static Size largePageSize = 0;
+
+/*
+ * The committed parts of anonymous memory, kept as a sorted array of disjoint ranges. Recording them by
+ * address means that committing memory twice counts it once, and that uncommitting or releasing a range takes
+ * away exactly what was committed in it and no more, under the type and with the backing it was committed with.
+ * Both native memory tracking and the large page statistics are updated from here. Adjacent ranges of the same
+ * type and backing are merged, so a heap that grows and shrinks at one end needs only a few entries.
+ * The array is allocated directly with mmap and is only accessed with committedRangesLock held.
+ */
+typedef struct CommittedRange {
+    Address start;
+    Address end;
+    int type;
+    jboolean large;
+} CommittedRange;
+
+static CommittedRange *committedRanges = NULL;
+static int committedRangesLength = 0;
+static int committedRangesCapacity = 0;
+static volatile int committedRangesLock = 0;
+
+/* Number of committed bytes of heap and code memory backed with, respectively without, large pages. */
+static volatile Size largePageBytes = 0;
+static volatile Size smallPageBytes = 0;
+
+static jboolean usesLargePages(int type) {
+    return largePageMode != LARGE_PAGES_NONE && (type == HEAP_VM || type == CODE_VM);
+}
+
+static jboolean isLargePageAligned(Address address, Size size) {
+    return ((address | size) & (largePageSize - 1)) == 0;
+}
+
+static void lockCommittedRanges(void) {
+    while (__sync_lock_test_and_set(&committedRangesLock, 1)) {
+        while (committedRangesLock) {
+            sched_yield();
+        }
+    }
+}
+
+static void unlockCommittedRanges(void) {
+    __sync_lock_release(&committedRangesLock);
+}
+
+static void countCommitted(Size size, int type, jboolean large, jboolean add) {
+    if (add) {
+        nativeMemory_commit(type, size);
+    } else {
+        nativeMemory_uncommit(type, size);
+    }
+    if (type == HEAP_VM || type == CODE_VM) {
+        volatile Size *counter = large ? &largePageBytes : &smallPageBytes;
+        *counter = add ? *counter + size : *counter - size;
+    }
+}
+
+static jboolean ensureCommittedRangesCapacity(int length) {
+    if (length <= committedRangesCapacity) {
+        return JNI_TRUE;
+    }
+    int capacity = committedRangesCapacity == 0 ? 256 : committedRangesCapacity * 2;
+    void *array = mmap(0, capacity * sizeof(CommittedRange), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (array == MAP_FAILED) {
+        return JNI_FALSE;
+    }
+    if (committedRanges != NULL) {
+        memcpy(array, committedRanges, committedRangesLength * sizeof(CommittedRange));
+        munmap(committedRanges, committedRangesCapacity * sizeof(CommittedRange));
+    }
+    committedRanges = (CommittedRange *) array;
+    committedRangesCapacity = capacity;
+    return JNI_TRUE;
+}
+
+/*
+ * Gets the index of the first range that ends after a given address.
+ */
+static int findCommittedRange(Address address) {
+    int low = 0;
+    int high = committedRangesLength;
+    while (low < high) {
+        int mid = (low + high) >> 1;
+        if (committedRanges[mid].end <= address) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/*
+ * Removes [start, end) from the committed ranges, returning the number of bytes that were committed in it.
+ */
+static Size removeCommitted(Address start, Address end) {
+    Size removed = 0;
+    int i = findCommittedRange(start);
+    while (i < committedRangesLength && committedRanges[i].start < end) {
+        CommittedRange *range = &committedRanges[i];
+        Address overlapStart = range->start > start ? range->start : start;
+        Address overlapEnd = range->end < end ? range->end : end;
+        removed += overlapEnd - overlapStart;
+        countCommitted(overlapEnd - overlapStart, range->type, range->large, JNI_FALSE);
+        if (range->start < start && range->end > end) {
+            /* Split the range in two. If there is no room for the upper part, it is no longer counted. */
+            if (ensureCommittedRangesCapacity(committedRangesLength + 1)) {
+                range = &committedRanges[i];
+                memmove(&committedRanges[i + 2], &committedRanges[i + 1], (committedRangesLength - i - 1) * sizeof(CommittedRange));
+                committedRanges[i + 1].start = end;
+                committedRanges[i + 1].end = range->end;
+                committedRanges[i + 1].type = range->type;
+                committedRanges[i + 1].large = range->large;
+                committedRangesLength++;
+            } else {
+                countCommitted(range->end - end, range->type, range->large, JNI_FALSE);
+            }
+            range->end = start;
+            break;
+        } else if (range->start < start) {
+            range->end = start;
+            i++;
+        } else if (range->end > end) {
+            range->start = end;
+            break;
+        } else {
+            memmove(&committedRanges[i], &committedRanges[i + 1], (committedRangesLength - i - 1) * sizeof(CommittedRange));
+            committedRangesLength--;
+        }
+    }
+    return removed;
+}
+
+/*
+ * Adds [start, end) to the committed ranges. The range must not overlap any existing one.
+ */
+static jboolean isMergeable(CommittedRange *range, int type, jboolean large) {
+    return range->type == type && range->large == large;
+}
+
+static void addCommitted(Address start, Address end, int type, jboolean large) {
+    if (start == end) {
+        return;
+    }
+    int i = findCommittedRange(start);
+    countCommitted(end - start, type, large, JNI_TRUE);
+    if (i > 0 && committedRanges[i - 1].end == start && isMergeable(&committedRanges[i - 1], type, large)) {
+        committedRanges[i - 1].end = end;
+        if (i < committedRangesLength && committedRanges[i].start == end && isMergeable(&committedRanges[i], type, large)) {
+            committedRanges[i - 1].end = committedRanges[i].end;
+            memmove(&committedRanges[i], &committedRanges[i + 1], (committedRangesLength - i - 1) * sizeof(CommittedRange));
+            committedRangesLength--;
+        }
+    } else if (i < committedRangesLength && committedRanges[i].start == end && isMergeable(&committedRanges[i], type, large)) {
+        committedRanges[i].start = start;
+    } else if (ensureCommittedRangesCapacity(committedRangesLength + 1)) {
+        memmove(&committedRanges[i + 1], &committedRanges[i], (committedRangesLength - i) * sizeof(CommittedRange));
+        committedRanges[i].start = start;
+        committedRanges[i].end = end;
+        committedRanges[i].type = type;
+        committedRanges[i].large = large;
+        committedRangesLength++;
+    } else {
+        countCommitted(end - start, type, large, JNI_FALSE);
+    }
+}
+
+/*
+ * Records that [address, address + size) has been committed as memory of a given type,
+ * with [largeStart, largeEnd) of it backed by large pages.
+ */
+static void recordCommit(Address address, Size size, int type, Address largeStart, Address largeEnd) {
+    lockCommittedRanges();
+    removeCommitted(address, address + size);
+    if (largeStart < largeEnd) {
+        addCommitted(address, largeStart, type, JNI_FALSE);
+        addCommitted(largeStart, largeEnd, type, JNI_TRUE);
+        addCommitted(largeEnd, address + size, type, JNI_FALSE);
+    } else {
+        addCommitted(address, address + size, type, JNI_FALSE);
+    }
+    unlockCommittedRanges();
+}
+
+/*
+ * Records that [address, address + size) has been uncommitted or released.
+ */
+static void recordDecommit(Address address, Size size) {
+    lockCommittedRanges();
+    removeCommitted(address, address + size);
+    unlockCommittedRanges();
+}
+
+#if os_LINUX
+/*
+ * Reads the value (in kB) of a "Name:   value kB" line from a /proc file, returning 0 if it is not present.
+ */
+static Size readProcMemInfoField(const char *path, const char *name) {
+    char line[256];
+    Size result = 0;
+    size_t nameLength = strlen(name);
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return 0;
+    }
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strncmp(line, name, nameLength) == 0 && line[nameLength] == ':') {
+            result = (Size) strtoull(line + nameLength + 1, NULL, 10) * 1024;
+            break;
+        }
+    }
+    fclose(file);
+    return result;
+}
+
+static jboolean transparentHugePagesAvailable(void) {
+    char buffer[128];
+    jboolean result = JNI_FALSE;
+    FILE *file = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (file != NULL) {
+        if (fgets(buffer, sizeof(buffer), file) != NULL) {
+            /* The active setting is bracketed, e.g. "always [madvise] never" */
+            result = strstr(buffer, "[never]") == NULL ? JNI_TRUE : JNI_FALSE;
+        }
+        fclose(file);
+    }
+    return result;
+}
+
+static int hugeTLBFlags(void) {
+    int shift = 0;
+    while (((Size) 1 << shift) < largePageSize) {
+        shift++;
+    }
+    return MAP_HUGETLB | (shift << MAP_HUGE_SHIFT);
+}
+
+/*
+ * Checks that a page of the configured size can actually be taken from the hugetlbfs pool.
+ */
+static jboolean hugeTLBPagesAvailable(void) {
+    void *probe = mmap(0, (size_t) largePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON | hugeTLBFlags(), -1, 0);
+    if (probe == MAP_FAILED) {
+        return JNI_FALSE;
+    }
+    munmap(probe, (size_t) largePageSize);
+    return JNI_TRUE;
+}
+#endif
+
+void virtualMemory_initializeLargePages(jboolean useLargePages, jboolean transparent, Size pageSize) {
+    largePageMode = LARGE_PAGES_NONE;
+    largePageSize = 0;
+    if (useLargePages == JNI_FALSE && transparent == JNI_FALSE) {
+        return;
+    }
+#if os_LINUX
+    Size defaultSize = readProcMemInfoField("/proc/meminfo", "Hugepagesize");
+    largePageSize = pageSize != 0 ? pageSize : defaultSize;
+    if (largePageSize == 0 || (largePageSize & (largePageSize - 1)) != 0 || largePageSize <= virtualMemory_getPageSize()) {
+        log_println("WARNING: invalid large page size %lu, large pages disabled", largePageSize);
+        largePageSize = 0;
+        return;
+    }
+    if (transparent == JNI_FALSE) {
+        if (hugeTLBPagesAvailable()) {
+            largePageMode = LARGE_PAGES_HUGETLBFS;
+            return;
+        }
+        log_println("WARNING: no %lu byte pages available from hugetlbfs, trying transparent huge pages", largePageSize);
+    }
+    if (transparentHugePagesAvailable() && largePageSize == defaultSize) {
+        largePageMode = LARGE_PAGES_TRANSPARENT;
+        return;
+    }
+    log_println("WARNING: transparent huge pages of %lu bytes not available, large pages disabled", largePageSize);
+#else
+    log_println("WARNING: large pages are not supported on this platform");
+#endif
+    largePageSize = 0;
+}
+
+void virtualMemory_printLargePageStatistics(void) {
+    static const char *modeNames[] = {"none", "hugetlbfs", "transparent"};
+    log_lock();
+    log_println("Large pages: mode=%s, page size=%lu", modeNames[largePageMode], largePageSize);
+    if (largePageMode != LARGE_PAGES_NONE) {
+        Size total = largePageBytes + smallPageBytes;
+        log_println("  committed heap and code backed by large pages: %lu of %lu bytes (%lu%%)",
+                        largePageBytes, total, total == 0 ? 0 : (largePageBytes * 100) / total);
+#if os_LINUX
+        if (largePageMode == LARGE_PAGES_TRANSPARENT) {
+            /* madvise() only makes a mapping eligible; the kernel reports what was actually promoted. */
+            log_println("  resident in transparent huge pages: %lu bytes", readProcMemInfoField("/proc/self/smaps_rollup", "AnonHugePages"));
+        }
+#endif
+    }
+    log_unlock();
+}
+
+/*
+ * Sets up the large page backing for a range just mapped with base pages.
+ * The range is shrunk to whole large pages, which are returned in [*largeStart, *largeEnd).
+ */
+static void adviseLargePages(Address address, Size size, Address *largeStart, Address *largeEnd) {
+#if os_LINUX
+    Address start = (address + largePageSize - 1) & ~(largePageSize - 1);
+    Address end = (address + size) & ~(largePageSize - 1);
+    if (end > start && madvise((void *) start, (size_t) (end - start), MADV_HUGEPAGE) == 0) {
+        *largeStart = start;
+        *largeEnd = end;
+    }
+#endif
+}
+
+/*
+ * Reserves a range of virtual space whose start is aligned to the large page size by over-reserving
+ * and trimming the excess at both ends.
+ */
+static void *mmapLargePageAligned(Size size, int prot, int flags) {
+    Size extended = size + largePageSize;
+    void *result = mmap(0, (size_t) extended, prot, flags, -1, 0);
+    if (result != MAP_FAILED) {
+        Address start = (Address) result;
+        Address aligned = (start + largePageSize - 1) & ~(largePageSize - 1);
+        if (aligned > start) {
+            munmap((void *) start, (size_t) (aligned - start));
+        }
+        if (start + extended > aligned + size) {
+            munmap((void *) (aligned + size), (size_t) (start + extended - (aligned + size)));
+        }
+        result = (void *) aligned;
+    }
+    return result;
+}
+
+#if os_LINUX
+/*
+ * Maps whole large pages from the hugetlbfs pool, returning them in [*largeStart, *largeEnd).
+ */
+static void *mmapHugeTLB(Address address, Size size, int prot, int flags, Address *largeStart, Address *largeEnd) {
+    void *result = mmap((void *) address, (size_t) size, prot, flags | hugeTLBFlags(), -1, 0);
+    if (result != MAP_FAILED) {
+        *largeStart = (Address) result;
+        *largeEnd = *largeStart + size;
+    }
+    return result;
+}
+#endif
+
 /* Generic virtual space allocator.
  * If the address parameters is specified, allocate at the specified address and fail if it cannot be allocated.
  * Use MAP_NORESERVE if reserveSwap is false
  * Use PROT_NONE if protNone is true, otherwise set all protection (i.e., allow any type of access).
+ * Heap and code memory is backed by large pages if these are enabled, falling back to base pages
+ * for ranges that cannot be. Accessible memory that is either mapped within a reservation or has swap
+ * space reserved is recorded as committed. An accessible mapping at an OS chosen address without swap
+ * space is only a reservation, which is committed piecemeal by later mappings within it.
  */
-Address virtualMemory_allocatePrivateAnon(Address address, Size size, jboolean reserveSwap, jboolean protNone, int type) {
+static Address mapPrivateAnon(Address address, Size size, jboolean reserveSwap, jboolean protNone, int type) {
+  /* Code that must be within 32-bit displacements of the boot code is allocated from the code space
+   * (see virtualMemory_reserveCodeSpace), so there is no need to force MAP_32BIT here. */
   int flags = MAP_PRIVATE | MAP_ANON;
-#if os_LINUX
-  /* For some reason, subsequent calls to mmap to allocate out of the space
-   * reserved here only work if the reserved space is in 32-bit space. */
-//  flags |= MAP_32BIT;
-#endif
   int prot = protNone == JNI_TRUE ? PROT_NONE : PROT;
   if (reserveSwap == JNI_FALSE) {
      flags |= MAP_NORESERVE;
@@ -88,7 +461,38 @@ Address virtualMemory_allocatePrivateAnon(Address address, Size size, jboolean r
 	  flags |= MAP_FIXED;
   }
 
-  void * result = mmap((void*) address, (size_t) size, prot, flags, -1, 0);
+  void * result = MAP_FAILED;
+  jboolean largePages = usesLargePages(type);
+  Address largeStart = 0;
+  Address largeEnd = 0;
+#if os_LINUX
+  if (largePages && largePageMode == LARGE_PAGES_HUGETLBFS && reserveSwap == JNI_TRUE && protNone == JNI_FALSE && isLargePageAligned(address, size)) {
+      /* Committing whole large pages, whether within a reservation or at an OS chosen address:
+       * take them from the hugetlbfs pool, else fall back to base pages below. */
+      result = mmapHugeTLB(address, size, prot, flags, &largeStart, &largeEnd);
+  }
+#endif
+  if (result == MAP_FAILED) {
+      if (largePages && address == 0 && size >= largePageSize) {
+          result = mmapLargePageAligned(size, prot, flags);
+      } else {
+          result = mmap((void*) address, (size_t) size, prot, flags, -1, 0);
+      }
+  }
+  if (result != MAP_FAILED) {
+      if (protNone == JNI_TRUE) {
+          if (address != 0) {
+              recordDecommit(address, size);
+          }
+      } else {
+          if (largePages && largeStart == 0 && largePageMode == LARGE_PAGES_TRANSPARENT) {
+              adviseLargePages((Address) result, size, &largeStart, &largeEnd);
+          }
+          if (reserveSwap == JNI_TRUE || address != 0) {
+              recordCommit((Address) result, size, type, largeStart, largeEnd);
+          }
+      }
+  }
 
 #if log_LOADER
 	log_println("virtualMemory_allocatePrivateAnon(address=%p, size=%p, swap=%s, prot=%s) allocated at %p",
@@ -100,9 +504,24 @@ Address virtualMemory_allocatePrivateAnon(Address address, Size size, jboolean r
   return check_mmap_result(result);
 }
 
+/*
+ * Mapping at a non-zero address operates within an existing reservation, so only a mapping at an OS chosen
+ * address is recorded as a reservation. The committed memory is recorded by mapPrivateAnon().
+ */
+Address virtualMemory_allocatePrivateAnon(Address address, Size size, jboolean reserveSwap, jboolean protNone, int type) {
+    Address result = mapPrivateAnon(address, size, reserveSwap, protNone, type);
+    if (result != ALLOC_FAILED && address == 0) {
+        nativeMemory_reserve(type, size, JNI_FALSE);
+    }
+    return result;
+}
 
 Address virtualMemory_mapFile(Size size, jint fd, Size offset) {
-	return check_mmap_result(mmap(0, (size_t) size, PROT, MAP_PRIVATE, fd, (off_t) offset));
+    Address result = check_mmap_result(mmap(0, (size_t) size, PROT, MAP_PRIVATE, fd, (off_t) offset));
+    if (result != ALLOC_FAILED) {
+        nativeMemory_reserve(NATIVE_MEMORY_MAPPED_FILES, size, JNI_TRUE);
+    }
+    return result;
  }
 
 JNIEXPORT jlong JNICALL
@@ -110,8 +529,40 @@ Java_com_sun_max_memory_VirtualMemory_virtualMemory_1mapFile(JNIEnv *env, jclass
     return virtualMemory_mapFile((Size) size, fd, (Size) offset);
 }
 
+/*
+ * Creates (or truncates) the file at 'path', sizes it to 'size' bytes and maps it shared and writable.
+ * Stores to the mapping reach the page cache directly, so they survive the process however it terminates.
+ */
+Address virtualMemory_mapSharedFile(const char *path, Size size) {
+    Address result = ALLOC_FAILED;
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        log_println("could not open %s: %s", path, strerror(errno));
+        return ALLOC_FAILED;
+    }
+    if (ftruncate(fd, (off_t) size) == 0) {
+        result = check_mmap_result(mmap(0, (size_t) size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0));
+    } else {
+        log_println("could not size %s: %s", path, strerror(errno));
+    }
+    close(fd);
+    if (result != ALLOC_FAILED) {
+        nativeMemory_reserve(NATIVE_MEMORY_MAPPED_FILES, size, JNI_TRUE);
+    }
+    return result;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_sun_max_memory_VirtualMemory_virtualMemory_1mapSharedFile(JNIEnv *env, jclass c, jlong path, jlong size) {
+    return virtualMemory_mapSharedFile((const char *) path, (Size) size);
+}
+
 Address virtualMemory_mapFileIn31BitSpace(jint size, jint fd, Size offset) {
-	return check_mmap_result(mmap(0, (size_t) size, PROT, MAP_PRIVATE | MAP_32BIT, fd, (off_t) offset));
+    Address result = check_mmap_result(mmap(0, (size_t) size, PROT, MAP_PRIVATE | MAP_32BIT, fd, (off_t) offset));
+    if (result != ALLOC_FAILED) {
+        nativeMemory_reserve(NATIVE_MEMORY_MAPPED_FILES, size, JNI_TRUE);
+    }
+    return result;
 }
 
 JNIEXPORT jlong JNICALL
@@ -119,51 +570,163 @@ Java_com_sun_max_memory_VirtualMemory_virtualMemory_1mapFileIn31BitSpace(JNIEnv
     return virtualMemory_mapFileIn31BitSpace(size, fd, (Size) offset);
 }
 
+/* The mapping replaces part of a reservation that is already accounted for by native memory tracking. */
 Address virtualMemory_mapFileAtFixedAddress(Address address, Size size, jint fd, Size offset) {
     return check_mmap_result(mmap((void *) address, (size_t) size, PROT, MAP_PRIVATE | MAP_FIXED, fd, (off_t) offset));
 }
 
+/*
+ * The code space: a single window of virtual space reserved up front, from which committed chunks are handed out
+ * in increasing address order. As long as the window is placed within 32-bit displacement range of the boot code region,
+ * all code allocated from it can be reached by direct calls, however much of it is eventually committed.
+ */
+static Address codeSpaceStart = 0;
+static Address codeSpaceEnd = 0;
+static volatile Address codeSpaceCommitted = 0;
+static volatile int codeSpaceLock = 0;
+
+Address virtualMemory_reserveCodeSpace(Address address, Size size) {
+    c_ASSERT(codeSpaceStart == 0);
+    c_ASSERT(virtualMemory_pageAlign(address) == address && virtualMemory_pageAlign(size) == size);
+    Address result = mapPrivateAnon(address, size, JNI_FALSE, JNI_TRUE, CODE_VM);
+    if (result != ALLOC_FAILED) {
+        if (address == 0) {
+            /* A window placed at a given address lies in space already reserved (and accounted) by the caller. */
+            nativeMemory_reserve(CODE_VM, size, JNI_FALSE);
+        }
+        codeSpaceStart = result;
+        codeSpaceEnd = result + size;
+        codeSpaceCommitted = result;
+    }
+    return result;
+}
+
+/*
+ * Commits are serialized so that the committed end of the code space only advances past memory that
+ * has actually been mapped; a failed commit leaves it where it was for the next attempt.
+ */
+Address virtualMemory_commitCodeSpace(Size size) {
+    Address chunk = ALLOC_FAILED;
+    size = virtualMemory_pageAlign(size);
+    while (__sync_lock_test_and_set(&codeSpaceLock, 1)) {
+    }
+    if (codeSpaceStart != 0 && size <= codeSpaceEnd - codeSpaceCommitted) {
+        chunk = codeSpaceCommitted;
+        if (virtualMemory_allocatePrivateAnon(chunk, size, JNI_TRUE, JNI_FALSE, CODE_VM) == chunk) {
+            codeSpaceCommitted = chunk + size;
+        } else {
+            log_println("WARNING: could not commit %lu bytes of code space at %p", size, chunk);
+            chunk = ALLOC_FAILED;
+        }
+    }
+    __sync_lock_release(&codeSpaceLock);
+    return chunk;
+}
+
+Address virtualMemory_getCodeSpaceEnd(void) {
+    return codeSpaceEnd;
+}
+
 // end of conditional exclusion of mmap stuff not available (or used) on MAXVE
 #endif // MAXVE
 
+#if os_MAXVE
+
+void virtualMemory_initializeLargePages(jboolean useLargePages, jboolean transparent, Size pageSize) {
+}
+
+void virtualMemory_printLargePageStatistics(void) {
+}
+
+Address virtualMemory_reserveCodeSpace(Address address, Size size) {
+    c_UNIMPLEMENTED();
+    return ALLOC_FAILED;
+}
+
+Address virtualMemory_commitCodeSpace(Size size) {
+    return ALLOC_FAILED;
+}
+
+Address virtualMemory_getCodeSpaceEnd(void) {
+    return 0;
+}
+
+#endif
+
+
+/*
+ * Without mmap on MaxVE, native memory tracking cannot follow commits by address. All memory is recorded
+ * as committed when it is allocated and as uncommitted when it is released.
+ */
+#if os_MAXVE
+#define RECORDS_COMMITS_BY_ADDRESS JNI_FALSE
+#else
+#define RECORDS_COMMITS_BY_ADDRESS JNI_TRUE
+#endif
 
 Address virtualMemory_allocate(Size size, int type) {
+    Address result;
 #if os_MAXVE
-	return (Address) maxve_virtualMemory_allocate(size, type);
+	result = (Address) maxve_virtualMemory_allocate(size, type);
 #else
-    return check_mmap_result(mmap(0, (size_t) size, PROT, MAP_ANON | MAP_PRIVATE, -1, (off_t) 0));
+    result = mapPrivateAnon((Address) 0, size, JNI_TRUE, JNI_FALSE, type);
 #endif
+    if (result != ALLOC_FAILED) {
+        nativeMemory_reserve(type, size, !RECORDS_COMMITS_BY_ADDRESS);
+    }
+    return result;
 }
 
 Address virtualMemory_allocateIn31BitSpace(Size size, int type) {
+    Address result;
 #if os_LINUX
-    return check_mmap_result(mmap(0, (size_t) size, PROT, MAP_ANON | MAP_PRIVATE | MAP_32BIT, -1, (off_t) 0));
+    result = check_mmap_result(mmap(0, (size_t) size, PROT, MAP_ANON | MAP_PRIVATE | MAP_32BIT, -1, (off_t) 0));
+    if (result != ALLOC_FAILED) {
+        recordCommit(result, size, type, 0, 0);
+    }
 #elif os_MAXVE
-    return (Address) maxve_virtualMemory_allocateIn31BitSpace(size, type);
+    result = (Address) maxve_virtualMemory_allocateIn31BitSpace(size, type);
 #else
     c_UNIMPLEMENTED();
-    return 0;
+    result = 0;
 #endif
+    if (result != ALLOC_FAILED) {
+        nativeMemory_reserve(type, size, !RECORDS_COMMITS_BY_ADDRESS);
+    }
+    return result;
 }
 
 Address virtualMemory_deallocate(Address start, Size size, int type) {
+    Address result;
 #if os_MAXVE
-    return (Address) maxve_virtualMemory_deallocate((void *)start, size, type);
+    result = (Address) maxve_virtualMemory_deallocate((void *)start, size, type);
 #else
-    int result = munmap((void *) start, (size_t) size);
-    return result == -1 ? 0 : start;
+    result = munmap((void *) start, (size_t) size) == -1 ? 0 : start;
+    if (result != 0) {
+        recordDecommit(start, size);
+    }
 #endif
+    if (result != 0) {
+        /* Whatever was committed in the range has been recorded as uncommitted above, under the type it was committed as. */
+        nativeMemory_release(type, size, RECORDS_COMMITS_BY_ADDRESS ? 0 : size);
+    }
+    return result;
 }
 
 boolean virtualMemory_allocateAtFixedAddress(Address address, Size size, int type) {
+    boolean result;
 #if os_SOLARIS || os_DARWIN  || os_LINUX
-    return check_mmap_result(mmap((void *) address, (size_t) size, PROT, MAP_ANON | MAP_PRIVATE | MAP_FIXED, -1, (off_t) 0)) != ALLOC_FAILED;
+    result = mapPrivateAnon(address, size, JNI_TRUE, JNI_FALSE, type) != ALLOC_FAILED;
 #elif os_MAXVE
-    return (Address) maxve_virtualMemory_allocateAtFixedAddress((unsigned long)address, size, type) != ALLOC_FAILED;
+    result = (Address) maxve_virtualMemory_allocateAtFixedAddress((unsigned long)address, size, type) != ALLOC_FAILED;
 #else
     c_UNIMPLEMENTED();
-    return false;
+    result = false;
 #endif
+    if (result) {
+        nativeMemory_reserve(type, size, !RECORDS_COMMITS_BY_ADDRESS);
+    }
+    return result;
 }
 
 void virtualMemory_protectPages(Address address, int count) {
@@ -218,6 +781,11 @@ Size virtualMemory_getPhysicalMemorySize(void) {
 #elif os_SOLARIS  || os_LINUX
         Size numPhysicalPages = (Size) sysconf(_SC_PHYS_PAGES);
         physicalMemory = numPhysicalPages * virtualMemory_getPageSize();
+        /* Report no more than the memory limit of the process's container, if any. */
+        Size memoryLimit = resources_getMemoryLimit() & ~((Size) virtualMemory_getPageSize() - 1);
+        if (memoryLimit != 0 && memoryLimit < physicalMemory) {
+            physicalMemory = memoryLimit;
+        }
 #elif os_DARWIN
         int query[2];
         query[0] = CTL_HW;
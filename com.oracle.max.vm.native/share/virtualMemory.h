@@ -30,11 +30,18 @@
 #define STACK_VM 1
 #define CODE_VM 2
 #define DATA_VM 3
+#define MALLOC_VM 4 // arenas and large blocks of the native allocator (see memory.c); not a VirtualMemory.Type
+
+#define LARGE_PAGES_NONE 0           // base pages only
+#define LARGE_PAGES_HUGETLBFS 1      // explicit huge pages from the hugetlbfs pool (MAP_HUGETLB)
+#define LARGE_PAGES_TRANSPARENT 2    // transparent huge pages (madvise(MADV_HUGEPAGE))
 
 #define ALLOC_FAILED ((Address) 0)  // return value for failed allocations
 
 extern Address virtualMemory_mapFileIn31BitSpace(jint size, jint fd, Size offset);
 
+extern Address virtualMemory_mapSharedFile(const char *path, Size size);
+
 extern Address virtualMemory_mapFileAtFixedAddress(Address address, Size size, jint fd, Size offset);
 
 extern boolean virtualMemory_allocateAtFixedAddress(Address address, Size size, int type);
@@ -49,6 +56,37 @@ extern Size virtualMemory_getPhysicalMemorySize(void);
 
 extern Address virtualMemory_pageAlign(Address address);
 
+/**
+ * Configures large page backing for heap and code memory. Must be called before the boot image is mapped.
+ * If the requested kind of large pages is not available, this falls back to transparent huge pages
+ * and then to base pages, printing a warning.
+ *
+ * @param useLargePages request explicit (hugetlbfs) large pages
+ * @param transparent request transparent huge pages
+ * @param pageSize the large page size, or 0 for the platform's default huge page size
+ */
+extern void virtualMemory_initializeLargePages(jboolean useLargePages, jboolean transparent, Size pageSize);
+extern void virtualMemory_printLargePageStatistics(void);
+
+/**
+ * Reserves the window of virtual space from which code memory is committed by virtualMemory_commitCodeSpace().
+ * This can only be done once.
+ *
+ * @param address the page aligned start of the window, or 0 to let the OS choose. A non-zero address must lie within
+ *        virtual space already reserved by the caller, as the window is mapped over it.
+ * @param size the page aligned size of the window
+ * @return the start of the window or ALLOC_FAILED
+ */
+extern Address virtualMemory_reserveCodeSpace(Address address, Size size);
+
+/**
+ * Commits the next chunk of the code space. Chunks are handed out contiguously in increasing address order.
+ *
+ * @return the start of the committed chunk or ALLOC_FAILED if the code space is exhausted
+ */
+extern Address virtualMemory_commitCodeSpace(Size size);
+extern Address virtualMemory_getCodeSpaceEnd(void);
+
 extern void virtualMemory_protectPages(Address address, int count);
 extern void virtualMemory_unprotectPages(Address address, int count);
 #endif /*__virtualMemory_h__*/
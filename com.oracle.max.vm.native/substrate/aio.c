@@ -0,0 +1,741 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "c.h"
+#include "log.h"
+#include "mutex.h"
+#include "aio.h"
+
+#if os_LINUX
+
+#include <poll.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define AIO_HAS_URING 1
+#endif
+#endif
+
+/*
+ * The state of an operation in the epoll engine.
+ */
+#define OP_FREE      0
+#define OP_QUEUED    1
+#define OP_WAITING   2
+
+typedef struct {
+    jint state;
+    jint opcode;
+    jint fd;
+    jint pollFd;        /* a dup of fd, so that several operations on fd can be registered with epoll at once */
+    jboolean isSocket;
+    char *buffer;
+    jint length;
+    jlong offset;       /* for AIO_TIMEOUT, the deadline once submitted */
+    jlong userData;
+} aio_Operation;
+
+struct aio_Engine {
+    jint kind;
+    jint entries;
+
+    /* Serializes aio_prepare() and aio_submit() */
+    mutex_Struct submitLock;
+
+    /* Serializes aio_reap() */
+    mutex_Struct reapLock;
+
+    /* The number of operations queued or in flight */
+    volatile jint inFlight;
+
+#if AIO_HAS_URING
+    int ringFd;
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    struct io_uring_sqe *sqes;
+    size_t sqesSize;
+    unsigned *sqHead;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    unsigned sqLocalTail;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    struct io_uring_cqe *cqes;
+
+    /* The kernel reads the timespec of a timeout when it is submitted, so it is kept here until then */
+    struct __kernel_timespec *timeouts;
+#endif
+
+    int epollFd;
+
+    /* Guards the operations and the completed results of the epoll engine */
+    mutex_Struct lock;
+    aio_Operation *operations;
+    jint *queue;
+    jint queued;
+    aio_Completion *completed;
+    jint completedHead;
+    jint completedCount;
+};
+
+static jlong nanoTime(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((jlong) ts.tv_sec) * 1000000000LL + ts.tv_nsec;
+}
+
+static jlong deadlineAfter(jlong timeoutNanos) {
+    return timeoutNanos < 0 ? -1 : nanoTime() + timeoutNanos;
+}
+
+/*
+ * Converts a deadline to a timeout in milliseconds for poll(2) or epoll_wait(2), rounding up.
+ */
+static int millisUntil(jlong deadline) {
+    if (deadline < 0) {
+        return -1;
+    }
+    jlong remaining = deadline - nanoTime();
+    if (remaining <= 0) {
+        return 0;
+    }
+    jlong millis = (remaining + 999999) / 1000000;
+    return millis > 0x7fffffff ? 0x7fffffff : (int) millis;
+}
+
+#if AIO_HAS_URING
+
+static inline unsigned loadAcquire(unsigned *p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+static inline void storeRelease(unsigned *p, unsigned value) {
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+}
+
+static void closeUring(aio_Engine engine) {
+    if (engine->sqes != NULL) {
+        munmap(engine->sqes, engine->sqesSize);
+    }
+    if (engine->cqRing != NULL && engine->cqRing != engine->sqRing) {
+        munmap(engine->cqRing, engine->cqRingSize);
+    }
+    if (engine->sqRing != NULL) {
+        munmap(engine->sqRing, engine->sqRingSize);
+    }
+    if (engine->ringFd >= 0) {
+        close(engine->ringFd);
+    }
+    free(engine->timeouts);
+}
+
+/*
+ * Sets up an io_uring instance and maps its rings.
+ *
+ * @return false if io_uring is unavailable or lacks the operations used here (before Linux 5.7)
+ */
+static boolean openUring(aio_Engine engine) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    engine->ringFd = (int) syscall(__NR_io_uring_setup, engine->entries, &params);
+    if (engine->ringFd < 0) {
+        return false;
+    }
+    /* Fast poll came with the same release as IORING_OP_READ and IORING_OP_ACCEPT are usable on sockets */
+    if ((params.features & IORING_FEAT_FAST_POLL) == 0 || (params.features & IORING_FEAT_SINGLE_MMAP) == 0) {
+        close(engine->ringFd);
+        engine->ringFd = -1;
+        return false;
+    }
+
+    engine->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    engine->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (engine->cqRingSize > engine->sqRingSize) {
+        engine->sqRingSize = engine->cqRingSize;
+    }
+    engine->cqRingSize = engine->sqRingSize;
+    engine->sqRing = mmap(NULL, engine->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, engine->ringFd, IORING_OFF_SQ_RING);
+    if (engine->sqRing == MAP_FAILED) {
+        engine->sqRing = NULL;
+        closeUring(engine);
+        return false;
+    }
+    engine->cqRing = engine->sqRing;
+    engine->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    engine->sqes = (struct io_uring_sqe *) mmap(NULL, engine->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, engine->ringFd, IORING_OFF_SQES);
+    if (engine->sqes == MAP_FAILED) {
+        engine->sqes = NULL;
+        closeUring(engine);
+        return false;
+    }
+    engine->timeouts = (struct __kernel_timespec *) calloc(params.sq_entries, sizeof(struct __kernel_timespec));
+    if (engine->timeouts == NULL) {
+        closeUring(engine);
+        return false;
+    }
+
+    char *sq = (char *) engine->sqRing;
+    engine->sqHead = (unsigned *) (sq + params.sq_off.head);
+    engine->sqTail = (unsigned *) (sq + params.sq_off.tail);
+    engine->sqMask = (unsigned *) (sq + params.sq_off.ring_mask);
+    engine->sqArray = (unsigned *) (sq + params.sq_off.array);
+    engine->sqLocalTail = *engine->sqTail;
+    char *cq = (char *) engine->cqRing;
+    engine->cqHead = (unsigned *) (cq + params.cq_off.head);
+    engine->cqTail = (unsigned *) (cq + params.cq_off.tail);
+    engine->cqMask = (unsigned *) (cq + params.cq_off.ring_mask);
+    engine->cqes = (struct io_uring_cqe *) (cq + params.cq_off.cqes);
+
+    /* The completion queue is at least as large as the submission queue, so limiting the operations in flight to the latter prevents overflow */
+    engine->entries = params.sq_entries;
+    engine->kind = AIO_URING;
+    return true;
+}
+
+static jint prepareUring(aio_Engine engine, jint opcode, jint fd, Address buffer, jint length, jlong offset, jlong userData) {
+    unsigned index = engine->sqLocalTail & *engine->sqMask;
+    struct io_uring_sqe *sqe = &engine->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->fd = fd;
+    sqe->user_data = (__u64) userData;
+    switch (opcode) {
+        case AIO_READ:
+        case AIO_WRITE:
+            sqe->opcode = opcode == AIO_READ ? IORING_OP_READ : IORING_OP_WRITE;
+            sqe->addr = (__u64) buffer;
+            sqe->len = (__u32) length;
+            sqe->off = offset < 0 ? (__u64) -1 : (__u64) offset;
+            break;
+        case AIO_ACCEPT:
+            sqe->opcode = IORING_OP_ACCEPT;
+            sqe->accept_flags = SOCK_CLOEXEC;
+            break;
+        case AIO_TIMEOUT:
+            engine->timeouts[index].tv_sec = offset / 1000000000LL;
+            engine->timeouts[index].tv_nsec = offset % 1000000000LL;
+            sqe->opcode = IORING_OP_TIMEOUT;
+            sqe->fd = -1;
+            sqe->addr = (__u64) &engine->timeouts[index];
+            sqe->len = 1;
+            break;
+    }
+    engine->sqArray[index] = index;
+    engine->sqLocalTail++;
+    return 0;
+}
+
+static jint submitUring(aio_Engine engine) {
+    unsigned toSubmit = engine->sqLocalTail - *engine->sqTail;
+    if (toSubmit == 0) {
+        return 0;
+    }
+    storeRelease(engine->sqTail, engine->sqLocalTail);
+    int submitted;
+    do {
+        submitted = (int) syscall(__NR_io_uring_enter, engine->ringFd, toSubmit, 0, 0, NULL, 0);
+    } while (submitted < 0 && errno == EINTR);
+    return submitted < 0 ? -errno : submitted;
+}
+
+static jint reapUring(aio_Engine engine, aio_Completion *completions, jint max, jint min, jlong timeoutNanos) {
+    jlong deadline = deadlineAfter(timeoutNanos);
+    jint count = 0;
+    while (true) {
+        unsigned head = *engine->cqHead;
+        unsigned tail = loadAcquire(engine->cqTail);
+        while (head != tail && count < max) {
+            struct io_uring_cqe *cqe = &engine->cqes[head & *engine->cqMask];
+            completions[count].userData = (jlong) cqe->user_data;
+            /* An expired timeout completes with -ETIME */
+            completions[count].result = cqe->res == -ETIME ? 0 : cqe->res;
+            count++;
+            head++;
+        }
+        storeRelease(engine->cqHead, head);
+        if (count >= min || count == max) {
+            break;
+        }
+        /* The ring file descriptor polls readable while there are completions to reap */
+        int timeout = millisUntil(deadline);
+        if (timeout == 0) {
+            break;
+        }
+        struct pollfd pfd;
+        pfd.fd = engine->ringFd;
+        pfd.events = POLLIN;
+        if (poll(&pfd, 1, timeout) < 0 && errno != EINTR) {
+            return count == 0 ? -errno : count;
+        }
+    }
+    __sync_fetch_and_sub(&engine->inFlight, count);
+    return count;
+}
+
+#endif /* AIO_HAS_URING */
+
+static void complete(aio_Engine engine, jlong userData, jlong result) {
+    jint tail = (engine->completedHead + engine->completedCount) % engine->entries;
+    engine->completed[tail].userData = userData;
+    engine->completed[tail].result = result;
+    engine->completedCount++;
+}
+
+static void freeOperation(aio_Engine engine, aio_Operation *op) {
+    if (op->pollFd >= 0) {
+        epoll_ctl(engine->epollFd, EPOLL_CTL_DEL, op->pollFd, NULL);
+        close(op->pollFd);
+        op->pollFd = -1;
+    }
+    op->state = OP_FREE;
+}
+
+/*
+ * Attempts an operation of the epoll engine without blocking.
+ *
+ * @return the result of the operation, or -EAGAIN if it would have blocked
+ */
+static jlong perform(aio_Operation *op) {
+    ssize_t n;
+    do {
+        switch (op->opcode) {
+            case AIO_READ:
+                if (op->isSocket) {
+                    n = recv(op->fd, op->buffer, op->length, MSG_DONTWAIT);
+                } else if (op->offset >= 0) {
+                    n = pread(op->fd, op->buffer, op->length, op->offset);
+                } else {
+                    n = read(op->fd, op->buffer, op->length);
+                }
+                break;
+            case AIO_WRITE:
+                if (op->isSocket) {
+                    n = send(op->fd, op->buffer, op->length, MSG_DONTWAIT | MSG_NOSIGNAL);
+                } else if (op->offset >= 0) {
+                    n = pwrite(op->fd, op->buffer, op->length, op->offset);
+                } else {
+                    n = write(op->fd, op->buffer, op->length);
+                }
+                break;
+            case AIO_ACCEPT: {
+                /* accept(2) has no per-call non-blocking flag and the listening socket may be blocking */
+                struct pollfd pfd;
+                pfd.fd = op->fd;
+                pfd.events = POLLIN;
+                if (poll(&pfd, 1, 0) == 0) {
+                    return -EAGAIN;
+                }
+                n = accept4(op->fd, NULL, NULL, SOCK_CLOEXEC);
+                break;
+            }
+            default:
+                c_ASSERT(false);
+                n = 0;
+        }
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) {
+        return errno == EWOULDBLOCK ? -EAGAIN : -errno;
+    }
+    return n;
+}
+
+static jint prepareEpoll(aio_Engine engine, jint opcode, jint fd, Address buffer, jint length, jlong offset, jlong userData) {
+    mutex_enter(&engine->lock);
+    jint i;
+    for (i = 0; i < engine->entries; i++) {
+        if (engine->operations[i].state == OP_FREE) {
+            break;
+        }
+    }
+    c_ASSERT(i < engine->entries);
+    aio_Operation *op = &engine->operations[i];
+    op->state = OP_QUEUED;
+    op->opcode = opcode;
+    op->fd = fd;
+    op->pollFd = -1;
+    op->buffer = (char *) buffer;
+    op->length = length;
+    op->offset = offset;
+    op->userData = userData;
+    engine->queue[engine->queued++] = i;
+    mutex_exit(&engine->lock);
+    return 0;
+}
+
+static jint submitEpoll(aio_Engine engine) {
+    mutex_enter(&engine->lock);
+    jint submitted = engine->queued;
+    jint q;
+    for (q = 0; q < engine->queued; q++) {
+        aio_Operation *op = &engine->operations[engine->queue[q]];
+        op->state = OP_WAITING;
+        if (op->opcode == AIO_TIMEOUT) {
+            op->offset = nanoTime() + op->offset;
+            continue;
+        }
+        struct stat st;
+        op->isSocket = fstat(op->fd, &st) == 0 && S_ISSOCK(st.st_mode);
+        jlong result = -EAGAIN;
+        if (op->isSocket || op->opcode == AIO_ACCEPT) {
+            /* Sockets are often ready already, which saves a trip through epoll */
+            result = perform(op);
+        }
+        if (result == -EAGAIN) {
+            struct epoll_event event;
+            event.events = (op->opcode == AIO_WRITE ? EPOLLOUT : EPOLLIN) | EPOLLONESHOT;
+            event.data.u32 = engine->queue[q];
+            op->pollFd = dup(op->fd);
+            if (op->pollFd >= 0 && epoll_ctl(engine->epollFd, EPOLL_CTL_ADD, op->pollFd, &event) == 0) {
+                continue;
+            }
+            if (errno == EPERM) {
+                /* Regular files cannot be polled and are always ready */
+                result = perform(op);
+            } else {
+                result = -errno;
+            }
+        }
+        complete(engine, op->userData, result);
+        freeOperation(engine, op);
+    }
+    engine->queued = 0;
+    mutex_exit(&engine->lock);
+    return submitted;
+}
+
+#define AIO_EPOLL_EVENTS 64
+
+static jint reapEpoll(aio_Engine engine, aio_Completion *completions, jint max, jint min, jlong timeoutNanos) {
+    jlong deadline = deadlineAfter(timeoutNanos);
+    struct epoll_event events[AIO_EPOLL_EVENTS];
+    jint count = 0;
+    while (true) {
+        mutex_enter(&engine->lock);
+        jlong now = nanoTime();
+        jlong nextTimeout = -1;
+        jint i;
+        for (i = 0; i < engine->entries; i++) {
+            aio_Operation *op = &engine->operations[i];
+            if (op->state == OP_WAITING && op->opcode == AIO_TIMEOUT) {
+                if (op->offset <= now) {
+                    complete(engine, op->userData, 0);
+                    freeOperation(engine, op);
+                } else if (nextTimeout < 0 || op->offset < nextTimeout) {
+                    nextTimeout = op->offset;
+                }
+            }
+        }
+        while (engine->completedCount > 0 && count < max) {
+            completions[count++] = engine->completed[engine->completedHead];
+            engine->completedHead = (engine->completedHead + 1) % engine->entries;
+            engine->completedCount--;
+        }
+        mutex_exit(&engine->lock);
+
+        if (count >= min || count == max) {
+            break;
+        }
+        int timeout = millisUntil(deadline);
+        if (timeout == 0) {
+            break;
+        }
+        if (nextTimeout >= 0) {
+            int untilNext = millisUntil(nextTimeout);
+            if (timeout < 0 || untilNext < timeout) {
+                timeout = untilNext;
+            }
+        }
+        int n = epoll_wait(engine->epollFd, events, AIO_EPOLL_EVENTS, timeout);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return count == 0 ? -errno : count;
+        }
+        mutex_enter(&engine->lock);
+        for (i = 0; i < n; i++) {
+            aio_Operation *op = &engine->operations[events[i].data.u32];
+            jlong result = perform(op);
+            if (result == -EAGAIN) {
+                /* Another reader got there first: wait for readiness again */
+                struct epoll_event event;
+                event.events = (op->opcode == AIO_WRITE ? EPOLLOUT : EPOLLIN) | EPOLLONESHOT;
+                event.data.u32 = events[i].data.u32;
+                if (epoll_ctl(engine->epollFd, EPOLL_CTL_MOD, op->pollFd, &event) == 0) {
+                    continue;
+                }
+                result = -errno;
+            }
+            complete(engine, op->userData, result);
+            freeOperation(engine, op);
+        }
+        mutex_exit(&engine->lock);
+    }
+    __sync_fetch_and_sub(&engine->inFlight, count);
+    return count;
+}
+
+static void closeEpoll(aio_Engine engine) {
+    if (engine->operations != NULL) {
+        jint i;
+        for (i = 0; i < engine->entries; i++) {
+            freeOperation(engine, &engine->operations[i]);
+        }
+    }
+    if (engine->epollFd >= 0) {
+        close(engine->epollFd);
+    }
+    free(engine->operations);
+    free(engine->queue);
+    free(engine->completed);
+}
+
+static boolean openEpoll(aio_Engine engine) {
+    engine->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    engine->operations = (aio_Operation *) calloc(engine->entries, sizeof(aio_Operation));
+    engine->queue = (jint *) calloc(engine->entries, sizeof(jint));
+    engine->completed = (aio_Completion *) calloc(engine->entries, sizeof(aio_Completion));
+    if (engine->epollFd < 0 || engine->operations == NULL || engine->queue == NULL || engine->completed == NULL) {
+        closeEpoll(engine);
+        return false;
+    }
+    jint i;
+    for (i = 0; i < engine->entries; i++) {
+        engine->operations[i].pollFd = -1;
+    }
+    mutex_initialize(&engine->lock);
+    engine->kind = AIO_EPOLL;
+    return true;
+}
+
+aio_Engine aio_open(jint entries, jboolean useUring) {
+    if (entries <= 0) {
+        errno = EINVAL;
+        return NULL;
+    }
+    aio_Engine engine = (aio_Engine) calloc(1, sizeof(struct aio_Engine));
+    if (engine == NULL) {
+        return NULL;
+    }
+    engine->entries = entries;
+    engine->epollFd = -1;
+#if AIO_HAS_URING
+    engine->ringFd = -1;
+    if (!useUring || !openUring(engine))
+#endif
+    {
+        engine->entries = entries;
+        if (!openEpoll(engine)) {
+            int error = errno;
+            free(engine);
+            errno = error;
+            return NULL;
+        }
+    }
+    mutex_initialize(&engine->submitLock);
+    mutex_initialize(&engine->reapLock);
+    return engine;
+}
+
+jint aio_getKind(aio_Engine engine) {
+    return engine->kind;
+}
+
+jint aio_prepare(aio_Engine engine, jint opcode, jint fd, Address buffer, jint length, jlong offset, jlong userData) {
+    c_ASSERT(opcode >= AIO_READ && opcode <= AIO_TIMEOUT);
+    mutex_enter(&engine->submitLock);
+    jint result = -1;
+    if (engine->inFlight < engine->entries) {
+        __sync_fetch_and_add(&engine->inFlight, 1);
+#if AIO_HAS_URING
+        if (engine->kind == AIO_URING) {
+            result = prepareUring(engine, opcode, fd, buffer, length, offset, userData);
+        } else
+#endif
+        {
+            result = prepareEpoll(engine, opcode, fd, buffer, length, offset, userData);
+        }
+    }
+    mutex_exit(&engine->submitLock);
+    return result;
+}
+
+jint aio_submit(aio_Engine engine) {
+    jint result;
+    mutex_enter(&engine->submitLock);
+#if AIO_HAS_URING
+    if (engine->kind == AIO_URING) {
+        result = submitUring(engine);
+    } else
+#endif
+    {
+        result = submitEpoll(engine);
+    }
+    mutex_exit(&engine->submitLock);
+    return result;
+}
+
+jint aio_reap(aio_Engine engine, aio_Completion *completions, jint max, jint min, jlong timeoutNanos) {
+    jint result;
+    if (min > max) {
+        min = max;
+    }
+    mutex_enter(&engine->reapLock);
+#if AIO_HAS_URING
+    if (engine->kind == AIO_URING) {
+        result = reapUring(engine, completions, max, min, timeoutNanos);
+    } else
+#endif
+    {
+        result = reapEpoll(engine, completions, max, min, timeoutNanos);
+    }
+    mutex_exit(&engine->reapLock);
+    return result;
+}
+
+void aio_close(aio_Engine engine) {
+#if AIO_HAS_URING
+    if (engine->kind == AIO_URING) {
+        closeUring(engine);
+    } else
+#endif
+    {
+        closeEpoll(engine);
+        mutex_dispose(&engine->lock);
+    }
+    mutex_dispose(&engine->submitLock);
+    mutex_dispose(&engine->reapLock);
+    free(engine);
+}
+
+#else
+
+aio_Engine aio_open(jint entries, jboolean useUring) {
+    errno = ENOSYS;
+    return NULL;
+}
+
+jint aio_getKind(aio_Engine engine) {
+    c_UNIMPLEMENTED();
+    return -1;
+}
+
+jint aio_prepare(aio_Engine engine, jint opcode, jint fd, Address buffer, jint length, jlong offset, jlong userData) {
+    c_UNIMPLEMENTED();
+    return -1;
+}
+
+jint aio_submit(aio_Engine engine) {
+    c_UNIMPLEMENTED();
+    return -ENOSYS;
+}
+
+jint aio_reap(aio_Engine engine, aio_Completion *completions, jint max, jint min, jlong timeoutNanos) {
+    c_UNIMPLEMENTED();
+    return -ENOSYS;
+}
+
+void aio_close(aio_Engine engine) {
+    c_UNIMPLEMENTED();
+}
+
+#endif /* os_LINUX */
+
+/*
+ * JNI entry points for com.sun.max.vm.io.AsyncIO. Opening and reaping are JNI functions because they may block.
+ */
+
+static void throwIOException(JNIEnv *env, const char *operation, int error) {
+    char message[256];
+    snprintf(message, sizeof(message), "%s failed: %s", operation, strerror(error));
+    (*env)->ThrowNew(env, (*env)->FindClass(env, "java/io/IOException"), message);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_sun_max_vm_io_AsyncIO_open(JNIEnv *env, jclass c, jint entries, jboolean useUring) {
+    aio_Engine engine = aio_open(entries, useUring);
+    if (engine == NULL) {
+        throwIOException(env, "aio_open", errno);
+    }
+    return (jlong) (Address) engine;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_sun_max_vm_io_AsyncIO_prepare(JNIEnv *env, jclass c, jlong engine, jint opcode, jint fd, jlong buffer, jint length, jlong offset, jlong userData) {
+    return aio_prepare((aio_Engine) (Address) engine, opcode, fd, (Address) buffer, length, offset, userData);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_sun_max_vm_io_AsyncIO_submit(JNIEnv *env, jclass c, jlong engine) {
+    jint result = aio_submit((aio_Engine) (Address) engine);
+    if (result < 0) {
+        throwIOException(env, "aio_submit", -result);
+    }
+    return result;
+}
+
+#define AIO_REAP_BATCH 256
+
+JNIEXPORT jint JNICALL
+Java_com_sun_max_vm_io_AsyncIO_reap(JNIEnv *env, jclass c, jlong engine, jlongArray userData, jlongArray results, jint min, jlong timeoutNanos) {
+    aio_Completion completions[AIO_REAP_BATCH];
+    jlong data[AIO_REAP_BATCH];
+    jlong result[AIO_REAP_BATCH];
+    jint max = (*env)->GetArrayLength(env, userData);
+    if (max > AIO_REAP_BATCH) {
+        max = AIO_REAP_BATCH;
+    }
+    jint count = aio_reap((aio_Engine) (Address) engine, completions, max, min, timeoutNanos);
+    if (count < 0) {
+        throwIOException(env, "aio_reap", -count);
+        return 0;
+    }
+    jint i;
+    for (i = 0; i < count; i++) {
+        data[i] = completions[i].userData;
+        result[i] = completions[i].result;
+    }
+    (*env)->SetLongArrayRegion(env, userData, 0, count, data);
+    (*env)->SetLongArrayRegion(env, results, 0, count, result);
+    return count;
+}
+
+JNIEXPORT void JNICALL
+Java_com_sun_max_vm_io_AsyncIO_close(JNIEnv *env, jclass c, jlong engine) {
+    aio_close((aio_Engine) (Address) engine);
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+/**
+ * An asynchronous I/O engine with explicit submission and completion queues.
+ *
+ * Operations are queued with aio_prepare(), handed to the kernel in batches with aio_submit()
+ * and their results are collected with aio_reap(), which may be called by several threads.
+ * On Linux kernels with io_uring (5.7 or later) each batch costs a single system call.
+ * Elsewhere, or when io_uring is not wanted, the engine falls back to waiting for readiness
+ * with epoll and then performing each operation without blocking.
+ */
+#ifndef __aio_h__
+#define __aio_h__ 1
+
+#include "word.h"
+#include "jni.h"
+
+/*
+ * Operation codes. These must match the constants in AsyncIO.java.
+ */
+#define AIO_READ     0  /* read up to length bytes into buffer, at offset or the current position if offset < 0 */
+#define AIO_WRITE    1  /* write length bytes from buffer, at offset or the current position if offset < 0 */
+#define AIO_ACCEPT   2  /* accept a connection on a listening socket */
+#define AIO_TIMEOUT  3  /* complete after offset nanoseconds */
+
+/*
+ * Engine kinds.
+ */
+#define AIO_EPOLL    0
+#define AIO_URING    1
+
+typedef struct aio_Engine *aio_Engine;
+
+/*
+ * The result of a completed operation: the number of bytes transferred, the accepted file descriptor,
+ * 0 for an expired timeout or a negated errno value if the operation failed.
+ */
+typedef struct {
+    jlong userData;
+    jlong result;
+} aio_Completion;
+
+/**
+ * Creates an engine.
+ *
+ * @param entries the maximum number of operations queued or in flight at any time
+ * @param useUring specifies whether io_uring is to be used if the kernel supports it
+ * @return the engine or NULL, with errno set, if it could not be created
+ */
+extern aio_Engine aio_open(jint entries, jboolean useUring);
+
+/**
+ * Gets the kind of an engine, i.e. AIO_URING or AIO_EPOLL.
+ */
+extern jint aio_getKind(aio_Engine engine);
+
+/**
+ * Queues an operation. It is not started until the next call to aio_submit().
+ *
+ * @return 0 on success, or -1 if the engine already has the maximum number of operations queued or in flight
+ */
+extern jint aio_prepare(aio_Engine engine, jint opcode, jint fd, Address buffer, jint length, jlong offset, jlong userData);
+
+/**
+ * Starts all the operations queued since the last call.
+ *
+ * @return the number of operations started, or a negated errno value
+ */
+extern jint aio_submit(aio_Engine engine);
+
+/**
+ * Collects the results of completed operations.
+ *
+ * @param completions the array in which to store the results
+ * @param max the length of completions
+ * @param min the number of results to wait for
+ * @param timeoutNanos the maximum time to wait for min results, or -1 to wait indefinitely
+ * @return the number of results stored in completions, or a negated errno value
+ */
+extern jint aio_reap(aio_Engine engine, aio_Completion *completions, jint max, jint min, jlong timeoutNanos);
+
+/**
+ * Releases an engine. Operations still in flight are abandoned.
+ */
+extern void aio_close(aio_Engine engine);
+
+#endif /*__aio_h__*/
@@ -316,6 +316,8 @@ static void mapHeapAndCode(int fd) {
         // The address returned might subsequently be used to memory map various regions, including the
         // boot heap region, automatically splitting this mapping.
         // In any case,  the VM (mostly the heap scheme) is responsible for releasing unused reserved space.
+        // As no swap space is reserved for it, native memory tracking records it as reserved heap; only memory
+        // committed within it later is recorded as committed.
         reservedVirtualSpace = virtualMemory_allocatePrivateAnon((Address) 0, virtualSpaceSize, JNI_FALSE, JNI_FALSE, HEAP_VM);
         if (reservedVirtualSpace == ALLOC_FAILED) {
             log_exit(4, "could not reserve requested virtual space");
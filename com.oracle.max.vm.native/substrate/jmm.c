@@ -21,6 +21,9 @@
  * questions.
  */
 
+#include <string.h>
+
+#include "os.h"
 #include "jmm.h"
 
 static void jmm_reserved() {
@@ -31,6 +34,15 @@ static jint jmm_GetVersion(JNIEnv *env) {
 }
 
 static jint jmm_GetOptionalSupport(JNIEnv *env, jmmOptionalSupport* support) {
+    if (support == NULL) {
+        return -1;
+    }
+    memset(support, 0, sizeof(jmmOptionalSupport));
+#if os_LINUX || os_DARWIN
+    /* See native_threadCpuTime() in time.c */
+    support->isCurrentThreadCpuTimeSupported = 1;
+    support->isOtherThreadCpuTimeSupported = 1;
+#endif
     return 0;
 }
 
@@ -27,16 +27,23 @@
  * jvalue array and then call the version of the same JNI function that takes its
  * arguments in such an array. This isolates the implementation of such functions
  * from the platform/compiler dependent way in which varargs are implemented.
+ *
+ * The kinds of a method's arguments are obtained from the VM once per jmethodID and
+ * cached in a table of argument descriptors until the ID of the method's class is released. Methods taking no arguments or a single
+ * int, long or reference argument are marshalled without the copying loop.
  */
 #include <alloca.h>
+#include <sched.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include "log.h"
 #include "kind.h"
 #include "word.h"
 #include "threads.h"
+#include "memory.h"
 
 #include "vm.h"
 
@@ -123,28 +130,216 @@ static void copyVarargsToArray(jvalue *argumentArray, va_list argumentList, int
     }
 }
 
+/*
+ * The ways in which the arguments described by an ArgumentDescriptor are marshalled.
+ */
+#define ARGUMENTS_GENERIC 0
+#define ARGUMENTS_NONE    1
+#define ARGUMENTS_INT     2
+#define ARGUMENTS_LONG    3
+#define ARGUMENTS_WORD    4
+
+/**
+ * The number and kinds of the arguments of the method denoted by a jmethodID.
+ * A descriptor is immutable while it is published in the table.
+ */
+typedef struct ArgumentDescriptor {
+    struct ArgumentDescriptor *next;
+    struct ArgumentDescriptor *nextRetired;
+    jmethodID methodID;
+    int numberOfArguments;
+    int capacity;
+    int marshalling;
+    char kinds[];
+} *ArgumentDescriptor;
+
+#define ARGUMENT_DESCRIPTOR_BUCKETS 1024
+
+/* The number of low bits of a jmethodID that hold the index of the method in its holder (see MemberID.java). */
+#define MEMBER_INDEX_BITS 16
+
+static ArgumentDescriptor argumentDescriptors[ARGUMENT_DESCRIPTOR_BUCKETS];
+
+/*
+ * Descriptors of methods whose holder's class ID has been released. Lookups do not lock and may still
+ * be traversing a retired descriptor, so its memory is not freed but reused for a later descriptor.
+ * The retired list and all changes to the buckets are guarded by argumentDescriptorsLock.
+ */
+static ArgumentDescriptor retiredArgumentDescriptors;
+static volatile int argumentDescriptorsLock;
+
+/**
+ * Returned for a method ID whose arguments could not be determined. The upcall that failed
+ * has left an exception pending which will be thrown by the subsequent call.
+ */
+static struct ArgumentDescriptor noArguments = { NULL, NULL, NULL, 0, 0, ARGUMENTS_NONE };
+
+static void lockArgumentDescriptors(void) {
+    while (__sync_lock_test_and_set(&argumentDescriptorsLock, 1)) {
+        while (argumentDescriptorsLock) {
+            sched_yield();
+        }
+    }
+}
+
+static void unlockArgumentDescriptors(void) {
+    __sync_lock_release(&argumentDescriptorsLock);
+}
+
+static ArgumentDescriptor *argumentDescriptorBucket(jmethodID methodID) {
+    Address hash = ((Address) methodID) * 2654435761U;
+    return &argumentDescriptors[(hash >> 12) & (ARGUMENT_DESCRIPTOR_BUCKETS - 1)];
+}
+
+static ArgumentDescriptor findArgumentDescriptor(ArgumentDescriptor descriptor, jmethodID methodID) {
+    while (descriptor != NULL && __atomic_load_n(&descriptor->methodID, __ATOMIC_ACQUIRE) != methodID) {
+        descriptor = descriptor->next;
+    }
+    return descriptor;
+}
+
+static int argumentMarshalling(int numberOfArguments, char *kinds) {
+    if (numberOfArguments == 0) {
+        return ARGUMENTS_NONE;
+    }
+    if (numberOfArguments == 1) {
+        switch (kinds[0]) {
+            case kind_BYTE:
+            case kind_BOOLEAN:
+            case kind_SHORT:
+            case kind_CHAR:
+            case kind_INT:
+                return ARGUMENTS_INT;
+            case kind_LONG:
+                return ARGUMENTS_LONG;
+            case kind_WORD:
+            case kind_REFERENCE:
+                return ARGUMENTS_WORD;
+        }
+    }
+    return ARGUMENTS_GENERIC;
+}
+
+/*
+ * Gets a retired descriptor with room for a given number of argument kinds or allocates a new one.
+ * Must be called with argumentDescriptorsLock held.
+ */
+static ArgumentDescriptor newArgumentDescriptor(int numberOfArguments) {
+    ArgumentDescriptor *link = &retiredArgumentDescriptors;
+    while (*link != NULL) {
+        ArgumentDescriptor descriptor = *link;
+        if (descriptor->capacity >= numberOfArguments) {
+            *link = descriptor->nextRetired;
+            return descriptor;
+        }
+        link = &descriptor->nextRetired;
+    }
+    ArgumentDescriptor descriptor = (ArgumentDescriptor) memory_allocateTagged(sizeof(struct ArgumentDescriptor) + numberOfArguments, MEMORY_TAG_JNI, false);
+    if (descriptor == NULL) {
+        log_exit(1, "could not allocate JNI argument descriptor");
+    }
+    descriptor->capacity = numberOfArguments;
+    return descriptor;
+}
+
+/**
+ * Gets the argument descriptor for a given method ID, creating and publishing it
+ * on first use. Lookups do not lock; a descriptor is published under a lock, unless
+ * another thread published one for the same method first.
+ */
+static ArgumentDescriptor getArgumentDescriptor(JNIEnv *env, jmethodID methodID) {
+    ArgumentDescriptor *bucket = argumentDescriptorBucket(methodID);
+    ArgumentDescriptor descriptor = findArgumentDescriptor(__atomic_load_n(bucket, __ATOMIC_ACQUIRE), methodID);
+    if (descriptor != NULL) {
+        return descriptor;
+    }
+
+    /* An exception raised by the upcalls below can only be detected if none was already pending */
+    jboolean exceptionPending = (*env)->ExceptionCheck(env);
+    int numberOfArguments = getVMInterface()->GetNumberOfArguments(env, methodID);
+    if (!exceptionPending && (*env)->ExceptionCheck(env)) {
+        return &noArguments;
+    }
+    char *kinds = (char *) alloca(numberOfArguments);
+    getVMInterface()->GetKindsOfArguments(env, methodID, kinds);
+    if (!exceptionPending && (*env)->ExceptionCheck(env)) {
+        return &noArguments;
+    }
+
+    lockArgumentDescriptors();
+    descriptor = findArgumentDescriptor(*bucket, methodID);
+    if (descriptor == NULL) {
+        descriptor = newArgumentDescriptor(numberOfArguments);
+        memcpy(descriptor->kinds, kinds, numberOfArguments);
+        descriptor->numberOfArguments = numberOfArguments;
+        descriptor->marshalling = argumentMarshalling(numberOfArguments, kinds);
+        descriptor->next = *bucket;
+        /* A lookup still traversing a reused descriptor must not match it before it is complete */
+        __atomic_store_n(&descriptor->methodID, methodID, __ATOMIC_RELEASE);
+        __atomic_store_n(bucket, descriptor, __ATOMIC_RELEASE);
+    }
+    unlockArgumentDescriptors();
+    return descriptor;
+}
+
+/**
+ * Retires the argument descriptors of the methods of a class whose ID is being released,
+ * so that a class that is later given the same ID does not find them.
+ *
+ * @param classID the ID of the holder of the methods
+ */
+void jni_releaseArgumentDescriptors(jint classID) {
+    int i;
+    lockArgumentDescriptors();
+    for (i = 0; i < ARGUMENT_DESCRIPTOR_BUCKETS; i++) {
+        ArgumentDescriptor *link = &argumentDescriptors[i];
+        while (*link != NULL) {
+            ArgumentDescriptor descriptor = *link;
+            if ((jint) (((Address) descriptor->methodID) >> MEMBER_INDEX_BITS) == classID) {
+                /* The descriptor keeps its next pointer so that a lookup traversing it still reaches the rest of the bucket */
+                __atomic_store_n(link, descriptor->next, __ATOMIC_RELEASE);
+                __atomic_store_n(&descriptor->methodID, NULL, __ATOMIC_RELEASE);
+                descriptor->nextRetired = retiredArgumentDescriptors;
+                retiredArgumentDescriptors = descriptor;
+            } else {
+                link = &descriptor->next;
+            }
+        }
+    }
+    unlockArgumentDescriptors();
+}
+
 /**
  * Copies the varargs from their platform dependent locations into a jvalue array allocated on
  * the current call stack. This array can then be passed to the corresponding routine that
  * takes such an array of arguments.
  *
- * This copying of arguments allocates two arrays on the stack; a jbyte array for getting
- * the kinds of the arguments and the jvalue array for the copied arguments. The number
- * of arguments is determined by parsing the method's signature.
+ * A method with no arguments or a single int, long or reference argument has its argument
+ * read directly into a single jvalue. Otherwise the arguments are copied into an array
+ * that is stack allocated and so needs no corresponding deallocation.
  */
 #define PREPARE_CALL \
-    int numberOfVarArgs; \
-    jvalue *argumentArray; \
-    char *kinds; \
+    jvalue argument; \
+    jvalue *argumentArray = &argument; \
+    ArgumentDescriptor descriptor = getArgumentDescriptor(env, methodID); \
     \
-    numberOfVarArgs = getVMInterface()->GetNumberOfArguments(env, methodID); \
-    /* Space for array of argument kinds is stack allocated and so needs no corresponding deallocation */ \
-    kinds = (char *) alloca(numberOfVarArgs); \
-    getVMInterface()->GetKindsOfArguments(env, methodID, kinds); \
-    /* Space for arguments is stack allocated and so needs no corresponding deallocation */ \
-    argumentArray = (jvalue *) alloca(sizeof(jvalue) * numberOfVarArgs); \
-    \
-    copyVarargsToArray(argumentArray, argumentList, numberOfVarArgs, kinds);
+    switch (descriptor->marshalling) { \
+        case ARGUMENTS_NONE: \
+            break; \
+        case ARGUMENTS_INT: \
+            argument.i = va_arg(argumentList, jint); \
+            break; \
+        case ARGUMENTS_LONG: \
+            argument.j = va_arg(argumentList, jlong); \
+            break; \
+        case ARGUMENTS_WORD: \
+            *((Word *) &argument) = va_arg(argumentList, Word); \
+            break; \
+        default: \
+            argumentArray = (jvalue *) alloca(sizeof(jvalue) * descriptor->numberOfArguments); \
+            copyVarargsToArray(argumentArray, argumentList, descriptor->numberOfArguments, descriptor->kinds); \
+            break; \
+    }
 
 /*
  * Call<type>Method Routines
@@ -26,6 +26,7 @@
  */
 #include "log.h"
 #include "jni.h"
+#include "threads.h"
 
 #define BUFSIZE 8192
 JNIEXPORT jint JNICALL
@@ -53,6 +54,79 @@ Java_test_bench_threads_JNI_1invocations_nativework(JNIEnv *env, jclass cls, jlo
     return sum;
 }
 
+JNIEXPORT jlong JNICALL
+Java_test_bench_threads_JNI_1invocations_criticalwork(JNIEnv *env, jclass cls, jlong workload) {
+    return Java_test_bench_threads_JNI_1invocations_nativework(env, cls, workload);
+}
+
+/*
+ * Critical implementations take neither the JNIEnv nor the class
+ * and receive each primitive array as its length and element pointer.
+ */
+JNIEXPORT jlong JNICALL
+JavaCritical_test_bench_threads_JNI_1invocations_criticalwork(jlong workload) {
+    return Java_test_bench_threads_JNI_1invocations_nativework(NULL, NULL, workload);
+}
+
+static jlong checksum(jbyte *data, jint length) {
+    jlong sum = 1;
+    int i;
+    for (i = 0; i < length; i++) {
+        sum = sum * 31 + data[i];
+    }
+    return sum;
+}
+
+JNIEXPORT jlong JNICALL
+Java_test_bench_threads_JNI_1invocations_checksum(JNIEnv *env, jclass cls, jbyteArray array) {
+    jsize length = (*env)->GetArrayLength(env, array);
+    jbyte *data = (jbyte *) (*env)->GetPrimitiveArrayCritical(env, array, NULL);
+    if (data == NULL) {
+        return 0;
+    }
+    jlong sum = checksum(data, length);
+    (*env)->ReleasePrimitiveArrayCritical(env, array, data, JNI_ABORT);
+    return sum;
+}
+
+JNIEXPORT jlong JNICALL
+JavaCritical_test_bench_threads_JNI_1invocations_checksum(jint length, jbyte *data) {
+    return checksum(data, length);
+}
+
+JNIEXPORT void JNICALL
+Java_test_bench_threads_Log_1throughput_logRecords(JNIEnv *env, jclass cls, jint records, jint lines) {
+    int record;
+    int line;
+    for (record = 0; record < records; record++) {
+        log_lock();
+        for (line = 0; line < lines; line++) {
+            log_println("Log_throughput: thread %p record %d line %d", thread_self(), record, line);
+        }
+        log_unlock();
+    }
+}
+
+JNIEXPORT jdouble JNICALL
+Java_jtt_jni_JNI_1Callbacks_callbacks(JNIEnv *env, jclass c, jclass cls, jint n) {
+    jmethodID noArgument = (*env)->GetStaticMethodID(env, cls, "noArgument", "()I");
+    jmethodID intArgument = (*env)->GetStaticMethodID(env, cls, "intArgument", "(I)I");
+    jmethodID longArgument = (*env)->GetStaticMethodID(env, cls, "longArgument", "(J)J");
+    jmethodID objectArgument = (*env)->GetStaticMethodID(env, cls, "objectArgument", "(Ljava/lang/Object;)I");
+    jmethodID manyArguments = (*env)->GetStaticMethodID(env, cls, "manyArguments", "(IJLjava/lang/Object;FD)D");
+    jstring s = (*env)->NewStringUTF(env, "XXX");
+    jdouble sum = 0;
+    int i;
+    for (i = 0; i < n; i++) {
+        sum += (*env)->CallStaticIntMethod(env, cls, noArgument);
+        sum += (*env)->CallStaticIntMethod(env, cls, intArgument, i);
+        sum += (*env)->CallStaticLongMethod(env, cls, longArgument, (jlong) i);
+        sum += (*env)->CallStaticIntMethod(env, cls, objectArgument, s);
+        sum += (*env)->CallStaticDoubleMethod(env, cls, manyArguments, i, (jlong) i, s, 0.5f, 0.25);
+    }
+    return sum;
+}
+
 JNIEXPORT void JNICALL
 Java_jtt_jni_JNI_1Nop_nop(JNIEnv *env, jclass c) {
 }
@@ -231,3 +305,73 @@ Java_jtt_jni_JNI_1ManyObjectParameters_manyObjectParameters(JNIEnv *env, jclass
     (*env)->SetObjectArrayElement(env, array, 55, object55);
     return array;
 }
+
+/*
+ * Natives of jtt.jni.JNI_CriticalNatives. The JavaCritical_ implementations are used when the VM binds the
+ * methods to critical implementations, the Java_ ones otherwise.
+ */
+static jint sumInts(jint *values, jint length) {
+    jint sum = 0;
+    int i;
+    for (i = 0; i < length; i++) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+JNIEXPORT jint JNICALL
+Java_jtt_jni_JNI_1CriticalNatives_sum(JNIEnv *env, jclass c, jintArray values) {
+    jint sum;
+    jint *elements;
+    if (values == NULL) {
+        return 0;
+    }
+    elements = (*env)->GetIntArrayElements(env, values, NULL);
+    sum = sumInts(elements, (*env)->GetArrayLength(env, values));
+    (*env)->ReleaseIntArrayElements(env, values, elements, JNI_ABORT);
+    return sum;
+}
+
+JNIEXPORT jint JNICALL
+JavaCritical_jtt_jni_JNI_1CriticalNatives_sum(jint length, jint *values) {
+    if (values == NULL) {
+        return length == 0 ? 0 : -1;
+    }
+    return sumInts(values, length);
+}
+
+JNIEXPORT jint JNICALL
+Java_jtt_jni_JNI_1CriticalNatives_combine(JNIEnv *env, jclass c, jbyteArray a, jint scale, jdoubleArray b) {
+    return (*env)->GetArrayLength(env, a) * 10000 + (*env)->GetArrayLength(env, b) * 100 + scale;
+}
+
+JNIEXPORT jint JNICALL
+JavaCritical_jtt_jni_JNI_1CriticalNatives_combine(jint aLength, jbyte *a, jint scale, jint bLength, jdouble *b) {
+    if (a[0] != 1 || a[2] != 3 || b[0] != 0.5 || b[1] != 0.25) {
+        return -1;
+    }
+    return aLength * 10000 + bLength * 100 + scale;
+}
+
+static jint registeredImpl(JNIEnv *env, jclass c) {
+    return 42;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_jtt_jni_JNI_1CriticalNatives_register(JNIEnv *env, jclass c) {
+    JNINativeMethod method;
+    method.name = "registered";
+    method.signature = "()I";
+    method.fnPtr = (void *) registeredImpl;
+    return (*env)->RegisterNatives(env, c, &method, 1) == 0;
+}
+
+JNIEXPORT jint JNICALL
+Java_jtt_jni_JNI_1CriticalNatives_registered(JNIEnv *env, jclass c) {
+    return 7;
+}
+
+JNIEXPORT jint JNICALL
+JavaCritical_jtt_jni_JNI_1CriticalNatives_registered(void) {
+    return 7;
+}
@@ -37,6 +37,7 @@
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #if os_DARWIN
 #include <sys/poll.h>
 #else
@@ -50,11 +51,17 @@
 #include "threads.h"
 #include "maxine.h"
 #include "memory.h"
+#include "resources.h"
 
 #if os_SOLARIS
 #include <sys/filio.h>
 #endif
 
+#if os_LINUX
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#endif
+
 #if os_DARWIN
 #define lseek64 lseek
 #include <sys/poll.h>
@@ -214,44 +221,22 @@ jlong JVM_FreeMemory(void) {
 jlong
 JVM_MaxMemory(void) {
     JNIEnv *env = currentJniEnv();
-    return vm.MaxMemory(env);
+    jlong maxMemory = vm.MaxMemory(env);
+    /* The heap can never usefully grow beyond the memory limit of the process's container. */
+    jlong memoryLimit = (jlong) resources_getMemoryLimit();
+    if (memoryLimit > 0 && memoryLimit < maxMemory) {
+        return memoryLimit;
+    }
+    return maxMemory;
 }
 
 jlong JVM_TotalMemory(void) {
     return JVM_MaxMemory();
 }
 
-#if os_SOLARIS
-#include <sys/pset.h>
-#endif
-
 jint
 JVM_ActiveProcessorCount(void) {
-#if os_SOLARIS
-    int online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
-    pid_t pid = getpid();
-    psetid_t pset = PS_NONE;
-    // Are we running in a processor set or is there any processor set around?
-    if (pset_bind(PS_QUERY, P_PID, pid, &pset) == 0) {
-        uint_t pset_cpus;
-        // Query the number of cpus available to us.
-        if (pset_info(pset, NULL, &pset_cpus, NULL) == 0) {
-            c_ASSERT(pset_cpus > 0 && pset_cpus <= online_cpus);
-            return pset_cpus;
-        }
-    }
-    // Otherwise return number of online cpus
-    return online_cpus;
-#elif os_LINUX || os_DARWIN
-    // Linux doesn't yet have a (official) notion of processor sets,
-    // so just return the number of online processors.
-    int online_cpus = sysconf(_SC_NPROCESSORS_ONLN);
-    c_ASSERT(online_cpus > 0);
-    return online_cpus;
-#else
-    UNIMPLEMENTED();
-    return 0;
-#endif
+    return resources_getActiveProcessorCount();
 }
 
 #if os_SOLARIS || os_LINUX || os_DARWIN
@@ -1790,7 +1775,7 @@ JVM_Write(jint fd, char *buf, jint nbytes) {
  * descriptor
  */
 jint JVM_Available(jint fd, jlong *pbytes) {
-    jlong cur, end;
+    jlong cur;
 
     struct stat st;
     if (fstat(fd, &st) >= 0) {
@@ -1800,8 +1785,16 @@ jint JVM_Available(jint fd, jlong *pbytes) {
                 *pbytes = n;
                 return 1;
             }
+        } else if (S_ISREG(st.st_mode)) {
+            // The size from fstat() saves seeking to the end of the file and back.
+            if ((cur = lseek64(fd, 0L, SEEK_CUR)) == -1) {
+                return 0;
+            }
+            *pbytes = cur < st.st_size ? st.st_size - cur : 0;
+            return 1;
         }
     }
+    jlong end;
     if ((cur = lseek64(fd, 0L, SEEK_CUR)) == -1) {
         return 0;
     } else if ((end = lseek64(fd, 0L, SEEK_END)) == -1) {
@@ -1847,6 +1840,308 @@ JVM_Sync(jint fd) {
     return fsync(fd);
 }
 
+/*
+ * Positional and vectored file I/O. These are not part of HotSpot's JVM interface, but are
+ * called by com.sun.max.vm.io.FileIO. None of them uses or moves the file pointer.
+ * Unless stated otherwise they return -1 on error, with errno set.
+ */
+
+/*
+ * Read data from a file descriptor at a given offset.
+ *
+ * fd        the file descriptor to read from.
+ * buf       the buffer where to put the read data.
+ * nbytes    the number of bytes to read.
+ * offset    the offset in the file from which to read.
+ *
+ * This function returns the number of bytes read, 0 at end of file.
+ */
+jint
+JVM_PRead(jint fd, char *buf, jint nbytes, jlong offset) {
+    ssize_t n;
+    do {
+        n = pread(fd, buf, (size_t) nbytes, (off_t) offset);
+    } while (n == -1 && errno == EINTR);
+    return (jint) n;
+}
+
+/*
+ * Write data to a file descriptor at a given offset.
+ *
+ * This function returns the number of bytes written.
+ */
+jint
+JVM_PWrite(jint fd, char *buf, jint nbytes, jlong offset) {
+    ssize_t n;
+    do {
+        n = pwrite(fd, buf, (size_t) nbytes, (off_t) offset);
+    } while (n == -1 && errno == EINTR);
+    return (jint) n;
+}
+
+/*
+ * Scatter read from a file descriptor at a given offset into iovcnt buffers described by iov.
+ *
+ * This function returns the total number of bytes read, 0 at end of file.
+ */
+jlong
+JVM_PReadV(jint fd, struct iovec *iov, jint iovcnt, jlong offset) {
+    ssize_t n;
+#if os_LINUX || os_SOLARIS
+    do {
+        n = preadv(fd, iov, iovcnt, (off_t) offset);
+    } while (n == -1 && errno == EINTR);
+#else
+    jint i;
+    jlong total = 0;
+    for (i = 0; i < iovcnt; i++) {
+        n = JVM_PRead(fd, iov[i].iov_base, (jint) iov[i].iov_len, offset + total);
+        if (n <= 0) {
+            return total == 0 ? n : total;
+        }
+        total += n;
+        if ((size_t) n < iov[i].iov_len) {
+            break;
+        }
+    }
+    n = total;
+#endif
+    return (jlong) n;
+}
+
+/*
+ * Gather write to a file descriptor at a given offset from iovcnt buffers described by iov.
+ *
+ * This function returns the total number of bytes written.
+ */
+jlong
+JVM_PWriteV(jint fd, struct iovec *iov, jint iovcnt, jlong offset) {
+    ssize_t n;
+#if os_LINUX || os_SOLARIS
+    do {
+        n = pwritev(fd, iov, iovcnt, (off_t) offset);
+    } while (n == -1 && errno == EINTR);
+#else
+    jint i;
+    jlong total = 0;
+    for (i = 0; i < iovcnt; i++) {
+        n = JVM_PWrite(fd, iov[i].iov_base, (jint) iov[i].iov_len, offset + total);
+        if (n < 0) {
+            return total == 0 ? n : total;
+        }
+        total += n;
+        if ((size_t) n < iov[i].iov_len) {
+            break;
+        }
+    }
+    n = total;
+#endif
+    return (jlong) n;
+}
+
+#define JVM_COPY_BUFFER_SIZE (64 * 1024)
+
+/*
+ * Copies through a user space buffer, for when the kernel cannot copy between the two descriptors.
+ * outOffset is -1 to write at (and advance) the current position of outFd.
+ */
+static jlong copyWithBuffer(jint inFd, jlong inOffset, jint outFd, jlong outOffset, jlong count) {
+    char buffer[JVM_COPY_BUFFER_SIZE];
+    jlong total = 0;
+    while (total < count) {
+        jint chunk = count - total < JVM_COPY_BUFFER_SIZE ? (jint) (count - total) : JVM_COPY_BUFFER_SIZE;
+        jint n = JVM_PRead(inFd, buffer, chunk, inOffset + total);
+        if (n <= 0) {
+            return total == 0 ? n : total;
+        }
+        jint written = 0;
+        while (written < n) {
+            jint w = outOffset < 0 ? (jint) write(outFd, buffer + written, n - written) : JVM_PWrite(outFd, buffer + written, n - written, outOffset + total + written);
+            if (w < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return total + written == 0 ? -1 : total + written;
+            }
+            written += w;
+        }
+        total += n;
+    }
+    return total;
+}
+
+/*
+ * Copies a range of a file to a higher, overlapping range of the same file through a user space buffer,
+ * starting from the end so that no byte is overwritten before it has been read. The range is clipped
+ * to the end of the file. As the range is not copied from its start, a failure part way through
+ * returns -1 rather than the number of bytes copied.
+ */
+static jlong copyWithBufferBackward(jint fd, jlong inOffset, jlong outOffset, jlong count, jlong fileSize) {
+    char buffer[JVM_COPY_BUFFER_SIZE];
+    if (inOffset >= fileSize) {
+        return 0;
+    }
+    if (count > fileSize - inOffset) {
+        count = fileSize - inOffset;
+    }
+    jlong remaining = count;
+    while (remaining > 0) {
+        jint chunk = remaining < JVM_COPY_BUFFER_SIZE ? (jint) remaining : JVM_COPY_BUFFER_SIZE;
+        jlong position = remaining - chunk;
+        jint n = JVM_PRead(fd, buffer, chunk, inOffset + position);
+        if (n != chunk) {
+            if (n >= 0) {
+                errno = EIO;
+            }
+            return -1;
+        }
+        jint written = 0;
+        while (written < n) {
+            jint w = JVM_PWrite(fd, buffer + written, n - written, outOffset + position + written);
+            if (w < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -1;
+            }
+            written += w;
+        }
+        remaining -= chunk;
+    }
+    return count;
+}
+
+/*
+ * Transfer up to count bytes from a file at a given offset to another file descriptor,
+ * which may be a socket or pipe, at its current position. The data is not copied
+ * through user space where the platform supports it (sendfile(2)).
+ *
+ * This function returns the number of bytes transferred, 0 at end of file.
+ */
+jlong
+JVM_SendFile(jint outFd, jint inFd, jlong offset, jlong count) {
+#if os_LINUX
+    off_t off = (off_t) offset;
+    ssize_t n;
+    do {
+        n = sendfile(outFd, inFd, &off, (size_t) count);
+    } while (n == -1 && errno == EINTR);
+    if (n >= 0 || (errno != EINVAL && errno != ENOSYS)) {
+        return (jlong) n;
+    }
+#endif
+    return copyWithBuffer(inFd, offset, outFd, -1, count);
+}
+
+/*
+ * Copy up to count bytes between two files at the given offsets. Where the platform supports it
+ * (copy_file_range(2)) the copy is done in the kernel and may be shared or offloaded by the file system.
+ *
+ * This function returns the number of bytes copied, 0 at end of file.
+ */
+jlong
+JVM_CopyFileRange(jint inFd, jlong inOffset, jint outFd, jlong outOffset, jlong count) {
+#if os_LINUX && defined(SYS_copy_file_range)
+    loff_t in = (loff_t) inOffset;
+    loff_t out = (loff_t) outOffset;
+    long n;
+    do {
+        n = syscall(SYS_copy_file_range, inFd, &in, outFd, &out, (size_t) count, 0);
+    } while (n == -1 && errno == EINTR);
+    if (n >= 0 || (errno != EXDEV && errno != ENOSYS && errno != EINVAL && errno != EOPNOTSUPP)) {
+        return (jlong) n;
+    }
+#endif
+    if (outOffset > inOffset && outOffset - inOffset < count) {
+        struct stat inStat;
+        struct stat outStat;
+        if (fstat(inFd, &inStat) == 0 && fstat(outFd, &outStat) == 0 && inStat.st_dev == outStat.st_dev && inStat.st_ino == outStat.st_ino) {
+            /* Copying forwards would overwrite the source before it is read. A copy to a lower offset is safe
+             * forwards as each chunk is read before any byte at or above it is written. */
+            return copyWithBufferBackward(outFd, inOffset, outOffset, count, (jlong) inStat.st_size);
+        }
+    }
+    return copyWithBuffer(inFd, inOffset, outFd, outOffset, count);
+}
+
+/*
+ * Values of the advice argument to JVM_FAdvise. These must match the constants in FileIO.java.
+ */
+#define JVM_FADV_NORMAL      0
+#define JVM_FADV_SEQUENTIAL  1
+#define JVM_FADV_RANDOM      2
+#define JVM_FADV_WILLNEED    3
+#define JVM_FADV_DONTNEED    4
+#define JVM_FADV_NOREUSE     5
+
+/*
+ * Announce the intended access pattern for a range of a file (posix_fadvise(2)).
+ * This is only a hint: it returns 0 if the platform does not support it.
+ */
+jint
+JVM_FAdvise(jint fd, jlong offset, jlong length, jint advice) {
+#if os_LINUX || os_SOLARIS
+    static const int advices[] = {
+        POSIX_FADV_NORMAL, POSIX_FADV_SEQUENTIAL, POSIX_FADV_RANDOM,
+        POSIX_FADV_WILLNEED, POSIX_FADV_DONTNEED, POSIX_FADV_NOREUSE
+    };
+    if (advice < 0 || advice >= (jint) ARRAY_LENGTH(advices)) {
+        errno = EINVAL;
+        return -1;
+    }
+    int error = posix_fadvise(fd, (off_t) offset, (off_t) length, advices[advice]);
+    if (error != 0) {
+        errno = error;
+        return -1;
+    }
+#endif
+    return 0;
+}
+
+static jlong checkIOResult(JNIEnv *env, jlong result, const char *operation) {
+    if (result < 0) {
+        char message[256];
+        snprintf(message, sizeof(message), "%s failed: %s", operation, strerror(errno));
+        (*env)->ThrowNew(env, (*env)->FindClass(env, "java/io/IOException"), message);
+    }
+    return result;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_sun_max_vm_io_FileIO_pread(JNIEnv *env, jclass c, jint fd, jlong address, jint length, jlong offset) {
+    return (jint) checkIOResult(env, JVM_PRead(fd, (char *) address, length, offset), "pread");
+}
+
+JNIEXPORT jint JNICALL
+Java_com_sun_max_vm_io_FileIO_pwrite(JNIEnv *env, jclass c, jint fd, jlong address, jint length, jlong offset) {
+    return (jint) checkIOResult(env, JVM_PWrite(fd, (char *) address, length, offset), "pwrite");
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_sun_max_vm_io_FileIO_preadv(JNIEnv *env, jclass c, jint fd, jlong iov, jint iovcnt, jlong offset) {
+    return checkIOResult(env, JVM_PReadV(fd, (struct iovec *) iov, iovcnt, offset), "preadv");
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_sun_max_vm_io_FileIO_pwritev(JNIEnv *env, jclass c, jint fd, jlong iov, jint iovcnt, jlong offset) {
+    return checkIOResult(env, JVM_PWriteV(fd, (struct iovec *) iov, iovcnt, offset), "pwritev");
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_sun_max_vm_io_FileIO_sendfile(JNIEnv *env, jclass c, jint outFd, jint inFd, jlong offset, jlong count) {
+    return checkIOResult(env, JVM_SendFile(outFd, inFd, offset, count), "sendfile");
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_sun_max_vm_io_FileIO_copyFileRange(JNIEnv *env, jclass c, jint inFd, jlong inOffset, jint outFd, jlong outOffset, jlong count) {
+    return checkIOResult(env, JVM_CopyFileRange(inFd, inOffset, outFd, outOffset, count), "copy_file_range");
+}
+
+JNIEXPORT void JNICALL
+Java_com_sun_max_vm_io_FileIO_fadvise(JNIEnv *env, jclass c, jint fd, jlong offset, jlong length, jint advice) {
+    checkIOResult(env, JVM_FAdvise(fd, offset, length, advice), "posix_fadvise");
+}
+
 /*
  * Networking library support
  */
@@ -43,6 +43,7 @@
 #include "os.h"
 #include "vm.h"
 #include "virtualMemory.h"
+#include "resources.h"
 
 #include "maxine.h"
 
@@ -73,6 +74,62 @@ static void max_fd_limit() {
 }
 
 
+/**
+ * Parses a size option value such as "2m", "1G" or "4096" into a number of bytes, returning 0 if it is malformed.
+ */
+static Size parseSize(const char *value) {
+    char *end;
+    Size result = (Size) strtoull(value, &end, 10);
+    switch (*end) {
+        case 'g': case 'G': result <<= 10;
+        /* fall through */
+        case 'm': case 'M': result <<= 10;
+        /* fall through */
+        case 'k': case 'K': result <<= 10;
+            end++;
+            break;
+    }
+    return *end == '\0' ? result : 0;
+}
+
+/**
+ * Applies the options that must take effect before the boot image is mapped, i.e. before the VM parses them.
+ * They are left in place so that the VM can still see them; see VirtualMemory.java and VMOptions.java.
+ */
+static void applyNativeOptions(int argc, char *argv[]) {
+    jboolean useLargePages = JNI_FALSE;
+    jboolean transparent = JNI_FALSE;
+    Size largePageSize = 0;
+    jboolean logBuffered = JNI_FALSE;
+    int i;
+    for (i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (arg == NULL) {
+            continue;
+        } else if (strcmp(arg, "-XX:+UseLargePages") == 0) {
+            useLargePages = JNI_TRUE;
+        } else if (strcmp(arg, "-XX:-UseLargePages") == 0) {
+            useLargePages = JNI_FALSE;
+        } else if (strcmp(arg, "-XX:+UseTransparentHugePages") == 0) {
+            transparent = JNI_TRUE;
+        } else if (strcmp(arg, "-XX:-UseTransparentHugePages") == 0) {
+            transparent = JNI_FALSE;
+        } else if (strncmp(arg, "-XX:LargePageSizeInBytes=", 25) == 0) {
+            largePageSize = parseSize(arg + 25);
+        } else if (strncmp(arg, "-XX:ActiveProcessorCount=", 25) == 0) {
+            resources_setActiveProcessorCount(atoi(arg + 25));
+        } else if (strcmp(arg, "-XX:+LogBuffered") == 0) {
+            logBuffered = JNI_TRUE;
+        } else if (strcmp(arg, "-XX:-LogBuffered") == 0) {
+            logBuffered = JNI_FALSE;
+        }
+    }
+    if (logBuffered) {
+        log_enableBuffering();
+    }
+    virtualMemory_initializeLargePages(useLargePages, transparent, largePageSize);
+}
+
 #define IMAGE_FILE_NAME  "maxine.vm"
 #define DARWIN_STACK_ALIGNMENT ((Address) 16)
 
@@ -344,6 +401,8 @@ int maxine(int argc, char *argv[], char *executablePath) {
 #endif
     max_fd_limit();
 
+    applyNativeOptions(argc, argv);
+
     loadImage();
 
     tla_initialize(image_header()->tlaSize);
@@ -401,6 +460,8 @@ void native_exit(jint code) {
     // which can cause a recursive crash.
     if (code != 11) {
         cleanupCurrentThreadBlockBeforeExit();
+    } else {
+        log_flushOnFatalError();
     }
     exit(code);
 }
@@ -410,6 +471,7 @@ void core_dump() {
     log_print("dumping core....\n  heap @ ");
     log_print_symbol(image_heap());
     log_print_newline();
+    log_flushOnFatalError();
     // Use kill instead of abort so the vm process keeps running after the core is created.
     kill(getpid(), SIGABRT);
     sleep(3);
@@ -25,9 +25,13 @@
 
 #include "os.h"
 #include "jni.h"
+#include "word.h"
 
 extern jlong native_nanoTime(void);
 extern jlong native_currentTimeMillis(void);
+extern jlong native_threadCpuTime(Address nativeThread, jboolean userOnly);
+extern jlong native_threadCpuTimeHandle(Address nativeThread);
+extern jlong native_threadCpuTimeOfHandle(jlong handle, jboolean userOnly);
 extern void *native_executablePath(void);
 extern void  native_exit(int code);
 extern void *native_environment(void);
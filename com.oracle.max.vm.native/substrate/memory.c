@@ -26,37 +26,291 @@
 #include <sys/mman.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sched.h>
 
 #include "word.h"
 #include "jni.h"
 #include "memory.h"
 #include "virtualMemory.h"
+#include "nativeMemory.h"
 #include "log.h"
 
+/*
+ * VM-internal native memory is allocated from size-segregated arenas. Each thread caches
+ * a bounded number of free blocks per size class so that the common allocation and
+ * deallocation paths take no lock. Blocks too large for a size class are delegated to
+ * malloc(3). Every block is preceded by a header recording its size class, accounting tag
+ * and requested size, so that deallocation needs no lookup and native memory tracking
+ * always knows the live bytes of each tag.
+ */
+
+/* The header size preserves the alignment malloc(3) guarantees for the returned memory. */
+#define HEADER_SIZE 16
+#define HEADER_MAGIC 0x4d41
+#define LARGE_CLASS 0xff
+
+/* The largest request whose block size, header included, does not wrap around. */
+#define MAX_REQUEST_SIZE (((Size) -1) - HEADER_SIZE)
+
+typedef struct BlockHeader {
+    Unsigned2 magic;
+    Unsigned1 sizeClass;
+    Unsigned1 tag;
+    Size size;
+} *BlockHeader;
+
+#define HEADER(pointer) ((BlockHeader) ((pointer) - HEADER_SIZE))
+
+/* Block sizes (header included) of the size classes. */
+static const Size classSizes[] = {
+    32, 48, 64, 80, 96, 128, 160, 192, 256, 320, 384, 512, 640, 768, 1024, 1280, 1536, 2048, 2560, 3072, 4096
+};
+
+#define NUMBER_OF_CLASSES ((int) ARRAY_LENGTH(classSizes))
+#define MAX_SMALL_BLOCK_SIZE 4096
+#define ARENA_CHUNK_SIZE (1024 * 1024)
+
+/* The number of blocks moved between a thread cache and the shared free lists in one go. */
+#define BATCH_BYTES (16 * 1024)
+#define MIN_BATCH 4
+#define MAX_BATCH 64
+
+#if os_MAXVE
+/* No thread local storage: all allocation is delegated to the native allocator. */
+#define USE_ARENAS 0
+#define THREAD_LOCAL
+#else
+#define USE_ARENAS 1
+#define THREAD_LOCAL __thread
+#endif
+
+typedef struct ThreadCache {
+    Address head[NUMBER_OF_CLASSES];
+    jint count[NUMBER_OF_CLASSES];
+} ThreadCache;
+
+static THREAD_LOCAL ThreadCache threadCache;
+
+/* Maps a block size rounded up to 16 bytes, divided by 16, to the index of its size class. */
+static Unsigned1 classIndex[MAX_SMALL_BLOCK_SIZE / 16 + 1];
+static volatile boolean classIndexInitialized;
+
+/* State shared by all threads, guarded by arenaLock. */
+static volatile int arenaLock;
+static Address freeLists[NUMBER_OF_CLASSES];
+static Address arenaTop;
+static Address arenaEnd;
+
+static void lockArenas(void) {
+    while (__sync_lock_test_and_set(&arenaLock, 1)) {
+        while (arenaLock) {
+            sched_yield();
+        }
+    }
+}
+
+static void unlockArenas(void) {
+    __sync_lock_release(&arenaLock);
+}
+
+static void initializeClassIndex(void) {
+    int c = 0;
+    unsigned int i;
+    for (i = 0; i < ARRAY_LENGTH(classIndex); i++) {
+        while (classSizes[c] < i * 16) {
+            c++;
+        }
+        classIndex[i] = (Unsigned1) c;
+    }
+    classIndexInitialized = true;
+}
+
+static inline int batchSize(int c) {
+    int n = BATCH_BYTES / classSizes[c];
+    return n < MIN_BATCH ? MIN_BATCH : (n > MAX_BATCH ? MAX_BATCH : n);
+}
+
+/**
+ * Moves a batch of free blocks of size class {@code c} into a thread cache, carving new blocks
+ * from the current arena chunk if the shared free list runs dry.
+ *
+ * @return false if no memory could be obtained
+ */
+static boolean refill(ThreadCache *cache, int c) {
+    const Size blockSize = classSizes[c];
+    int n = batchSize(c);
+    lockArenas();
+    while (n > 0 && freeLists[c] != 0) {
+        Address block = freeLists[c];
+        freeLists[c] = *((Address *) block);
+        *((Address *) block) = cache->head[c];
+        cache->head[c] = block;
+        cache->count[c]++;
+        n--;
+    }
+    while (n > 0) {
+        if (arenaTop + blockSize > arenaEnd) {
+            Address chunk = virtualMemory_allocate(ARENA_CHUNK_SIZE, MALLOC_VM);
+            if (chunk == ALLOC_FAILED) {
+                break;
+            }
+            arenaTop = chunk;
+            arenaEnd = chunk + ARENA_CHUNK_SIZE;
+        }
+        Address block = arenaTop;
+        arenaTop += blockSize;
+        *((Address *) block) = cache->head[c];
+        cache->head[c] = block;
+        cache->count[c]++;
+        n--;
+    }
+    unlockArenas();
+    return cache->head[c] != 0;
+}
+
+/**
+ * Returns a batch of the blocks of size class {@code c} in a thread cache to the shared free list.
+ */
+static void flush(ThreadCache *cache, int c, int n) {
+    Address first = cache->head[c];
+    Address last = first;
+    int i;
+    if (first == 0 || n <= 0) {
+        return;
+    }
+    for (i = 1; i < n && *((Address *) last) != 0; i++) {
+        last = *((Address *) last);
+    }
+    cache->head[c] = *((Address *) last);
+    cache->count[c] -= i;
+    lockArenas();
+    *((Address *) last) = freeLists[c];
+    freeLists[c] = first;
+    unlockArenas();
+}
+
+Address memory_allocateTagged(Size size, jint tag, jboolean zero) {
+    Address block;
+    int c = LARGE_CLASS;
+    if (size > MAX_REQUEST_SIZE) {
+        return 0;
+    }
+    const Size blockSize = size + HEADER_SIZE;
+    if (tag < 0 || tag >= MEMORY_TAG_COUNT) {
+        tag = MEMORY_TAG_UNKNOWN;
+    }
+    if (USE_ARENAS && blockSize <= MAX_SMALL_BLOCK_SIZE) {
+        ThreadCache *cache = &threadCache;
+        if (!classIndexInitialized) {
+            initializeClassIndex();
+        }
+        c = classIndex[(blockSize + 15) >> 4];
+        block = cache->head[c];
+        if (block == 0) {
+            if (!refill(cache, c)) {
+                return 0;
+            }
+            block = cache->head[c];
+        }
+        cache->head[c] = *((Address *) block);
+        cache->count[c]--;
+        if (zero) {
+            memset((void *) (block + HEADER_SIZE), 0, (size_t) size);
+        }
+    } else {
+        block = (Address) (zero ? calloc(1, (size_t) blockSize) : malloc((size_t) blockSize));
+        if (block == 0) {
+            return 0;
+        }
+        nativeMemory_reserve(MALLOC_VM, blockSize, JNI_TRUE);
+    }
+    BlockHeader header = (BlockHeader) block;
+    header->magic = HEADER_MAGIC;
+    header->sizeClass = (Unsigned1) c;
+    header->tag = (Unsigned1) tag;
+    header->size = size;
+    nativeMemory_recordMalloc(tag, size);
+    return block + HEADER_SIZE;
+}
+
 Address memory_allocate(Size size)
 {
-    Address mem = (Address) calloc(1, (size_t) size);
-    if (mem % sizeof(void *)) {
-        log_println("MEMORY ALLOCATED NOT WORD-ALIGNED (size:%d at address:%x, void* size: %d)", size, mem, sizeof(void *));
-    }
-    return mem;
+    return memory_allocateTagged(size, MEMORY_TAG_UNKNOWN, true);
 }
 
 Address memory_reallocate(Address pointer, Size size)
 {
-    Address mem;
-	if (pointer == 0) {
-		mem = (Address) calloc(1, (size_t) size);
-	} else {
-	    mem = (Address) realloc((void *) pointer, (size_t) size);
-	}
-	//log_println("MEMORY ALLOCATED of size:%d at address:%x", size, mem);
-    return mem;
+    if (pointer == 0) {
+        return memory_allocateTagged(size, MEMORY_TAG_UNKNOWN, true);
+    }
+    if (size > MAX_REQUEST_SIZE) {
+        return 0;
+    }
+    BlockHeader header = HEADER(pointer);
+    c_ASSERT(header->magic == HEADER_MAGIC);
+    const jint tag = header->tag;
+    const Size oldSize = header->size;
+    if (header->sizeClass == LARGE_CLASS && size + HEADER_SIZE > MAX_SMALL_BLOCK_SIZE) {
+        BlockHeader newHeader = (BlockHeader) realloc((void *) header, (size_t) (size + HEADER_SIZE));
+        if (newHeader == NULL) {
+            return 0;
+        }
+        nativeMemory_release(MALLOC_VM, oldSize + HEADER_SIZE, oldSize + HEADER_SIZE);
+        nativeMemory_reserve(MALLOC_VM, size + HEADER_SIZE, JNI_TRUE);
+        nativeMemory_recordRealloc(tag, oldSize, size);
+        newHeader->size = size;
+        return ((Address) newHeader) + HEADER_SIZE;
+    }
+    if (header->sizeClass != LARGE_CLASS && size + HEADER_SIZE <= classSizes[header->sizeClass]) {
+        nativeMemory_recordRealloc(tag, oldSize, size);
+        header->size = size;
+        return pointer;
+    }
+    Address result = memory_allocateTagged(size, tag, false);
+    if (result != 0) {
+        memcpy((void *) result, (const void *) pointer, (size_t) (oldSize < size ? oldSize : size));
+        memory_deallocate(pointer);
+    }
+    return result;
 }
 
 jint memory_deallocate(Address pointer)
 {
-    free((void *) pointer);
-    //log_println("MEMORY FREED at address: %x", pointer);
+    if (pointer == 0) {
+        return 0;
+    }
+    BlockHeader header = HEADER(pointer);
+    c_ASSERT(header->magic == HEADER_MAGIC);
+    const int c = header->sizeClass;
+    header->magic = 0;
+    nativeMemory_recordFree(header->tag, header->size);
+    if (c == LARGE_CLASS) {
+        nativeMemory_release(MALLOC_VM, header->size + HEADER_SIZE, header->size + HEADER_SIZE);
+        free((void *) header);
+    } else {
+        ThreadCache *cache = &threadCache;
+        Address block = (Address) header;
+        *((Address *) block) = cache->head[c];
+        cache->head[c] = block;
+        if (++cache->count[c] > 2 * batchSize(c)) {
+            flush(cache, c, batchSize(c));
+        }
+    }
     return 0;
 }
+
+void memory_threadTerminated(void)
+{
+#if USE_ARENAS
+    ThreadCache *cache = &threadCache;
+    int c;
+    for (c = 0; c < NUMBER_OF_CLASSES; c++) {
+        flush(cache, c, cache->count[c]);
+    }
+#endif
+}
+
+void memory_copy(Address from, Address to, Size size)
+{
+    memcpy((void *) to, (const void *) from, (size_t) size);
+}
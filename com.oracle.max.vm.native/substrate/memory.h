@@ -24,4 +24,48 @@
 #ifndef MEMORY_H_
 #define MEMORY_H_
 
+#include "word.h"
+#include "jni.h"
+
+/*
+ * Accounting tags for VM-internal native memory. These must be kept in sync with
+ * the constants of the com.sun.max.memory.Memory.Tag enum.
+ */
+#define MEMORY_TAG_UNKNOWN 0
+#define MEMORY_TAG_JNI 1
+#define MEMORY_TAG_STRING 2
+#define MEMORY_TAG_MONITOR 3
+#define MEMORY_TAG_IO 4
+#define MEMORY_TAG_UNSAFE 5
+#define MEMORY_TAG_LOG 6
+#define MEMORY_TAG_GC 7
+#define MEMORY_TAG_VM 8
+#define MEMORY_TAG_TEST 9
+#define MEMORY_TAG_COUNT 10
+
+/**
+ * Allocates zeroed memory accounted to MEMORY_TAG_UNKNOWN.
+ */
+extern Address memory_allocate(Size size);
+
+/**
+ * Allocates word aligned memory. Small blocks are served from per-thread caches of size-segregated
+ * arena blocks so that the common case takes no lock.
+ *
+ * @param size the number of bytes requested
+ * @param tag the MEMORY_TAG_* to which the allocation is accounted
+ * @param zero specifies if the returned memory must be zeroed
+ * @return the allocated memory or 0 if the allocation failed
+ */
+extern Address memory_allocateTagged(Size size, jint tag, jboolean zero);
+
+extern Address memory_reallocate(Address pointer, Size size);
+extern jint memory_deallocate(Address pointer);
+extern void memory_copy(Address from, Address to, Size size);
+
+/**
+ * Returns the blocks cached by the current thread to the shared arenas. Called when a thread terminates.
+ */
+extern void memory_threadTerminated(void);
+
 #endif /* MEMORY_H_ */
@@ -23,66 +23,9 @@
 #include "jni.h"
 #include "os.h"
 
-#if os_LINUX || os_DARWIN
-#   include <unistd.h>
-#elif os_SOLARIS
-#   include <sys/types.h>
-#   include <sys/pset.h>
-#   include <unistd.h>
-#elif os_MAXVE
-#   include <maxve.h>
-#elif os_WINDOWS
-	// TODO if we ever want to support MS Windows
-#endif
+#include "resources.h"
 
-/*
- * Mostly copied from HotSpot.
- */
 JNIEXPORT jint JNICALL
 Java_java_lang_Runtime_availableProcessors(JNIEnv *env, jclass c, jobject runtime) {
-#if os_LINUX || os_DARWIN
-
-	// Cannot find out active processors, so just return the number of online processors:
-	return sysconf(_SC_NPROCESSORS_ONLN);
-
-#elif os_SOLARIS
-
-	  pid_t pid = getpid();
-	  psetid_t pset = PS_NONE;
-	  // Are we running in a processor set?
-	  if (pset_bind(PS_QUERY, P_PID, pid, &pset) == 0) {
-	    if (pset != PS_NONE) {
-	      uint_t cardinality;
-	      // Determine the number of CPUs in the processor set:
-	      if (pset_info(pset, NULL, &cardinality, NULL) == 0) {
-   	          return cardinality;
-	      }
-	    }
-	  }
-	  // Not in a processor set.
-	  // Return the number of online CPUs:
-	  return sysconf(_SC_NPROCESSORS_ONLN);
-
-#elif os_WINDOWS
-	SYSTEM_INFO si;
-	DWORD_PTR processAffinityMaskPointer = 0;
-	DWORD_PTR systemAffinityMaskPointer = 0;
-
-	GetSystemInfo(&si);
-	if (si.dwNumberOfProcessors <= sizeof(UINT_PTR) * BitsPerByte &&
-	        GetProcessAffinityMask(GetCurrentProcess(), &processAffinityMaskPointer, &systemAffinityMaskPointer)) {
-		 // The number of active processors is determined as the number of bits in the process affinity mask:
-	    int numberOfBits = 0;
-	    while (processAffinityMaskPointer != 0) {
-	        processAffinityMaskPointer = processAffinityMaskPointer & (processAffinityMaskPointer - 1);
-	        numberOfBits++;
-	    }
-	    return numberOfBits;
-	}
-	return si.dwNumberOfProcessors;
-#elif os_MAXVE
-	return maxve_numProcessors();
-#else
-	c_UNIMPLEMENTED();
-#endif
+    return resources_getActiveProcessorCount();
 }
@@ -26,8 +26,8 @@ PROJECT = ../../..
 LIB = jvm
 
 SOURCES = c.c condition.c log.c image.c $(ISA).c jni.c jvm.c maxine.c memory.c mutex.c \
-          relocation.c dataio.c runtime.c  snippet.c threads.c threadLocals.c time.c trap.c \
-          virtualMemory.c jnitests.c sync.c signal.c jmm.c jvmti.c
+          relocation.c resources.c aio.c dataio.c runtime.c  snippet.c threads.c threadLocals.c time.c trap.c utf8.c \
+          virtualMemory.c nativeMemory.c jnitests.c sync.c signal.c jmm.c jvmti.c
 
 SOURCE_DIRS = platform share substrate
 
@@ -22,6 +22,7 @@
  */
 #include "os.h"
 #include "jni.h"
+#include "word.h"
 #include "maxine.h"
 
 #include <sys/types.h>
@@ -30,8 +31,18 @@
 #if os_DARWIN
 #include <mach/mach_time.h>
 #include <mach/kern_return.h>
+#include <mach/mach.h>
+#include <pthread.h>
 #elif os_LINUX
 #include <dlfcn.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
 #endif
 
 
@@ -130,3 +141,160 @@ jlong native_currentTimeMillis(void) {
 	return 1;
 #endif
 }
+
+#if os_LINUX
+/**
+ * Formats a non-negative number into the end of a buffer, returning a pointer to its first digit.
+ */
+static char *formatDecimal(char *end, int value) {
+    char *s = end;
+    do {
+        *--s = '0' + (value % 10);
+        value /= 10;
+    } while (value != 0);
+    return s;
+}
+
+/**
+ * Gets the user mode CPU time of a thread other than the current thread from /proc.
+ * The kernel only reports this time with clock tick granularity.
+ * This is called from C_FUNCTION natives, i.e. without a thread state transition, so the
+ * file is read with the raw system calls into a stack buffer rather than with stdio.
+ */
+static jlong threadUserTimeFromProc(pid_t tid) {
+    static const char prefix[] = "/proc/self/task/";
+    static const char suffix[] = "/stat";
+    char path[64];
+    char digits[16];
+    char buf[512];
+    char *tidString = formatDecimal(digits + sizeof(digits), (int) tid);
+    size_t tidLength = digits + sizeof(digits) - tidString;
+    memcpy(path, prefix, sizeof(prefix) - 1);
+    memcpy(path + sizeof(prefix) - 1, tidString, tidLength);
+    memcpy(path + sizeof(prefix) - 1 + tidLength, suffix, sizeof(suffix));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    ssize_t n;
+    do {
+        n = read(fd, buf, sizeof(buf) - 1);
+    } while (n < 0 && errno == EINTR);
+    close(fd);
+    if (n <= 0) {
+        return -1;
+    }
+    buf[n] = '\0';
+
+    /* The command name field may contain spaces so skip past its closing parenthesis.
+     * The fields after it start with the state, utime is the 12th field after the state. */
+    char *s = strrchr(buf, ')');
+    if (s == NULL) {
+        return -1;
+    }
+    unsigned long utime;
+    if (sscanf(s + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu", &utime) != 1) {
+        return -1;
+    }
+    static jlong ticksPerSecond = 0;
+    if (ticksPerSecond == 0) {
+        ticksPerSecond = sysconf(_SC_CLK_TCK);
+    }
+    return ((jlong) utime) * (1000 * 1000 * 1000) / ticksPerSecond;
+}
+#endif
+
+#if os_LINUX
+/*
+ * A per-thread CPU clock id encodes the kernel thread id as (~tid << 3) | 6 (CPUCLOCK_SCHED).
+ */
+#define THREAD_CPU_CLOCK(tid) ((clockid_t) ((~(tid) << 3) | 6))
+#define THREAD_CPU_CLOCK_TID(clockId) ((pid_t) ~((clockId) >> 3))
+
+static jlong threadCpuTimeOfTid(pid_t tid, jboolean userOnly) {
+    struct timespec tp;
+    if (userOnly) {
+        return threadUserTimeFromProc(tid);
+    }
+    if (clock_gettime(THREAD_CPU_CLOCK(tid), &tp) != 0) {
+        return -1;
+    }
+    return ((jlong) tp.tv_sec) * (1000 * 1000 * 1000) + (jlong) tp.tv_nsec;
+}
+#elif os_DARWIN
+static jlong threadCpuTimeOfPort(mach_port_t port, jboolean userOnly) {
+    thread_basic_info_data_t info;
+    mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+    if (thread_info(port, THREAD_BASIC_INFO, (thread_info_t) &info, &count) != KERN_SUCCESS) {
+        return -1;
+    }
+    jlong nanos = ((jlong) info.user_time.seconds) * (1000 * 1000 * 1000) + ((jlong) info.user_time.microseconds) * 1000;
+    if (!userOnly) {
+        nanos += ((jlong) info.system_time.seconds) * (1000 * 1000 * 1000) + ((jlong) info.system_time.microseconds) * 1000;
+    }
+    return nanos;
+}
+#endif
+
+/**
+ * Gets a handle by which the CPU time of a native thread can be read with native_threadCpuTimeOfHandle().
+ * Unlike the native thread itself, the handle can still be used once the thread has exited; reading
+ * the CPU time then fails. This allows the time to be read without holding a lock that keeps the thread alive.
+ * On Linux the handle is the thread's kernel id, which may be reused by a thread started after the
+ * thread exits. A time read with the handle is therefore only known to be the thread's if the
+ * thread is found to be still alive after the read.
+ *
+ * @param nativeThread the handle of a live native thread (e.g. a pthread_t value)
+ * @return the handle or 0 if the CPU time of the thread is not available
+ */
+jlong native_threadCpuTimeHandle(Address nativeThread) {
+#if os_LINUX
+    clockid_t clockId;
+    if (pthread_getcpuclockid((pthread_t) nativeThread, &clockId) != 0) {
+        return 0;
+    }
+    return (jlong) THREAD_CPU_CLOCK_TID(clockId);
+#elif os_DARWIN
+    return (jlong) pthread_mach_thread_np((pthread_t) nativeThread);
+#else
+    return 0;
+#endif
+}
+
+/**
+ * Gets the CPU time consumed by the thread denoted by a handle obtained from native_threadCpuTimeHandle().
+ *
+ * @return the CPU time in nanoseconds or -1 if it is not available
+ */
+jlong native_threadCpuTimeOfHandle(jlong handle, jboolean userOnly) {
+#if os_LINUX
+    return threadCpuTimeOfTid((pid_t) handle, userOnly);
+#elif os_DARWIN
+    return threadCpuTimeOfPort((mach_port_t) handle, userOnly);
+#else
+    return -1;
+#endif
+}
+
+/**
+ * Gets the CPU time consumed by a native thread.
+ *
+ * @param nativeThread the handle of a live native thread (e.g. a pthread_t value)
+ * @param userOnly specifies if only the time spent in user mode is returned
+ * @return the CPU time in nanoseconds or -1 if it is not available
+ */
+jlong native_threadCpuTime(Address nativeThread, jboolean userOnly) {
+#if os_LINUX
+    pthread_t thread = (pthread_t) nativeThread;
+    if (userOnly && pthread_equal(thread, pthread_self())) {
+        struct rusage usage;
+        if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+            return -1;
+        }
+        return ((jlong) usage.ru_utime.tv_sec) * (1000 * 1000 * 1000) + ((jlong) usage.ru_utime.tv_usec) * 1000;
+    }
+#endif
+    jlong handle = native_threadCpuTimeHandle(nativeThread);
+    return handle == 0 ? -1 : native_threadCpuTimeOfHandle(handle, userOnly);
+}
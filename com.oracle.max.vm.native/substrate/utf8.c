@@ -0,0 +1,251 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+#include "isa.h"
+#include "utf8.h"
+
+#if isa_AMD64
+#include <emmintrin.h>
+
+#if defined(__GNUC__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 8))
+#include <immintrin.h>
+#define UTF8_AVX2 1
+#define AVX2 __attribute__((target("avx2")))
+
+static boolean hasAVX2(void) {
+    static int result = -1;
+    if (result < 0) {
+        __builtin_cpu_init();
+        result = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+    return result;
+}
+#endif
+
+/*
+ * Each of the following kernels handles a prefix of its input consisting of ASCII characters
+ * other than 0 (i.e. characters encoded in a single byte) and returns the length of that prefix,
+ * rounded down to a multiple of the vector width. The scalar code handles the rest.
+ */
+
+static jint narrowAsciiSSE2(const jchar *chars, jint length, jbyte *utf) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i nonAscii = _mm_set1_epi16((short) 0xff80);
+    jint i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i *) (chars + i));
+        __m128i b = _mm_loadu_si128((const __m128i *) (chars + i + 8));
+        __m128i high = _mm_and_si128(_mm_or_si128(a, b), nonAscii);
+        __m128i zeros = _mm_or_si128(_mm_cmpeq_epi16(a, zero), _mm_cmpeq_epi16(b, zero));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) != 0xffff || _mm_movemask_epi8(zeros) != 0) {
+            break;
+        }
+        if (utf != NULL) {
+            _mm_storeu_si128((__m128i *) (utf + i), _mm_packus_epi16(a, b));
+        }
+    }
+    return i;
+}
+
+static jint widenAsciiSSE2(const jbyte *utf, jint length, jchar *chars) {
+    const __m128i zero = _mm_setzero_si128();
+    jint i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *) (utf + i));
+        if (_mm_movemask_epi8(v) != 0) {
+            break;
+        }
+        if (chars != NULL) {
+            _mm_storeu_si128((__m128i *) (chars + i), _mm_unpacklo_epi8(v, zero));
+            _mm_storeu_si128((__m128i *) (chars + i + 8), _mm_unpackhi_epi8(v, zero));
+        }
+    }
+    return i;
+}
+
+#if UTF8_AVX2
+
+AVX2 static jint narrowAsciiAVX2(const jchar *chars, jint length, jbyte *utf) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i nonAscii = _mm256_set1_epi16((short) 0xff80);
+    jint i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i *) (chars + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *) (chars + i + 16));
+        __m256i zeros = _mm256_or_si256(_mm256_cmpeq_epi16(a, zero), _mm256_cmpeq_epi16(b, zero));
+        if (!_mm256_testz_si256(_mm256_or_si256(a, b), nonAscii) || !_mm256_testz_si256(zeros, zeros)) {
+            break;
+        }
+        if (utf != NULL) {
+            /* packus works within 128-bit lanes, so the quadwords must be put back in order */
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xd8);
+            _mm256_storeu_si256((__m256i *) (utf + i), packed);
+        }
+    }
+    return i;
+}
+
+AVX2 static jint widenAsciiAVX2(const jbyte *utf, jint length, jchar *chars) {
+    jint i = 0;
+    for (; i + 32 <= length; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i *) (utf + i));
+        if (_mm256_movemask_epi8(v) != 0) {
+            break;
+        }
+        if (chars != NULL) {
+            _mm256_storeu_si256((__m256i *) (chars + i), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+            _mm256_storeu_si256((__m256i *) (chars + i + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+        }
+    }
+    return i;
+}
+
+#endif /* UTF8_AVX2 */
+
+static jint narrowAscii(const jchar *chars, jint length, jbyte *utf) {
+#if UTF8_AVX2
+    if (length >= 32 && hasAVX2()) {
+        return narrowAsciiAVX2(chars, length, utf);
+    }
+#endif
+    return narrowAsciiSSE2(chars, length, utf);
+}
+
+static jint widenAscii(const jbyte *utf, jint length, jchar *chars) {
+#if UTF8_AVX2
+    if (length >= 32 && hasAVX2()) {
+        return widenAsciiAVX2(utf, length, chars);
+    }
+#endif
+    return widenAsciiSSE2(utf, length, chars);
+}
+
+#else
+
+static jint narrowAscii(const jchar *chars, jint length, jbyte *utf) {
+    return 0;
+}
+
+static jint widenAscii(const jbyte *utf, jint length, jchar *chars) {
+    return 0;
+}
+
+#endif /* isa_AMD64 */
+
+jint utf8_lengthOfUtf16(const jchar *chars, jint length) {
+    jint i = narrowAscii(chars, length, NULL);
+    jint result = i;
+    for (; i < length; i++) {
+        jchar ch = chars[i];
+        if (ch >= 0x0001 && ch <= 0x007f) {
+            result++;
+        } else if (ch > 0x07ff) {
+            result += 3;
+        } else {
+            result += 2;
+        }
+    }
+    return result;
+}
+
+jint utf8_fromUtf16(const jchar *chars, jint length, jbyte *utf) {
+    jbyte *start = utf;
+    jint i = 0;
+    while (i < length) {
+        jint n = narrowAscii(chars + i, length - i, utf);
+        i += n;
+        utf += n;
+        /* Encode characters one at a time until the next ASCII character */
+        do {
+            if (i == length) {
+                return utf - start;
+            }
+            jchar ch = chars[i++];
+            if (ch >= 0x0001 && ch <= 0x007f) {
+                *utf++ = (jbyte) ch;
+                break;
+            } else if (ch > 0x07ff) {
+                *utf++ = (jbyte) (0xe0 | (ch >> 12));
+                *utf++ = (jbyte) (0x80 | ((ch >> 6) & 0x3f));
+                *utf++ = (jbyte) (0x80 | (ch & 0x3f));
+            } else {
+                *utf++ = (jbyte) (0xc0 | (ch >> 6));
+                *utf++ = (jbyte) (0x80 | (ch & 0x3f));
+            }
+        } while (true);
+    }
+    return utf - start;
+}
+
+jint utf8_utf16Length(const jbyte *utf, jint length) {
+    jint i = 0;
+    jint result = 0;
+    while (i < length) {
+        jint n = widenAscii(utf + i, length - i, NULL);
+        i += n;
+        result += n;
+        if (i == length) {
+            break;
+        }
+        jint c = utf[i] & 0xff;
+        if (c < 0x80) {
+            i++;
+        } else if ((c & 0xe0) == 0xc0) {
+            if (i + 2 > length || (utf[i + 1] & 0xc0) != 0x80) {
+                return -1;
+            }
+            i += 2;
+        } else if ((c & 0xf0) == 0xe0) {
+            if (i + 3 > length || (utf[i + 1] & 0xc0) != 0x80 || (utf[i + 2] & 0xc0) != 0x80) {
+                return -1;
+            }
+            i += 3;
+        } else {
+            return -1;
+        }
+        result++;
+    }
+    return result;
+}
+
+void utf8_toUtf16(const jbyte *utf, jint length, jchar *chars) {
+    jint i = 0;
+    while (i < length) {
+        jint n = widenAscii(utf + i, length - i, chars);
+        i += n;
+        chars += n;
+        if (i == length) {
+            break;
+        }
+        jint c = utf[i] & 0xff;
+        if (c < 0x80) {
+            *chars++ = (jchar) c;
+            i++;
+        } else if ((c & 0xe0) == 0xc0) {
+            *chars++ = (jchar) (((c & 0x1f) << 6) | (utf[i + 1] & 0x3f));
+            i += 2;
+        } else {
+            *chars++ = (jchar) (((c & 0x0f) << 12) | ((utf[i + 1] & 0x3f) << 6) | (utf[i + 2] & 0x3f));
+            i += 3;
+        }
+    }
+}
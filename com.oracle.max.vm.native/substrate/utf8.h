@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+/**
+ * Transcoding between the UTF-16 of Java strings and the modified UTF-8 used by JNI: the character 0
+ * is encoded in 2 bytes and supplementary characters are encoded as surrogate pairs of 3 bytes each.
+ * On AMD64 runs of ASCII characters are transcoded 16 (SSE2) or 32 (AVX2) at a time.
+ */
+#ifndef __utf8_h__
+#define __utf8_h__ 1
+
+#include "word.h"
+#include "jni.h"
+
+/**
+ * Gets the number of bytes in the modified UTF-8 encoding of length UTF-16 characters.
+ */
+extern jint utf8_lengthOfUtf16(const jchar *chars, jint length);
+
+/**
+ * Encodes length UTF-16 characters in modified UTF-8. The result is not zero terminated.
+ *
+ * @param utf the buffer for the result, which must be at least utf8_lengthOfUtf16(chars, length) bytes long
+ * @return the number of bytes written to utf
+ */
+extern jint utf8_fromUtf16(const jchar *chars, jint length, jbyte *utf);
+
+/**
+ * Gets the number of UTF-16 characters encoded by length bytes of modified UTF-8.
+ *
+ * @return the number of characters or -1 if the bytes are not valid modified UTF-8
+ */
+extern jint utf8_utf16Length(const jbyte *utf, jint length);
+
+/**
+ * Decodes length bytes of valid modified UTF-8 (as checked by utf8_utf16Length()) into UTF-16.
+ *
+ * @param chars the buffer for the result, which must be at least utf8_utf16Length(utf, length) characters long
+ */
+extern void utf8_toUtf16(const jbyte *utf, jint length, jchar *chars);
+
+#endif /*__utf8_h__*/
@@ -259,7 +259,7 @@ typedef struct {
     jobject process;
     jlong task;
     jobject threadList;
-    jlong tlaList;
+    TLAIndex tlaIndex;
 } GatherThreadArgs;
 
 static boolean gatherThread(thread_t thread, void* args) {
@@ -274,15 +274,17 @@ static boolean gatherThread(thread_t thread, void* args) {
 
     TLA threadLocals = (TLA) alloca(tlaSize());
     NativeThreadLocalsStruct nativeThreadLocalsStruct;
-    TLA tla = teleProcess_findTLA(a->task, a->tlaList, threadState.__rsp, threadLocals, &nativeThreadLocalsStruct);
+    TLA tla = teleProcess_lookupTLA(a->tlaIndex, threadState.__rsp, threadLocals, &nativeThreadLocalsStruct);
     teleProcess_jniGatherThread(a->env, a->process, a->threadList, thread, state, threadState.__rip, tla);
     return true;
 }
 
 JNIEXPORT void JNICALL
 Java_com_sun_max_tele_channel_natives_TeleChannelNatives_gatherThreads(JNIEnv *env, jobject this, jlong task, jobject teleProcess, jobject threadList, jlong tlaList) {
-    GatherThreadArgs args = {env, teleProcess, task, threadList, tlaList};
+    TLAIndex tlaIndex = teleProcess_indexTLAs(task, tlaList);
+    GatherThreadArgs args = {env, teleProcess, task, threadList, tlaIndex};
     forall_threads(task, gatherThread, (void *) &args);
+    teleProcess_freeTLAIndex(tlaIndex);
 }
 
 JNIEXPORT jboolean JNICALL
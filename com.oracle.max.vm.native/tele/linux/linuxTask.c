@@ -25,16 +25,19 @@
  * Functions for controlling and accessing the memory of a Linux task (i.e. thread or process) via ptrace(2).
  */
 #include <stdlib.h>
+#include <stddef.h>
 #include <unistd.h>
 #include <ctype.h>
 #include <errno.h>
 #include <fcntl.h>
 #include <string.h>
 #include <signal.h>
-#include <dirent.h>
 #include <sys/wait.h>
+#include <sys/uio.h>
 #include <sys/time.h>
+#include <time.h>
 #include <sys/prctl.h>
+#include <sys/user.h>
 
 #include "log.h"
 #include "ptrace.h"
@@ -46,40 +49,6 @@
  * task stopping/suspension. */
 static sigset_t _caughtSignals;
 
-/**
- * Waits for a newly started thread to stop (via a SIGSTOP), configures it for ptracing
- * and resumes the new thread as well as the thread that started it (which is currently
- * stopped on a SIGTRAP).
- *
- * @param newTid the PID of the new thread
- * @param starterTid the thread from which 'newTid' was started (via pthread_start()).
- */
-static void task_attach_ptrace_to_new_task(int newTid, int starterTid) {
-    int result;
-    int status;
-    do {
-        tele_log_println("Waiting for new task %d to stop", newTid);
-        result = waitpid(newTid, &status, __WALL);
-    } while (result == -1 && errno == EINTR);
-
-    if (result == -1) {
-        perror("Error waiting for new task to stop");
-        exit(1);
-    } else if (result != newTid) {
-        log_println("Wait returned unexpected PID %d", result);
-        exit(1);
-    } else if (!WIFSTOPPED(status) || WSTOPSIG(status) != SIGSTOP) {
-        log_println("Wait returned status %p", status);
-        exit(1);
-    }
-
-    ptrace(PT_SETOPTIONS, newTid, 0, PTRACE_O_TRACECLONE | PTRACE_O_TRACEEXIT);
-
-    tele_log_println("Resuming tasks %d and %d", newTid, starterTid);
-    ptrace(PT_CONTINUE, newTid, 0, 0);
-    ptrace(PT_CONTINUE, starterTid, 0, 0);
-}
-
 /**
  * Reads the stat of a task from /proc/<tgid>/task/<tid>/stat. See proc(5).
  *
@@ -240,404 +209,583 @@ char task_state(pid_t tgid, pid_t tid) {
     return state;
 }
 
-/**
- * Converts a directory entry to a numeric PID.
+/*
+ * The tasks of the traced process are tracked in memory from the events reported by waitpid(2)
+ * rather than by scanning /proc/<pid>/task. Each task is in one of the following states:
+ *
+ *     'R': running (or at least not known to be stopped)
+ *     'T': in a ptrace-stop
+ *     'X': exited or detached; the slot is reused when the table is rehashed
  *
- * @param entry the directory entry to convert
- * @return the numeric PID corresponding to 'entry->d_name' or 0 if the name
- *         is not a valid PID or entry does is not a directory
+ * The table is an open addressing hash table keyed by task id, as a VM may have thousands of threads.
  */
-int dirent_task_pid(const struct dirent *entry) {
-    char *endptr;
-    if (entry->d_type == DT_DIR) {
-        errno = 0;
-        pid_t tid = (pid_t) strtol(entry->d_name, &endptr, 10);
-        if (errno != 0) {
-            log_println("Error converting dirent name \"%s\"to a long value: %s", entry->d_name, strerror(errno));
-            return 0;
-        }
-        if (*endptr == '\0') {
-            return tid;
+typedef struct {
+    pid_t tid;
+    char state;
+    /* The signal to be delivered to the task when it is resumed. */
+    int pendingSignal;
+    /* The ptrace request (PT_CONTINUE or PT_STEP) with which the task was last resumed. */
+    int resumeRequest;
+    /* Specifies if the task has been sent a PTRACE_INTERRUPT whose PTRACE_EVENT_STOP has not been reported yet. */
+    boolean interruptPending;
+    /* The value of _watchpointsEpoch when the watchpoints were last written to the task's debug registers. */
+    int watchpointsEpoch;
+    /* The start of the watchpoint that caused the task's last stop, if it was caused by a watchpoint. */
+    Address watchpointAddress;
+    /* The kind of access that triggered that watchpoint (one of the WATCHPOINT_CODE_* values), or 0 if the
+     * task's last stop was not caused by a watchpoint. */
+    int watchpointCode;
+} TaskStruct, *Task;
+
+static TaskStruct *_tasks = NULL;
+static int _tasksCapacity = 0;
+static int _tasksUsed = 0;
+static int _liveTasks = 0;
+static int _stoppedTasks = 0;
+
+/* The time in nanoseconds between the first task stopping and all tasks being stopped, for the last stop. */
+static jlong _lastStopLatency = 0;
+
+static inline int task_slot(pid_t tid, int capacity) {
+    return (int) (((unsigned int) tid * 2654435761U) & (capacity - 1));
+}
+
+static Task task_lookup(pid_t tid) {
+    if (_tasksCapacity == 0) {
+        return NULL;
+    }
+    int i = task_slot(tid, _tasksCapacity);
+    while (_tasks[i].tid != 0) {
+        if (_tasks[i].tid == tid) {
+            return &_tasks[i];
         }
+        i = (i + 1) & (_tasksCapacity - 1);
+    }
+    return NULL;
+}
+
+static void task_set_state(Task task, char state) {
+    if (task->state != 'X') {
+        _liveTasks--;
+    }
+    if (task->state == 'T') {
+        _stoppedTasks--;
+    }
+    task->state = state;
+    if (state != 'X') {
+        _liveTasks++;
+    }
+    if (state == 'T') {
+        _stoppedTasks++;
     }
-    return 0;
 }
 
 /**
- * Scans a directory in the /proc filesystem for task subdirectories.
- *
- * @param pid the PID of the process whose /proc/<pid>/task directory will be scanned
- * @param tasks [out] an array of PIDs corresponding to the entries in the scanned directory
- *        for which dirent_task_pid() returns a non-zero result. The memory allocated for this
- *        array needs to be reclaimed by the caller.
- * @return the number of entries returned in 'tasks' or -1 if an error occurs. If an error occurs,
- *        no memory has been allocated and the value of '*tasks' is undefined.
+ * Rehashes the task table into a table of a given capacity, dropping the entries for exited tasks.
  */
-int scan_process_tasks(pid_t pid, pid_t **tasks) {
-    char *taskDirPath;
-    asprintf(&taskDirPath, "/proc/%d/task", (pid_t) pid);
-    c_ASSERT(taskDirPath != NULL);
-
-    struct dirent **entries = NULL;
-    const int nEntries = scandir(taskDirPath, &entries, dirent_task_pid, alphasort);
-    if (nEntries > 0) {
-        (*tasks) = (pid_t *) malloc(nEntries * sizeof(pid_t *));
-        int n = 0;
-        while (n < nEntries) {
-            pid_t tid = dirent_task_pid(entries[n]);
-            (*tasks)[n] = tid;
-            free(entries[n]);
-            n++;
+static void tasks_rehash(int capacity) {
+    TaskStruct *oldTasks = _tasks;
+    int oldCapacity = _tasksCapacity;
+    _tasks = (TaskStruct *) calloc(capacity, sizeof(TaskStruct));
+    c_ASSERT(_tasks != NULL);
+    _tasksCapacity = capacity;
+    _tasksUsed = 0;
+    int i;
+    for (i = 0; i < oldCapacity; i++) {
+        if (oldTasks[i].tid != 0 && oldTasks[i].state != 'X') {
+            int slot = task_slot(oldTasks[i].tid, capacity);
+            while (_tasks[slot].tid != 0) {
+                slot = (slot + 1) & (capacity - 1);
+            }
+            _tasks[slot] = oldTasks[i];
+            _tasksUsed++;
         }
-        free(entries);
     }
-    int error = errno;
-    free(taskDirPath);
-    errno = error;
-    return nEntries;
+    free(oldTasks);
 }
 
-/* The pause time between each poll of the VM to see if at least one thread has stopped */
-#define PROCESS_POLL_PAUSE_NANOSECONDS (200 * 1000)
-
-jboolean process_resume_all_threads(pid_t pid) {
-    pid_t *tasks = NULL;
-    const int nTasks = scan_process_tasks(pid, &tasks);
-    if (nTasks < 0) {
-        log_println("Error scanning /proc/%d/task directory: %s", pid, strerror(errno));
-        return false;
+static Task task_add(pid_t tid) {
+    Task task = task_lookup(tid);
+    if (task != NULL) {
+        return task;
     }
-
-    boolean result = true;
-    int n = 0;
-    while (n < nTasks) {
-        pid_t tid = tasks[n];
-
-        /* Clear any left over SIGSTOP or SIGTRAP signals. */
-        siginfo_t siginfo;
-        ptrace(PT_GETSIGINFO, tid, NULL, &siginfo);
-        int signal = siginfo.si_signo;
-        if (signal != 0) {
-            if (!sigismember(&_caughtSignals, signal)) {
-                log_println("Error: Task %d with pending signal %d [%s] should not have been stopped by debugger", tid, signal, strsignal(signal));
-            } else {
-                tele_log_println("Clearing signal %d [%s] for task %d before resuming it", signal, strsignal(signal), tid);
-                siginfo.si_signo = 0;
-                siginfo.si_code = 0;
-                siginfo.si_errno = 0;
-                ptrace(PT_SETSIGINFO, tid, NULL, &siginfo);
-            }
+    if ((_tasksUsed + 1) * 2 > _tasksCapacity) {
+        int capacity = _tasksCapacity == 0 ? 64 : _tasksCapacity;
+        while ((_liveTasks + 1) * 4 > capacity) {
+            capacity *= 2;
         }
+        tasks_rehash(capacity);
+    }
+    int slot = task_slot(tid, _tasksCapacity);
+    while (_tasks[slot].tid != 0) {
+        slot = (slot + 1) & (_tasksCapacity - 1);
+    }
+    task = &_tasks[slot];
+    task->tid = tid;
+    task->state = 'X';
+    task->pendingSignal = 0;
+    task->resumeRequest = PT_CONTINUE;
+    task->interruptPending = false;
+    task->watchpointsEpoch = 0;
+    task->watchpointAddress = 0;
+    task->watchpointCode = 0;
+    _tasksUsed++;
+    task_set_state(task, 'R');
+    tele_log_println("Tracking task %d [%d live tasks]", tid, _liveTasks);
+    return task;
+}
+
+static void tasks_reset(void) {
+    free(_tasks);
+    _tasks = NULL;
+    _tasksCapacity = 0;
+    _tasksUsed = 0;
+    _liveTasks = 0;
+    _stoppedTasks = 0;
+}
 
-        tele_log_println("Resuming task %d", tid);
-        if (ptrace(PT_CONTINUE, tid, 0, 0) != 0) {
-            result = false;
+int process_tasks(pid_t pid, pid_t **tasks) {
+    *tasks = (pid_t *) malloc((_liveTasks == 0 ? 1 : _liveTasks) * sizeof(pid_t));
+    if (*tasks == NULL) {
+        return -1;
+    }
+    int n = 0;
+    int i;
+    for (i = 0; i < _tasksCapacity; i++) {
+        if (_tasks[i].tid != 0 && _tasks[i].state != 'X') {
+            (*tasks)[n++] = _tasks[i].tid;
         }
-        n++;
     }
-    free(tasks);
-    return result;
+    return n;
 }
 
-int process_wait_all_threads_stopped(pid_t pid) {
-    pid_t pgid = getpgid(pid);
+char process_task_state(pid_t tid) {
+    Task task = task_lookup(tid);
+    if (task == NULL || task->state == 'X') {
+        return 'Z';
+    }
+    return task->state;
+}
 
-    boolean stopping = false;
-    while (1) {
+jlong process_last_stop_latency(void) {
+    return _lastStopLatency;
+}
 
-        pid_t *tasks;
-        const int nTasks = scan_process_tasks(pid, &tasks);
-        if (nTasks < 0) {
-            log_println("Error scanning /proc/%d/task directory: %s", pid, strerror(errno));
-            return -1;
+int process_snapshot_registers(RegisterSnapshotRecord records, int capacity) {
+    int n = 0;
+    int i;
+    for (i = 0; i < _tasksCapacity; i++) {
+        Task task = &_tasks[i];
+        if (task->tid != 0 && task->state == 'T') {
+            if (n < capacity) {
+                RegisterSnapshotRecord record = &records[n];
+                record->tid = task->tid;
+                record->valid = task_read_registers(task->tid, &record->integerRegisters, &record->stateRegisters, &record->floatingPointRegisters);
+            }
+            n++;
         }
+    }
+    return n;
+}
 
-        if (stopping) {
-            tele_log_println("Stopping %d tasks...", nTasks);
-        } else {
-            tele_log_println("Scanning %d tasks...", nTasks);
-        }
+/*
+ * Hardware watchpoints, implemented with the x86 debug registers. DR0-DR3 hold the watched addresses,
+ * DR7 enables each of them and gives the kind and length of access watched and DR6 records which of
+ * them triggered a debug trap. The debug registers are per task, so the watchpoint settings are kept
+ * here and written to a task with PTRACE_POKEUSER (i.e. PT_WRITE_U) just before it is resumed if they
+ * have changed since they were last written to the task. This covers the tasks started after a watchpoint
+ * is activated as well as the existing ones, and costs nothing when no watchpoint changes.
+ */
 
-        int nStopped = 0;
-        int nExited = 0;
-        int n = 0;
-        while (n < nTasks) {
-            pid_t tid = tasks[n];
-
-            /* The WNOHANG option means that we won't be blocked on the waitpid() call if the signal
-             * state of the task has not changed since the last time waitpid() was called on it.
-             * The __WALL option is necessary so that we can wait on a thread not directly
-             * created by the primordial VM thread. This strangeness is due to the way threads
-             * are implemented on Linux. See the waitpid(2) man page for more detail. */
-            int waitOptions = WNOHANG | __WALL;
-            if (stopping) {
-                tele_log_println("Waiting for %d", tid);
-            }
-            int status = 0;
-            int result = waitpid(tid, &status, waitOptions);
-            if (result == 0) {
-                char state = task_state(pid, tid);
-                if (state == 'T') {
-                    nStopped++;
-                }
-                tele_log_println("No change in task %d since waitpid last called on it", tid);
-            } else if (result < 0) {
-                log_println("Error calling waitpid(%d): %s", tid, strerror(errno));
-            } else if (WIFEXITED(status)) {
-                log_println("Task %d exited with exit status %d", tid, WEXITSTATUS(status));
-            } else if (WIFSIGNALED(status)) {
-                int signal = WTERMSIG(status);
-                log_println("Task %d terminated by signal %d [%s]", tid, signal, strsignal(signal));
-            } else if (WIFSTOPPED(status)) {
-                int signal = WSTOPSIG(status);
-                tele_log_println("Task %d stopped by signal %d [%s]", tid, signal, strsignal(signal));
-
-                if (!sigismember(&_caughtSignals, signal)) {
-                    tele_log_println("Resuming task %d with signal %d [%s]", tid, signal, strsignal(signal));
-                    ptrace(PT_CONTINUE, tid, NULL, (Address) signal);
-                } else {
-                    if (signal == SIGTRAP) {
-                        nStopped++;
-                        int event = PTRACE_EVENT(status);
-                        if (event != 0) {
-                            unsigned long eventMsg;
-                            ptrace(PT_GETEVENTMSG, tid, NULL, &eventMsg);
-                            if (event == PTRACE_EVENT_CLONE) {
-                                /* This is the SIGTRAP event denoting that a new thread has been started. */
-                                int newTid = eventMsg;
-                                task_attach_ptrace_to_new_task(newTid, tid);
-                                nStopped--;
-                            } else if (event == PTRACE_EVENT_EXIT) {
-                                /* This is the SIGTRAP event denoting that a thread is about to exit
-                                 * and needs to be detached from ptrace. */
-                                nExited++;
-                                nStopped--;
-                                tele_log_println("Detaching exiting task %d", tid);
-                                ptrace(PT_DETACH, tid, NULL, 0);
-                            } else {
-                                log_println("Task %d received unexpected ptrace event %d with message %ul", tid, event, eventMsg);
-                            }
-                        }
-                    } else {
-                        nStopped++;
-                    }
-                }
-            } else {
-                char state = task_state(pid, tid);
-                tele_log_println("Task %d not yet stopped; state = '%c'", tid, state);
-                if (state == 'Z') {
-                    /* Missed the PTRACE_EVENT_EXIT event for this task somehow. Still need to account
-                     * for it as exited. However, we cannot no longer PT_DETACH it. */
-                    tele_log_println("Missed exit event for task %d: cleaning up anyway", tid);
-                    nExited++;
-                }
-            }
-            n++;
+/* The kinds of access watched by a debug register, as encoded in the R/W bits of DR7. */
+#define WATCH_EXEC 0
+#define WATCH_WRITE 1
+#define WATCH_READ_WRITE 3
+
+typedef struct {
+    /* The watched address, or 0 if the slot is free. */
+    Address address;
+    /* The number of bytes watched: 1, 2, 4 or 8, with 'address' aligned to this length. */
+    int length;
+    int kind;
+    /* The memory region of the watchpoint occupying this slot, which may occupy other slots too. */
+    Address start;
+    Address size;
+} WatchpointSlotStruct, *WatchpointSlot;
+
+static WatchpointSlotStruct _watchpointSlots[TASK_WATCHPOINT_SLOTS];
+static int _watchpointsEpoch = 0;
+static int _activeWatchpointSlots = 0;
+
+#if isa_AMD64
+#define DEBUG_REGISTER(n) (offsetof(struct user, u_debugreg) + (n) * sizeof(((struct user *) 0)->u_debugreg[0]))
+
+static Address watchpoints_dr7(void) {
+    Address dr7 = 0;
+    int i;
+    for (i = 0; i < TASK_WATCHPOINT_SLOTS; i++) {
+        WatchpointSlot slot = &_watchpointSlots[i];
+        if (slot->address != 0) {
+            /* The LEN bits encode lengths 1, 2, 8 and 4 as 0, 1, 2 and 3 respectively. */
+            Address len = slot->length == 8 ? 2 : slot->length - 1;
+            dr7 |= 1UL << (i * 2);
+            dr7 |= ((Address) slot->kind) << (16 + i * 4);
+            dr7 |= len << (18 + i * 4);
         }
-        free(tasks);
+    }
+    return dr7;
+}
 
-        if (nExited == nTasks) {
-            tele_log_println("All threads have exited");
-            return 0;
+/**
+ * Writes the current watchpoint settings to the debug registers of a stopped task.
+ */
+static void task_write_watchpoints(Task task) {
+    /* Disable all the watchpoints first so that the task never has an enabled watchpoint with a stale address. */
+    if (ptrace(PT_WRITE_U, task->tid, DEBUG_REGISTER(7), 0) != 0) {
+        return;
+    }
+    int i;
+    for (i = 0; i < TASK_WATCHPOINT_SLOTS; i++) {
+        if (_watchpointSlots[i].address != 0) {
+            ptrace(PT_WRITE_U, task->tid, DEBUG_REGISTER(i), _watchpointSlots[i].address);
         }
+    }
+    Address dr7 = watchpoints_dr7();
+    if (dr7 != 0 && ptrace(PT_WRITE_U, task->tid, DEBUG_REGISTER(7), dr7) != 0) {
+        return;
+    }
+    task->watchpointsEpoch = _watchpointsEpoch;
+}
 
-        if (nStopped == 0) {
-            /* No tasks are stopped yet: continue after a brief sleep */
-            usleep(PROCESS_POLL_PAUSE_NANOSECONDS);
-            continue;
+/**
+ * Determines if the debug trap that stopped a task was caused by a watchpoint, recording the
+ * watchpoint in the task if so.
+ */
+static void task_check_watchpoint_hit(Task task) {
+    errno = 0;
+    Address dr6 = (Address) ptrace(PT_READ_U, task->tid, DEBUG_REGISTER(6), 0);
+    if (errno != 0) {
+        return;
+    }
+    int i;
+    for (i = 0; i < TASK_WATCHPOINT_SLOTS; i++) {
+        WatchpointSlot slot = &_watchpointSlots[i];
+        if ((dr6 & (1UL << i)) != 0 && slot->address != 0) {
+            task->watchpointAddress = slot->start;
+            task->watchpointCode = slot->kind == WATCH_EXEC ? WATCHPOINT_CODE_EXEC : (slot->kind == WATCH_WRITE ? WATCHPOINT_CODE_WRITE : WATCHPOINT_CODE_READ);
+            tele_log_println("Task %d triggered watchpoint at %p", task->tid, slot->start);
+            break;
         }
+    }
+    if ((dr6 & 0xf) != 0) {
+        /* The status bits are sticky. */
+        ptrace(PT_WRITE_U, task->tid, DEBUG_REGISTER(6), 0);
+    }
+}
+#else
+static void task_write_watchpoints(Task task) {
+    task->watchpointsEpoch = _watchpointsEpoch;
+}
 
-        if (nStopped != nTasks) {
-            /* Give all tasks a brief chance to receive the last SIGSTOP (if any) */
-            usleep(PROCESS_POLL_PAUSE_NANOSECONDS);
+static void task_check_watchpoint_hit(Task task) {
+}
+#endif
 
-            /* Stop all threads by sending SIGSTOP to the process group (which is why the VM
-             * must run in a separate process group from the debugger!). Note that the tasks
-             * already stopped due to a previous SIGSTOP will simply ignore this SIGSTOP.
-             * However, the SIGSTOP must be sent until all tasks have stopped so that we catch
-             * tasks that start in between each SIGSTOP. */
-            tele_log_println("Not all tasks stopped yet - sending SIGSTOP to process group %d", pgid);
-            kill(-pgid, SIGSTOP);
-            stopping = true;
-            continue;
+/**
+ * Prepares a stopped task to be resumed.
+ */
+static void task_resuming(Task task) {
+    task->watchpointAddress = 0;
+    task->watchpointCode = 0;
+    if (task->watchpointsEpoch != _watchpointsEpoch) {
+        task_write_watchpoints(task);
+    }
+}
+
+/**
+ * Resumes a stopped task, delivering the signal pending for it (if any).
+ *
+ * @param request PT_CONTINUE or PT_STEP
+ * @return true if the task was resumed, false otherwise (in which case the task is marked as exited if it no longer exists)
+ */
+static boolean task_resume(Task task, int request) {
+    int signal = task->pendingSignal;
+    tele_log_println("Resuming task %d with request %d and signal %d", task->tid, request, signal);
+    task_resuming(task);
+    if (ptrace(request, task->tid, NULL, (Address) signal) != 0) {
+        if (errno == ESRCH) {
+            /* The task was killed while stopped. */
+            task_set_state(task, 'X');
         }
+        return false;
+    }
+    task->pendingSignal = 0;
+    task->resumeRequest = request;
+    task_set_state(task, 'R');
+    return true;
+}
 
-        /* Re-scan tasks to ensure we've got them all and they are all stopped. */
-        const int mTasks = scan_process_tasks(pid, &tasks);
-        if (mTasks < 0) {
-            log_println("Error scanning /proc/%d/task directory: %s", pid, strerror(errno));
-            continue;
+jboolean process_resume_task(pid_t tid, int request) {
+    Task task = task_lookup(tid);
+    if (task == NULL) {
+        return ptrace(request, tid, NULL, 0) == 0;
+    }
+    return task_resume(task, request);
+}
+
+int process_watchpoint_slots(void) {
+#if isa_AMD64
+    return TASK_WATCHPOINT_SLOTS;
+#else
+    return 0;
+#endif
+}
+
+jboolean process_activate_watchpoint(Address start, Address size, boolean read, boolean write, boolean exec) {
+    if (process_watchpoint_slots() == 0 || size == 0 || (!read && !write && !exec)) {
+        return false;
+    }
+    /* Cover the region with naturally aligned ranges of 1, 2, 4 or 8 bytes, one per debug register.
+     * An exec watchpoint can only watch the instruction at the start of the region. */
+    WatchpointSlotStruct slots[TASK_WATCHPOINT_SLOTS];
+    int n = 0;
+    if (exec) {
+        slots[n].address = start;
+        slots[n].length = 1;
+        slots[n].kind = WATCH_EXEC;
+        n++;
+    }
+    if (read || write) {
+        Address address = start;
+        Address end = start + size;
+        while (address < end) {
+            if (n >= TASK_WATCHPOINT_SLOTS - _activeWatchpointSlots) {
+                log_println("Too few debug registers free to watch %lu bytes at %p", size, start);
+                return false;
+            }
+            int length = 8;
+            while ((address & (length - 1)) != 0 || address + length > end) {
+                length /= 2;
+            }
+            slots[n].address = address;
+            slots[n].length = length;
+            slots[n].kind = read ? WATCH_READ_WRITE : WATCH_WRITE;
+            n++;
+            address += length;
         }
-        free(tasks);
+    }
+    if (n > TASK_WATCHPOINT_SLOTS - _activeWatchpointSlots) {
+        log_println("Too few debug registers free to watch %lu bytes at %p", size, start);
+        return false;
+    }
+    int i, j = 0;
+    for (i = 0; i < TASK_WATCHPOINT_SLOTS && j < n; i++) {
+        if (_watchpointSlots[i].address == 0) {
+            _watchpointSlots[i] = slots[j++];
+            _watchpointSlots[i].start = start;
+            _watchpointSlots[i].size = size;
+        }
+    }
+    _activeWatchpointSlots += n;
+    _watchpointsEpoch++;
+    return true;
+}
 
-        int nNewTasks = mTasks - nTasks;
-        if (nNewTasks != 0) {
-            tele_log_println("%d new tasks started since last scan - continuing...", mTasks - nTasks);
-            continue;
+jboolean process_deactivate_watchpoint(Address start, Address size) {
+    boolean found = false;
+    int i;
+    for (i = 0; i < TASK_WATCHPOINT_SLOTS; i++) {
+        WatchpointSlot slot = &_watchpointSlots[i];
+        if (slot->address != 0 && slot->start == start && slot->size == size) {
+            memset(slot, 0, sizeof(WatchpointSlotStruct));
+            _activeWatchpointSlots--;
+            found = true;
         }
+    }
+    if (found) {
+        _watchpointsEpoch++;
+    }
+    return found;
+}
 
-        /* We are now sure that we have stopped all the tasks. */
-        stopping = false;
-        tele_log_println("Stopped all tasks...");
-        return mTasks;
+/**
+ * Gets a task that is stopped as a result of triggering a hardware watchpoint.
+ */
+static Task task_watchpoint_hit(pid_t tid) {
+    Task task = task_lookup(tid);
+    if (task != NULL && task->state == 'T' && task->watchpointCode != 0) {
+        return task;
     }
+    return NULL;
 }
 
-/* An alternative version that reduces the amount of calls to waitpid() by polling the state
- * of each task first and only calling waitpid() that are known to be in the 'T' state. I'm
- * not yet sure which version performs better once there are lots of threads so I'm leaving
- * it around for now [Doug]. */
-int process_wait_all_threads_stopped_alternative(pid_t pid) {
-    pid_t pgid = getpgid(pid);
+boolean process_task_watchpoint_hit(pid_t tid) {
+    return task_watchpoint_hit(tid) != NULL;
+}
 
-    /* The debugging related signals we want to intercept. */
-    sigset_t caughtSignals;
-    sigemptyset(&caughtSignals);
-    sigaddset(&caughtSignals, SIGTRAP);
-    sigaddset(&caughtSignals, SIGSTOP);
+Address process_task_watchpoint_address(pid_t tid) {
+    Task task = task_watchpoint_hit(tid);
+    return task == NULL ? 0 : task->watchpointAddress;
+}
 
-    boolean stopping = false;
-    while (1) {
+int process_task_watchpoint_code(pid_t tid) {
+    Task task = task_watchpoint_hit(tid);
+    return task == NULL ? 0 : task->watchpointCode;
+}
 
-        pid_t *tasks;
-        const int nTasks = scan_process_tasks(pid, &tasks);
-        if (nTasks < 0) {
-            log_println("Error scanning /proc/%d/task directory: %s", pid, strerror(errno));
-            return -1;
+jboolean process_resume_all_threads(pid_t pid) {
+    boolean result = true;
+    int i;
+    for (i = 0; i < _tasksCapacity; i++) {
+        Task task = &_tasks[i];
+        if (task->tid != 0 && task->state == 'T') {
+            if (!task_resume(task, PT_CONTINUE) && task->state != 'X') {
+                result = false;
+            }
         }
+    }
+    return result;
+}
 
-        if (stopping) {
-            tele_log_println("Stopping %d tasks...", nTasks);
-        } else {
-            tele_log_println("Scanning %d tasks...", nTasks);
+/**
+ * Waits for and handles the next waitpid(2) event from a task in the traced process group.
+ *
+ * @param pgid the process group of the traced process
+ * @param stopping specifies if all tasks are being stopped, in which case a task reporting any ptrace-stop is left stopped
+ * @return 1 if the event stopped a task that was running for a reason that should stop all tasks (e.g. a breakpoint),
+ *         0 if the event was handled otherwise and -1 if there are no more tasks to wait for
+ */
+static int process_handle_event(pid_t pgid, boolean stopping) {
+    int status = 0;
+    /* The __WALL option is necessary so that we can wait on a thread not directly created by the
+     * primordial VM thread. Waiting on the process group rather than any child avoids reaping
+     * processes started by the debugger itself. */
+    pid_t tid = waitpid(-pgid, &status, __WALL);
+    if (tid < 0) {
+        if (errno == EINTR) {
+            return 0;
         }
-
-        int nStopped = 0;
-        int nExited = 0;
-        boolean allStopped = true;
-        int n = 0;
-        while (n < nTasks) {
-            pid_t tid = tasks[n];
-            char state = task_state(pid, tid);
-            if (state == 'T') {
-                nStopped++;
-
-                /* The WNOHANG option means that we won't be blocked on the waitpid() call if the signal
-                 * state of the task has not changed since the last time waitpid() was called on it.
-                 * The __WALL option is necessary so that we can wait on a thread not directly
-                 * created by the primordial VM thread. This strangeness is due to the way threads
-                 * are implemented on Linux. See the waitpid(2) man page for more detail. */
-                int waitOptions = WNOHANG | __WALL;
-                if (stopping) {
-                    tele_log_println("Waiting for %d", tid);
-                }
-                int status = 0;
-                int result = waitpid(tid, &status, waitOptions);
-                if (result == 0) {
-                    tele_log_println("No change in task %d since waitpid last called on it", tid);
-                } else if (result < 0) {
-                    log_println("Error calling waitpid(%d): %s", tid, strerror(errno));
-                } else {
-                    c_ASSERT(result == tid);
-                    if (WIFEXITED(status)) {
-                        log_println("Task %d exited with exit status %d", tid, WEXITSTATUS(status));
-                    } else if (WIFSIGNALED(status)) {
-                        int signal = WTERMSIG(status);
-                        log_println("Task %d terminated by signal %d [%s]", tid, signal, strsignal(signal));
-                    } else {
-                        if (!WIFSTOPPED(status)) {
-                            log_println("Task %d should be stopped!", tid);
-                        }
-                        int signal = WSTOPSIG(status);
-                        tele_log_println("Task %d stopped by signal %d [%s]", tid, signal, strsignal(signal));
-
-                        if (!sigismember(&caughtSignals, signal)) {
-                            tele_log_println("Resuming task %d with signal %d [%s]", tid, signal, strsignal(signal));
-                            allStopped = false;
-                            nStopped--;
-                            ptrace(PT_CONTINUE, tid, NULL, (Address) signal);
-                        } else {
-                            if (signal == SIGTRAP) {
-                                int event = PTRACE_EVENT(status);
-                                if (event != 0) {
-                                    unsigned long eventMsg;
-                                    ptrace(PT_GETEVENTMSG, tid, NULL, &eventMsg);
-                                    if (event == PTRACE_EVENT_CLONE) {
-                                        /* This is the SIGTRAP event denoting that a new thread has been started. */
-                                        allStopped = false;
-                                        nStopped--;
-                                        int newTid = eventMsg;
-                                        task_attach_ptrace_to_new_task(newTid, tid);
-                                    } else if (event == PTRACE_EVENT_EXIT) {
-                                        /* This is the SIGTRAP event denoting that a thread is about to exit
-                                         * and needs to be detached from ptrace. */
-                                        nStopped--;
-                                        nExited++;
-                                        tele_log_println("Detaching exiting task %d", tid);
-                                        ptrace(PT_DETACH, tid, NULL, 0);
-                                    } else {
-                                        log_println("Task %d received unexpected ptrace event %d with message %ul", tid, event, eventMsg);
-                                    }
-                                }
-                            } else {
-                                c_ASSERT(signal == SIGSTOP);
-                            }
-                        }
-                    }
-                }
-            } else {
-                allStopped = false;
-                tele_log_println("Task %d not yet stopped; state = '%c'", tid, state);
+        if (errno != ECHILD) {
+            log_println("Error calling waitpid(%d): %s", -pgid, strerror(errno));
+        }
+        int i;
+        for (i = 0; i < _tasksCapacity; i++) {
+            if (_tasks[i].tid != 0 && _tasks[i].state != 'X') {
+                task_set_state(&_tasks[i], 'X');
             }
-            n++;
         }
-        free(tasks);
+        return -1;
+    }
 
-        if (nExited == nTasks) {
-            tele_log_println("All threads have exited");
-            return 0;
-        }
+    /* A new task may report its initial stop before its creator reports the clone event. */
+    Task task = task_add(tid);
+
+    if (WIFEXITED(status)) {
+        tele_log_println("Task %d exited with exit status %d", tid, WEXITSTATUS(status));
+        task_set_state(task, 'X');
+        return 0;
+    }
+    if (WIFSIGNALED(status)) {
+        tele_log_println("Task %d terminated by signal %d [%s]", tid, WTERMSIG(status), strsignal(WTERMSIG(status)));
+        task_set_state(task, 'X');
+        return 0;
+    }
+    if (!WIFSTOPPED(status)) {
+        return 0;
+    }
 
-        if (nStopped == 0) {
-            /* No tasks are stopped yet: continue after a brief sleep */
-            usleep(PROCESS_POLL_PAUSE_NANOSECONDS);
-            continue;
+    int signal = WSTOPSIG(status);
+    int event = PTRACE_EVENT(status);
+    if (event == PTRACE_EVENT_CLONE) {
+        unsigned long eventMsg;
+        ptrace(PT_GETEVENTMSG, tid, NULL, &eventMsg);
+        /* The new task reports an initial PTRACE_EVENT_STOP of its own. */
+        task_add((pid_t) eventMsg);
+    } else if (event == PTRACE_EVENT_EXIT) {
+        tele_log_println("Detaching exiting task %d", tid);
+        ptrace(PT_DETACH, tid, NULL, 0);
+        task_set_state(task, 'X');
+        return 0;
+    } else if (event == 0 && sigismember(&_caughtSignals, signal)) {
+        /* A breakpoint, single step or suspension request. */
+        tele_log_println("Task %d stopped by signal %d [%s]", tid, signal, strsignal(signal));
+        boolean wasRunning = task->state == 'R';
+        task->pendingSignal = 0;
+        if (signal == SIGTRAP && _activeWatchpointSlots > 0) {
+            task_check_watchpoint_hit(task);
         }
+        task_set_state(task, 'T');
+        return wasRunning ? 1 : 0;
+    } else if (event == 0) {
+        /* A signal for the VM: deliver it now or, if all tasks are being stopped, when they are resumed. */
+        task->pendingSignal = signal;
+    } else if (event == PTRACE_EVENT_STOP) {
+        /* The stop requested by a PTRACE_INTERRUPT or the initial stop of a new task. */
+        task->interruptPending = false;
+    } else {
+        log_println("Task %d received unexpected ptrace event %d", tid, event);
+    }
 
-        if (!allStopped) {
-            /* Give all tasks a brief chance to receive the last SIGSTOP (if any) */
-            usleep(PROCESS_POLL_PAUSE_NANOSECONDS);
+    if (stopping) {
+        task_set_state(task, 'T');
+    } else {
+        /* A clone event, a PTRACE_EVENT_STOP of a new task or a late PTRACE_EVENT_STOP from a
+         * PTRACE_INTERRUPT whose stop was first reported for some other reason. The task is resumed
+         * the way it was last resumed so that a single step is not turned into a continue. */
+        task_resume(task, task->resumeRequest);
+    }
+    return 0;
+}
 
-            /* Stop all threads by sending SIGSTOP to the process group (which is why the VM
-             * must run in a separate process group from the debugger!). Note that the tasks
-             * already be stopped due to a previous SIGSTOP will simply ignore this SIGSTOP.
-             * However, the SIGSTOP must be sent until all tasks have stopped so that we can
-             * tasks that start in between each SIGSTOP. */
-            tele_log_println("Not all tasks stopped yet - sending SIGSTOP to process group %d", pgid);
-            kill(-pgid, SIGSTOP);
-            stopping = true;
-            continue;
-        }
+int process_wait_all_threads_stopped(pid_t pid) {
+    pid_t pgid = getpgid(pid);
+    if (pgid < 0) {
+        /* The VM is always started as the leader of its own process group. */
+        pgid = pid;
+    }
 
-        /* Re-scan tasks to ensure we've got them all and they are all stopped. */
-        const int mTasks = scan_process_tasks(pid, &tasks);
-        if (mTasks < 0) {
-            log_println("Error scanning /proc/%d/task directory: %s", pid, strerror(errno));
-            continue;
+    boolean stopping = false;
+    struct timespec firstStop;
+    while (_liveTasks > 0) {
+        int result = process_handle_event(pgid, stopping);
+        if (result < 0) {
+            break;
         }
-        free(tasks);
-
-        int nNewTasks = mTasks - nTasks;
-        if (nNewTasks != 0) {
-            tele_log_println("%d new tasks started since last scan - continuing...", mTasks - nTasks);
-            continue;
+        if (_stoppedTasks == _liveTasks) {
+            if (!stopping) {
+                clock_gettime(CLOCK_MONOTONIC, &firstStop);
+            }
+            break;
         }
+        if (result > 0 && !stopping) {
+            /* Stop all other tasks in a single pass. Tasks started from now on are left in their initial stop. */
+            stopping = true;
+            clock_gettime(CLOCK_MONOTONIC, &firstStop);
+            int i;
+            for (i = 0; i < _tasksCapacity; i++) {
+                Task task = &_tasks[i];
+                /* A task with an interrupt pending from an earlier stop will report a PTRACE_EVENT_STOP anyway. */
+                if (task->tid != 0 && task->state == 'R' && !task->interruptPending) {
+                    if (ptrace(PT_INTERRUPT, task->tid, 0, 0) == 0) {
+                        task->interruptPending = true;
+                    } else if (errno != ESRCH) {
+                        log_println("Error interrupting task %d: %s", task->tid, strerror(errno));
+                    }
+                }
+            }
+        }
+    }
 
-        /* We are now sure that we have stopped all the tasks. */
-        stopping = false;
-        tele_log_println("Stopped all tasks...");
-        return mTasks;
+    if (_liveTasks == 0) {
+        tele_log_println("All threads have exited");
+        return 0;
     }
+
+    struct timespec allStopped;
+    clock_gettime(CLOCK_MONOTONIC, &allStopped);
+    _lastStopLatency = (allStopped.tv_sec - firstStop.tv_sec) * 1000000000LL + (allStopped.tv_nsec - firstStop.tv_nsec);
+    tele_log_println("Stopped all %d tasks in %lld nanoseconds", _liveTasks, (long long) _lastStopLatency);
+    return _liveTasks;
 }
 
 JNIEXPORT jint JNICALL
@@ -652,10 +800,6 @@ Java_com_sun_max_tele_debug_linux_LinuxTask_nativeCreateChildProcess(JNIEnv *env
     int childPid = fork();
     if (childPid == 0) {
         /*child:*/
-        tele_log_println("Attaching ptrace to VM process %d", getpid());
-        if (ptrace(PT_TRACEME, 0, 0, 0) != 0) {
-            log_exit(1, "Failed to attach ptrace to VM process %d", getpid());
-        }
 
         char *portDef;
         if (asprintf(&portDef, "MAX_AGENT_PORT=%u", vmAgentPort) == -1) {
@@ -677,6 +821,9 @@ Java_com_sun_max_tele_debug_linux_LinuxTask_nativeCreateChildProcess(JNIEnv *env
          * stop all threads in the child. */
         setpgid(0, 0);
 
+        /* Stop until the parent has attached ptrace to this process with PTRACE_SEIZE. */
+        raise(SIGSTOP);
+
         /* This call does not return if it succeeds: */
         tele_log_println("Launching VM executable: %s", argv[0]);
         execv(argv[0], argv);
@@ -685,12 +832,39 @@ Java_com_sun_max_tele_debug_linux_LinuxTask_nativeCreateChildProcess(JNIEnv *env
     } else {
         /*parent:*/
         int status;
-        if (waitpid(childPid, &status, 0) == childPid && WIFSTOPPED(status)) {
+        if (waitpid(childPid, &status, WUNTRACED) != childPid || !WIFSTOPPED(status)) {
+            log_println("VM process %d did not stop before executing the VM", childPid);
+            return -1;
+        }
+
+        /* Seize the child so that its tasks can be stopped with PTRACE_INTERRUPT. The options
+         * make it (and the tasks it starts) trap when it starts new threads, exits or executes
+         * the VM. Tasks started by the child are traced automatically. */
+        if (ptrace(PT_SEIZE, childPid, 0, PTRACE_O_TRACECLONE | PTRACE_O_TRACEEXIT | PTRACE_O_TRACEEXEC) != 0) {
+            log_println("Failed to attach ptrace to VM process %d: %s", childPid, strerror(errno));
+            return -1;
+        }
+        kill(childPid, SIGCONT);
 
-            /* Configure child so that it traps when it exits or starts new threads */
-            ptrace(PT_SETOPTIONS, childPid, 0, PTRACE_O_TRACECLONE | PTRACE_O_TRACEEXIT);
-            return childPid;
+        /* Run the child up to the point where it has executed the VM. */
+        while (1) {
+            if (waitpid(childPid, &status, __WALL) != childPid || !WIFSTOPPED(status)) {
+                log_println("VM process %d terminated before executing the VM", childPid);
+                return -1;
+            }
+            if (PTRACE_EVENT(status) == PTRACE_EVENT_EXEC) {
+                break;
+            }
+            int signal = WSTOPSIG(status);
+            if (PTRACE_EVENT(status) != 0 || signal == SIGSTOP || signal == SIGCONT) {
+                signal = 0;
+            }
+            ptrace(PT_CONTINUE, childPid, 0, (Address) signal);
         }
+
+        tasks_reset();
+        task_set_state(task_add(childPid), 'T');
+        return childPid;
     }
     return -1;
 }
@@ -713,10 +887,7 @@ Java_com_sun_max_tele_debug_linux_LinuxTask_nativeSuspend(JNIEnv *env, jclass c,
 
 JNIEXPORT jboolean JNICALL
 Java_com_sun_max_tele_debug_linux_LinuxTask_nativeSingleStep(JNIEnv *env, jclass c, jint tgid, int tid) {
-    if (ptrace(PT_STEP, tid, 0, 0) != 0) {
-        return false;
-    }
-    return true;
+    return process_resume_task(tid, PT_STEP);
 }
 
 JNIEXPORT jboolean JNICALL
@@ -724,8 +895,7 @@ Java_com_sun_max_tele_debug_linux_LinuxTask_nativeResume(JNIEnv *env, jclass c,
     if (allTasks) {
         return process_resume_all_threads(tgid);
     }
-    int result = ptrace(PT_CONTINUE, tid, NULL, 0);
-    return result == 0;
+    return process_resume_task(tid, PT_CONTINUE);
 }
 
 JNIEXPORT jint JNICALL
@@ -740,6 +910,36 @@ Java_com_sun_max_tele_debug_linux_LinuxTask_nativeWait(JNIEnv *env, jclass c, ji
     return PS_UNKNOWN;
 }
 
+JNIEXPORT jlong JNICALL
+Java_com_sun_max_tele_debug_linux_LinuxTask_nativeLastStopLatency(JNIEnv *env, jclass c) {
+    return process_last_stop_latency();
+}
+
+JNIEXPORT jint JNICALL
+Java_com_sun_max_tele_debug_linux_LinuxTask_nativeWatchpointSlots(JNIEnv *env, jclass c) {
+    return process_watchpoint_slots();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_sun_max_tele_debug_linux_LinuxTask_nativeActivateWatchpoint(JNIEnv *env, jclass c, jlong start, jlong size, jboolean read, jboolean write, jboolean exec) {
+    return process_activate_watchpoint((Address) start, (Address) size, read, write, exec);
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_sun_max_tele_debug_linux_LinuxTask_nativeDeactivateWatchpoint(JNIEnv *env, jclass c, jlong start, jlong size) {
+    return process_deactivate_watchpoint((Address) start, (Address) size);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_sun_max_tele_debug_linux_LinuxTask_nativeReadWatchpointAddress(JNIEnv *env, jclass c, jint tid) {
+    return process_task_watchpoint_address(tid);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_sun_max_tele_debug_linux_LinuxTask_nativeReadWatchpointAccessCode(JNIEnv *env, jclass c, jint tid) {
+    return process_task_watchpoint_code(tid);
+}
+
 JNIEXPORT jboolean JNICALL
 Java_com_sun_max_tele_debug_linux_LinuxTask_nativeKill(JNIEnv *env, jclass c, jint tgid, jint tid) {
     pid_t killID = -getpgid(tgid);
@@ -752,66 +952,167 @@ Java_com_sun_max_tele_debug_linux_LinuxTask_nativeKill(JNIEnv *env, jclass c, ji
 }
 
 /**
- * Gets an open file descriptor on /proc/<pid>/mem for reading the memory of the traced process 'tgid'.
- *
- * @param tgid the task group id of the traced process
- * @param address the address at which the memory of tgid is to be read
- * @return a file descriptor opened on the memory file and positioned at 'address' or -1 if there was an error.
- *        If there was no error, it is the caller's responsibility to close the file descriptor.
+ * The file descriptor opened on /proc/<tgid>/mem for the traced process identified by '_memoryFdTgid'.
+ * It is kept open until the process is detached from (or terminates) so that each memory access
+ * costs a single pread64/pwrite64 instead of an open, seek, read and close.
  */
-int task_memory_read_fd(int tgid, const void *address) {
-    ptrace_check_tracer(POS, tgid);
+static int _memoryFd = -1;
+static pid_t _memoryFdTgid = 0;
+
+/* Set once process_vm_readv/process_vm_writev are found to be unavailable (i.e. kernels older than 3.2). */
+static boolean _noProcessVMAccess = false;
+
+int task_memory_fd(pid_t tgid) {
+    if (_memoryFd >= 0) {
+        if (_memoryFdTgid == tgid) {
+            return _memoryFd;
+        }
+        task_memory_close(_memoryFdTgid);
+    }
     char *memoryFileName;
     asprintf(&memoryFileName, "/proc/%d/mem", tgid);
     c_ASSERT(memoryFileName != NULL);
-    int fd = open(memoryFileName, O_RDONLY);
+    /* Writing through /proc/<pid>/mem is only supported on Linux 2.6.39 and later. */
+    int fd = open(memoryFileName, O_RDWR);
+    if (fd < 0) {
+        fd = open(memoryFileName, O_RDONLY);
+    }
     if (fd < 0) {
         log_println("Error opening %s: %s", memoryFileName, strerror(errno));
-        return fd;
+    } else {
+        _memoryFd = fd;
+        _memoryFdTgid = tgid;
     }
     free(memoryFileName);
-    off64_t fdOffset = (off64_t) address;
-    if (lseek64(fd, fdOffset, SEEK_SET) != fdOffset) {
-        log_println("Error seeking memory file for process %d to %p [%ul]: %s", tgid, address, fdOffset, strerror(errno));
-        close(fd);
+    return fd;
+}
+
+void task_memory_close(pid_t tgid) {
+    if (_memoryFd >= 0 && _memoryFdTgid == tgid) {
+        close(_memoryFd);
+        _memoryFd = -1;
+        _memoryFdTgid = 0;
+    }
+}
+
+/**
+ * Copies 'size' bytes from 'src' in the address space of 'tgid' to 'dst' in the caller's address space
+ * with process_vm_readv(2), retrying on a short read until all bytes are copied or an error occurs.
+ *
+ * @return the number of bytes copied or -1 if process_vm_readv(2) is not supported
+ */
+static ssize_t task_process_vm_read(pid_t tgid, const void *src, void *dst, size_t size) {
+    size_t bytesRead = 0;
+    while (bytesRead < size) {
+        struct iovec local = {(char *) dst + bytesRead, size - bytesRead};
+        struct iovec remote = {(char *) src + bytesRead, size - bytesRead};
+        ssize_t n = process_vm_readv(tgid, &local, 1, &remote, 1, 0);
+        if (n <= 0) {
+            if (n < 0 && errno == ENOSYS) {
+                _noProcessVMAccess = true;
+                return -1;
+            }
+            break;
+        }
+        bytesRead += n;
+    }
+    return bytesRead;
+}
+
+/**
+ * Copies 'size' bytes from 'src' in the address space of 'tgid' to 'dst' in the caller's address space,
+ * without reporting a failure to copy them all.
+ *
+ * @return the number of bytes copied or -1 if the memory file could not be opened
+ */
+static ssize_t task_read_quietly(pid_t tgid, const void *src, void *dst, size_t size) {
+    if (!_noProcessVMAccess) {
+        ssize_t bytesRead = task_process_vm_read(tgid, src, dst, size);
+        if (bytesRead == (ssize_t) size) {
+            return size;
+        }
+        /* Fall back to the memory file, which can also read pages that are not readable in the tracee. */
+    }
+
+    int fd = task_memory_fd(tgid);
+    if (fd < 0) {
         return -1;
     }
-    return fd;
+    size_t bytesRead = 0;
+    while (bytesRead < size) {
+        ssize_t n = pread64(fd, (char *) dst + bytesRead, size - bytesRead, (off64_t) (Address) src + bytesRead);
+        if (n <= 0) {
+            break;
+        }
+        bytesRead += n;
+    }
+    return bytesRead;
 }
 
 /**
  * Copies 'size' bytes from 'src' in the address space of 'tgid' to 'dst' in the caller's address space.
  */
 size_t task_read(pid_t tgid, pid_t tid, const void *src, void *dst, size_t size) {
-    char state;
-    if ((state = task_state(tgid, tid)) != 'T') {
-        log_println("Cannot read memory of task %d while it is in state '%c'", tid, state);
-        return 0;
+    //tele_log_println("Reading %d bytes from memory of task %d at %p", size, tid, src);
+    ssize_t bytesRead = task_read_quietly(tgid, src, dst, size);
+    if (bytesRead >= 0 && bytesRead != (ssize_t) size) {
+        char state = task_state(tgid, tid);
+        log_println("Only read %d of %d bytes from %p (task %d in state '%c'): %s", bytesRead, size, src, tid, state, strerror(errno));
     }
+    return bytesRead;
+}
 
-    //tele_log_println("Reading %d bytes from memory of task %d at %p", size, tid, src);
-    if (size <= sizeof(Address)) {
-        Address word = ptrace(PT_READ_D, tid, (Address) src, NULL);
-        if (errno != 0) {
-            int error = errno;
-            log_println("Could not read word at %p: %s", src, strerror(error));
-            return -1;
+size_t task_read_ranges(pid_t tgid, pid_t tid, const Address *srcs, jint *lengths, int count, void *dst) {
+    struct iovec local[TASK_READ_RANGES_MAX_IOV];
+    struct iovec remote[TASK_READ_RANGES_MAX_IOV];
+    size_t totalRead = 0;
+    char *dstRange = (char *) dst;
+    int i = 0;
+    while (i < count) {
+        const int first = i;
+        size_t batchSize = 0;
+        int n = 0;
+        if (!_noProcessVMAccess) {
+            while (i < count && n < TASK_READ_RANGES_MAX_IOV) {
+                local[n].iov_base = dstRange + batchSize;
+                local[n].iov_len = lengths[i];
+                remote[n].iov_base = (void *) srcs[i];
+                remote[n].iov_len = lengths[i];
+                batchSize += lengths[i];
+                n++;
+                i++;
+            }
+            ssize_t bytesRead = process_vm_readv(tgid, local, n, remote, n, 0);
+            if (bytesRead == (ssize_t) batchSize) {
+                totalRead += batchSize;
+                dstRange += batchSize;
+                continue;
+            }
+            if (bytesRead < 0 && errno == ENOSYS) {
+                _noProcessVMAccess = true;
+            }
         } else {
-            memcpy(dst, &word, size);
-        }
-        return size;
-    } else {
-        int fd = task_memory_read_fd(tgid, src);
-        if (fd < 0) {
-            return -1;
+            n = 1;
+            i++;
         }
-        size_t bytesRead = read(fd, dst, size);
-        if (bytesRead != size) {
-            log_println("Only read %d of %d bytes from %p: %s", bytesRead, size, src, strerror(errno));
+        /* A range in this batch could not be read in one go: read the ranges of the batch one at a time. */
+        int r;
+        for (r = first; r < first + n; r++) {
+            const size_t length = lengths[r];
+            /* Ranges may be speculative (e.g. prefetched pages) so failing to read one is not reported. */
+            ssize_t bytesRead = task_read_quietly(tgid, (const void *) srcs[r], dstRange, length);
+            if (bytesRead < 0) {
+                bytesRead = 0;
+            }
+            if ((size_t) bytesRead != length) {
+                memset(dstRange + bytesRead, 0, length - bytesRead);
+                lengths[r] = bytesRead;
+            }
+            totalRead += bytesRead;
+            dstRange += length;
         }
-        close(fd);
-        return bytesRead;
     }
+    return totalRead;
 }
 
 /**
@@ -850,12 +1151,10 @@ int task_write_subword(jint tgid, jint tid, void *dst, const void *src, size_t s
 }
 
 /**
- * Copies 'size' bytes from 'src' in the caller's address space to 'dst' in the address space of 'tgid'.
+ * Copies 'size' bytes from 'src' in the caller's address space to 'dst' in the address space of 'tgid'
+ * one word at a time with ptrace(2).
  */
-size_t task_write(pid_t tgid, pid_t tid, void *dst, const void *src, size_t size) {
-    if (size == 0) {
-        return 0;
-    }
+static size_t task_write_ptrace(pid_t tgid, pid_t tid, void *dst, const void *src, size_t size) {
     char state;
     if ((state = task_state(tgid, tid)) != 'T') {
         log_println("Cannot write to memory of task %d while it is in state '%c'", tid, state);
@@ -883,6 +1182,38 @@ size_t task_write(pid_t tgid, pid_t tid, void *dst, const void *src, size_t size
     return bytesWritten;
 }
 
+/**
+ * Copies 'size' bytes from 'src' in the caller's address space to 'dst' in the address space of 'tgid'.
+ */
+size_t task_write(pid_t tgid, pid_t tid, void *dst, const void *src, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    /* process_vm_writev(2) honours page protections so it fails for code (e.g. when planting
+     * a breakpoint). Writes that it cannot complete go through the memory file, which does not. */
+    if (!_noProcessVMAccess) {
+        struct iovec local = {(void *) src, size};
+        struct iovec remote = {dst, size};
+        ssize_t n = process_vm_writev(tgid, &local, 1, &remote, 1, 0);
+        if (n == (ssize_t) size) {
+            return size;
+        }
+        if (n < 0 && errno == ENOSYS) {
+            _noProcessVMAccess = true;
+        }
+    }
+
+    int fd = task_memory_fd(tgid);
+    if (fd >= 0) {
+        ssize_t n = pwrite64(fd, src, size, (off64_t) (Address) dst);
+        if (n == (ssize_t) size) {
+            return size;
+        }
+    }
+    return task_write_ptrace(tgid, tid, dst, src, size);
+}
+
 JNIEXPORT jint JNICALL
 Java_com_sun_max_tele_debug_linux_LinuxTask_nativeWriteBytes(JNIEnv *env, jclass c, jint tgid, jint tid, jlong dst, jobject src, jboolean isDirectByteBuffer, jint srcOffset, jint length) {
     ProcessHandleStruct ph = {tgid, tid};
@@ -895,6 +1226,45 @@ Java_com_sun_max_tele_debug_linux_LinuxTask_nativeReadBytes(JNIEnv *env, jclass
     return teleProcess_read(&ph, env, c, src, dst, isDirectByteBuffer, dstOffset, length);
 }
 
+JNIEXPORT jint JNICALL
+Java_com_sun_max_tele_debug_linux_LinuxTask_nativeReadBytesBatch(JNIEnv *env, jclass c, jint tgid, jint tid, jlongArray srcs, jintArray lengths, jint count, jobject dst, jint dstOffset) {
+    void *dstBuffer = (*env)->GetDirectBufferAddress(env, dst);
+    if (dstBuffer == 0) {
+        log_println("Failed to get address from NIO direct buffer");
+        return -1;
+    }
+    if (count < 0 || count > (*env)->GetArrayLength(env, srcs) || count > (*env)->GetArrayLength(env, lengths)) {
+        log_println("Invalid range count %d for batched read", count);
+        return -1;
+    }
+    jlong *srcAddresses = (*env)->GetLongArrayElements(env, srcs, NULL);
+    jint *rangeLengths = (*env)->GetIntArrayElements(env, lengths, NULL);
+    jlong end = dstOffset;
+    int i;
+    for (i = 0; i < count; i++) {
+        if (rangeLengths[i] < 0) {
+            break;
+        }
+        end += rangeLengths[i];
+    }
+    if (dstOffset < 0 || i < count || end > (*env)->GetDirectBufferCapacity(env, dst)) {
+        log_println("Batched read of %d ranges does not fit in the destination buffer", count);
+        (*env)->ReleaseLongArrayElements(env, srcs, srcAddresses, JNI_ABORT);
+        (*env)->ReleaseIntArrayElements(env, lengths, rangeLengths, JNI_ABORT);
+        return -1;
+    }
+    c_ASSERT(sizeof(jlong) == sizeof(Address));
+    size_t bytesRead = task_read_ranges(tgid, tid, (const Address *) srcAddresses, rangeLengths, count, (jbyte *) dstBuffer + dstOffset);
+    (*env)->ReleaseLongArrayElements(env, srcs, srcAddresses, JNI_ABORT);
+    (*env)->ReleaseIntArrayElements(env, lengths, rangeLengths, 0);
+    return bytesRead;
+}
+
+JNIEXPORT void JNICALL
+Java_com_sun_max_tele_debug_linux_LinuxTask_nativeCloseMemory(JNIEnv *env, jclass c, jint tgid) {
+    task_memory_close(tgid);
+}
+
 JNIEXPORT jboolean JNICALL
 Java_com_sun_max_tele_debug_linux_LinuxTask_nativeSetInstructionPointer(JNIEnv *env, jclass c, jint tid, jlong instructionPointer) {
     struct user_regs_struct registers;
@@ -967,6 +1337,29 @@ Java_com_sun_max_tele_debug_linux_LinuxTask_nativeReadRegisters(JNIEnv *env, jcl
                     stateRegisters, stateRegistersLength);
 }
 
+JNIEXPORT void JNICALL
+Java_com_sun_max_tele_debug_linux_LinuxTask_nativeRegisterSnapshotLayout(JNIEnv *env, jclass c, jintArray layout) {
+    jint sizes[7];
+    sizes[0] = sizeof(RegisterSnapshotRecordStruct);
+    sizes[1] = offsetof(RegisterSnapshotRecordStruct, integerRegisters);
+    sizes[2] = offsetof(RegisterSnapshotRecordStruct, stateRegisters);
+    sizes[3] = offsetof(RegisterSnapshotRecordStruct, floatingPointRegisters);
+    sizes[4] = sizeof(isa_CanonicalIntegerRegistersStruct);
+    sizes[5] = sizeof(isa_CanonicalStateRegistersStruct);
+    sizes[6] = sizeof(isa_CanonicalFloatingPointRegistersStruct);
+    (*env)->SetIntArrayRegion(env, layout, 0, 7, sizes);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_sun_max_tele_debug_linux_LinuxTask_nativeSnapshotRegisters(JNIEnv *env, jclass c, jobject buffer, jint capacity) {
+    RegisterSnapshotRecord records = (RegisterSnapshotRecord) (*env)->GetDirectBufferAddress(env, buffer);
+    if (records == NULL) {
+        log_println("Register snapshot buffer is not a direct buffer");
+        return -1;
+    }
+    return process_snapshot_registers(records, capacity);
+}
+
 // The following methods support core-dump access for Linux
 #include <sys/procfs.h>
 
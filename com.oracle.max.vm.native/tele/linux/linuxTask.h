@@ -43,6 +43,29 @@ boolean task_read_registers(pid_t tid,
     isa_CanonicalStateRegistersStruct *canonicalStateRegisters,
     isa_CanonicalFloatingPointRegistersStruct *canonicalFloatingPointRegisters);
 
+/**
+ * The record for one thread in a register snapshot taken by process_snapshot_registers().
+ */
+typedef struct {
+    jlong tid;
+    /* Non-zero if the registers were read successfully. */
+    jlong valid;
+    isa_CanonicalIntegerRegistersStruct integerRegisters;
+    isa_CanonicalStateRegistersStruct stateRegisters;
+    isa_CanonicalFloatingPointRegistersStruct floatingPointRegisters;
+} RegisterSnapshotRecordStruct, *RegisterSnapshotRecord;
+
+/**
+ * Copies the registers of all the stopped threads of the traced process into an array of records,
+ * so that the registers of every thread can be obtained with a single call from Java.
+ *
+ * @param records the array into which the records are written
+ * @param capacity the number of records that fit in 'records'
+ * @return the number of stopped threads, which may be greater than 'capacity' in which case
+ *         only the first 'capacity' records have been written
+ */
+int process_snapshot_registers(RegisterSnapshotRecord records, int capacity);
+
 /**
  * Reads the stat of a task from /proc/<tgid>/task/<tid>/stat. See proc(5).
  *
@@ -73,20 +96,39 @@ extern pid_t _ptracerTask;
 #define _LARGEFILE64_SOURCE 1
 
 /**
- * Gets an open file descriptor on /proc/<pid>/mem for reading the memory of the traced process 'tgid'.
+ * Gets the file descriptor opened on /proc/<pid>/mem for accessing the memory of the traced process 'tgid'.
+ * The descriptor is cached and must not be closed by the caller; see task_memory_close().
  *
  * @param tgid the task group id of the traced process
- * @param address the address at which the memory of tgid is to be read
- * @return a file descriptor opened on the memory file and positioned at 'address' or -1 if there was an error.
- *        If there was no error, it is the caller's responsibility to close the file descriptor.
+ * @return a file descriptor opened on the memory file or -1 if there was an error
  */
-int task_memory_read_fd(int tgid, const void *address);
+int task_memory_fd(pid_t tgid);
+
+/**
+ * Closes the file descriptor cached by task_memory_fd() for 'tgid', if any.
+ */
+void task_memory_close(pid_t tgid);
 
 /**
  * Copies 'size' bytes from 'src' in the address space of 'tgid' to 'dst' in the caller's address space.
  */
 size_t task_read(pid_t tgid, pid_t tid, const void *src, void *dst, size_t size);
 
+/**
+ * The maximum number of ranges passed to a single process_vm_readv(2) call by task_read_ranges().
+ */
+#define TASK_READ_RANGES_MAX_IOV 1024
+
+/**
+ * Copies 'count' ranges of memory from the address space of 'tgid' to consecutive locations starting at 'dst'
+ * in the caller's address space. Range 'i' starts at 'srcs[i]' and is 'lengths[i]' bytes long.
+ * If a range can only be partially read, the unread part of its destination is zeroed and 'lengths[i]'
+ * is updated to the number of bytes read. Such failures are not logged as ranges may be read speculatively.
+ *
+ * @return the total number of bytes read
+ */
+size_t task_read_ranges(pid_t tgid, pid_t tid, const Address *srcs, jint *lengths, int count, void *dst);
+
 /**
  * Copies 'size' bytes from 'src' in the caller's address space to 'dst' in the address space of 'tgid'.
  * The value of 'size' must be >= 0 and < sizeof(Word).
@@ -100,34 +142,109 @@ size_t task_write(pid_t tgid, pid_t tid, void *dst, const void *src, size_t size
 
 /**
  * Waits for at least one thread in a given process to stop on a SIGTRAP or SIGSTOP at which
- * time, all threads in the process group will be stopped (via SIGSTOP).
+ * time, all other threads in the process are stopped with PTRACE_INTERRUPT. The state of each
+ * thread is tracked from the events reported by waitpid(2) so no polling of /proc is involved.
  *
  * @param pid the PID of the process whose threads are to stopped once any one of them hits a
  *        breakpoint or receives some other debugger related signal
- * @return the number of stopped threads or -1 if an error occurred
+ * @return the number of stopped threads or 0 if all threads have exited
  */
 int process_wait_all_threads_stopped(pid_t pid);
 
 /**
- * Converts a directory entry to a numeric PID.
+ * Resumes all the stopped threads of a given process, delivering any signal intercepted
+ * for a thread while all threads were being stopped.
+ *
+ * @return true if all the threads were resumed, false otherwise
+ */
+jboolean process_resume_all_threads(pid_t pid);
+
+/**
+ * Resumes (or single steps) a single stopped thread outside of process_resume_all_threads(),
+ * delivering any signal intercepted for the thread while all threads were being stopped.
+ *
+ * @param request PT_CONTINUE or PT_STEP
+ * @return true if the thread was resumed, false otherwise
+ */
+jboolean process_resume_task(pid_t tid, int request);
+
+/**
+ * Gets the ids of the live threads of a given process, as tracked by process_wait_all_threads_stopped().
+ *
+ * @param tasks [out] an array of the thread ids which needs to be reclaimed by the caller
+ * @return the number of entries returned in 'tasks' or -1 if an error occurs
+ */
+int process_tasks(pid_t pid, pid_t **tasks);
+
+/**
+ * Gets the state of a thread as tracked by process_wait_all_threads_stopped().
+ *
+ * @return 'T' if the thread is stopped, 'R' if it is running or 'Z' if it has exited or is unknown
+ */
+char process_task_state(pid_t tid);
+
+/**
+ * Gets the time in nanoseconds from the first thread stopping to all threads being stopped
+ * in the last call to process_wait_all_threads_stopped().
+ */
+jlong process_last_stop_latency(void);
+
+/**
+ * The number of hardware watchpoint slots, i.e. the x86 debug registers DR0-DR3.
+ */
+#define TASK_WATCHPOINT_SLOTS 4
+
+/*
+ * The access codes reported for a triggered watchpoint. These are the si_code values
+ * for watchpoint traps on Solaris (TRAP_RWATCH, TRAP_WWATCH and TRAP_XWATCH).
+ * A debug trap does not say whether a watched location was read or written so a
+ * watchpoint that traps on reads always reports WATCHPOINT_CODE_READ.
+ */
+#define WATCHPOINT_CODE_READ 3
+#define WATCHPOINT_CODE_WRITE 4
+#define WATCHPOINT_CODE_EXEC 5
+
+/**
+ * Gets the number of hardware watchpoint slots available on this platform, which is 0 if
+ * hardware watchpoints are not supported.
+ */
+int process_watchpoint_slots(void);
+
+/**
+ * Activates a hardware watchpoint on a region of memory in all the threads of the traced process. The
+ * region is covered by naturally aligned ranges of up to 8 bytes, each of which uses one of the
+ * TASK_WATCHPOINT_SLOTS slots, with an extra slot for an exec watchpoint. The debug registers of each
+ * thread are updated when it is next resumed.
+ *
+ * @return false if there are not enough free slots for the watchpoint
+ */
+jboolean process_activate_watchpoint(Address start, Address size, boolean read, boolean write, boolean exec);
+
+/**
+ * Deactivates the hardware watchpoint activated for a given region of memory.
+ *
+ * @return false if there is no watchpoint for the region
+ */
+jboolean process_deactivate_watchpoint(Address start, Address size);
+
+/**
+ * Determines if a given thread is stopped as a result of triggering a hardware watchpoint.
+ */
+boolean process_task_watchpoint_hit(pid_t tid);
+
+/**
+ * Gets the start address of the watchpoint triggered by a given thread.
  *
- * @param entry the directory entry to convert
- * @return the numeric PID corresponding to 'entry->d_name' or 0 if the name
- *         is not a valid PID or entry does is not a directory
+ * @return 0 if the thread is not stopped as a result of triggering a hardware watchpoint
  */
-int dirent_task_pid(const struct dirent *entry);
+Address process_task_watchpoint_address(pid_t tid);
 
 /**
- * Scans a directory in the /proc filesystem for task subdirectories.
+ * Gets the kind of access (one of the WATCHPOINT_CODE_* values) that triggered the watchpoint a given thread is stopped at.
  *
- * @param pid the PID of the process whose /proc/<pid>/task directory will be scanned
- * @param tasks [out] an array of PIDs corresponding to the entries in the scanned directory
- *        for which dirent_task_pid() returns a non-zero result. The memory allocated for this
- *        array needs to be reclaimed by the caller.
- * @return the number of entries returned in 'tasks' or -1 if an error occurs. If an error occurs,
- *        no memory has been allocated and the value of '*tasks' is undefined.
+ * @return 0 if the thread is not stopped as a result of triggering a hardware watchpoint
  */
-int scan_process_tasks(pid_t pid, pid_t **tasks);
+int process_task_watchpoint_code(pid_t tid);
 
 /**
  * Prints the contents of /proc/<tgid>/task/<tid>/stat in a human readable to the log stream.
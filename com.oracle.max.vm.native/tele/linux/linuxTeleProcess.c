@@ -86,39 +86,42 @@ ThreadState_t toThreadState(char taskState, pid_t tid) {
     return threadState;
 }
 
-static void gatherThread(JNIEnv *env, pid_t tgid, pid_t tid, jobject linuxTeleProcess, jobject threadList, jlong tlaList) {
+static void gatherThread(JNIEnv *env, pid_t tgid, pid_t tid, jobject linuxTeleProcess, jobject threadList, TLAIndex tlaIndex) {
 
     isa_CanonicalIntegerRegistersStruct canonicalIntegerRegisters;
     isa_CanonicalStateRegistersStruct canonicalStateRegisters;
 
-    char taskState = task_state(tgid, tid);
+    char taskState = process_task_state(tid);
 
     TLA tla = 0;
     if (taskState == 'T' && task_read_registers(tid, &canonicalIntegerRegisters, &canonicalStateRegisters, NULL)) {
         Address stackPointer = (Address) canonicalIntegerRegisters.rsp;
         TLA threadLocals = (TLA) alloca(tlaSize());
         NativeThreadLocalsStruct nativeThreadLocalsStruct;
-        ProcessHandleStruct ph = {tgid, tid};
-        tla = teleProcess_findTLA(&ph, tlaList, stackPointer, threadLocals, &nativeThreadLocalsStruct);
+        tla = teleProcess_lookupTLA(tlaIndex, stackPointer, threadLocals, &nativeThreadLocalsStruct);
     }
-    teleProcess_jniGatherThread(env, linuxTeleProcess, threadList, tid, toThreadState(taskState, tid), (jlong) canonicalStateRegisters.rip, tla);
+    ThreadState_t threadState = process_task_watchpoint_hit(tid) ? TS_WATCHPOINT : toThreadState(taskState, tid);
+    teleProcess_jniGatherThread(env, linuxTeleProcess, threadList, tid, threadState, (jlong) canonicalStateRegisters.rip, tla);
 }
 
 JNIEXPORT void JNICALL
 Java_com_sun_max_tele_debug_linux_LinuxNativeTeleChannelProtocol_nativeGatherThreads(JNIEnv *env, jclass c, jlong pid, jobject linuxTeleProcess, jobject threads, long tlaList) {
 
     pid_t *tasks;
-    const int nTasks = scan_process_tasks(pid, &tasks);
+    const int nTasks = process_tasks(pid, &tasks);
     if (nTasks < 0) {
-        log_println("Error scanning /proc/%d/task directory: %s", pid, strerror(errno));
+        log_println("Error getting the tasks of process %d", pid);
         return;
     }
 
+    ProcessHandleStruct ph = {pid, pid};
+    TLAIndex tlaIndex = teleProcess_indexTLAs(&ph, tlaList);
     int n = 0;
     while (n < nTasks) {
         pid_t tid = tasks[n];
-        gatherThread(env, pid, tid, linuxTeleProcess, threads, tlaList);
+        gatherThread(env, pid, tid, linuxTeleProcess, threads, tlaIndex);
         n++;
     }
+    teleProcess_freeTLAIndex(tlaIndex);
     free(tasks);
 }
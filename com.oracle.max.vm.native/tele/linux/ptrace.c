@@ -55,6 +55,8 @@ static const char* requestToString(int request, char *unknownRequestNameBuf, int
         case PT_GETEVENTMSG: return "GETEVENTMSG";;
         case PT_GETSIGINFO: return "GETSIGINFO";;
         case PT_SETSIGINFO: return "SETSIGINFO";;
+        case PT_SEIZE: return "SEIZE";;
+        case PT_INTERRUPT: return "INTERRUPT";;
     }
     snprintf(unknownRequestNameBuf, unknownRequestNameBufLength, "<unknown:%d>", request);
     return unknownRequestNameBuf;
@@ -70,6 +72,7 @@ const char* ptraceEventName(int event) {
         case 4: return "PTRACE_EVENT_EXEC";
         case 5: return "PTRACE_EVENT_VFORK_DONE";
         case 6: return "PTRACE_EVENT_EXIT";
+        case 128: return "PTRACE_EVENT_STOP";
     }
     return "<unknown>";
 }
@@ -56,6 +56,8 @@
 #define PT_GETEVENTMSG 0x4201
 #define PT_GETSIGINFO  0x4202
 #define PT_SETSIGINFO  0x4203
+#define PT_SEIZE       0x4206
+#define PT_INTERRUPT   0x4207
 
 #define PTRACE_O_TRACESYSGOOD   0x00000001
 #define PTRACE_O_TRACEFORK      0x00000002
@@ -72,6 +74,7 @@
 #define PTRACE_EVENT_EXEC       4
 #define PTRACE_EVENT_VFORK_DONE 5
 #define PTRACE_EVENT_EXIT       6
+#define PTRACE_EVENT_STOP       128
 
 #define POS_PARAMS const char *file, int line
 #define POS __FILE__, __LINE__
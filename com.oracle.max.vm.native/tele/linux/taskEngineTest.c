@@ -0,0 +1,397 @@
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+
+/*
+ * Tests for the stop/resume engine in linuxTask.c. The engine is driven by a script of waitpid(2)
+ * events, with ptrace(2) interposed to record the requests it makes, so no process is traced.
+ *
+ * Build and run (see tele.mk):
+ *
+ *  make taskEngineTest
+ */
+
+#define waitpid test_waitpid
+
+#include "linuxTask.c"
+
+#undef waitpid
+
+/* The status reported by waitpid for a task stopped by a signal, or by a ptrace event. */
+#define STOPPED(signal) (((signal) << 8) | 0x7f)
+#define EVENT_STOPPED(signal, event) (((event) << 16) | STOPPED(signal))
+
+#define MAX_EVENTS 32
+#define MAX_REQUESTS 64
+#define MAX_TASKS 4
+
+typedef struct {
+    pid_t tid;
+    int status;
+} EventStruct;
+
+typedef struct {
+    int request;
+    pid_t tid;
+    Address data;
+} RequestStruct;
+
+static EventStruct _events[MAX_EVENTS];
+static int _eventCount;
+static int _nextEvent;
+
+static RequestStruct _requests[MAX_REQUESTS];
+static int _requestCount;
+
+/* The debug status register (DR6) of each task, indexed by task number. */
+static Address _debugStatus[MAX_TASKS];
+
+static int _failures;
+
+#define check(condition) do { \
+    if (!(condition)) { \
+        log_println("%s:%d: check failed: %s", __FILE__, __LINE__, #condition); \
+        _failures++; \
+    } \
+} while (0)
+
+pid_t test_waitpid(pid_t pid, int *status, int options) {
+    if (_nextEvent == _eventCount) {
+        errno = ECHILD;
+        return -1;
+    }
+    *status = _events[_nextEvent].status;
+    return _events[_nextEvent++].tid;
+}
+
+long _ptrace(POS_PARAMS, int request, pid_t pid, void *address, void *data) {
+#if isa_AMD64
+    if ((Address) address == DEBUG_REGISTER(6) && pid >= 100 && pid < 100 + MAX_TASKS) {
+        if (request == PT_READ_U) {
+            return _debugStatus[pid - 100];
+        } else if (request == PT_WRITE_U) {
+            _debugStatus[pid - 100] = (Address) data;
+            return 0;
+        }
+    }
+#endif
+    if (request == PT_READ_U || request == PT_WRITE_U || request == PT_GETEVENTMSG) {
+        return 0;
+    }
+    c_ASSERT(_requestCount < MAX_REQUESTS);
+    _requests[_requestCount].request = request;
+    _requests[_requestCount].tid = pid;
+    _requests[_requestCount].data = (Address) data;
+    _requestCount++;
+    return 0;
+}
+
+/* The parts of the VM referenced by the tele objects linked with this test, none of which are used. */
+
+void *thread_self(void) {
+    return NULL;
+}
+
+int tlaSize(void) {
+    return 0;
+}
+
+void tla_initialize(int size) {
+}
+
+static void event(pid_t tid, int status) {
+    c_ASSERT(_eventCount < MAX_EVENTS);
+    _events[_eventCount].tid = tid;
+    _events[_eventCount].status = status;
+    _eventCount++;
+}
+
+/**
+ * Starts a test with a given number of running tasks, numbered from 100.
+ */
+static void setUp(int nTasks) {
+    c_ASSERT(nTasks <= MAX_TASKS);
+    tasks_reset();
+    memset(_watchpointSlots, 0, sizeof(_watchpointSlots));
+    _activeWatchpointSlots = 0;
+    memset(_debugStatus, 0, sizeof(_debugStatus));
+    int i;
+    for (i = 0; i < nTasks; i++) {
+        task_add(100 + i);
+    }
+    _eventCount = 0;
+    _nextEvent = 0;
+    _requestCount = 0;
+}
+
+/**
+ * Counts the recorded ptrace requests of a given kind made for a given task.
+ */
+static int requests(int request, pid_t tid) {
+    int n = 0;
+    int i;
+    for (i = 0; i < _requestCount; i++) {
+        if (_requests[i].request == request && _requests[i].tid == tid) {
+            n++;
+        }
+    }
+    return n;
+}
+
+/**
+ * Gets the most recent resume request (PT_CONTINUE or PT_STEP) made for a given task.
+ */
+static RequestStruct *lastResume(pid_t tid) {
+    int i;
+    for (i = _requestCount - 1; i >= 0; i--) {
+        if ((_requests[i].request == PT_CONTINUE || _requests[i].request == PT_STEP) && _requests[i].tid == tid) {
+            return &_requests[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * A breakpoint in one task stops the others with a single PTRACE_INTERRUPT each.
+ */
+static void test_stop_all(void) {
+    setUp(3);
+    event(100, STOPPED(SIGTRAP));
+    event(101, EVENT_STOPPED(SIGTRAP, PTRACE_EVENT_STOP));
+    event(102, EVENT_STOPPED(SIGTRAP, PTRACE_EVENT_STOP));
+
+    check(process_wait_all_threads_stopped(100) == 3);
+    check(requests(PT_INTERRUPT, 100) == 0);
+    check(requests(PT_INTERRUPT, 101) == 1);
+    check(requests(PT_INTERRUPT, 102) == 1);
+    check(process_task_state(100) == 'T' && process_task_state(101) == 'T' && process_task_state(102) == 'T');
+    check(!task_lookup(101)->interruptPending && !task_lookup(102)->interruptPending);
+
+    check(process_resume_all_threads(100));
+    check(requests(PT_CONTINUE, 100) == 1 && requests(PT_CONTINUE, 101) == 1 && requests(PT_CONTINUE, 102) == 1);
+    check(process_task_state(101) == 'R');
+}
+
+/**
+ * A task that hits a breakpoint before the PTRACE_INTERRUPT sent to it takes effect reports the
+ * interrupt's PTRACE_EVENT_STOP once it is resumed. If it was single stepped, it must be stepped again
+ * rather than continued.
+ */
+static void test_late_interrupt_stop_while_stepping(void) {
+    setUp(2);
+    event(100, STOPPED(SIGTRAP));
+    event(101, STOPPED(SIGTRAP));
+
+    check(process_wait_all_threads_stopped(100) == 2);
+    check(requests(PT_INTERRUPT, 101) == 1);
+    check(task_lookup(101)->interruptPending);
+
+    check(process_resume_task(101, PT_STEP));
+    check(process_task_state(101) == 'R');
+
+    event(101, EVENT_STOPPED(SIGTRAP, PTRACE_EVENT_STOP));
+    event(101, STOPPED(SIGTRAP));
+    check(process_wait_all_threads_stopped(100) == 2);
+    check(requests(PT_STEP, 101) == 2);
+    check(requests(PT_CONTINUE, 101) == 0);
+    check(!task_lookup(101)->interruptPending);
+    check(process_task_state(101) == 'T');
+}
+
+/**
+ * Stops all three tasks with task 101 reporting a breakpoint before the PTRACE_INTERRUPT sent to it,
+ * then resumes them all.
+ */
+static void stopWithInterruptPendingFor101(void) {
+    setUp(3);
+    event(100, STOPPED(SIGTRAP));
+    event(101, STOPPED(SIGTRAP));
+    event(102, EVENT_STOPPED(SIGTRAP, PTRACE_EVENT_STOP));
+    check(process_wait_all_threads_stopped(100) == 3);
+    check(task_lookup(101)->interruptPending);
+    check(process_resume_all_threads(100));
+}
+
+/**
+ * A late PTRACE_EVENT_STOP from a continued task continues it again.
+ */
+static void test_late_interrupt_stop_while_continuing(void) {
+    stopWithInterruptPendingFor101();
+
+    event(101, EVENT_STOPPED(SIGTRAP, PTRACE_EVENT_STOP));
+    event(102, STOPPED(SIGTRAP));
+    event(100, EVENT_STOPPED(SIGTRAP, PTRACE_EVENT_STOP));
+    event(101, EVENT_STOPPED(SIGTRAP, PTRACE_EVENT_STOP));
+    check(process_wait_all_threads_stopped(100) == 3);
+    check(requests(PT_CONTINUE, 101) == 2);
+    check(requests(PT_INTERRUPT, 101) == 2);
+    check(process_task_state(100) == 'T' && process_task_state(101) == 'T' && process_task_state(102) == 'T');
+}
+
+/**
+ * A task with an interrupt still pending is not interrupted again when the next stop starts
+ * before its late PTRACE_EVENT_STOP is reported, which then counts as its stop.
+ */
+static void test_pending_interrupt_not_repeated(void) {
+    stopWithInterruptPendingFor101();
+
+    event(102, STOPPED(SIGTRAP));
+    event(101, EVENT_STOPPED(SIGTRAP, PTRACE_EVENT_STOP));
+    event(100, EVENT_STOPPED(SIGTRAP, PTRACE_EVENT_STOP));
+    check(process_wait_all_threads_stopped(100) == 3);
+    check(requests(PT_INTERRUPT, 100) == 1);
+    check(requests(PT_INTERRUPT, 101) == 1);
+    check(requests(PT_CONTINUE, 101) == 1);
+    check(!task_lookup(101)->interruptPending);
+    check(process_task_state(100) == 'T' && process_task_state(101) == 'T' && process_task_state(102) == 'T');
+}
+
+/**
+ * A signal for the VM intercepted while all tasks are being stopped is delivered when the task
+ * is resumed, whether by resuming all tasks or by resuming or single stepping just that task.
+ */
+static void test_pending_signal_delivered(void) {
+    setUp(2);
+    event(100, STOPPED(SIGTRAP));
+    event(101, STOPPED(SIGUSR1));
+    check(process_wait_all_threads_stopped(100) == 2);
+    check(task_lookup(101)->pendingSignal == SIGUSR1);
+
+    check(process_resume_task(101, PT_STEP));
+    check(lastResume(101)->request == PT_STEP && lastResume(101)->data == SIGUSR1);
+    check(task_lookup(101)->pendingSignal == 0);
+
+    setUp(2);
+    event(100, STOPPED(SIGTRAP));
+    event(101, STOPPED(SIGUSR2));
+    check(process_wait_all_threads_stopped(100) == 2);
+    check(process_resume_task(101, PT_CONTINUE));
+    check(lastResume(101)->request == PT_CONTINUE && lastResume(101)->data == SIGUSR2);
+
+    setUp(2);
+    event(100, STOPPED(SIGTRAP));
+    event(101, STOPPED(SIGUSR1));
+    check(process_wait_all_threads_stopped(100) == 2);
+    check(process_resume_all_threads(100));
+    check(lastResume(100)->data == 0);
+    check(lastResume(101)->data == SIGUSR1);
+}
+
+/**
+ * A signal for the VM reported while the tasks are running is delivered straight away,
+ * with the request the task was last resumed with.
+ */
+static void test_signal_forwarded_while_running(void) {
+    setUp(2);
+    event(100, STOPPED(SIGTRAP));
+    event(101, EVENT_STOPPED(SIGTRAP, PTRACE_EVENT_STOP));
+    check(process_wait_all_threads_stopped(100) == 2);
+    check(process_resume_task(100, PT_STEP));
+
+    event(100, STOPPED(SIGUSR1));
+    event(100, STOPPED(SIGTRAP));
+    check(process_wait_all_threads_stopped(100) == 2);
+    check(requests(PT_STEP, 100) == 2);
+    check(lastResume(100)->data == SIGUSR1);
+}
+
+#if isa_AMD64
+/**
+ * A watchpoint uses one debug register for each naturally aligned range of up to 8 bytes
+ * covering its region, so no more than 32 bytes can be watched.
+ */
+static void test_watchpoint_slots(void) {
+    setUp(1);
+    check(!process_activate_watchpoint(0x1000, 40, false, true, false));
+    check(_activeWatchpointSlots == 0);
+    check(process_activate_watchpoint(0x1000, 32, false, true, false));
+    check(_activeWatchpointSlots == 4);
+    check(!process_activate_watchpoint(0x2000, 1, false, true, false));
+    check(process_deactivate_watchpoint(0x1000, 32));
+    check(_activeWatchpointSlots == 0);
+
+    check(process_activate_watchpoint(0x2003, 4, true, false, false));
+    check(_activeWatchpointSlots == 3);
+    check(!process_activate_watchpoint(0x3000, 8, false, true, true));
+    check(process_activate_watchpoint(0x3000, 1, false, false, true));
+    check(_activeWatchpointSlots == 4);
+
+    /* With every slot taken, the exec slot must not let the read/write ranges run past the free count */
+    check(!process_activate_watchpoint(0x4000, 32, true, true, true));
+    check(!process_activate_watchpoint(0x4000, 1, false, false, true));
+    check(_activeWatchpointSlots == 4);
+    check(process_deactivate_watchpoint(0x3000, 1));
+    check(!process_activate_watchpoint(0x4000, 8, false, true, true));
+    check(_activeWatchpointSlots == 3);
+}
+
+/**
+ * The watchpoint triggered by each task is recorded in the task, and forgotten when it is resumed.
+ */
+static void test_watchpoint_hit_per_task(void) {
+    setUp(3);
+    check(process_activate_watchpoint(0x1000, 8, false, true, false));
+    check(process_activate_watchpoint(0x2000, 4, true, true, false));
+    _debugStatus[1] = 1 << 0;
+    _debugStatus[2] = 1 << 1;
+    event(101, STOPPED(SIGTRAP));
+    event(100, EVENT_STOPPED(SIGTRAP, PTRACE_EVENT_STOP));
+    event(102, STOPPED(SIGTRAP));
+    check(process_wait_all_threads_stopped(100) == 3);
+
+    check(!process_task_watchpoint_hit(100));
+    check(process_task_watchpoint_address(100) == 0 && process_task_watchpoint_code(100) == 0);
+    check(process_task_watchpoint_hit(101));
+    check(process_task_watchpoint_address(101) == 0x1000 && process_task_watchpoint_code(101) == WATCHPOINT_CODE_WRITE);
+    check(process_task_watchpoint_hit(102));
+    check(process_task_watchpoint_address(102) == 0x2000 && process_task_watchpoint_code(102) == WATCHPOINT_CODE_READ);
+    check(_debugStatus[1] == 0 && _debugStatus[2] == 0);
+
+    check(process_resume_task(101, PT_CONTINUE));
+    check(!process_task_watchpoint_hit(101) && process_task_watchpoint_address(101) == 0);
+    check(process_task_watchpoint_address(102) == 0x2000);
+}
+#endif
+
+int main(int argc, char **argv) {
+    sigemptyset(&_caughtSignals);
+    sigaddset(&_caughtSignals, SIGTRAP);
+    sigaddset(&_caughtSignals, SIGSTOP);
+
+    test_stop_all();
+    test_late_interrupt_stop_while_stepping();
+    test_late_interrupt_stop_while_continuing();
+    test_pending_interrupt_not_repeated();
+    test_pending_signal_delivered();
+    test_signal_forwarded_while_running();
+#if isa_AMD64
+    test_watchpoint_slots();
+    test_watchpoint_hit_per_task();
+#endif
+
+    if (_failures != 0) {
+        log_println("taskEngineTest: %d checks failed", _failures);
+        return 1;
+    }
+    log_println("taskEngineTest: ok");
+    return 0;
+}
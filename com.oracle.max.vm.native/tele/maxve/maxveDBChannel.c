@@ -163,15 +163,17 @@ Java_com_sun_max_tele_debug_maxve_MaxVEDBNativeTeleChannelProtocol_nativeGatherT
     int num_threads;
 
     threads = db_gather_threads(&num_threads);
+    TLAIndex tlaIndex = teleProcess_indexTLAs(&db_memory_handler, tlaList);
     int i;
     for (i=0; i<num_threads; i++) {
         tele_log_println("nativeGatherThreads processing thread %d,", threads[i].id);
         TLA threadLocals = (TLA) alloca(tlaSize());
         NativeThreadLocalsStruct nativeThreadLocalsStruct;
         struct db_regs *db_regs = checked_get_regs("nativeGatherThreads", threads[i].id);
-        threadLocals = teleProcess_findTLA(&db_memory_handler, tlaList, db_regs->rsp, threadLocals, &nativeThreadLocalsStruct);
+        threadLocals = teleProcess_lookupTLA(tlaIndex, db_regs->rsp, threadLocals, &nativeThreadLocalsStruct);
         teleProcess_jniGatherThread(env, teleDomain, threadList, (jlong) threads[i].id, toThreadState(threads[i].flags), db_regs->rip, threadLocals);
     }
+    teleProcess_freeTLAIndex(tlaIndex);
     free(threads);
 
     return 0;
@@ -216,15 +216,17 @@ static struct tele_xg_thread *get_thread(int id) {
 JNIEXPORT jboolean JNICALL
 Java_com_sun_max_tele_debug_guestvm_GuestVMXGNativeTeleChannelProtocol_nativeGatherThreads(JNIEnv *env, jclass c, jobject teleDomain, jobject threadList, jlong tlaList) {
     tele_xg_gather_threads();
+    TLAIndex tlaIndex = teleProcess_indexTLAs(&xg_memory_handler, tlaList);
     struct tele_xg_thread *tcb = tele_xg_thread_list;
     while (tcb != NULL) {
             debug_println("nativeGatherThreads processing thread %d,", tcb->id);
             TLA threadLocals = (TLA) alloca(tlaSize());
             NativeThreadLocalsStruct nativeThreadLocalsStruct;
-            threadLocals = teleProcess_findTLA(&xg_memory_handler, tlaList, tcb->regs.u.xregs_64.rsp, threadLocals, &nativeThreadLocalsStruct);
+            threadLocals = teleProcess_lookupTLA(tlaIndex, tcb->regs.u.xregs_64.rsp, threadLocals, &nativeThreadLocalsStruct);
             teleProcess_jniGatherThread(env, teleDomain, threadList, (jlong) tcb->id, toThreadState(tcb->flags), tcb->regs.u.xregs_64.rip, threadLocals);
             tcb = tcb->next;
     }
+    teleProcess_freeTLAIndex(tlaIndex);
     return 0;
 }
 
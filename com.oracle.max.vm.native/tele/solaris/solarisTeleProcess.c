@@ -203,7 +203,7 @@ typedef struct GatherThreadArgument {
     JNIEnv *env;
     jobject teleProcess;
     jobject threadList;
-    Address tlaList;
+    TLAIndex tlaIndex;
 } *GatherThreadArgument;
 
 static int gatherThread(void *data, const lwpstatus_t *ls) {
@@ -216,7 +216,7 @@ static int gatherThread(void *data, const lwpstatus_t *ls) {
     NativeThreadLocalsStruct nativeThreadLocalsStruct;
     Address stackPointer = ls->pr_reg[R_SP];
     Address instructionPointer = ls->pr_reg[R_PC];
-    TLA tla = teleProcess_findTLA(a->ph, a->tlaList, stackPointer, threadLocals, &nativeThreadLocalsStruct);
+    TLA tla = teleProcess_lookupTLA(a->tlaIndex, stackPointer, threadLocals, &nativeThreadLocalsStruct);
     teleProcess_jniGatherThread(a->env, a->teleProcess, a->threadList, lwpId, threadState, instructionPointer, tla);
 
     return 0;
@@ -231,12 +231,13 @@ Java_com_sun_max_tele_channel_natives_TeleChannelNatives_gatherThreads(JNIEnv *e
     a.env = env;
     a.teleProcess = teleProcess;
     a.threadList = threadList;
-    a.tlaList = tlaList;
+    a.tlaIndex = teleProcess_indexTLAs(ph, tlaList);
 
     int error = Plwp_iter(ph, gatherThread, &a);
     if (error != 0) {
         log_println("Error iterating over threads of process");
     }
+    teleProcess_freeTLAIndex(a.tlaIndex);
 }
 
 JNIEXPORT jboolean JNICALL
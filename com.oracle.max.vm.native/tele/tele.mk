@@ -28,14 +28,14 @@ LIB = tele
 include $(PROJECT)/platform/platform.mk
 include $(PROJECT)/tele/$(OS)/$(OS).mk
 
-SOURCES = $(OS_SOURCES) c.c log.c tele.c mutex.c threadLocals.c threads.c $(ISA).c platform.c relocation.c dataio.c virtualMemory.c
+SOURCES = $(OS_SOURCES) c.c log.c tele.c mutex.c threadLocals.c threads.c $(ISA).c platform.c relocation.c dataio.c resources.c virtualMemory.c nativeMemory.c
 
 SOURCE_DIRS = tele tele/$(OS) platform hosted share substrate
 
 include $(PROJECT)/share/share.mk
 
 ifeq ($(OS),linux)
-all : $(LIBRARY) ptraceTest
+all : $(LIBRARY) ptraceTest taskEngineTest
 else
 all : $(LIBRARY)
 endif
@@ -43,3 +43,18 @@ endif
 ptraceTest: ptraceTest.c
 	gcc -Wall -o ptraceTest $< -lc -lm -lpthread
 
+# taskEngineTest includes linuxTask.c and interposes on ptrace itself
+TASK_ENGINE_TEST_OBJECTS = teleProcess.o linuxTeleProcess.o c.o log.o mutex.o $(ISA).o
+
+taskEngineTest: taskEngineTest.c linuxTask.c $(TASK_ENGINE_TEST_OBJECTS)
+	$(CC) $(CFLAGS) $(CPPFLAGS) -o $@ $< $(TASK_ENGINE_TEST_OBJECTS) -lc -lm -lpthread
+
+ifeq ($(OS),linux)
+check : taskEngineTest
+	./taskEngineTest
+else
+check :
+endif
+
+.PHONY: check
+
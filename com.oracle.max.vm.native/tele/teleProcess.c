@@ -90,36 +90,135 @@ void teleProcess_jniGatherThread(JNIEnv *env, jobject teleProcess, jobject threa
                     size);
 }
 
-static boolean isTLAForStackPointer(ProcessHandle ph, Address stackPointer, Address tla, TLA tlaCopy, NativeThreadLocals ntlCopy) {
-    Address ntl;
+/**
+ * An entry in a TLAIndex, identifying a copy of a TLA by the stack range of its thread.
+ */
+typedef struct {
+    Address stackBase;
+    Size stackSize;
+    int copy;
+} TLAIndexEntryStruct, *TLAIndexEntry;
 
-    readProcessMemory(ph, tla, tlaCopy, tlaSize());
-    ntl = tla_load(Address, tlaCopy, NATIVE_THREAD_LOCALS);
-    readProcessMemory(ph, ntl, ntlCopy, sizeof(NativeThreadLocalsStruct));
-    tla_store(tlaCopy, NATIVE_THREAD_LOCALS, ntlCopy);
+struct TLAIndexStruct {
+    /* The number of TLAs in the index. */
+    int count;
+    /* The copies of the TLAs, in list order, each 'tlaSize()' bytes long. */
+    char *tlaCopies;
+    /* The copies of the native thread locals of each TLA, in list order. */
+    NativeThreadLocalsStruct *ntlCopies;
+    /* The entries sorted by stack base. */
+    TLAIndexEntryStruct *entries;
+};
+
+static int compareTLAIndexEntries(const void *a, const void *b) {
+    Address stackBaseA = ((TLAIndexEntry) a)->stackBase;
+    Address stackBaseB = ((TLAIndexEntry) b)->stackBase;
+    return stackBaseA < stackBaseB ? -1 : (stackBaseA > stackBaseB ? 1 : 0);
+}
+
+TLAIndex teleProcess_indexTLAs(ProcessHandle ph, Address tlaList) {
+    TLAIndex index = (TLAIndex) calloc(1, sizeof(struct TLAIndexStruct));
+    if (index == NULL) {
+        log_println("Failed to allocate TLA index");
+        return NULL;
+    }
+    const int size = tlaSize();
+    int capacity = 0;
+    Address tla = tlaList;
+    while (tla != 0) {
+        if (index->count == capacity) {
+            capacity = capacity == 0 ? 64 : capacity * 2;
+            char *tlaCopies = (char *) realloc(index->tlaCopies, capacity * size);
+            NativeThreadLocalsStruct *ntlCopies = (NativeThreadLocalsStruct *) realloc(index->ntlCopies, capacity * sizeof(NativeThreadLocalsStruct));
+            if (tlaCopies != NULL) {
+                index->tlaCopies = tlaCopies;
+            }
+            if (ntlCopies != NULL) {
+                index->ntlCopies = ntlCopies;
+            }
+            if (tlaCopies == NULL || ntlCopies == NULL) {
+                log_println("Failed to allocate TLA index of %d entries", capacity);
+                break;
+            }
+        }
+        TLA tlaCopy = (TLA) (index->tlaCopies + index->count * size);
+        NativeThreadLocals ntlCopy = &index->ntlCopies[index->count];
+        if (readProcessMemory(ph, tla, tlaCopy, size) != (size_t) size) {
+            break;
+        }
+        Address ntl = tla_load(Address, tlaCopy, NATIVE_THREAD_LOCALS);
+        if (readProcessMemory(ph, ntl, ntlCopy, sizeof(NativeThreadLocalsStruct)) != sizeof(NativeThreadLocalsStruct)) {
+            /* Keep the TLA so that the rest of the list is still reached; with an empty stack it matches no stack pointer */
+            memset((void *) ntlCopy, 0, sizeof(NativeThreadLocalsStruct));
+        }
 #if log_TELE
-    log_print("teleProcess_findTLA(%p): ", stackPointer);
-    tla_println(tlaCopy);
+        log_print("teleProcess_indexTLAs[%d]: ", index->count);
+        tla_println(tlaCopy);
 #endif
-    Address stackBase = ntlCopy->stackBase;
-    Size stackSize = ntlCopy->stackSize;
-    return stackBase <= stackPointer && stackPointer < (stackBase + stackSize);
+        index->count++;
+        tla = tla_load(Address, tlaCopy, FORWARD_LINK);
+    }
+
+    index->entries = (TLAIndexEntryStruct *) malloc((index->count == 0 ? 1 : index->count) * sizeof(TLAIndexEntryStruct));
+    if (index->entries == NULL) {
+        log_println("Failed to allocate TLA index of %d entries", index->count);
+        index->count = 0;
+        return index;
+    }
+    int i;
+    for (i = 0; i < index->count; i++) {
+        index->entries[i].stackBase = index->ntlCopies[i].stackBase;
+        index->entries[i].stackSize = index->ntlCopies[i].stackSize;
+        index->entries[i].copy = i;
+    }
+    qsort(index->entries, index->count, sizeof(TLAIndexEntryStruct), compareTLAIndexEntries);
+    return index;
 }
 
-TLA teleProcess_findTLA(ProcessHandle ph, Address tlaList, Address stackPointer, TLA tlaCopy, NativeThreadLocals ntlCopy) {
+TLA teleProcess_lookupTLA(TLAIndex index, Address stackPointer, TLA tlaCopy, NativeThreadLocals ntlCopy) {
     memset((void *) tlaCopy, 0, tlaSize());
     memset((void *) ntlCopy, 0, sizeof(NativeThreadLocalsStruct));
+    if (index == NULL) {
+        return 0;
+    }
 
-    if (tlaList != 0) {
-        Address tla = tlaList;
-        while (tla != 0) {
-            if (isTLAForStackPointer(ph, stackPointer, tla, tlaCopy, ntlCopy)) {
-                return tlaCopy;
-            }
-            tla = tla_load(Address, tlaCopy, FORWARD_LINK);
-        };
+    /* Find the last entry whose stack base is not above 'stackPointer'. */
+    int low = 0;
+    int high = index->count - 1;
+    int found = -1;
+    while (low <= high) {
+        int middle = (low + high) >> 1;
+        if (index->entries[middle].stackBase <= stackPointer) {
+            found = middle;
+            low = middle + 1;
+        } else {
+            high = middle - 1;
+        }
+    }
+    if (found < 0) {
+        return 0;
+    }
+    TLAIndexEntry entry = &index->entries[found];
+    if (stackPointer >= entry->stackBase + entry->stackSize) {
+        return 0;
+    }
+    memcpy((void *) tlaCopy, index->tlaCopies + entry->copy * tlaSize(), tlaSize());
+    memcpy(ntlCopy, &index->ntlCopies[entry->copy], sizeof(NativeThreadLocalsStruct));
+    tla_store(tlaCopy, NATIVE_THREAD_LOCALS, ntlCopy);
+#if log_TELE
+    log_print("teleProcess_lookupTLA(%p): ", stackPointer);
+    tla_println(tlaCopy);
+#endif
+    return tlaCopy;
+}
+
+void teleProcess_freeTLAIndex(TLAIndex index) {
+    if (index != NULL) {
+        free(index->tlaCopies);
+        free(index->ntlCopies);
+        free(index->entries);
+        free(index);
     }
-    return 0;
 }
 
 int teleProcess_read(ProcessHandle ph, JNIEnv *env, jclass c, jlong src, jobject dst, jboolean isDirectByteBuffer, jint offset, jint length) {
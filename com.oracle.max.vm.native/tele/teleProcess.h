@@ -82,21 +82,41 @@ typedef struct maxve_memory_handler *ProcessHandle;
 #endif
 
 /**
- * Searches the thread locals list in the VM's address space for an entry 'tla' such that:
+ * A copy of all the entries in the thread locals list in the VM's address space, indexed by stack range.
+ */
+typedef struct TLAIndexStruct *TLAIndex;
+
+/**
+ * Copies every entry in the thread locals list in the VM's address space, along with its native thread locals,
+ * and sorts the copies by stack base. This reads each entry once, so that finding the entries for all of a
+ * process's threads with teleProcess_lookupTLA() costs a number of reads linear in the number of threads.
+ *
+ * @param ph a platform specific process handle
+ * @param tlaList the head of the thread locals list in the VM's address space
+ * @return the index, which must be released with teleProcess_freeTLAIndex(), or NULL if it could not be allocated
+ */
+extern TLAIndex teleProcess_indexTLAs(ProcessHandle ph, Address tlaList);
+
+/**
+ * Searches an index of the thread locals list for an entry 'tla' such that:
  *
  *   tla.stackBase <= stackPointer && stackPointer < (tla.stackBase + tla.stackSize)
  *
- * If such an entry is found, then its contents are copied from the VM to the structs pointed to by 'tlCopy' and 'ntlCopy'.
+ * If such an entry is found, then its contents are copied to the structs pointed to by 'tlaCopy' and 'ntlCopy'.
  *
- * @param ph a platform specific process handle
- * @param tlaList the head of the thread locals list in the VM's address space
+ * @param index an index created by teleProcess_indexTLAs()
  * @param stackPointer the stack pointer to search with
- * @param tlaCopy pointer to a TLA which the found entry (if any) will be copied from the VM's address space
+ * @param tlaCopy pointer to a TLA into which the found entry (if any) will be copied
  * @param ntlCopy pointer to storage for a NativeThreadLocalsStruct into which the native thread locals of the found entry
- *        (if any) will be copied from the VM's address space
+ *        (if any) will be copied
  * @return the entry that was found, NULL otherwise
  */
-extern TLA teleProcess_findTLA(ProcessHandle ph, Address tlaList, Address stackPointer, TLA tlaCopy, NativeThreadLocals ntlCopy);
+extern TLA teleProcess_lookupTLA(TLAIndex index, Address stackPointer, TLA tlaCopy, NativeThreadLocals ntlCopy);
+
+/**
+ * Releases an index created by teleProcess_indexTLAs().
+ */
+extern void teleProcess_freeTLAIndex(TLAIndex index);
 
 /**
  * Makes the upcall to TeleProcess.jniGatherThread
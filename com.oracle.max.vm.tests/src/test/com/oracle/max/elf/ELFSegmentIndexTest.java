@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2007, 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package test.com.oracle.max.elf;
+
+import static com.oracle.max.elf.ELFFileMapping.*;
+
+import java.io.*;
+import java.nio.*;
+
+import com.oracle.max.elf.*;
+import com.sun.max.ide.*;
+
+/**
+ * Tests the lookup of virtual addresses in the loadable segments of an ELF file with {@link ELFSegmentIndex}
+ * and the mapping of the resulting file ranges with {@link ELFFileMapping}, including ranges on either side of
+ * and across the boundary between two mapping windows.
+ */
+public class ELFSegmentIndexTest extends MaxTestCase {
+
+    public ELFSegmentIndexTest(String name) {
+        super(name);
+    }
+
+    public static void main(String[] args) {
+        junit.textui.TestRunner.run(ELFSegmentIndexTest.class);
+    }
+
+    private static ELFSegmentIndex index(long[]... segments) {
+        final ELFHeader header = new ELFHeader();
+        header.e_phnum = (short) segments.length;
+        final ELFProgramHeaderTable table = new ELFProgramHeaderTable(header);
+        for (int i = 0; i < segments.length; i++) {
+            final ELFProgramHeaderTable.Entry64 entry = table.new Entry64();
+            entry.p_type = (int) segments[i][0];
+            entry.p_vaddr = segments[i][1];
+            entry.p_filesz = segments[i][2];
+            entry.p_memsz = segments[i][3];
+            entry.p_offset = segments[i][4];
+            table.entries[i] = entry;
+        }
+        return new ELFSegmentIndex(table);
+    }
+
+    private static long[] segment(int type, long vaddr, long filesz, long memsz, long offset) {
+        return new long[] {type, vaddr, filesz, memsz, offset};
+    }
+
+    public void test_find() {
+        final long high = 0xffffffffff600000L;
+        final ELFSegmentIndex index = index(
+            segment(ELFProgramHeaderTable.PT_LOAD, 0x3000, 0x1000, 0x1000, 0x5000),
+            segment(ELFProgramHeaderTable.PT_NOTE, 0x8000, 0x1000, 0x1000, 0x100),
+            segment(ELFProgramHeaderTable.PT_LOAD, high, 0x1000, 0x1000, 0x7000),
+            segment(ELFProgramHeaderTable.PT_LOAD, 0x1000, 0x1000, 0x2000, 0x1000),
+            segment(ELFProgramHeaderTable.PT_LOAD, 0x6000, 0, 0x1000, 0x9000));
+        assertEquals(3, index.size());
+
+        assertEquals(-1, index.find(0xfff));
+        final int first = index.find(0x1000);
+        assertEquals(0x1000, index.start(first));
+        // only the file-backed part of the segment is indexed
+        assertEquals(0x2000, index.end(first));
+        assertEquals(-1, index.find(0x2000));
+        assertEquals(0x1800, index.fileOffset(first, 0x1800));
+
+        final int second = index.find(0x3fff);
+        assertEquals(0x3000, index.start(second));
+        assertEquals(0x5fff, index.fileOffset(second, 0x3fff));
+        assertEquals(-1, index.find(0x4000));
+
+        // neither non-loadable nor empty segments are indexed
+        assertEquals(-1, index.find(0x8000));
+        assertEquals(-1, index.find(0x6000));
+
+        // addresses are compared unsigned
+        final int last = index.find(high + 0x10);
+        assertEquals(2, last);
+        assertEquals(0x7010, index.fileOffset(last, high + 0x10));
+        assertEquals(-1, index.find(high - 1));
+    }
+
+    public void test_overlap() {
+        final ELFSegmentIndex index = index(
+            segment(ELFProgramHeaderTable.PT_LOAD, 0x1800, 0x1000, 0x1000, 0x10000),
+            segment(ELFProgramHeaderTable.PT_LOAD, 0x1000, 0x1000, 0x1000, 0x20000),
+            segment(ELFProgramHeaderTable.PT_LOAD, 0x1200, 0x100, 0x100, 0x30000));
+        assertEquals(2, index.size());
+        final int first = index.find(0x17ff);
+        assertEquals(0x207ff, index.fileOffset(first, 0x17ff));
+        // the lower segment takes precedence where they overlap
+        assertEquals(first, index.find(0x1fff));
+        assertEquals(first, index.find(0x1200));
+        final int second = index.find(0x2000);
+        assertEquals(0x2000, index.start(second));
+        assertEquals(0x2800, index.end(second));
+        assertEquals(0x10800, index.fileOffset(second, 0x2000));
+    }
+
+    private static final int MARKERS = 16;
+
+    private static final long BOUNDARY = WINDOW_SIZE;
+
+    private static byte marker(long fileOffset) {
+        return (byte) (fileOffset * 31 + 7);
+    }
+
+    /**
+     * Creates a sparse file spanning two mapping windows, with marker bytes either side of the end of the first
+     * window and of the part of the second window mapped by the first one.
+     */
+    private static File createFile() throws IOException {
+        final File file = File.createTempFile("elfmapping", ".core");
+        file.deleteOnExit();
+        final RandomAccessFile raf = new RandomAccessFile(file, "rw");
+        try {
+            raf.setLength(BOUNDARY + WINDOW_OVERLAP + MARKERS * 2);
+            for (long start : new long[] {BOUNDARY - MARKERS, BOUNDARY + WINDOW_OVERLAP - MARKERS}) {
+                for (long offset = start; offset < start + MARKERS * 2; offset++) {
+                    raf.seek(offset);
+                    raf.write(marker(offset));
+                }
+            }
+        } finally {
+            raf.close();
+        }
+        return file;
+    }
+
+    private static void assertMarkers(ByteBuffer buffer, long fileOffset, int length) {
+        assertNotNull(buffer);
+        assertEquals(length, buffer.remaining());
+        for (int i = 0; i < length; i++) {
+            final long offset = fileOffset + i;
+            final boolean marked = (offset >= BOUNDARY - MARKERS && offset < BOUNDARY + MARKERS) ||
+                                   offset >= BOUNDARY + WINDOW_OVERLAP - MARKERS;
+            assertEquals("byte at " + offset, marked ? marker(offset) : 0, buffer.get(buffer.position() + i));
+        }
+    }
+
+    public void test_windowBoundary() throws IOException {
+        final File file = createFile();
+        final RandomAccessFile raf = new RandomAccessFile(file, "r");
+        try {
+            final ELFFileMapping mapping = new ELFFileMapping(raf.getChannel());
+            assertEquals(0, mapping.mappedWindows());
+
+            // the end of the first window
+            assertMarkers(mapping.range(BOUNDARY - MARKERS, MARKERS), BOUNDARY - MARKERS, MARKERS);
+            assertEquals(1, mapping.mappedWindows());
+
+            // a range across the boundary is served by the overlap of the first window
+            assertMarkers(mapping.range(BOUNDARY - MARKERS, MARKERS * 2), BOUNDARY - MARKERS, MARKERS * 2);
+            assertMarkers(mapping.range(BOUNDARY - 1, WINDOW_OVERLAP + 1), BOUNDARY - 1, WINDOW_OVERLAP + 1);
+            assertEquals(1, mapping.mappedWindows());
+
+            // but not past the end of the overlap
+            assertNull(mapping.range(BOUNDARY - 1, WINDOW_OVERLAP + 2));
+            assertNull(mapping.range(BOUNDARY - MARKERS, WINDOW_OVERLAP + MARKERS + 1));
+
+            // a range starting on the boundary is served by the second window
+            assertMarkers(mapping.range(BOUNDARY, MARKERS), BOUNDARY, MARKERS);
+            assertEquals(2, mapping.mappedWindows());
+            final long tail = BOUNDARY + WINDOW_OVERLAP - MARKERS;
+            assertMarkers(mapping.range(tail, MARKERS * 2), tail, MARKERS * 2);
+
+            // nor past the end of the file
+            assertNull(mapping.range(BOUNDARY + WINDOW_OVERLAP, MARKERS * 2 + 1));
+            assertNull(mapping.range(BOUNDARY + WINDOW_OVERLAP + MARKERS * 2, 1));
+        } finally {
+            raf.close();
+            file.delete();
+        }
+    }
+
+    public void test_segmentAcrossBoundary() throws IOException {
+        final File file = createFile();
+        final RandomAccessFile raf = new RandomAccessFile(file, "r");
+        try {
+            final ELFFileMapping mapping = new ELFFileMapping(raf.getChannel());
+            final long vaddr = 0x7f0000000000L;
+            final long offset = BOUNDARY - 0x1000;
+            final ELFSegmentIndex index = index(segment(ELFProgramHeaderTable.PT_LOAD, vaddr, 0x2000, 0x2000, offset));
+            final long address = vaddr + 0x1000 - MARKERS;
+            final int segment = index.find(address);
+            assertEquals(0, segment);
+            final long fileOffset = index.fileOffset(segment, address);
+            assertEquals(BOUNDARY - MARKERS, fileOffset);
+            final int length = (int) Math.min(WINDOW_OVERLAP, index.end(segment) - address);
+            assertMarkers(mapping.range(fileOffset, length), fileOffset, length);
+        } finally {
+            raf.close();
+            file.delete();
+        }
+    }
+}
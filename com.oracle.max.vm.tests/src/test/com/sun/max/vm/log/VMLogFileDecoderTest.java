@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2007, 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package test.com.sun.max.vm.log;
+
+import static com.sun.max.vm.log.nat.mapped.VMLogNativeMapped.*;
+
+import java.io.*;
+import java.nio.*;
+
+import com.sun.max.ide.*;
+import com.sun.max.vm.log.VMLog.Record;
+import com.sun.max.vm.log.hosted.*;
+
+/**
+ * Tests that {@link VMLogFileDecoder} only decodes the complete records of a file written by
+ * {@link com.sun.max.vm.log.nat.mapped.VMLogNativeMapped}.
+ */
+public class VMLogFileDecoderTest extends MaxTestCase {
+
+    private static final int LOGGER_ID = 3;
+    private static final int THREAD_ID = 5;
+    private static final int WORD_SIZE = 8;
+    private static final int RECORD_SIZE = ARGS_OFFSET + Record.MAX_ARGS * WORD_SIZE;
+    private static final int LOG_ENTRIES = 4;
+    private static final int DATA_OFFSET = 256;
+
+    public VMLogFileDecoderTest(String name) {
+        super(name);
+    }
+
+    public static void main(String[] args) {
+        junit.textui.TestRunner.run(VMLogFileDecoderTest.class);
+    }
+
+    private static int header(int op, int argCount, int loggerId) {
+        return (THREAD_ID << Record.THREAD_SHIFT) | (op << Record.OPERATION_SHIFT) | (loggerId << Record.LOGGER_ID_SHIFT) | argCount;
+    }
+
+    private static int recordOffset(int slot) {
+        return DATA_OFFSET + slot * RECORD_SIZE;
+    }
+
+    private static void putString(ByteBuffer buffer, String s) throws UnsupportedEncodingException {
+        final byte[] bytes = s.getBytes("UTF-8");
+        buffer.putInt(bytes.length);
+        buffer.put(bytes);
+        buffer.position((buffer.position() + 3) & ~3);
+    }
+
+    private static void putRecord(ByteBuffer buffer, int slot, int header, int id, long... args) {
+        final int offset = recordOffset(slot);
+        buffer.putInt(offset, header);
+        buffer.putInt(offset + ID_OFFSET, id);
+        for (int n = 0; n < args.length; n++) {
+            buffer.putLong(offset + ARGS_OFFSET + n * WORD_SIZE, args[n]);
+        }
+    }
+
+    private static File writeLogFile(boolean initialized) throws IOException {
+        final ByteBuffer buffer = ByteBuffer.allocate(DATA_OFFSET + LOG_ENTRIES * RECORD_SIZE).order(ByteOrder.LITTLE_ENDIAN);
+        buffer.putInt(VERSION_OFFSET, VERSION);
+        buffer.putInt(WORD_SIZE_OFFSET, WORD_SIZE);
+        buffer.putInt(RECORD_SIZE_OFFSET, RECORD_SIZE);
+        buffer.putInt(LOG_ENTRIES_OFFSET, LOG_ENTRIES);
+        buffer.putInt(METADATA_OFFSET_OFFSET, FILE_HEADER_SIZE);
+        buffer.putInt(DATA_OFFSET_OFFSET, DATA_OFFSET);
+        buffer.position(FILE_HEADER_SIZE);
+        buffer.putInt(1);
+        buffer.putInt(LOGGER_ID);
+        putString(buffer, "Test");
+        buffer.putInt(2);
+        buffer.putInt(0);
+        putString(buffer, "First");
+        buffer.putInt(2);
+        putString(buffer, "Second");
+
+        // a complete record
+        putRecord(buffer, 0, header(1, 2, LOGGER_ID), 7, 0x10, 0x20);
+        // a record torn after its id and first argument were written: the header is still clear
+        putRecord(buffer, 1, 0, 8, 0x30);
+        // a record of a logger that is not in the metadata
+        putRecord(buffer, 2, header(0, 1, LOGGER_ID + 1), 6, 0x40);
+        // a complete record, older than the one in slot 0
+        putRecord(buffer, 3, header(0, 1, LOGGER_ID), 5, 0x50);
+        if (initialized) {
+            buffer.putInt(MAGIC_OFFSET, MAGIC);
+        }
+
+        final File file = File.createTempFile("VMLogFileDecoderTest", null);
+        file.deleteOnExit();
+        final FileOutputStream out = new FileOutputStream(file);
+        try {
+            out.write(buffer.array());
+        } finally {
+            out.close();
+        }
+        return file;
+    }
+
+    private static String decode(VMLogFileDecoder decoder, int offset) {
+        final ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+        final PrintStream out = new PrintStream(bytes);
+        decoder.printDecoded(offset, out);
+        out.flush();
+        return bytes.toString().trim();
+    }
+
+    public void test_tornRecordsAreSkipped() throws IOException {
+        final VMLogFileDecoder decoder = new VMLogFileDecoder(writeLogFile(true));
+        final Integer[] offsets = decoder.recordOffsets();
+        assertEquals(2, offsets.length);
+        assertEquals(recordOffset(3), offsets[0].intValue());
+        assertEquals(recordOffset(0), offsets[1].intValue());
+        assertEquals("5 [5] Test.First(0x50)", decode(decoder, offsets[0]));
+        assertEquals("7 [5] Test.Second(0x10, @0x20)", decode(decoder, offsets[1]));
+    }
+
+    public void test_uninitializedFileIsRejected() throws IOException {
+        try {
+            new VMLogFileDecoder(writeLogFile(false));
+            fail();
+        } catch (IOException e) {
+        }
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2009, 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package test.vm.output;
+
+import java.io.*;
+import java.net.*;
+import java.nio.*;
+import java.nio.channels.*;
+
+import sun.nio.ch.*;
+
+import com.sun.max.vm.io.*;
+
+/**
+ * Exercises {@link AsyncIO} over loopback: accepts a connection, reads from and writes to it and waits for a timeout,
+ * each through the submission and completion queues. Run with {@code -XX:-UseIOUring} to test the epoll engine.
+ */
+public class AsyncIOLoopback implements MaxineOnly {
+
+    private static final long ACCEPT = 1;
+    private static final long READ = 2;
+    private static final long WRITE = 3;
+    private static final long TIMEOUT = 4;
+
+    public static void main(String[] args) throws Exception {
+        final ServerSocketChannel server = ServerSocketChannel.open();
+        server.socket().bind(new InetSocketAddress(InetAddress.getByName("127.0.0.1"), 0));
+        final AsyncIO aio = new AsyncIO(16);
+        final long[] userData = new long[16];
+        final long[] results = new long[16];
+
+        aio.accept(((SelChImpl) server).getFD(), ACCEPT);
+        aio.timeout(10000000L, TIMEOUT);
+        System.out.println("submitted " + aio.submit());
+        final SocketChannel client = SocketChannel.open(server.socket().getLocalSocketAddress());
+
+        // The accept and the timeout complete in either order, so their results are only printed once both are in.
+        FileDescriptor accepted = null;
+        boolean timedOut = false;
+        int n = 0;
+        while (n < 2) {
+            final int count = aio.reap(userData, results, 1, -1);
+            for (int i = 0; i < count; i++) {
+                if (userData[i] == ACCEPT) {
+                    if (results[i] < 0) {
+                        throw new Error("accept failed: " + results[i]);
+                    }
+                    accepted = AsyncIO.newFileDescriptor((int) results[i]);
+                } else if (userData[i] == TIMEOUT) {
+                    timedOut = true;
+                } else {
+                    throw new Error("unexpected completion of operation " + userData[i]);
+                }
+            }
+            n += count;
+        }
+        System.out.println("accepted " + (accepted != null));
+        System.out.println("timed out " + timedOut);
+
+        final ByteBuffer in = ByteBuffer.allocateDirect(64);
+        aio.read(accepted, in, -1, READ);
+        aio.submit();
+        System.out.println("nothing to read yet: " + aio.reap(userData, results, 1, 0));
+        client.write(ByteBuffer.wrap("hello".getBytes()));
+        check(aio.reap(userData, results, 1, -1), userData, READ);
+        in.limit((int) results[0]);
+        final byte[] bytes = new byte[in.remaining()];
+        in.get(bytes);
+        System.out.println("read " + new String(bytes));
+
+        final ByteBuffer out = ByteBuffer.allocateDirect(64);
+        out.put("world".getBytes()).flip();
+        aio.write(accepted, out, -1, WRITE);
+        aio.submit();
+        check(aio.reap(userData, results, 1, -1), userData, WRITE);
+        System.out.println("wrote " + results[0]);
+        final ByteBuffer reply = ByteBuffer.allocate(5);
+        while (reply.hasRemaining()) {
+            client.read(reply);
+        }
+        System.out.println("client read " + new String(reply.array()));
+
+        aio.close();
+        // closes the accepted connection
+        new FileInputStream(accepted).close();
+        client.close();
+        server.close();
+    }
+
+    private static void check(int count, long[] userData, long expected) {
+        if (count != 1 || userData[0] != expected) {
+            throw new Error("expected the completion of operation " + expected);
+        }
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package test.vm.output;
+
+import java.io.*;
+import java.nio.*;
+
+import com.sun.max.vm.io.*;
+
+/**
+ * Exercises the positional, vectored and zero-copy operations of {@link FileIO} on temporary files,
+ * checking the data transferred and that the file pointers of the descriptors involved are left alone
+ * (except for the output of {@link FileIO#transferTo}, which is written at its current position).
+ */
+public class FileIOPositional implements MaxineOnly {
+
+    public static void main(String[] args) throws Exception {
+        final File file = File.createTempFile("FileIOPositional", null);
+        final File copy = File.createTempFile("FileIOPositional", null);
+        file.deleteOnExit();
+        copy.deleteOnExit();
+        final RandomAccessFile raf = new RandomAccessFile(file, "rw");
+        final RandomAccessFile copyRaf = new RandomAccessFile(copy, "rw");
+        final FileDescriptor fd = raf.getFD();
+        final FileDescriptor copyFd = copyRaf.getFD();
+
+        // pwrite, including past the end of the file
+        ByteBuffer buffer = direct("0123456789");
+        check("pwrite", FileIO.pwrite(fd, buffer, 0), 10);
+        check("pwrite consumes the buffer", buffer.remaining(), 0);
+        check("pwrite past end", FileIO.pwrite(fd, direct("abc"), 20), 3);
+        check("file length", raf.length(), 23L);
+        check("file pointer after pwrite", raf.getFilePointer(), 0L);
+
+        // pread, including at the end of the file
+        buffer = ByteBuffer.allocateDirect(4);
+        check("pread", FileIO.pread(fd, buffer, 3), 4);
+        check("pread data", string(buffer), "3456");
+        check("pread at end", FileIO.pread(fd, ByteBuffer.allocateDirect(4), 23), -1);
+        buffer = ByteBuffer.allocateDirect(8);
+        check("pread short", FileIO.pread(fd, buffer, 21), 2);
+        check("pread short data", string(buffer), "bc");
+        check("file pointer after pread", raf.getFilePointer(), 0L);
+
+        // pwritev and preadv, with reads split across buffer boundaries
+        check("pwritev", FileIO.pwritev(fd, new ByteBuffer[] {direct("AB"), direct(""), direct("CD")}, 10), 4L);
+        final ByteBuffer[] buffers = {ByteBuffer.allocateDirect(2), ByteBuffer.allocateDirect(3), ByteBuffer.allocateDirect(5)};
+        check("preadv", FileIO.preadv(fd, buffers, 8), 10L);
+        check("preadv data 0", string(buffers[0]), "89");
+        check("preadv data 1", string(buffers[1]), "ABC");
+        check("preadv data 2", string(buffers[2]), "D\0\0\0\0");
+        final ByteBuffer[] tail = {ByteBuffer.allocateDirect(2), ByteBuffer.allocateDirect(2)};
+        check("preadv short", FileIO.preadv(fd, tail, 20), 3L);
+        check("preadv short remaining", tail[0].remaining() + tail[1].remaining(), 1);
+        check("preadv at end", FileIO.preadv(fd, new ByteBuffer[] {ByteBuffer.allocateDirect(1)}, 23), -1L);
+        check("file pointer after preadv", raf.getFilePointer(), 0L);
+
+        // copyRange between files and transferTo at the current position of the output
+        check("copyRange", FileIO.copyRange(fd, 0, copyFd, 5, 10), 10L);
+        buffer = ByteBuffer.allocateDirect(15);
+        check("copyRange read back", FileIO.pread(copyFd, buffer, 0), 15);
+        check("copyRange data", string(buffer), "\0\0\0\0\u00000123456789");
+        check("copyRange at end", FileIO.copyRange(fd, 23, copyFd, 0, 10), 0L);
+        copyRaf.seek(2);
+        check("transferTo", FileIO.transferTo(fd, 20, 3, copyFd), 3L);
+        check("file pointer after transferTo", copyRaf.getFilePointer(), 5L);
+        buffer = ByteBuffer.allocateDirect(7);
+        FileIO.pread(copyFd, buffer, 0);
+        check("transferTo data", string(buffer), "\0\u0000abc01");
+        check("file pointers after copies", raf.getFilePointer(), 0L);
+
+        // copyRange to a higher range of the same file that overlaps the source
+        check("pwrite before overlapping copyRange", FileIO.pwrite(copyFd, direct("abcdefgh"), 0), 8);
+        check("copyRange overlapping", FileIO.copyRange(copyFd, 0, copyFd, 2, 6), 6L);
+        buffer = ByteBuffer.allocateDirect(8);
+        FileIO.pread(copyFd, buffer, 0);
+        check("copyRange overlapping data", string(buffer), "ababcdef");
+
+        FileIO.fadvise(fd, 0, 0, FileIO.Advice.SEQUENTIAL);
+        FileIO.fadvise(fd, 0, 0, FileIO.Advice.DONTNEED);
+
+        try {
+            FileIO.pread(fd, ByteBuffer.allocate(4), 0);
+            throw new Error("heap buffer accepted");
+        } catch (IllegalArgumentException e) {
+            System.out.println("heap buffer rejected");
+        }
+
+        raf.close();
+        copyRaf.close();
+        try {
+            FileIO.pread(fd, ByteBuffer.allocateDirect(4), 0);
+            throw new Error("read from closed file");
+        } catch (IOException e) {
+            System.out.println("closed file rejected");
+        }
+        file.delete();
+        copy.delete();
+    }
+
+    private static ByteBuffer direct(String s) {
+        final ByteBuffer buffer = ByteBuffer.allocateDirect(s.length());
+        buffer.put(s.getBytes()).flip();
+        return buffer;
+    }
+
+    private static String string(ByteBuffer buffer) {
+        buffer.flip();
+        final byte[] bytes = new byte[buffer.remaining()];
+        buffer.get(bytes);
+        return new String(bytes);
+    }
+
+    private static void check(String what, Object actual, Object expected) {
+        if (!actual.equals(expected)) {
+            throw new Error(what + ": expected " + expected + " but got " + actual);
+        }
+        System.out.println(what + ": " + actual.toString().replace('\0', '.'));
+    }
+}
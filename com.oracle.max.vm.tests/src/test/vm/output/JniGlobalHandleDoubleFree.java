@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package test.vm.output;
+
+import java.util.*;
+
+import com.sun.max.unsafe.*;
+import com.sun.max.vm.jni.*;
+
+/**
+ * Has several threads free the same global JNI handles at the same time. Only one free of each handle
+ * may take effect: the number of live handles must return to where it was, and handles allocated
+ * afterwards must all be distinct, which they would not be if a slot had been put on a free list twice.
+ */
+public class JniGlobalHandleDoubleFree implements MaxineOnly {
+
+    private static final int THREADS = 4;
+    private static final int HANDLES = 1000;
+    private static final int ROUNDS = 10;
+
+    public static void main(String[] args) throws Exception {
+        final int baseline = JniHandles.liveGlobalHandles();
+        for (int round = 0; round < ROUNDS; round++) {
+            final long[] handles = new long[HANDLES];
+            for (int i = 0; i < HANDLES; i++) {
+                handles[i] = JniHandles.createGlobalHandle(new Integer(i)).asAddress().toLong();
+            }
+            final Thread[] threads = new Thread[THREADS];
+            for (int t = 0; t < THREADS; t++) {
+                threads[t] = new Thread() {
+                    @Override
+                    public void run() {
+                        for (long handle : handles) {
+                            JniHandles.destroyGlobalHandle(Address.fromLong(handle).asJniHandle());
+                        }
+                    }
+                };
+            }
+            for (Thread thread : threads) {
+                thread.start();
+            }
+            for (Thread thread : threads) {
+                thread.join();
+            }
+            check("live handles after round " + round, JniHandles.liveGlobalHandles(), baseline);
+
+            // Reallocate more handles than were freed so that every recycled slot is handed out
+            final Object[] objects = new Object[HANDLES * THREADS];
+            final long[] reallocated = new long[objects.length];
+            final Set<Long> distinct = new HashSet<Long>();
+            for (int i = 0; i < objects.length; i++) {
+                objects[i] = new Object();
+                reallocated[i] = JniHandles.createGlobalHandle(objects[i]).asAddress().toLong();
+                distinct.add(reallocated[i]);
+            }
+            check("distinct handles after round " + round, distinct.size(), objects.length);
+            for (int i = 0; i < objects.length; i++) {
+                final JniHandle handle = Address.fromLong(reallocated[i]).asJniHandle();
+                if (JniHandles.get(handle) != objects[i]) {
+                    throw new Error("handle " + i + " does not refer to its object");
+                }
+                JniHandles.destroyGlobalHandle(handle);
+            }
+        }
+        check("live handles at end", JniHandles.liveGlobalHandles(), baseline);
+    }
+
+    private static void check(String what, int actual, int expected) {
+        if (actual != expected) {
+            throw new Error(what + ": expected " + expected + " but got " + actual);
+        }
+        System.out.println(what + ": ok");
+    }
+}
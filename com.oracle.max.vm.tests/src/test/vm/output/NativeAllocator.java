@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package test.vm.output;
+
+import com.sun.max.memory.*;
+import com.sun.max.unsafe.*;
+
+/**
+ * Exercises the size-class arenas and per-thread caches behind {@link Memory#allocate(Size, Memory.Tag, boolean)}.
+ * Blocks of every size class and some large blocks are checked for alignment, zeroing and overlap, grown and
+ * shrunk across class boundaries, and freed by threads other than the one that allocated them. The allocations
+ * are accounted to the {@linkplain Memory.Tag#TEST test tag}, which nothing else uses, and the bytes recorded
+ * for it must return to where they were once everything has been freed.
+ */
+public class NativeAllocator implements MaxineOnly {
+
+    private static final Memory.Tag TAG = Memory.Tag.TEST;
+    private static final int MAX_SIZE = 4200;
+    private static final int THREADS = 4;
+    private static final int BLOCKS_PER_THREAD = 2000;
+
+    public static void main(String[] args) throws Exception {
+        final long baseline = allocated();
+        sizeClasses(baseline);
+        reallocation(baseline);
+        crossThreadFree(baseline);
+        churn(baseline);
+    }
+
+    private static void sizeClasses(long baseline) {
+        final Pointer[] blocks = new Pointer[MAX_SIZE + 1];
+        long total = 0;
+        for (int size = 0; size <= MAX_SIZE; size++) {
+            blocks[size] = Memory.mustAllocate(size, TAG, true);
+            if ((blocks[size].toLong() & 15) != 0) {
+                throw new Error("block of " + size + " bytes is not 16 byte aligned");
+            }
+            for (int i = 0; i < size; i++) {
+                if (blocks[size].getByte(i) != 0) {
+                    throw new Error("block of " + size + " bytes is not zeroed at " + i);
+                }
+            }
+            fill(blocks[size], size, size);
+            total += size;
+        }
+        check("bytes of all sizes", allocated() - baseline, total);
+        for (int size = 0; size <= MAX_SIZE; size++) {
+            verify(blocks[size], size, size);
+            Memory.deallocate(blocks[size]);
+        }
+        check("bytes after freeing all sizes", allocated() - baseline, 0);
+    }
+
+    private static void reallocation(long baseline) {
+        // Within a class, to the next class, to a large block and back to a small one
+        final int[] sizes = {1, 10, 40, 1000, 4080, 4081, 100000, 200, 0};
+        Pointer block = Memory.mustAllocate(sizes[0], TAG, false);
+        fill(block, sizes[0], 7);
+        for (int i = 1; i < sizes.length; i++) {
+            final int oldSize = sizes[i - 1];
+            final int newSize = sizes[i];
+            block = Memory.reallocate(block, Size.fromInt(newSize));
+            if (block.isZero()) {
+                throw new Error("reallocation to " + newSize + " bytes failed");
+            }
+            verify(block, Math.min(oldSize, newSize), 7);
+            fill(block, newSize, 7);
+            check("bytes after reallocation to " + newSize, allocated() - baseline, newSize);
+        }
+        Memory.deallocate(block);
+        check("bytes after freeing reallocated block", allocated() - baseline, 0);
+    }
+
+    private static void crossThreadFree(long baseline) throws InterruptedException {
+        final Pointer[] blocks = new Pointer[BLOCKS_PER_THREAD];
+        for (int i = 0; i < blocks.length; i++) {
+            blocks[i] = Memory.mustAllocate(size(i), TAG, false);
+            fill(blocks[i], size(i), i);
+        }
+        final Thread freer = new Thread() {
+            @Override
+            public void run() {
+                for (int i = 0; i < blocks.length; i++) {
+                    verify(blocks[i], size(i), i);
+                    Memory.deallocate(blocks[i]);
+                }
+            }
+        };
+        freer.start();
+        freer.join();
+        check("bytes after freeing in another thread", allocated() - baseline, 0);
+    }
+
+    private static void churn(long baseline) throws InterruptedException {
+        final Thread[] threads = new Thread[THREADS];
+        for (int t = 0; t < THREADS; t++) {
+            final int seed = t;
+            threads[t] = new Thread() {
+                @Override
+                public void run() {
+                    final Pointer[] blocks = new Pointer[BLOCKS_PER_THREAD];
+                    for (int round = 0; round < 5; round++) {
+                        for (int i = 0; i < blocks.length; i++) {
+                            blocks[i] = Memory.mustAllocate(size(i + seed), TAG, false);
+                            fill(blocks[i], size(i + seed), i + round);
+                        }
+                        for (int i = 0; i < blocks.length; i++) {
+                            verify(blocks[i], size(i + seed), i + round);
+                            Memory.deallocate(blocks[i]);
+                        }
+                    }
+                }
+            };
+        }
+        for (Thread thread : threads) {
+            thread.start();
+        }
+        for (Thread thread : threads) {
+            thread.join();
+        }
+        check("bytes after concurrent churn", allocated() - baseline, 0);
+    }
+
+    private static int size(int i) {
+        return (i * 37) % 600 + 1;
+    }
+
+    private static long allocated() {
+        return NativeMemoryTracking.allocatedBytes(TAG).toLong();
+    }
+
+    private static void fill(Pointer block, int size, int seed) {
+        for (int i = 0; i < size; i++) {
+            block.setByte(i, (byte) (seed + i));
+        }
+    }
+
+    private static void verify(Pointer block, int size, int seed) {
+        for (int i = 0; i < size; i++) {
+            if (block.getByte(i) != (byte) (seed + i)) {
+                throw new Error("block at " + block.toHexString() + " of " + size + " bytes was overwritten at " + i);
+            }
+        }
+    }
+
+    private static void check(String what, long actual, long expected) {
+        if (actual != expected) {
+            throw new Error(what + ": expected " + expected + " but got " + actual);
+        }
+        System.out.println(what + ": ok");
+    }
+}
@@ -51,6 +51,7 @@ public class Package extends BootImagePackage {
             "com.sun.max.vm.debug.*",
             "com.sun.max.vm.heap.**",
             "com.sun.max.vm.instrument.*",
+            "com.sun.max.vm.io.*",
             "com.sun.max.vm.jdk.**",
             "com.sun.max.vm.jni.*",
             "com.sun.max.vm.ti.*",
@@ -37,7 +37,8 @@ import com.sun.max.vm.runtime.*;
  * This class provides methods to access raw memory through pointers.
  * It also provides allocation methods that are expected to be for small quantities
  * of memory (or quantities that are not multiple of a page) that will be satisfied
- * by the native allocation library, i.e. malloc/free.
+ * by the VM's native allocator (see memory.c). Each allocation is accounted to a {@link Tag}
+ * and can optionally skip zeroing when the caller overwrites the whole block.
  * Large amounts of memory should be allocated using the {@link VirtualMemory} class.
  */
 public final class Memory {
@@ -58,23 +59,55 @@ public final class Memory {
      */
     public static final long ZAPPED_MARKER = 0xDEADBEEFCAFEBABEL;
 
+    /**
+     * The subsystems to which native memory allocations are accounted.
+     * The ordinals must be kept in sync with the MEMORY_TAG_* constants in memory.h.
+     */
+    public enum Tag {
+        UNKNOWN,
+        JNI,
+        STRING,
+        MONITOR,
+        IO,
+        UNSAFE,
+        LOG,
+        GC,
+        VM,
+        /**
+         * Reserved for tests that check the accounting of their own allocations.
+         */
+        TEST
+    }
+
     @C_FUNCTION
-    private static native Pointer memory_allocate(Size size);
+    private static native Pointer memory_allocateTagged(Size size, int tag, boolean zero);
 
     /**
-     * Allocates an aligned chunk of memory using a malloc(3)-like facility.
+     * Allocates an aligned, zeroed chunk of memory using a malloc(3)-like facility.
      *
      * @param size the size of the chunk of memory to be allocated
      * @return a pointer to the allocated chunk of memory or {@code Pointer.zero()} if allocation failed
      */
     public static Pointer allocate(Size size) {
+        return allocate(size, Tag.UNKNOWN, true);
+    }
+
+    /**
+     * Allocates an aligned chunk of memory using a malloc(3)-like facility.
+     *
+     * @param size the size of the chunk of memory to be allocated
+     * @param tag the subsystem to which the allocation is accounted
+     * @param zero specifies if the chunk must be zeroed. Callers that overwrite the whole chunk should pass {@code false}.
+     * @return a pointer to the allocated chunk of memory or {@code Pointer.zero()} if allocation failed
+     */
+    public static Pointer allocate(Size size, Tag tag, boolean zero) {
         if (size.toLong() < 0) {
             throw new IllegalArgumentException();
         }
         if (isHosted()) {
             return boxedAllocate(size);
         }
-        return memory_allocate(size);
+        return memory_allocateTagged(size, tag.ordinal(), zero);
     }
 
     @HOSTED_ONLY
@@ -93,7 +126,21 @@ public final class Memory {
      * @throws OutOfMemoryError if allocation failed or log message and VM termination if early in bootstrap
      */
     public static Pointer mustAllocate(Size size) throws OutOfMemoryError, IllegalArgumentException {
-        final Pointer result = isHosted() ? boxedAllocate(size) : memory_allocate(size);
+        return mustAllocate(size, Tag.UNKNOWN, true);
+    }
+
+    /**
+     * @param size the size of the chunk of memory to be allocated
+     * @param tag the subsystem to which the allocation is accounted
+     * @param zero specifies if the chunk must be zeroed
+     * @return a pointer to the allocated chunk of memory
+     * @throws OutOfMemoryError if allocation failed or log message and VM termination if early in bootstrap
+     */
+    public static Pointer mustAllocate(Size size, Tag tag, boolean zero) throws OutOfMemoryError, IllegalArgumentException {
+        if (size.toLong() < 0) {
+            throw new IllegalArgumentException();
+        }
+        final Pointer result = isHosted() ? boxedAllocate(size) : memory_allocateTagged(size, tag.ordinal(), zero);
         if (result.isZero()) {
             if (MaxineVM.isPrimordialOrPristine()) {
                 MaxineVM.reportPristineMemoryFailure("unknown", "mustAllocate", size);
@@ -114,10 +161,25 @@ public final class Memory {
         return mustAllocate(Size.fromInt(size));
     }
 
+    /**
+     * @param size the size of the chunk of memory to be allocated
+     * @param tag the subsystem to which the allocation is accounted
+     * @param zero specifies if the chunk must be zeroed
+     * @return a pointer to the allocated chunk of memory
+     * @throws IllegalArgumentException if size is negative
+     * @throws OutOfMemoryError if allocation failed
+     */
+    public static Pointer mustAllocate(int size, Tag tag, boolean zero) throws OutOfMemoryError, IllegalArgumentException {
+        return mustAllocate(Size.fromInt(size), tag, zero);
+    }
+
     @C_FUNCTION
     private static native Pointer memory_reallocate(Pointer block, Size size);
 
     public static Pointer reallocate(Pointer block, Size size) throws OutOfMemoryError, IllegalArgumentException {
+        if (size.toLong() < 0) {
+            throw new IllegalArgumentException();
+        }
         if (isHosted()) {
             Pointer newBlock = allocate(size);
             Memory.copyBytes(block, newBlock, size);
@@ -208,6 +270,23 @@ public final class Memory {
         assert i.equals(numberOfBytes);
     }
 
+    @C_FUNCTION
+    private static native void memory_copy(Pointer fromPointer, Pointer toPointer, Size numberOfBytes);
+
+    /**
+     * Copies a non-overlapping block of memory with the platform's memcpy(3), which is much faster than
+     * {@link #copyBytes(Pointer, Pointer, Size)} for large blocks. The native call contains no safepoint,
+     * so either block may be the contents of a heap object if the caller has no safepoint polls either.
+     */
+    @INLINE
+    public static void bulkCopyBytes(Pointer fromPointer, Pointer toPointer, Size numberOfBytes) {
+        if (isHosted()) {
+            copyBytes(fromPointer, toPointer, numberOfBytes);
+        } else {
+            memory_copy(fromPointer, toPointer, numberOfBytes);
+        }
+    }
+
     @NO_SAFEPOINT_POLLS("speed")
     public static void readBytes(Pointer fromPointer, int numberOfBytes, byte[] toArray, int startIndex) {
         for (int i = 0; i < numberOfBytes; i++) {
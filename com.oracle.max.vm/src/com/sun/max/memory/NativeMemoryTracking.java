@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.sun.max.memory;
+
+import sun.misc.*;
+
+import com.sun.max.annotate.*;
+import com.sun.max.unsafe.*;
+import com.sun.max.vm.*;
+import com.sun.max.vm.MaxineVM.Phase;
+
+/**
+ * Reports the native memory of the VM process as recorded by native memory tracking (see nativeMemory.c).
+ * The VM always records its virtual memory reservations and commits, thread stacks, thread locals
+ * blocks and {@linkplain Memory#allocate(Size, Memory.Tag, boolean) native allocations}, so a summary
+ * or the change since a baseline can be printed at any time.
+ */
+public final class NativeMemoryTracking implements SignalHandler {
+
+    private static boolean PrintNativeMemoryAtExit = false;
+    private static boolean PrintNativeMemoryOnSignal = false;
+
+    static {
+        VMOptions.addFieldOption("-XX:", "PrintNativeMemoryAtExit", NativeMemoryTracking.class,
+            "Print a summary of the native memory used by the VM when it exits.", Phase.PRISTINE);
+        VMOptions.addFieldOption("-XX:", "PrintNativeMemoryOnSignal", NativeMemoryTracking.class,
+            "Print the native memory used by the VM and its change since the previous report when SIGUSR2 is received.", Phase.PRISTINE);
+    }
+
+    private NativeMemoryTracking() {
+    }
+
+    /**
+     * Takes the initial baseline and installs the reporting requested by the options.
+     */
+    public static void initialize() {
+        baseline();
+        if (PrintNativeMemoryOnSignal) {
+            Signal.handle(new Signal("USR2"), new NativeMemoryTracking());
+        }
+        if (PrintNativeMemoryAtExit) {
+            Runtime.getRuntime().addShutdownHook(new Thread("NativeMemoryTrackingPrinter") {
+                @Override
+                public void run() {
+                    printSummary();
+                }
+            });
+        }
+    }
+
+    public void handle(Signal sig) {
+        printDiff();
+        baseline();
+    }
+
+    /**
+     * Prints the reserved and committed native memory of each category to the {@linkplain Log log stream}.
+     */
+    public static void printSummary() {
+        nativeMemory_printSummary();
+    }
+
+    /**
+     * Prints the change of the native memory of each category since the last {@linkplain #baseline() baseline}.
+     */
+    public static void printDiff() {
+        nativeMemory_printDiff();
+    }
+
+    /**
+     * Records the current native memory usage as the baseline for {@link #printDiff()}.
+     */
+    public static void baseline() {
+        nativeMemory_baseline();
+    }
+
+    /**
+     * Gets the number of bytes of native memory currently committed by the VM.
+     */
+    public static Size totalCommitted() {
+        return nativeMemory_totalCommitted();
+    }
+
+    /**
+     * Gets the number of bytes currently {@linkplain Memory#allocate(Size, Memory.Tag, boolean) allocated} for a given tag.
+     */
+    public static Size allocatedBytes(Memory.Tag tag) {
+        return nativeMemory_mallocBytes(tag.ordinal());
+    }
+
+    @C_FUNCTION
+    private static native void nativeMemory_printSummary();
+
+    @C_FUNCTION
+    private static native void nativeMemory_printDiff();
+
+    @C_FUNCTION
+    private static native void nativeMemory_baseline();
+
+    @C_FUNCTION
+    private static native Size nativeMemory_totalCommitted();
+
+    @C_FUNCTION
+    private static native Size nativeMemory_mallocBytes(int tag);
+}
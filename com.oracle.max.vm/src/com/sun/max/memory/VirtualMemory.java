@@ -46,8 +46,27 @@ import com.sun.max.vm.MaxineVM.Phase;
  */
 public final class VirtualMemory {
     private static boolean TraceAnonOperations = false;
+
+    /*
+     * The large page options are acted upon by the native launcher (see maxine.c) before the boot image is mapped.
+     * They are registered here so that they are accepted and documented like any other VM option.
+     */
+    private static boolean UseLargePages = false;
+    private static boolean UseTransparentHugePages = false;
+    private static Size LargePageSizeInBytes = Size.zero();
+    public static boolean PrintLargePages = false;
+
     static {
         VMOptions.addFieldOption("-XX:", "TraceAnonOperations", VirtualMemory.class, "TraceAnonOperations", Phase.PRISTINE);
+        VMOptions.addFieldOption("-XX:", "UseLargePages", VirtualMemory.class,
+            "Back the heap and code cache with explicit large pages from hugetlbfs, " +
+            "falling back to transparent huge pages if none are available.", Phase.PRISTINE);
+        VMOptions.addFieldOption("-XX:", "UseTransparentHugePages", VirtualMemory.class,
+            "Back the heap and code cache with transparent huge pages.", Phase.PRISTINE);
+        VMOptions.addFieldOption("-XX:", "LargePageSizeInBytes", VirtualMemory.class,
+            "Large page size (0 selects the platform default, e.g. 2M on x64 Linux).", Phase.PRISTINE);
+        VMOptions.addFieldOption("-XX:", "PrintLargePages", VirtualMemory.class,
+            "Print the large page configuration at startup and the large page coverage of the heap and code cache at exit.", Phase.PRISTINE);
     }
 
     public enum Type {
@@ -226,6 +245,45 @@ public final class VirtualMemory {
         return !uncommitted.isZero();
     }
 
+    /**
+     * Reserves the code space, a window of virtual space from which {@link #commitCodeSpace(Size)} hands out committed
+     * chunks in increasing address order. This can only be done once.
+     *
+     * @param address page aligned start of the window, or zero to let the OS choose. A non-zero address must lie in
+     *            virtual space already reserved by the VM as the window is mapped over it.
+     * @param size page aligned size of the window
+     * @return the start of the window or {@link Pointer#zero()} if the reservation failed
+     */
+    public static Pointer reserveCodeSpace(Address address, Size size) {
+        if (TraceAnonOperations) {
+            traceRange("reserveCodeSpace", address, size);
+        }
+        return virtualMemory_reserveCodeSpace(address, size);
+    }
+
+    /**
+     * Commits the next chunk of the {@linkplain #reserveCodeSpace(Address, Size) code space}.
+     * Successive chunks are contiguous.
+     *
+     * @param size the size of the chunk, rounded up to a whole number of pages
+     * @return the start of the chunk or {@link Pointer#zero()} if the code space is exhausted
+     */
+    public static Pointer commitCodeSpace(Size size) {
+        commitMemoryTime.start();
+        final Pointer chunk = virtualMemory_commitCodeSpace(size);
+        commitMemoryTime.stop();
+        if (TraceAnonOperations) {
+            traceRange("commitCodeSpace", chunk, size);
+        }
+        return chunk;
+    }
+
+    @C_FUNCTION
+    private static native Pointer virtualMemory_reserveCodeSpace(Address address, Size size);
+
+    @C_FUNCTION
+    private static native Pointer virtualMemory_commitCodeSpace(Size size);
+
     /**
      * Return the amount of physical memory (in bytes) of the underlying platform.
      * @return amount of physical memory in bytes
@@ -238,6 +296,16 @@ public final class VirtualMemory {
     @C_FUNCTION
     private static native Size virtualMemory_getPhysicalMemorySize();
 
+    /**
+     * Prints the large page mode and how much of the committed heap and code memory is backed by large pages.
+     */
+    public static void printLargePageStatistics() {
+        virtualMemory_printLargePageStatistics();
+    }
+
+    @C_FUNCTION
+    private static native void virtualMemory_printLargePageStatistics();
+
     /* Page protection methods */
 
     /**
@@ -314,12 +382,26 @@ public final class VirtualMemory {
         return Pointer.fromLong(virtualMemory_mapFileIn31BitSpace(size, fd, fileOffset.toLong()));
     }
 
+    /**
+     * Creates (or truncates) a file, sizes it and maps it shared and writable, so that stores to the mapping
+     * are written back to the file even if the VM process is killed.
+     *
+     * @param path the file path as a C string
+     * @param size the size of the file and the mapping
+     * @return the address of the mapping or {@link Pointer#zero()} if the file could not be created or mapped
+     */
+    public static Pointer mapSharedFile(Pointer path, Size size) {
+        return Pointer.fromLong(virtualMemory_mapSharedFile(path.toLong(), size.toLong()));
+    }
+
     /* These are JNI functions because they may block */
 
     private static native long virtualMemory_mapFile(long size, int fd, long fileOffset);
 
     private static native long virtualMemory_mapFileIn31BitSpace(int size, int fd, long fileOffset);
 
+    private static native long virtualMemory_mapSharedFile(long path, long size);
+
     public static void traceRange(String label, Address start, Size size) {
         Log.print(label);
         Log.print("[ ");
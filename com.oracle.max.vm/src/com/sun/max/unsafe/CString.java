@@ -90,7 +90,7 @@ public final class CString {
      */
     public static Pointer utf8FromJava(String string) {
         final byte[] utf8 = Utf8.stringToUtf8(string);
-        final Pointer cString = Memory.mustAllocate(utf8.length + 1);
+        final Pointer cString = Memory.mustAllocate(utf8.length + 1, Memory.Tag.STRING, false);
         Pointer p = cString;
         for (byte utf8Char : utf8) {
             p.writeByte(0, utf8Char);
@@ -307,7 +307,7 @@ public final class CString {
             bufferSize += utf8Length + 1;
         }
 
-        long buffer = unsafe ? WithoutAccessCheck.unsafe.allocateMemory(bufferSize) : Memory.mustAllocate(bufferSize).toLong();
+        long buffer = unsafe ? WithoutAccessCheck.unsafe.allocateMemory(bufferSize) : Memory.mustAllocate(bufferSize, Memory.Tag.STRING, false).toLong();
 
         long stringPointer = buffer + pointerArraySize;
         for (int i = 0; i < strings.length; ++i) {
@@ -408,7 +408,7 @@ public final class CString {
     public static Pointer append(Pointer cstring, String string) {
         Size csl = CString.length(cstring);
         int sl = string.length();
-        Pointer result = Memory.allocate(csl.plus(sl).plus(1));
+        Pointer result = Memory.allocate(csl.plus(sl).plus(1), Memory.Tag.STRING, false);
         if (result.isZero()) {
             return result;
         }
@@ -430,7 +430,7 @@ public final class CString {
         Size csl1 = CString.length(cstring1);
         Size csl2 = CString.length(cstring2);
         Size nl = csl1.plus(csl2);
-        Pointer result = Memory.allocate(nl.plus(1));
+        Pointer result = Memory.allocate(nl.plus(1), Memory.Tag.STRING, false);
         if (result.isZero()) {
             return result;
         }
@@ -448,7 +448,7 @@ public final class CString {
      */
     public static Pointer copy(Pointer cstring) {
         Size length = CString.length(cstring);
-        Pointer result = Memory.allocate(length.plus(1));
+        Pointer result = Memory.allocate(length.plus(1), Memory.Tag.STRING, false);
         if (result.isZero()) {
             return result;
         }
@@ -470,7 +470,7 @@ public final class CString {
             return cstring;
         }
         Size nl = csl.minus(sl);
-        Pointer result = Memory.allocate(nl);
+        Pointer result = Memory.allocate(nl.plus(1), Memory.Tag.STRING, false);
         if (result.isZero()) {
             return result;
         }
@@ -303,6 +303,22 @@ public class VMOptions {
     private static final VMStringOption logFileOption = register(new VMStringOption("-XX:LogFile=", false, null,
         "Redirect VM log output to the specified file. By default, VM log output goes to the standard output stream."), MaxineVM.Phase.STARTING);
 
+    /**
+     * This option is parsed in the native code (see maxine.c). It's declared here simply so that it
+     * shows up in the {@linkplain #printUsage(Category) usage} message.
+     */
+    private static final VMBooleanXXOption logBufferedOption = register(new VMBooleanXXOption("-XX:-LogBuffered",
+        "Format VM log output into per-thread buffers that are written in batches by a background thread. " +
+        "Output of one thread between Log.lock() and Log.unlock() is written as one record."), MaxineVM.Phase.STARTING);
+
+    /**
+     * This option is parsed in the native code (see maxine.c). It's declared here simply so that it
+     * shows up in the {@linkplain #printUsage(Category) usage} message.
+     */
+    private static final VMIntOption activeProcessorCountOption = register(new VMIntOption("-XX:ActiveProcessorCount=", 0,
+        "Number of processors the VM reports as available. By default, this is derived from the CPU affinity mask and " +
+        "any container (cgroup) CPU quota."), MaxineVM.Phase.STARTING);
+
     /**
      * The '-verbose' option and all its variants (e.g. '-verbose:gc', '-verbose:class' etc).
      */
@@ -759,7 +775,7 @@ public class VMOptions {
      */
     private static Pointer copy(int initialArgc, Pointer initialArgv) {
         final Size copySize = Size.fromInt(Pointer.size() * initialArgc);
-        Pointer p = Memory.allocate(copySize);
+        Pointer p = Memory.allocate(copySize, Memory.Tag.VM, false);
         Memory.copyBytes(initialArgv, p, copySize);
         return p;
     }
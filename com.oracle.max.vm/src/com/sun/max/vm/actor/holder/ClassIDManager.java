@@ -119,6 +119,10 @@ public final class ClassIDManager {
     }
 
     private static void clear(int id) {
+        if (!MaxineVM.isHosted()) {
+            // The JNI method IDs of the class's methods become invalid with its ID
+            jni_releaseArgumentDescriptors(id);
+        }
         ClassActor c = idToClassActor.set(id, null);
         usedIDs.clear(id);
         if (TraceClassIDs) {
@@ -130,6 +134,12 @@ public final class ClassIDManager {
         }
     }
 
+    /**
+     * Discards the argument descriptors cached for the JNI method IDs of a class (see jni.c).
+     */
+    @C_FUNCTION
+    private static native void jni_releaseArgumentDescriptors(int classID);
+
     private static boolean TraceClassIDs;
     static {
         VMOptions.addFieldOption("-XX:", "TraceClassIDs", "Trace management of class identifiers.");
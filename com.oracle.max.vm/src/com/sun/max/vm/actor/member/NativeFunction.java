@@ -39,6 +39,17 @@ public final class NativeFunction {
     private final ClassMethodActor classMethodActor;
     private String symbol;
 
+    /**
+     * Prefix of the symbol of a {@linkplain #linkCritical() critical} implementation of a native method.
+     */
+    public static final String CRITICAL_PREFIX = "JavaCritical_";
+
+    /**
+     * Determines if this native function is bound to a critical implementation, i.e. one that takes
+     * neither the JNIEnv nor the class parameter and receives primitive arrays as a length and element pointer pair.
+     */
+    private boolean critical;
+
     private Address address = Address.zero();
 
     /**
@@ -93,6 +104,46 @@ public final class NativeFunction {
         return symbol;
     }
 
+    /**
+     * Gets the symbol of the critical implementation of this native function. The symbol is {@link #makeSymbol()}
+     * with the {@code Java_} prefix replaced by {@link #CRITICAL_PREFIX}.
+     */
+    public String makeCriticalSymbol() {
+        return CRITICAL_PREFIX + makeSymbol().substring("Java_".length());
+    }
+
+    /**
+     * Determines if this native function is bound to a critical implementation.
+     */
+    public boolean isCritical() {
+        return critical;
+    }
+
+    /**
+     * Attempts to bind this native function to a critical implementation. This must be called before the stub for
+     * this native function is generated as it determines the calling convention used by the stub. A native function
+     * that already has an address, for example from {@code RegisterNatives}, keeps it.
+     *
+     * @return {@code true} if a critical implementation was found and bound
+     */
+    public boolean linkCritical() {
+        if (!critical) {
+            if (address.isNotZero()) {
+                return false;
+            }
+            Address criticalAddress = DynamicLinker.lookupIfPresent(classMethodActor, makeCriticalSymbol()).asAddress();
+            if (criticalAddress.isZero()) {
+                return false;
+            }
+            critical = true;
+            address = criticalAddress;
+            if (NativeInterfaces.verbose()) {
+                Log.println("[Dynamic-linking critical native method " + classMethodActor.holder().name + "." + classMethodActor.name + " = " + address.toHexString() + "]");
+            }
+        }
+        return true;
+    }
+
     /**
      * Gets the native function pointer for this native function, linking it first if necessary.
      *
@@ -113,7 +164,7 @@ public final class NativeFunction {
 
     @NEVER_INLINE
     public Address link0() throws UnsatisfiedLinkError {
-        address = DynamicLinker.lookup(classMethodActor, makeSymbol()).asAddress();
+        address = DynamicLinker.lookup(classMethodActor, critical ? makeCriticalSymbol() : makeSymbol()).asAddress();
         if (JniFunctions.logger.enabled()) {
             JniFunctions.logger.log(LogOperations.DynamicLink.ordinal(), LINK_ENTRY, MethodID.fromMethodActor(classMethodActor), address);
         }
@@ -137,6 +188,11 @@ public final class NativeFunction {
      * Sets (or clears) the machine code address for this native function.
      */
     public void setAddress(Address address) {
+        if (critical && address.isNotZero()) {
+            // The stub passes arguments using the critical convention so it
+            // cannot be rebound to an implementation registered via JNI.
+            return;
+        }
         this.address = address;
         if (JniFunctions.logger.enabled()) {
             JniFunctions.logger.log(LogOperations.RegisterNativeMethod.ordinal(), REGISTER_ENTRY, MethodID.fromMethodActor(classMethodActor), address);
@@ -68,6 +68,15 @@ public abstract class CodeManager {
         register(new VMSizeOption("-XX:ReservedOptCodeCacheSize=", Size.M.times(16),
             "Memory allocated for runtime code region cache."), MaxineVM.Phase.PRISTINE);
 
+    /**
+     * VM option for specifying the amount of virtual memory to be reserved for all runtime code. The runtime code regions
+     * are committed from this space and the opt code region grows into the remainder of it when full. Code managers that
+     * need to keep runtime code within 32-bit displacements of the boot code region may reserve less than this.
+     */
+    public static final VMSizeOption reservedCodeSpaceSize =
+        register(new VMSizeOption("-XX:ReservedCodeSpaceSize=", Size.G.times(2),
+            "Virtual memory reserved for all runtime code regions."), MaxineVM.Phase.PRISTINE);
+
     private int nAllocations = 0;
 
     private int lastSurvivorSize;
@@ -153,6 +162,24 @@ public abstract class CodeManager {
     void initialize() {
     }
 
+    /**
+     * Gets the end of the virtual memory reserved for runtime code, i.e. the first address that
+     * the heap scheme may use for other purposes.
+     */
+    public Address reservedCodeSpaceEnd() {
+        return runtimeOptCodeRegion.end();
+    }
+
+    /**
+     * Attempts to grow the {@linkplain #runtimeOptCodeRegion opt code region} in place when it is full.
+     *
+     * @param minimumIncrement the number of bytes by which the region must at least grow
+     * @return {@code true} if the region was grown, {@code false} if it cannot grow
+     */
+    protected boolean growRuntimeOptCodeRegion(Size minimumIncrement) {
+        return false;
+    }
+
     private static int BOOT_TO_BASELINE_INITIAL_SIZE = 10;
 
     /**
@@ -248,6 +275,11 @@ public abstract class CodeManager {
                     CodeEviction.codeEvictionLogger.logStats_Surviving(lastSurvivorSize, largestSurvivorSize);
                 }
             }
+
+            // The opt code region is not evicted, but may be able to grow.
+            if (start.isZero() && currentCodeRegion == runtimeOptCodeRegion && growRuntimeOptCodeRegion(allocationSize)) {
+                start = currentCodeRegion.allocate(allocationSize, false);
+            }
         }
 
         traceChunkAllocation(allocationTraceDescription, allocationSize, start, inHeap);
@@ -260,7 +292,7 @@ public abstract class CodeManager {
             if (currentCodeRegion == runtimeBaselineCodeRegion) {
                 Log.println(" - try larger value for " + runtimeBaselineCodeRegionSize.toString() + "<n>");
             } else if (currentCodeRegion == runtimeOptCodeRegion) {
-                Log.println(" - try larger value for " + runtimeOptCodeRegionSize.toString() + "<n>");
+                Log.println(" - try larger value for " + reservedCodeSpaceSize.toString() + "<n>");
             }
             MaxineVM.exit(11);
         }
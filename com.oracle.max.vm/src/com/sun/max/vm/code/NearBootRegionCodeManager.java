@@ -31,31 +31,86 @@ import com.sun.max.vm.heap.*;
 
 /**
  * A code manager that reserves and allocates virtual memory immediately after the boot region.
- * Specifically, the code manager allocates two page-aligned contiguous ranges of virtual memory immediately (one for each of the baseline and optimized code regions) after the
- * first virtual memory page next to the boot heap region highest address.
- * It relies on cooperation with the HeapScheme to reserve up to 1 G of space next to the boot heap region.
- * This guarantees that (1) virtual memory can be allocated at that address, and (2) all code allocated from the code manager will be within a 32-bit displacement from
- * any code in the boot code region.
+ * Specifically, the code manager reserves a {@linkplain VirtualMemory#reserveCodeSpace(Address, Size) code space}
+ * starting at the first virtual memory page next to the boot heap region highest address, and commits two
+ * page-aligned contiguous ranges from it (one for each of the baseline and optimized code regions).
+ * The code space is sized such that any address in it is within a 32-bit displacement from any code in the
+ * boot code region, so the optimized code region can later grow into the uncommitted remainder of the code space
+ * without ever needing indirect calls.
+ * It relies on cooperation with the HeapScheme to reserve enough space next to the boot heap region.
+ * This guarantees that virtual memory can be allocated at that address.
  *
  * See {@link HeapSchemeAdaptor#createCodeManager()}
  */
 public class NearBootRegionCodeManager extends CodeManager {
+
     /**
-     * Initialize this code manager. This comprises allocating virtual memory the code manager will allocate code from.
+     * End of the code space. The optimized code region may grow up to this address.
+     */
+    private Address codeSpaceEnd = Address.zero();
+
+    /**
+     * Initialize this code manager. This comprises reserving the code space and committing the memory the code manager will initially allocate code from.
      */
     @Override
     void initialize() {
-        final Address baselineAddress = Code.bootCodeRegion().end().alignUp(Platform.platform().pageSize);
-        tryAllocate(runtimeBaselineCodeRegionSize, runtimeBaselineCodeRegion, baselineAddress);
-        final Address optAddress = runtimeBaselineCodeRegion.end().alignUp(Platform.platform().pageSize);
+        final int pageSize = Platform.platform().pageSize;
+        final Address codeSpaceStart = Code.bootCodeRegion().end().alignUp(pageSize);
+        final Address endOfReservedSpace = Heap.startOfReservedVirtualSpace().plus(Size.K.times(VMConfiguration.vmConfig().heapScheme().reservedVirtualSpaceKB()));
+        // Any code in the code space must be reachable with a 32-bit displacement from any code in the boot code region
+        final Address maxCodeSpaceEnd = Code.bootCodeRegion().start().plus(Integer.MAX_VALUE).alignDown(pageSize);
+        Address end = codeSpaceStart.plus(reservedCodeSpaceSize.getValue()).alignUp(pageSize);
+        if (end.greaterThan(maxCodeSpaceEnd)) {
+            end = maxCodeSpaceEnd;
+        }
+        if (end.greaterThan(endOfReservedSpace)) {
+            end = endOfReservedSpace;
+        }
+        final Size initialSize = runtimeBaselineCodeRegionSize.getValue().alignUp(pageSize).plus(runtimeOptCodeRegionSize.getValue().alignUp(pageSize));
+        if (end.minus(codeSpaceStart).lessThan(initialSize)) {
+            throw ProgramError.unexpected("code space too small for the runtime code regions");
+        }
+        if (!Heap.AvoidsAnonOperations && VirtualMemory.reserveCodeSpace(codeSpaceStart, end.minus(codeSpaceStart).asSize()).isZero()) {
+            throw ProgramError.unexpected("could not reserve code space");
+        }
+        codeSpaceEnd = end;
+        tryAllocate(runtimeBaselineCodeRegionSize, runtimeBaselineCodeRegion, codeSpaceStart);
+        final Address optAddress = runtimeBaselineCodeRegion.end().alignUp(pageSize);
         tryAllocate(runtimeOptCodeRegionSize, runtimeOptCodeRegion, optAddress);
     }
 
     private void tryAllocate(VMSizeOption s, CodeRegion cr, Address address) {
-        final Size size = s.getValue();
-        if (!Heap.AvoidsAnonOperations && !VirtualMemory.allocateAtFixedAddress(address, size, VirtualMemory.Type.CODE)) {
+        final Size size = s.getValue().alignUp(Platform.platform().pageSize);
+        if (!Heap.AvoidsAnonOperations && !VirtualMemory.commitCodeSpace(size).equals(address)) {
             throw ProgramError.unexpected("could not allocate " + cr.regionName());
         }
         cr.bind(address, size);
     }
+
+    @Override
+    public Address reservedCodeSpaceEnd() {
+        return codeSpaceEnd;
+    }
+
+    /**
+     * Grows the optimized code region in place by committing the next chunk of the code space, which directly follows it.
+     * The region grows by at least its initial size each time so that growth is infrequent.
+     */
+    @Override
+    protected boolean growRuntimeOptCodeRegion(Size minimumIncrement) {
+        final int pageSize = Platform.platform().pageSize;
+        Size increment = runtimeOptCodeRegionSize.getValue().alignUp(pageSize);
+        if (minimumIncrement.greaterThan(increment)) {
+            increment = minimumIncrement.alignUp(pageSize);
+        }
+        final Address regionEnd = runtimeOptCodeRegion.end();
+        if (regionEnd.plus(increment).greaterThan(codeSpaceEnd)) {
+            return false;
+        }
+        if (!Heap.AvoidsAnonOperations && !VirtualMemory.commitCodeSpace(increment).equals(regionEnd)) {
+            return false;
+        }
+        runtimeOptCodeRegion.setSize(runtimeOptCodeRegion.size().plus(increment));
+        return true;
+    }
 }
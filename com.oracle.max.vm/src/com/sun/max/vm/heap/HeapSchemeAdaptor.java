@@ -64,15 +64,15 @@ public abstract class HeapSchemeAdaptor extends AbstractVMScheme implements Heap
         }
 
         public GcInfo getLastGcInfo() {
-            return null;
+            return MemoryManagement.getLastGcInfo(this);
         }
 
         public long getCollectionCount() {
-            return collectionCount;
+            return MemoryManagement.getCollectionCount();
         }
 
         public long getCollectionTime() {
-            return accumulatedGCTime;
+            return MemoryManagement.getCollectionTime();
         }
 
         @Override
@@ -207,6 +207,17 @@ public abstract class HeapSchemeAdaptor extends AbstractVMScheme implements Heap
         super.initialize(phase);
         if (phase == MaxineVM.Phase.PRISTINE) {
             releaseUnusedReservedVirtualSpace();
+        } else if (phase == MaxineVM.Phase.RUNNING) {
+            MemoryManagement.initialize();
+            if (VirtualMemory.PrintLargePages) {
+                VirtualMemory.printLargePageStatistics();
+                Runtime.getRuntime().addShutdownHook(new Thread("LargePageStatisticsPrinter") {
+                    @Override
+                    public void run() {
+                        VirtualMemory.printLargePageStatistics();
+                    }
+                });
+            }
         }
     }
 
@@ -220,11 +231,12 @@ public abstract class HeapSchemeAdaptor extends AbstractVMScheme implements Heap
                 // If you change this for any platform above, you may also want to revisit reservedVirtualSpaceSize,
                 // bootRegionMappingConstraint and the native implementation of mapHeapAndCode.
                 //
-                // The default policy implemented by the HeapSchemeAdaptor is to reserve 1 G of virtual space
+                // The default policy implemented by the HeapSchemeAdaptor is to reserve 3 G of virtual space
                 // (as specified by reservedVirtualSpaceSize) and to memory map the boot region at the start of
                 // that reserved space (as specified by bootRegionMappingConstraint).
-                // The FixedAddressCodeManager then initialize itself by allocating the requested size at the end of
-                // the boot region. This guarantees that all relative displacements in code are 32-bit displacement.
+                // The NearBootRegionCodeManager then initialize itself by reserving a code space at the end of
+                // the boot region, no larger than what keeps all relative displacements in code 32-bit displacements,
+                // and committing the runtime code regions from it.
                 return new NearBootRegionCodeManager();
             }
             default: {
@@ -344,9 +356,9 @@ public abstract class HeapSchemeAdaptor extends AbstractVMScheme implements Heap
     }
 
     public int reservedVirtualSpaceKB() {
-        // Reserve 1 G of virtual space. This will be used to map the boot heap region and the dynamically allocated code region.
-        // See comment in createCodeManager
-        return Size.M.toInt();
+        // Reserve 3 G of virtual space. This will be used to map the boot heap region, the code space the runtime code regions
+        // are allocated from (at most 2 G), and whatever the heap scheme places after it. See comment in createCodeManager
+        return Size.M.times(3).toInt();
     }
 
     public BootRegionMappingConstraint bootRegionMappingConstraint() {
@@ -374,10 +386,10 @@ public abstract class HeapSchemeAdaptor extends AbstractVMScheme implements Heap
         Address endOfReservedVirtualSpaceSize = startOfReservedVirtualSpaceSize.plus(reservedVirtualSpaceSize);
         checkRuntimeCodeRegion(startOfReservedVirtualSpaceSize, endOfReservedVirtualSpaceSize, Code.getCodeManager().getRuntimeBaselineCodeRegion());
         checkRuntimeCodeRegion(startOfReservedVirtualSpaceSize, endOfReservedVirtualSpaceSize, Code.getCodeManager().getRuntimeOptCodeRegion());
-        Address startOfUnusedVirtualSpace = Code.getCodeManager().getRuntimeOptCodeRegion().end().alignUp(Platform.platform().pageSize);
+        Address startOfUnusedVirtualSpace = Code.getCodeManager().reservedCodeSpaceEnd().alignUp(Platform.platform().pageSize);
         Size unusedVirtualSpaceSize = endOfReservedVirtualSpaceSize.minus(startOfUnusedVirtualSpace).asSize();
         if (!unusedVirtualSpaceSize.isZero()) {
-            VirtualMemory.deallocate(startOfUnusedVirtualSpace, unusedVirtualSpaceSize, VirtualMemory.Type.DATA);
+            VirtualMemory.deallocate(startOfUnusedVirtualSpace, unusedVirtualSpaceSize, VirtualMemory.Type.HEAP);
         }
     }
 
@@ -282,7 +282,7 @@ public final class HeapRegionManager implements HeapAccountOwner {
                 final Address endOfInitialBootHeap = startOfManagedSpace.plus(bootHeapSize);
                 final Address endOfRegions = bounds().end();
                 Size uncommitedSpaceSize = endOfRegions.minus(endOfInitialBootHeap).asSize();
-                if (!VirtualMemory.uncommitMemory(endOfInitialBootHeap, uncommitedSpaceSize,  VirtualMemory.Type.DATA)) {
+                if (!VirtualMemory.uncommitMemory(endOfInitialBootHeap, uncommitedSpaceSize,  VirtualMemory.Type.HEAP)) {
                     MaxineVM.reportPristineMemoryFailure("uncommitted regions", "uncommit", uncommitedSpaceSize);
                 }
             }
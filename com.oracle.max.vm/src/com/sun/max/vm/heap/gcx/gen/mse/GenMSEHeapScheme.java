@@ -29,6 +29,7 @@ import static com.sun.max.vm.intrinsics.MaxineIntrinsicIDs.*;
 
 import com.sun.cri.xir.*;
 import com.sun.cri.xir.CiXirAssembler.XirOperand;
+import com.sun.management.GarbageCollectorMXBean;
 import com.sun.max.annotate.*;
 import com.sun.max.memory.*;
 import com.sun.max.platform.*;
@@ -185,7 +186,7 @@ final public class GenMSEHeapScheme extends HeapSchemeWithTLABAdaptor  implement
         FatalError.check(Heap.bootHeapRegion.start() == Heap.startOfReservedVirtualSpace(),
             "Boot heap region must be mapped at start of reserved virtual space");
 
-        final Address endOfCodeRegion = Code.getCodeManager().getRuntimeOptCodeRegion().end();
+        final Address endOfCodeRegion = Code.getCodeManager().reservedCodeSpaceEnd();
         final Address endOfReservedSpace = Heap.bootHeapRegion.start().plus(reservedSpace);
 
         // Initialize the heap region manager.
@@ -224,11 +225,11 @@ final public class GenMSEHeapScheme extends HeapSchemeWithTLABAdaptor  implement
 
             // First, uncommit range we want to free (this will create a new mapping that can then be deallocated)
             if (!Heap.AvoidsAnonOperations) {
-                if (!VirtualMemory.uncommitMemory(unusedReservedSpaceStart, leftoverSize,  VirtualMemory.Type.DATA)) {
+                if (!VirtualMemory.uncommitMemory(unusedReservedSpaceStart, leftoverSize,  VirtualMemory.Type.HEAP)) {
                     MaxineVM.reportPristineMemoryFailure("reserved space leftover", "uncommit", leftoverSize);
                 }
             }
-            if (VirtualMemory.deallocate(unusedReservedSpaceStart, leftoverSize, VirtualMemory.Type.DATA).isZero()) {
+            if (VirtualMemory.deallocate(unusedReservedSpaceStart, leftoverSize, VirtualMemory.Type.HEAP).isZero()) {
                 MaxineVM.reportPristineMemoryFailure("reserved space leftover", "deallocate", leftoverSize);
             }
 
@@ -387,6 +388,19 @@ final public class GenMSEHeapScheme extends HeapSchemeWithTLABAdaptor  implement
         return oldSpace.usedSpace().plus(youngSpace.usedSpace());
     }
 
+    @Override
+    public GarbageCollectorMXBean getGarbageCollectorMXBean() {
+        return new GenMSEGarbageCollectorMXBean();
+    }
+
+    private final class GenMSEGarbageCollectorMXBean extends HeapSchemeAdaptor.GarbageCollectorMXBeanAdaptor {
+        private GenMSEGarbageCollectorMXBean() {
+            super("GenMSE");
+            add(new HeapSpaceMemoryPoolMXBean("Nursery", youngSpace, this));
+            add(new HeapSpaceMemoryPoolMXBean("Old Generation", oldSpace, this));
+        }
+    }
+
     @Override
     public boolean pin(Object object) {
         return false;
@@ -95,7 +95,7 @@ public final class MSHeapScheme extends HeapSchemeWithTLABAdaptor {
         FatalError.check(Heap.bootHeapRegion.start() == Heap.startOfReservedVirtualSpace(),
                         "Boot heap region must be mapped at start of reserved virtual space");
 
-        final Address endOfCodeRegion = Code.getCodeManager().getRuntimeOptCodeRegion().end();
+        final Address endOfCodeRegion = Code.getCodeManager().reservedCodeSpaceEnd();
         final Address endOfReservedSpace = Heap.bootHeapRegion.start().plus(reservedSpace);
         final Address immortalStart = endOfCodeRegion.alignUp(pageSize);
         // Relocate immortal memory immediately after the end of the code region.
@@ -133,11 +133,11 @@ public final class MSHeapScheme extends HeapSchemeWithTLABAdaptor {
             Size leftoverSize = endOfReservedSpace.minus(leftoverStart).asSize();
             // First, uncommit range we want to free (this will create a new mapping that can then be deallocated)
             if (!Heap.AvoidsAnonOperations) {
-                if (!VirtualMemory.uncommitMemory(leftoverStart, leftoverSize,  VirtualMemory.Type.DATA)) {
+                if (!VirtualMemory.uncommitMemory(leftoverStart, leftoverSize,  VirtualMemory.Type.HEAP)) {
                     MaxineVM.reportPristineMemoryFailure("reserved space leftover", "uncommit", leftoverSize);
                 }
             }
-            if (VirtualMemory.deallocate(leftoverStart, leftoverSize, VirtualMemory.Type.DATA).isZero()) {
+            if (VirtualMemory.deallocate(leftoverStart, leftoverSize, VirtualMemory.Type.HEAP).isZero()) {
                 MaxineVM.reportPristineMemoryFailure("reserved space leftover", "deallocate", leftoverSize);
             }
 
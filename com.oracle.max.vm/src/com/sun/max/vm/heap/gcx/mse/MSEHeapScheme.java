@@ -26,6 +26,7 @@ import static com.sun.max.vm.VMConfiguration.*;
 import static com.sun.max.vm.heap.gcx.HeapRegionManager.*;
 import static com.sun.max.vm.intrinsics.MaxineIntrinsicIDs.*;
 
+import com.sun.management.GarbageCollectorMXBean;
 import com.sun.max.annotate.*;
 import com.sun.max.memory.*;
 import com.sun.max.platform.*;
@@ -118,7 +119,7 @@ public final class MSEHeapScheme extends HeapSchemeWithTLABAdaptor implements He
         FatalError.check(Heap.bootHeapRegion.start() == Heap.startOfReservedVirtualSpace(),
             "Boot heap region must be mapped at start of reserved virtual space");
 
-        final Address endOfCodeRegion = Code.getCodeManager().getRuntimeOptCodeRegion().end();
+        final Address endOfCodeRegion = Code.getCodeManager().reservedCodeSpaceEnd();
         final Address endOfReservedSpace = Heap.bootHeapRegion.start().plus(reservedSpace);
 
         // Initialize the heap region manager.
@@ -160,7 +161,7 @@ public final class MSEHeapScheme extends HeapSchemeWithTLABAdaptor implements He
             }
             // Free leftover of reserved space we will not be using.
             Size leftoverSize = endOfReservedSpace.minus(unusedReservedSpaceStart).asSize();
-            if (VirtualMemory.deallocate(unusedReservedSpaceStart, leftoverSize, VirtualMemory.Type.DATA).isZero()) {
+            if (VirtualMemory.deallocate(unusedReservedSpaceStart, leftoverSize, VirtualMemory.Type.HEAP).isZero()) {
                 MaxineVM.reportPristineMemoryFailure("reserved space leftover", "deallocate", leftoverSize);
             }
             //  Make the heap (and mark bitmap) inspectable
@@ -241,6 +242,18 @@ public final class MSEHeapScheme extends HeapSchemeWithTLABAdaptor implements He
         return markSweepSpace.usedSpace();
     }
 
+    @Override
+    public GarbageCollectorMXBean getGarbageCollectorMXBean() {
+        return new MSEGarbageCollectorMXBean();
+    }
+
+    private final class MSEGarbageCollectorMXBean extends HeapSchemeAdaptor.GarbageCollectorMXBeanAdaptor {
+        private MSEGarbageCollectorMXBean() {
+            super("MSE");
+            add(new HeapSpaceMemoryPoolMXBean("Heap", markSweepSpace, this));
+        }
+    }
+
     @INLINE
     public boolean pin(Object object) {
         // Objects never relocate. So this is always safe.
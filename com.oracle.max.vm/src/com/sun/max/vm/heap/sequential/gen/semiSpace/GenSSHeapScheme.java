@@ -26,8 +26,6 @@ import static com.sun.max.vm.MaxineVM.Phase.*;
 import static com.sun.max.vm.heap.gcx.EvacuationTimers.TIMED_OPERATION.*;
 import static com.sun.max.vm.intrinsics.MaxineIntrinsicIDs.*;
 
-import java.lang.management.*;
-
 import com.sun.cri.xir.*;
 import com.sun.cri.xir.CiXirAssembler.XirOperand;
 import com.sun.management.GarbageCollectorMXBean;
@@ -49,7 +47,6 @@ import com.sun.max.vm.heap.gcx.rset.*;
 import com.sun.max.vm.heap.gcx.rset.ctbl.*;
 import com.sun.max.vm.log.VMLog.Record;
 import com.sun.max.vm.log.hosted.*;
-import com.sun.max.vm.management.*;
 import com.sun.max.vm.reference.*;
 import com.sun.max.vm.runtime.*;
 import com.sun.max.vm.thread.*;
@@ -911,7 +908,7 @@ public final class GenSSHeapScheme extends HeapSchemeWithTLABAdaptor implements
             Heap.startOfReservedVirtualSpace(),
             "Boot heap region must be mapped at start of reserved virtual space");
 
-        final Address endOfCodeRegion = Code.getCodeManager().getRuntimeOptCodeRegion().end();
+        final Address endOfCodeRegion = Code.getCodeManager().reservedCodeSpaceEnd();
         final Address endOfReservedSpace = Heap.bootHeapRegion.start().plus(reservedSpace);
         final Address immortalStart = endOfCodeRegion.alignUp(pageSize);
         // Relocate immortal memory immediately after the end of the code region.
@@ -968,11 +965,11 @@ public final class GenSSHeapScheme extends HeapSchemeWithTLABAdaptor implements
 
             // First, uncommit range we want to free (this will create a new mapping that can then be deallocated)
             if (!Heap.AvoidsAnonOperations) {
-                if (!VirtualMemory.uncommitMemory(unusedReservedSpaceStart, leftoverSize,  VirtualMemory.Type.DATA)) {
+                if (!VirtualMemory.uncommitMemory(unusedReservedSpaceStart, leftoverSize,  VirtualMemory.Type.HEAP)) {
                     MaxineVM.reportPristineMemoryFailure("reserved space leftover", "uncommit", leftoverSize);
                 }
             }
-            if (VirtualMemory.deallocate(unusedReservedSpaceStart, leftoverSize, VirtualMemory.Type.DATA).isZero()) {
+            if (VirtualMemory.deallocate(unusedReservedSpaceStart, leftoverSize, VirtualMemory.Type.HEAP).isZero()) {
                 MaxineVM.reportPristineMemoryFailure("reserved space leftover", "deallocate", leftoverSize);
             }
             if (MaxineVM.isDebug()) {
@@ -1104,15 +1101,8 @@ public final class GenSSHeapScheme extends HeapSchemeWithTLABAdaptor implements
     private final class GenSSGarbageCollectorMXBean extends HeapSchemeAdaptor.GarbageCollectorMXBeanAdaptor {
         private GenSSGarbageCollectorMXBean() {
             super("GenSS");
-            add(new GenSSMemoryPoolMXBean(oldSpace.space, this));
-            add(new GenSSMemoryPoolMXBean(oldSpace.fromSpace, this));
-            add(new GenSSMemoryPoolMXBean(youngSpace.space, this));
-        }
-    }
-
-    private final class GenSSMemoryPoolMXBean extends MemoryPoolMXBeanAdaptor {
-        GenSSMemoryPoolMXBean(MemoryRegion region, MemoryManagerMXBean manager) {
-            super(MemoryType.HEAP, region, manager);
+            add(new HeapSpaceMemoryPoolMXBean("Old Generation", oldSpace, this));
+            add(new HeapSpaceMemoryPoolMXBean("Young Generation", youngSpace, this));
         }
     }
 
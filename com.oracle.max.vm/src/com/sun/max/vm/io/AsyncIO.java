@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.sun.max.vm.io;
+
+import java.io.*;
+import java.nio.*;
+
+import com.sun.max.annotate.*;
+import com.sun.max.memory.*;
+import com.sun.max.unsafe.*;
+import com.sun.max.vm.*;
+import com.sun.max.vm.MaxineVM.Phase;
+import com.sun.max.vm.type.*;
+
+/**
+ * An asynchronous I/O engine with explicit submission and completion queues, backed by io_uring
+ * where the kernel supports it and by epoll otherwise. Reads, writes, accepts and timeouts are
+ * {@linkplain #read queued}, {@linkplain #submit() submitted} as a batch and their results
+ * {@linkplain #reap reaped} later, by any number of threads. Each operation carries a caller-chosen
+ * {@code userData} value that identifies its result.
+ *
+ * The buffers given to reads and writes must be direct and must not be released or moved until the
+ * operation has completed.
+ *
+ * The natives are implemented in {@code aio.c}.
+ */
+public final class AsyncIO implements Closeable {
+
+    private static boolean UseIOUring = true;
+
+    static {
+        VMOptions.addFieldOption("-XX:", "UseIOUring", AsyncIO.class,
+            "Use io_uring for asynchronous I/O if the kernel supports it, otherwise epoll.", Phase.PRISTINE);
+    }
+
+    /*
+     * Operation codes. These must match the AIO_* constants in aio.h.
+     */
+    private static final int READ = 0;
+    private static final int WRITE = 1;
+    private static final int ACCEPT = 2;
+    private static final int TIMEOUT = 3;
+
+    /**
+     * The value of {@link #kind()} for an engine backed by epoll.
+     */
+    public static final int EPOLL = 0;
+
+    /**
+     * The value of {@link #kind()} for an engine backed by io_uring.
+     */
+    public static final int URING = 1;
+
+    private long engine;
+
+    /**
+     * Creates an engine.
+     *
+     * @param entries the maximum number of operations queued or in flight at any time
+     */
+    public AsyncIO(int entries) throws IOException {
+        engine = open(entries, UseIOUring);
+    }
+
+    /**
+     * Gets the mechanism backing this engine: {@link #URING} or {@link #EPOLL}.
+     */
+    public int kind() {
+        return aio_getKind(handle());
+    }
+
+    /**
+     * Queues a read of up to {@code buffer.remaining()} bytes into a direct buffer. Its result is the number of
+     * bytes read (0 at end of stream); the buffer's position is not updated.
+     *
+     * @param offset the offset in the file, or -1 for the current position (and for sockets and pipes)
+     * @return {@code false} if the engine already has the maximum number of operations queued or in flight
+     */
+    public boolean read(FileDescriptor fd, ByteBuffer buffer, long offset, long userData) {
+        return prepare(READ, fd, address(buffer), buffer.remaining(), offset, userData);
+    }
+
+    /**
+     * Queues a write of the remaining bytes of a direct buffer. Its result is the number of bytes written;
+     * the buffer's position is not updated.
+     *
+     * @param offset the offset in the file, or -1 for the current position (and for sockets and pipes)
+     * @return {@code false} if the engine already has the maximum number of operations queued or in flight
+     */
+    public boolean write(FileDescriptor fd, ByteBuffer buffer, long offset, long userData) {
+        return prepare(WRITE, fd, address(buffer), buffer.remaining(), offset, userData);
+    }
+
+    /**
+     * Queues the acceptance of a connection on a listening socket. Its result is the new socket's file descriptor.
+     *
+     * @return {@code false} if the engine already has the maximum number of operations queued or in flight
+     */
+    public boolean accept(FileDescriptor fd, long userData) {
+        return prepare(ACCEPT, fd, Address.zero(), 0, -1, userData);
+    }
+
+    /**
+     * Queues a timeout, whose result (0) becomes available after {@code nanos} nanoseconds.
+     *
+     * @return {@code false} if the engine already has the maximum number of operations queued or in flight
+     */
+    public boolean timeout(long nanos, long userData) {
+        return prepare(handle(), TIMEOUT, -1, 0L, 0, nanos, userData) == 0;
+    }
+
+    /**
+     * Starts all the operations queued since the last submission, with a single system call where possible.
+     *
+     * @return the number of operations started
+     */
+    public int submit() throws IOException {
+        return submit(handle());
+    }
+
+    /**
+     * Collects the results of completed operations. A result is the value described for the operation
+     * or, if the operation failed, a negated {@code errno} value.
+     *
+     * @param userData the array in which to store the {@code userData} of the completed operations
+     * @param results the array in which to store the results of the completed operations
+     * @param min the number of results to wait for
+     * @param timeoutNanos the maximum time to wait for {@code min} results, or -1 to wait indefinitely
+     * @return the number of results stored
+     */
+    public int reap(long[] userData, long[] results, int min, long timeoutNanos) throws IOException {
+        if (results.length < userData.length) {
+            throw new IllegalArgumentException("results is shorter than userData");
+        }
+        return reap(handle(), userData, results, min, timeoutNanos);
+    }
+
+    /**
+     * Wraps the file descriptor resulting from an {@linkplain #accept accepted} connection.
+     */
+    public static FileDescriptor newFileDescriptor(int fd) {
+        final FileDescriptor result = new FileDescriptor();
+        VirtualMemory.asJIOFDAlias(result).fd = fd;
+        return result;
+    }
+
+    /**
+     * Releases this engine. Operations still in flight are abandoned.
+     */
+    public synchronized void close() {
+        if (engine != 0) {
+            close(engine);
+            engine = 0;
+        }
+    }
+
+    private long handle() {
+        if (engine == 0) {
+            throw new IllegalStateException("closed");
+        }
+        return engine;
+    }
+
+    private boolean prepare(int opcode, FileDescriptor fd, Address buffer, int length, long offset, long userData) {
+        return prepare(handle(), opcode, FileIO.fd(fd), buffer.toLong(), length, offset, userData) == 0;
+    }
+
+    private static Address address(ByteBuffer buffer) {
+        if (!buffer.isDirect()) {
+            throw new IllegalArgumentException("buffer must be direct");
+        }
+        return Address.fromLong(ClassRegistry.Buffer_address.getLong(buffer) + buffer.position());
+    }
+
+    @C_FUNCTION
+    private static native int aio_getKind(long engine);
+
+    /* These are JNI functions because they may block, prepare() included as it waits for submissions in progress */
+
+    private static native int prepare(long engine, int opcode, int fd, long buffer, int length, long offset, long userData);
+
+    private static native long open(int entries, boolean useUring) throws IOException;
+
+    private static native int submit(long engine) throws IOException;
+
+    private static native int reap(long engine, long[] userData, long[] results, int min, long timeoutNanos) throws IOException;
+
+    private static native void close(long engine);
+}
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.sun.max.vm.io;
+
+import java.io.*;
+import java.nio.*;
+
+import com.sun.max.memory.*;
+import com.sun.max.unsafe.*;
+import com.sun.max.vm.type.*;
+
+/**
+ * Positional, vectored and zero-copy file I/O. None of these operations uses or moves the file pointer
+ * of the descriptor(s) it reads from, so they can be used concurrently on a shared descriptor.
+ * Buffers must be direct so that the data can be transferred without an intermediate copy.
+ *
+ * The natives are implemented in {@code jvm.c}.
+ */
+public final class FileIO {
+
+    private FileIO() {
+    }
+
+    /**
+     * Access pattern hints for {@link #fadvise}. These must match the {@code JVM_FADV_*} constants in {@code jvm.c}.
+     */
+    public enum Advice {
+        NORMAL,
+        SEQUENTIAL,
+        RANDOM,
+        WILLNEED,
+        DONTNEED,
+        NOREUSE;
+    }
+
+    static int fd(FileDescriptor fileDescriptor) {
+        return VirtualMemory.asJIOFDAlias(fileDescriptor).fd;
+    }
+
+    private static long address(ByteBuffer buffer) {
+        if (!buffer.isDirect()) {
+            throw new IllegalArgumentException("buffer must be direct");
+        }
+        return ClassRegistry.Buffer_address.getLong(buffer) + buffer.position();
+    }
+
+    /**
+     * Reads bytes from a file at a given offset into the remaining space of a direct buffer.
+     *
+     * @return the number of bytes read, or -1 at end of file
+     */
+    public static int pread(FileDescriptor fileDescriptor, ByteBuffer buffer, long offset) throws IOException {
+        final int n = pread(fd(fileDescriptor), address(buffer), buffer.remaining(), offset);
+        if (n == 0 && buffer.hasRemaining()) {
+            return -1;
+        }
+        buffer.position(buffer.position() + n);
+        return n;
+    }
+
+    /**
+     * Writes the remaining bytes of a direct buffer to a file at a given offset.
+     *
+     * @return the number of bytes written
+     */
+    public static int pwrite(FileDescriptor fileDescriptor, ByteBuffer buffer, long offset) throws IOException {
+        final int n = pwrite(fd(fileDescriptor), address(buffer), buffer.remaining(), offset);
+        buffer.position(buffer.position() + n);
+        return n;
+    }
+
+    /**
+     * Reads bytes from a file at a given offset into the remaining space of a sequence of direct buffers
+     * with a single system call.
+     *
+     * @return the number of bytes read, or -1 at end of file
+     */
+    public static long preadv(FileDescriptor fileDescriptor, ByteBuffer[] buffers, long offset) throws IOException {
+        final Pointer iov = iovec(buffers);
+        try {
+            final long n = preadv(fd(fileDescriptor), iov.toLong(), buffers.length, offset);
+            if (n == 0 && remaining(buffers) != 0) {
+                return -1;
+            }
+            advance(buffers, n);
+            return n;
+        } finally {
+            Memory.deallocate(iov);
+        }
+    }
+
+    /**
+     * Writes the remaining bytes of a sequence of direct buffers to a file at a given offset
+     * with a single system call.
+     *
+     * @return the number of bytes written
+     */
+    public static long pwritev(FileDescriptor fileDescriptor, ByteBuffer[] buffers, long offset) throws IOException {
+        final Pointer iov = iovec(buffers);
+        try {
+            final long n = pwritev(fd(fileDescriptor), iov.toLong(), buffers.length, offset);
+            advance(buffers, n);
+            return n;
+        } finally {
+            Memory.deallocate(iov);
+        }
+    }
+
+    /**
+     * Transfers up to {@code count} bytes from a file at a given offset to another descriptor (e.g. a socket),
+     * without copying the data through user space where the platform allows it.
+     *
+     * @return the number of bytes transferred
+     */
+    public static long transferTo(FileDescriptor in, long offset, long count, FileDescriptor out) throws IOException {
+        return sendfile(fd(out), fd(in), offset, count);
+    }
+
+    /**
+     * Copies up to {@code count} bytes between two files at the given offsets. Where the platform allows it,
+     * the copy happens entirely in the kernel (or the file system).
+     *
+     * @return the number of bytes copied
+     */
+    public static long copyRange(FileDescriptor in, long inOffset, FileDescriptor out, long outOffset, long count) throws IOException {
+        return copyFileRange(fd(in), inOffset, fd(out), outOffset, count);
+    }
+
+    /**
+     * Announces the intended access pattern for a range of a file. A {@code length} of 0 means up to the end of the file.
+     */
+    public static void fadvise(FileDescriptor fileDescriptor, long offset, long length, Advice advice) throws IOException {
+        fadvise(fd(fileDescriptor), offset, length, advice.ordinal());
+    }
+
+    /**
+     * Builds a native {@code struct iovec} array describing the remaining space of {@code buffers}.
+     * The caller must {@linkplain Memory#deallocate(Address) deallocate} it.
+     */
+    private static Pointer iovec(ByteBuffer[] buffers) {
+        final int entrySize = 2 * Word.size();
+        final Pointer iov = Memory.mustAllocate(buffers.length * entrySize, Memory.Tag.IO, false);
+        for (int i = 0; i < buffers.length; i++) {
+            iov.setLong(2 * i, address(buffers[i]));
+            iov.setLong(2 * i + 1, buffers[i].remaining());
+        }
+        return iov;
+    }
+
+    private static long remaining(ByteBuffer[] buffers) {
+        long result = 0;
+        for (ByteBuffer buffer : buffers) {
+            result += buffer.remaining();
+        }
+        return result;
+    }
+
+    private static void advance(ByteBuffer[] buffers, long n) {
+        for (int i = 0; i < buffers.length && n > 0; i++) {
+            final int step = (int) Math.min(n, buffers[i].remaining());
+            buffers[i].position(buffers[i].position() + step);
+            n -= step;
+        }
+    }
+
+    /* These are JNI functions because they may block */
+
+    private static native int pread(int fd, long address, int length, long offset) throws IOException;
+
+    private static native int pwrite(int fd, long address, int length, long offset) throws IOException;
+
+    private static native long preadv(int fd, long iov, int iovcnt, long offset) throws IOException;
+
+    private static native long pwritev(int fd, long iov, int iovcnt, long offset) throws IOException;
+
+    private static native long sendfile(int outFd, int inFd, long offset, long count) throws IOException;
+
+    private static native long copyFileRange(int inFd, long inOffset, int outFd, long outOffset, long count) throws IOException;
+
+    private static native void fadvise(int fd, long offset, long length, int advice) throws IOException;
+}
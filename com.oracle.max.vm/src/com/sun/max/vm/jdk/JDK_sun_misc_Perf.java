@@ -147,7 +147,7 @@ final class JDK_sun_misc_Perf {
             throw new IllegalArgumentException("name: " + name + " already exists");
         }
 
-        final Pointer address = Memory.mustAllocate(maxLength);
+        final Pointer address = Memory.mustAllocate(maxLength, Memory.Tag.VM, true);
         Memory.writeBytes(value, address);
         final PerfString perfString = new PerfString(name, variability, units, address);
         perfDataMap.put(name, perfString);
@@ -519,7 +519,7 @@ final class JDK_sun_misc_Unsafe {
         if (bytes < 0L || bytes > Word.widthValue().max) {
             throw new IllegalArgumentException();
         }
-        Pointer address = Memory.allocate(Size.fromLong(bytes));
+        Pointer address = Memory.allocate(Size.fromLong(bytes), Memory.Tag.UNSAFE, false);
         if (address.isZero()) {
             throw new OutOfMemoryError();
         }
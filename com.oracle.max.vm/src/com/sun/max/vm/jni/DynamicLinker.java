@@ -259,13 +259,7 @@ public final class DynamicLinker {
         if (MaxineVM.isHosted()) {
             symbolAddress = MethodID.fromMethodActor(classMethodActor);
         } else {
-            // First look in the native libraries loaded by the class loader of the class in which this native method was declared
-            ClassLoader classLoader = classMethodActor.holder().classLoader;
-            symbolAddress = Address.fromLong(findNative(classLoader, symbol));
-            // Now look in the system library path
-            if (symbolAddress.isZero() && classLoader != null) {
-                symbolAddress = Address.fromLong(findNative(null, symbol));
-            }
+            symbolAddress = lookupIfPresent(classMethodActor, symbol);
         }
         if (symbolAddress.isZero()) {
             throw new UnsatisfiedLinkError(symbol);
@@ -273,6 +267,24 @@ public final class DynamicLinker {
         return symbolAddress;
     }
 
+    /**
+     * Looks up the symbol for a native method in the libraries bound to the VM.
+     *
+     * @param classMethodActor the actor for a native method
+     * @param symbol the symbol to look up
+     * @return the address of {@code symbol} or zero if it cannot be found
+     */
+    public static Word lookupIfPresent(MethodActor classMethodActor, String symbol) {
+        // First look in the native libraries loaded by the class loader of the class in which this native method was declared
+        ClassLoader classLoader = classMethodActor.holder().classLoader;
+        Word symbolAddress = Address.fromLong(findNative(classLoader, symbol));
+        // Now look in the system library path
+        if (symbolAddress.isZero() && classLoader != null) {
+            symbolAddress = Address.fromLong(findNative(null, symbol));
+        }
+        return symbolAddress;
+    }
+
 
    /*
     * Inspector support for finding native functions. dlfcn isn't very helpful.
@@ -292,7 +304,7 @@ public final class DynamicLinker {
     */
 
     static {
-        new CriticalNativeMethod(Memory.class, "memory_allocate");
+        new CriticalNativeMethod(Memory.class, "memory_allocateTagged");
     }
 
     /**
@@ -340,7 +352,7 @@ public final class DynamicLinker {
                 if (libInfo.handle.equals(handle)) {
                     if (libInfo.sentinelAsCString.isZero()) {
                         Size length = CString.length(sentinel).plus(1);
-                        Pointer sentinelCopy = Memory.mustAllocate(length);
+                        Pointer sentinelCopy = Memory.mustAllocate(length, Memory.Tag.VM, false);
                         Memory.copyBytes(sentinel, sentinelCopy, length);
                         libInfo.sentinelAsCString = sentinelCopy;
                         libInfo.sentinelAddress = sentinelAddress;
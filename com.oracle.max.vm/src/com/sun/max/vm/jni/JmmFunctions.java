@@ -292,7 +292,7 @@ public final class JmmFunctions {
         }
 
         try {
-            return JniHandle.zero();
+            return JniHandles.createLocalHandle(((MemoryPoolMXBean) pool.unhand()).getUsage());
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return asJniHandle(0);
@@ -314,7 +314,7 @@ public final class JmmFunctions {
         }
 
         try {
-            return JniHandle.zero();
+            return JniHandles.createLocalHandle(((MemoryPoolMXBean) pool.unhand()).getPeakUsage());
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return asJniHandle(0);
@@ -362,7 +362,7 @@ public final class JmmFunctions {
         }
 
         try {
-            return 0;
+            return getLongAttribute(att);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return JNI_ERR;
@@ -375,16 +375,52 @@ public final class JmmFunctions {
         }
     }
 
+    /**
+     * Gets the value of a long attribute for {@link #GetLongAttribute} and {@link #GetLongAttributes}.
+     * An entry point must not call another one as that would nest the JNI prologue and epilogue.
+     */
+    private static long getLongAttribute(int att) {
+        switch (att) {
+            case JMM_CLASS_LOADED_COUNT:
+                return ClassLoadingManagement.getTotalClassCount();
+            case JMM_CLASS_UNLOADED_COUNT:
+                return ClassLoadingManagement.getUnloadedClassCount();
+            case JMM_THREAD_TOTAL_COUNT:
+                return ThreadManagement.getTotalStartedThreadCount();
+            case JMM_THREAD_LIVE_COUNT:
+                return ThreadManagement.getTotalThreadCount();
+            case JMM_THREAD_PEAK_COUNT:
+                return ThreadManagement.getPeakThreadCount();
+            case JMM_THREAD_DAEMON_COUNT:
+                return ThreadManagement.getDaemonThreadCount();
+            case JMM_GC_TIME_MS:
+                return MemoryManagement.getCollectionTime();
+            case JMM_GC_COUNT:
+                return MemoryManagement.getCollectionCount();
+            case JMM_GC_EXT_ATTRIBUTE_INFO_SIZE:
+                return 0;
+            default:
+                return -1;
+        }
+    }
+
     @VM_ENTRY_POINT
     private static boolean GetBoolAttribute(Pointer env, int att) {
-        // Source: JmmFunctionsSource.java:120
+        // Source: JmmFunctionsSource.java:149
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetBoolAttribute.ordinal(), UPCALL_ENTRY, anchor, env, Address.fromInt(att));
         }
 
         try {
-            return false;
+            switch (att) {
+                case JMM_THREAD_CONTENTION_MONITORING:
+                    return ThreadManagement.isThreadContentionMonitoringEnabled();
+                case JMM_THREAD_CPU_TIME:
+                    return ThreadManagement.isThreadCpuTimeEnabled();
+                default:
+                    return false;
+            }
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return false;
@@ -399,7 +435,7 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static boolean SetBoolAttribute(Pointer env, int att, boolean flag) {
-        // Source: JmmFunctionsSource.java:125
+        // Source: JmmFunctionsSource.java:161
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.SetBoolAttribute.ordinal(), UPCALL_ENTRY, anchor, env, Address.fromInt(att), Address.fromInt(flag ? 1 : 0));
@@ -412,7 +448,7 @@ public final class JmmFunctions {
                 case JMM_VERBOSE_CLASS:
                     return ClassLoadingManagement.setVerboseClass(flag);
                 case JMM_THREAD_CONTENTION_MONITORING:
-                    return ThreadManagement.setThreadCpuTimeEnabled(flag);
+                    return ThreadManagement.setThreadContentionMonitoringEnabled(flag);
                 case JMM_THREAD_CPU_TIME:
                     return ThreadManagement.setThreadCpuTimeEnabled(flag);
                 default:
@@ -432,15 +468,24 @@ public final class JmmFunctions {
     }
 
     @VM_ENTRY_POINT
-    private static int GetLongAttributes(Pointer env, JniHandle obj, JniHandle atts, int count, JniHandle result) {
-        // Source: JmmFunctionsSource.java:142
+    private static int GetLongAttributes(Pointer env, JniHandle obj, Pointer atts, int count, Pointer result) {
+        // Source: JmmFunctionsSource.java:178
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetLongAttributes.ordinal(), UPCALL_ENTRY, anchor, env, obj, atts, Address.fromInt(count), result);
         }
 
         try {
-            return 0;
+            // atts and result are native arrays of jmmLongAttribute and jlong values
+            int supported = 0;
+            for (int i = 0; i < count; i++) {
+                final long value = getLongAttribute(atts.getInt(i));
+                result.setLong(i, value);
+                if (value != -1) {
+                    supported++;
+                }
+            }
+            return supported;
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return JNI_ERR;
@@ -455,7 +500,7 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static JniHandle FindCircularBlockedThreads(Pointer env) {
-        // Source: JmmFunctionsSource.java:147
+        // Source: JmmFunctionsSource.java:192
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.FindCircularBlockedThreads.ordinal(), UPCALL_ENTRY, anchor, env);
@@ -477,14 +522,14 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static long GetThreadCpuTime(Pointer env, long thread_id) {
-        // Source: JmmFunctionsSource.java:152
+        // Source: JmmFunctionsSource.java:197
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetThreadCpuTime.ordinal(), UPCALL_ENTRY, anchor, env, Address.fromLong(thread_id));
         }
 
         try {
-            return 0;
+            return ThreadManagement.getThreadCpuTime(thread_id, false);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return JNI_ERR;
@@ -499,7 +544,7 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static JniHandle GetVMGlobalNames(Pointer env) {
-        // Source: JmmFunctionsSource.java:157
+        // Source: JmmFunctionsSource.java:202
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetVMGlobalNames.ordinal(), UPCALL_ENTRY, anchor, env);
@@ -521,7 +566,7 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static int GetVMGlobals(Pointer env, JniHandle names, Pointer globals, int count) {
-        // Source: JmmFunctionsSource.java:162
+        // Source: JmmFunctionsSource.java:207
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetVMGlobals.ordinal(), UPCALL_ENTRY, anchor, env, names, globals, Address.fromInt(count));
@@ -543,7 +588,7 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static int GetInternalThreadTimes(Pointer env, JniHandle names, JniHandle times) {
-        // Source: JmmFunctionsSource.java:167
+        // Source: JmmFunctionsSource.java:212
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetInternalThreadTimes.ordinal(), UPCALL_ENTRY, anchor, env, names, times);
@@ -565,14 +610,28 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static boolean ResetStatistic(Pointer env, Word obj, int type) {
-        // Source: JmmFunctionsSource.java:172
+        // Source: JmmFunctionsSource.java:217
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.ResetStatistic.ordinal(), UPCALL_ENTRY, anchor, env, obj, Address.fromInt(type));
         }
 
         try {
-            return false;
+            switch (type) {
+                case JMM_STAT_PEAK_THREAD_COUNT:
+                    ThreadManagement.resetPeakThreadCount();
+                    return true;
+                case JMM_STAT_PEAK_POOL_USAGE: {
+                    final Object pool = obj.asJniHandle().unhand();
+                    if (pool instanceof MemoryPoolMXBean) {
+                        ((MemoryPoolMXBean) pool).resetPeakUsage();
+                        return true;
+                    }
+                    return false;
+                }
+                default:
+                    return false;
+            }
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return false;
@@ -587,7 +646,7 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static void SetPoolSensor(Pointer env, JniHandle pool, int type, JniHandle sensor) {
-        // Source: JmmFunctionsSource.java:177
+        // Source: JmmFunctionsSource.java:236
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.SetPoolSensor.ordinal(), UPCALL_ENTRY, anchor, env, pool, Address.fromInt(type), sensor);
@@ -607,7 +666,7 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static long SetPoolThreshold(Pointer env, JniHandle pool, int type, long threshold) {
-        // Source: JmmFunctionsSource.java:181
+        // Source: JmmFunctionsSource.java:240
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.SetPoolThreshold.ordinal(), UPCALL_ENTRY, anchor, env, pool, Address.fromInt(type), Address.fromLong(threshold));
@@ -629,14 +688,14 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static JniHandle GetPoolCollectionUsage(Pointer env, JniHandle pool) {
-        // Source: JmmFunctionsSource.java:186
+        // Source: JmmFunctionsSource.java:245
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetPoolCollectionUsage.ordinal(), UPCALL_ENTRY, anchor, env, pool);
         }
 
         try {
-            return JniHandle.zero();
+            return JniHandles.createLocalHandle(((MemoryPoolMXBean) pool.unhand()).getCollectionUsage());
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return asJniHandle(0);
@@ -651,7 +710,7 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static int GetGCExtAttributeInfo(Pointer env, JniHandle mgr, Pointer ext_info, int count) {
-        // Source: JmmFunctionsSource.java:191
+        // Source: JmmFunctionsSource.java:250
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetGCExtAttributeInfo.ordinal(), UPCALL_ENTRY, anchor, env, mgr, ext_info, Address.fromInt(count));
@@ -673,13 +732,24 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static void GetLastGCStat(Pointer env, JniHandle mgr, Pointer gc_stat) {
-        // Source: JmmFunctionsSource.java:196
+        // Source: JmmFunctionsSource.java:255
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetLastGCStat.ordinal(), UPCALL_ENTRY, anchor, env, mgr, gc_stat);
         }
 
         try {
+            // Offsets of the fields of jmmGCStat (see jmm.h)
+            final long gcIndex = MemoryManagement.getCollectionCount();
+            gc_stat.writeLong(0, gcIndex);
+            if (gcIndex == 0) {
+                return;
+            }
+            gc_stat.writeLong(8, MemoryManagement.getLastGCStartTime());
+            gc_stat.writeLong(16, MemoryManagement.getLastGCEndTime());
+            copyUsages(MemoryManagement.getLastGCUsage(true), gc_stat.readWord(24).asJniHandle());
+            copyUsages(MemoryManagement.getLastGCUsage(false), gc_stat.readWord(32).asJniHandle());
+            gc_stat.writeInt(56, 0);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -691,16 +761,23 @@ public final class JmmFunctions {
         }
     }
 
+    private static void copyUsages(MemoryUsage[] usages, JniHandle array) {
+        final MemoryUsage[] result = (MemoryUsage[]) array.unhand();
+        if (result != null) {
+            System.arraycopy(usages, 0, result, 0, Math.min(usages.length, result.length));
+        }
+    }
+
     @VM_ENTRY_POINT
     private static long GetThreadCpuTimeWithKind(Pointer env, long thread_id, boolean user_sys_cpu_time) {
-        // Source: JmmFunctionsSource.java:200
+        // Source: JmmFunctionsSource.java:277
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetThreadCpuTimeWithKind.ordinal(), UPCALL_ENTRY, anchor, env, Address.fromLong(thread_id), Address.fromInt(user_sys_cpu_time ? 1 : 0));
         }
 
         try {
-            return 0;
+            return ThreadManagement.getThreadCpuTime(thread_id, !user_sys_cpu_time);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return JNI_ERR;
@@ -715,11 +792,11 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static native Pointer reserved5();
-        // Source: JmmFunctionsSource.java:205
+        // Source: JmmFunctionsSource.java:282
 
     @VM_ENTRY_POINT
     private static int DumpHeap0(Pointer env, JniHandle outputfile, boolean live) {
-        // Source: JmmFunctionsSource.java:208
+        // Source: JmmFunctionsSource.java:285
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.DumpHeap0.ordinal(), UPCALL_ENTRY, anchor, env, outputfile, Address.fromInt(live ? 1 : 0));
@@ -741,7 +818,7 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static JniHandle FindDeadlocks(Pointer env, boolean object_monitors_only) {
-        // Source: JmmFunctionsSource.java:213
+        // Source: JmmFunctionsSource.java:290
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.FindDeadlocks.ordinal(), UPCALL_ENTRY, anchor, env, Address.fromInt(object_monitors_only ? 1 : 0));
@@ -763,7 +840,7 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static void SetVMGlobal(Pointer env, JniHandle flag_name, Word new_value) {
-        // Source: JmmFunctionsSource.java:218
+        // Source: JmmFunctionsSource.java:295
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.SetVMGlobal.ordinal(), UPCALL_ENTRY, anchor, env, flag_name, new_value);
@@ -783,18 +860,18 @@ public final class JmmFunctions {
 
     @VM_ENTRY_POINT
     private static native Word reserved6();
-        // Source: JmmFunctionsSource.java:222
+        // Source: JmmFunctionsSource.java:299
 
     @VM_ENTRY_POINT
     private static JniHandle DumpThreads(Pointer env, JniHandle ids, boolean lockedMonitors, boolean lockedSynchronizers) {
-        // Source: JmmFunctionsSource.java:225
+        // Source: JmmFunctionsSource.java:302
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.DumpThreads.ordinal(), UPCALL_ENTRY, anchor, env, ids, Address.fromInt(lockedMonitors ? 1 : 0), Address.fromInt(lockedSynchronizers ? 1 : 0));
         }
 
         try {
-            return JniHandle.zero();
+            return JniHandles.createLocalHandle(ThreadManagement.dumpThreads((long[]) ids.unhand(), lockedMonitors, lockedSynchronizers));
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return asJniHandle(0);
@@ -95,12 +95,12 @@ public final class JmmFunctionsSource {
 
     @VM_ENTRY_POINT
     private static JniHandle GetMemoryPoolUsage(Pointer env, JniHandle pool) {
-        return JniHandle.zero();
+        return JniHandles.createLocalHandle(((MemoryPoolMXBean) pool.unhand()).getUsage());
     }
 
     @VM_ENTRY_POINT
     private static JniHandle GetPeakMemoryPoolUsage(Pointer env, JniHandle pool) {
-        return JniHandle.zero();
+        return JniHandles.createLocalHandle(((MemoryPoolMXBean) pool.unhand()).getPeakUsage());
     }
 
     @VM_ENTRY_POINT
@@ -113,12 +113,48 @@ public final class JmmFunctionsSource {
 
     @VM_ENTRY_POINT
     private static long GetLongAttribute(Pointer env, JniHandle obj, int att) {
-        return 0;
+        return getLongAttribute(att);
+    }
+
+    /**
+     * Gets the value of a long attribute for {@link #GetLongAttribute} and {@link #GetLongAttributes}.
+     * An entry point must not call another one as that would nest the JNI prologue and epilogue.
+     */
+    private static long getLongAttribute(int att) {
+        switch (att) {
+            case JMM_CLASS_LOADED_COUNT:
+                return ClassLoadingManagement.getTotalClassCount();
+            case JMM_CLASS_UNLOADED_COUNT:
+                return ClassLoadingManagement.getUnloadedClassCount();
+            case JMM_THREAD_TOTAL_COUNT:
+                return ThreadManagement.getTotalStartedThreadCount();
+            case JMM_THREAD_LIVE_COUNT:
+                return ThreadManagement.getTotalThreadCount();
+            case JMM_THREAD_PEAK_COUNT:
+                return ThreadManagement.getPeakThreadCount();
+            case JMM_THREAD_DAEMON_COUNT:
+                return ThreadManagement.getDaemonThreadCount();
+            case JMM_GC_TIME_MS:
+                return MemoryManagement.getCollectionTime();
+            case JMM_GC_COUNT:
+                return MemoryManagement.getCollectionCount();
+            case JMM_GC_EXT_ATTRIBUTE_INFO_SIZE:
+                return 0;
+            default:
+                return -1;
+        }
     }
 
     @VM_ENTRY_POINT
     private static boolean GetBoolAttribute(Pointer env, int att) {
-        return false;
+        switch (att) {
+            case JMM_THREAD_CONTENTION_MONITORING:
+                return ThreadManagement.isThreadContentionMonitoringEnabled();
+            case JMM_THREAD_CPU_TIME:
+                return ThreadManagement.isThreadCpuTimeEnabled();
+            default:
+                return false;
+        }
     }
 
     @VM_ENTRY_POINT
@@ -129,7 +165,7 @@ public final class JmmFunctionsSource {
             case JMM_VERBOSE_CLASS:
                 return ClassLoadingManagement.setVerboseClass(flag);
             case JMM_THREAD_CONTENTION_MONITORING:
-                return ThreadManagement.setThreadCpuTimeEnabled(flag);
+                return ThreadManagement.setThreadContentionMonitoringEnabled(flag);
             case JMM_THREAD_CPU_TIME:
                 return ThreadManagement.setThreadCpuTimeEnabled(flag);
             default:
@@ -139,8 +175,17 @@ public final class JmmFunctionsSource {
     }
 
     @VM_ENTRY_POINT
-    private static int GetLongAttributes(Pointer env, JniHandle obj, JniHandle atts, int count, JniHandle result) {
-        return 0;
+    private static int GetLongAttributes(Pointer env, JniHandle obj, Pointer atts, int count, Pointer result) {
+        // atts and result are native arrays of jmmLongAttribute and jlong values
+        int supported = 0;
+        for (int i = 0; i < count; i++) {
+            final long value = getLongAttribute(atts.getInt(i));
+            result.setLong(i, value);
+            if (value != -1) {
+                supported++;
+            }
+        }
+        return supported;
     }
 
     @VM_ENTRY_POINT
@@ -150,7 +195,7 @@ public final class JmmFunctionsSource {
 
     @VM_ENTRY_POINT
     private static long GetThreadCpuTime(Pointer env, long thread_id) {
-        return 0;
+        return ThreadManagement.getThreadCpuTime(thread_id, false);
     }
 
     @VM_ENTRY_POINT
@@ -170,7 +215,21 @@ public final class JmmFunctionsSource {
 
     @VM_ENTRY_POINT
     private static boolean ResetStatistic(Pointer env, Word obj, int type) {
-        return false;
+        switch (type) {
+            case JMM_STAT_PEAK_THREAD_COUNT:
+                ThreadManagement.resetPeakThreadCount();
+                return true;
+            case JMM_STAT_PEAK_POOL_USAGE: {
+                final Object pool = obj.asJniHandle().unhand();
+                if (pool instanceof MemoryPoolMXBean) {
+                    ((MemoryPoolMXBean) pool).resetPeakUsage();
+                    return true;
+                }
+                return false;
+            }
+            default:
+                return false;
+        }
     }
 
     @VM_ENTRY_POINT
@@ -184,7 +243,7 @@ public final class JmmFunctionsSource {
 
     @VM_ENTRY_POINT
     private static JniHandle GetPoolCollectionUsage(Pointer env, JniHandle pool) {
-        return JniHandle.zero();
+        return JniHandles.createLocalHandle(((MemoryPoolMXBean) pool.unhand()).getCollectionUsage());
     }
 
     @VM_ENTRY_POINT
@@ -194,11 +253,29 @@ public final class JmmFunctionsSource {
 
     @VM_ENTRY_POINT
     private static void GetLastGCStat(Pointer env, JniHandle mgr, Pointer gc_stat) {
+        // Offsets of the fields of jmmGCStat (see jmm.h)
+        final long gcIndex = MemoryManagement.getCollectionCount();
+        gc_stat.writeLong(0, gcIndex);
+        if (gcIndex == 0) {
+            return;
+        }
+        gc_stat.writeLong(8, MemoryManagement.getLastGCStartTime());
+        gc_stat.writeLong(16, MemoryManagement.getLastGCEndTime());
+        copyUsages(MemoryManagement.getLastGCUsage(true), gc_stat.readWord(24).asJniHandle());
+        copyUsages(MemoryManagement.getLastGCUsage(false), gc_stat.readWord(32).asJniHandle());
+        gc_stat.writeInt(56, 0);
+    }
+
+    private static void copyUsages(MemoryUsage[] usages, JniHandle array) {
+        final MemoryUsage[] result = (MemoryUsage[]) array.unhand();
+        if (result != null) {
+            System.arraycopy(usages, 0, result, 0, Math.min(usages.length, result.length));
+        }
     }
 
     @VM_ENTRY_POINT
     private static long GetThreadCpuTimeWithKind(Pointer env, long thread_id, boolean user_sys_cpu_time) {
-        return 0;
+        return ThreadManagement.getThreadCpuTime(thread_id, !user_sys_cpu_time);
     }
 
     @VM_ENTRY_POINT
@@ -223,6 +300,6 @@ public final class JmmFunctionsSource {
 
     @VM_ENTRY_POINT
     private static JniHandle DumpThreads(Pointer env, JniHandle ids, boolean lockedMonitors, boolean lockedSynchronizers) {
-        return JniHandle.zero();
+        return JniHandles.createLocalHandle(ThreadManagement.dumpThreads((long[]) ids.unhand(), lockedMonitors, lockedSynchronizers));
     }
 }
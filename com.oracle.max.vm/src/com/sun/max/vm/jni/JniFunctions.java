@@ -3054,7 +3054,7 @@ public final class JniFunctions {
 
         try {
             setCopyPointer(isCopy, true);
-            return copyString((String) string.unhand());
+            return JniStrings.copyChars((String) string.unhand());
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return asPointer(0);
@@ -3098,7 +3098,7 @@ public final class JniFunctions {
 
         try {
             try {
-                return JniHandles.createLocalHandle(CString.utf8ToJava(utf));
+                return JniHandles.createLocalHandle(JniStrings.fromUtf8(utf));
             } catch (Utf8Exception utf8Exception) {
                 return JniHandle.zero();
             }
@@ -3123,7 +3123,7 @@ public final class JniFunctions {
         }
 
         try {
-            return Utf8.utf8Length((String) string.unhand());
+            return JniStrings.utf8Length((String) string.unhand());
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return JNI_ERR;
@@ -3146,7 +3146,7 @@ public final class JniFunctions {
 
         try {
             setCopyPointer(isCopy, true);
-            return CString.utf8FromJava((String) string.unhand());
+            return JniStrings.toUtf8((String) string.unhand());
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return asPointer(0);
@@ -3471,18 +3471,13 @@ public final class JniFunctions {
     }
 
     private static Pointer getBooleanArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final boolean[] a = (boolean[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setBoolean(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.BOOLEAN, isCopy);
     }
 
     @VM_ENTRY_POINT
     private static Pointer GetByteArrayElements(Pointer env, JniHandle array, Pointer isCopy) {
-        // Source: JniFunctionsSource.java:1212
+        // Source: JniFunctionsSource.java:1207
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetByteArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, isCopy);
@@ -3503,18 +3498,13 @@ public final class JniFunctions {
     }
 
     private static Pointer getByteArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final byte[] a = (byte[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.BYTE.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setByte(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.BYTE, isCopy);
     }
 
     @VM_ENTRY_POINT
     private static Pointer GetCharArrayElements(Pointer env, JniHandle array, Pointer isCopy) {
-        // Source: JniFunctionsSource.java:1227
+        // Source: JniFunctionsSource.java:1217
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetCharArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, isCopy);
@@ -3535,18 +3525,13 @@ public final class JniFunctions {
     }
 
     private static Pointer getCharArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final char[] a = (char[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.CHAR.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setChar(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.CHAR, isCopy);
     }
 
     @VM_ENTRY_POINT
     private static Pointer GetShortArrayElements(Pointer env, JniHandle array, Pointer isCopy) {
-        // Source: JniFunctionsSource.java:1242
+        // Source: JniFunctionsSource.java:1227
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetShortArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, isCopy);
@@ -3567,18 +3552,13 @@ public final class JniFunctions {
     }
 
     private static Pointer getShortArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final short[] a = (short[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.SHORT.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setShort(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.SHORT, isCopy);
     }
 
     @VM_ENTRY_POINT
     private static Pointer GetIntArrayElements(Pointer env, JniHandle array, Pointer isCopy) {
-        // Source: JniFunctionsSource.java:1257
+        // Source: JniFunctionsSource.java:1237
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetIntArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, isCopy);
@@ -3599,18 +3579,13 @@ public final class JniFunctions {
     }
 
     private static Pointer getIntArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final int[] a = (int[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.INT.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setInt(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.INT, isCopy);
     }
 
     @VM_ENTRY_POINT
     private static Pointer GetLongArrayElements(Pointer env, JniHandle array, Pointer isCopy) {
-        // Source: JniFunctionsSource.java:1272
+        // Source: JniFunctionsSource.java:1247
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetLongArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, isCopy);
@@ -3631,18 +3606,13 @@ public final class JniFunctions {
     }
 
     private static Pointer getLongArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final long[] a = (long[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.LONG.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setLong(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.LONG, isCopy);
     }
 
     @VM_ENTRY_POINT
     private static Pointer GetFloatArrayElements(Pointer env, JniHandle array, Pointer isCopy) {
-        // Source: JniFunctionsSource.java:1287
+        // Source: JniFunctionsSource.java:1257
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetFloatArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, isCopy);
@@ -3663,18 +3633,13 @@ public final class JniFunctions {
     }
 
     private static Pointer getFloatArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final float[] a = (float[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.FLOAT.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setFloat(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.FLOAT, isCopy);
     }
 
     @VM_ENTRY_POINT
     private static Pointer GetDoubleArrayElements(Pointer env, JniHandle array, Pointer isCopy) {
-        // Source: JniFunctionsSource.java:1302
+        // Source: JniFunctionsSource.java:1267
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetDoubleArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, isCopy);
@@ -3695,18 +3660,13 @@ public final class JniFunctions {
     }
 
     private static Pointer getDoubleArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final double[] a = (double[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.DOUBLE.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setDouble(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.DOUBLE, isCopy);
     }
 
     @VM_ENTRY_POINT
     private static void ReleaseBooleanArrayElements(Pointer env, JniHandle array, Pointer elements, int mode) {
-        // Source: JniFunctionsSource.java:1317
+        // Source: JniFunctionsSource.java:1277
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.ReleaseBooleanArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, elements, Address.fromInt(mode));
@@ -3727,17 +3687,12 @@ public final class JniFunctions {
 
     private static void releaseBooleanArrayElements(JniHandle array, Pointer elements, int mode) {
         final boolean[] a = (boolean[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getBoolean(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.BOOLEAN, elements, mode);
     }
 
     @VM_ENTRY_POINT
     private static void ReleaseByteArrayElements(Pointer env, JniHandle array, Pointer elements, int mode) {
-        // Source: JniFunctionsSource.java:1332
+        // Source: JniFunctionsSource.java:1287
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.ReleaseByteArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, elements, Address.fromInt(mode));
@@ -3758,17 +3713,12 @@ public final class JniFunctions {
 
     private static void releaseByteArrayElements(JniHandle array, Pointer elements, int mode) {
         final byte[] a = (byte[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getByte(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.BYTE, elements, mode);
     }
 
     @VM_ENTRY_POINT
     private static void ReleaseCharArrayElements(Pointer env, JniHandle array, Pointer elements, int mode) {
-        // Source: JniFunctionsSource.java:1347
+        // Source: JniFunctionsSource.java:1297
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.ReleaseCharArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, elements, Address.fromInt(mode));
@@ -3789,17 +3739,12 @@ public final class JniFunctions {
 
     private static void releaseCharArrayElements(JniHandle array, Pointer elements, int mode) {
         final char[] a = (char[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getChar(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.CHAR, elements, mode);
     }
 
     @VM_ENTRY_POINT
     private static void ReleaseShortArrayElements(Pointer env, JniHandle array, Pointer elements, int mode) {
-        // Source: JniFunctionsSource.java:1362
+        // Source: JniFunctionsSource.java:1307
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.ReleaseShortArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, elements, Address.fromInt(mode));
@@ -3820,17 +3765,12 @@ public final class JniFunctions {
 
     private static void releaseShortArrayElements(JniHandle array, Pointer elements, int mode) {
         final short[] a = (short[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getShort(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.SHORT, elements, mode);
     }
 
     @VM_ENTRY_POINT
     private static void ReleaseIntArrayElements(Pointer env, JniHandle array, Pointer elements, int mode) {
-        // Source: JniFunctionsSource.java:1377
+        // Source: JniFunctionsSource.java:1317
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.ReleaseIntArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, elements, Address.fromInt(mode));
@@ -3851,17 +3791,12 @@ public final class JniFunctions {
 
     private static void releaseIntArrayElements(JniHandle array, Pointer elements, int mode) {
         final int[] a = (int[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getInt(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.INT, elements, mode);
     }
 
     @VM_ENTRY_POINT
     private static void ReleaseLongArrayElements(Pointer env, JniHandle array, Pointer elements, int mode) {
-        // Source: JniFunctionsSource.java:1392
+        // Source: JniFunctionsSource.java:1327
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.ReleaseLongArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, elements, Address.fromInt(mode));
@@ -3882,17 +3817,12 @@ public final class JniFunctions {
 
     private static void releaseLongArrayElements(JniHandle array, Pointer elements, int mode) {
         final long[] a = (long[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getLong(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.LONG, elements, mode);
     }
 
     @VM_ENTRY_POINT
     private static void ReleaseFloatArrayElements(Pointer env, JniHandle array, Pointer elements, int mode) {
-        // Source: JniFunctionsSource.java:1407
+        // Source: JniFunctionsSource.java:1337
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.ReleaseFloatArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, elements, Address.fromInt(mode));
@@ -3913,17 +3843,12 @@ public final class JniFunctions {
 
     private static void releaseFloatArrayElements(JniHandle array, Pointer elements, int mode) {
         final float[] a = (float[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getFloat(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.FLOAT, elements, mode);
     }
 
     @VM_ENTRY_POINT
     private static void ReleaseDoubleArrayElements(Pointer env, JniHandle array, Pointer elements, int mode) {
-        // Source: JniFunctionsSource.java:1422
+        // Source: JniFunctionsSource.java:1347
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.ReleaseDoubleArrayElements.ordinal(), UPCALL_ENTRY, anchor, env, array, elements, Address.fromInt(mode));
@@ -3944,17 +3869,12 @@ public final class JniFunctions {
 
     private static void releaseDoubleArrayElements(JniHandle array, Pointer elements, int mode) {
         final double[] a = (double[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getDouble(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.DOUBLE, elements, mode);
     }
 
     @VM_ENTRY_POINT
     private static void GetBooleanArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1437
+        // Source: JniFunctionsSource.java:1357
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetBooleanArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -3962,9 +3882,7 @@ public final class JniFunctions {
 
         try {
             final boolean[] a = (boolean[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                buffer.setBoolean(i, a[start + i]);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.BOOLEAN, buffer, true);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -3978,7 +3896,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void GetByteArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1445
+        // Source: JniFunctionsSource.java:1363
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetByteArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -3986,9 +3904,7 @@ public final class JniFunctions {
 
         try {
             final byte[] a = (byte[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                buffer.setByte(i, a[start + i]);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.BYTE, buffer, true);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4002,7 +3918,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void GetCharArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1453
+        // Source: JniFunctionsSource.java:1369
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetCharArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4010,9 +3926,7 @@ public final class JniFunctions {
 
         try {
             final char[] a = (char[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                buffer.setChar(i, a[start + i]);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.CHAR, buffer, true);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4026,7 +3940,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void GetShortArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1461
+        // Source: JniFunctionsSource.java:1375
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetShortArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4034,9 +3948,7 @@ public final class JniFunctions {
 
         try {
             final short[] a = (short[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                buffer.setShort(i, a[start + i]);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.SHORT, buffer, true);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4050,7 +3962,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void GetIntArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1469
+        // Source: JniFunctionsSource.java:1381
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetIntArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4058,9 +3970,7 @@ public final class JniFunctions {
 
         try {
             final int[] a = (int[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                buffer.setInt(i, a[start + i]);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.INT, buffer, true);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4074,7 +3984,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void GetLongArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1477
+        // Source: JniFunctionsSource.java:1387
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetLongArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4082,9 +3992,7 @@ public final class JniFunctions {
 
         try {
             final long[] a = (long[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                buffer.setLong(i, a[start + i]);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.LONG, buffer, true);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4098,7 +4006,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void GetFloatArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1485
+        // Source: JniFunctionsSource.java:1393
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetFloatArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4106,9 +4014,7 @@ public final class JniFunctions {
 
         try {
             final float[] a = (float[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                buffer.setFloat(i, a[start + i]);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.FLOAT, buffer, true);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4122,7 +4028,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void GetDoubleArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1493
+        // Source: JniFunctionsSource.java:1399
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetDoubleArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4130,9 +4036,7 @@ public final class JniFunctions {
 
         try {
             final double[] a = (double[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                buffer.setDouble(i, a[start + i]);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.DOUBLE, buffer, true);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4146,7 +4050,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void SetBooleanArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1501
+        // Source: JniFunctionsSource.java:1405
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.SetBooleanArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4154,9 +4058,7 @@ public final class JniFunctions {
 
         try {
             final boolean[] a = (boolean[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                a[start + i] = buffer.getBoolean(i);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.BOOLEAN, buffer, false);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4170,7 +4072,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void SetByteArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1509
+        // Source: JniFunctionsSource.java:1411
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.SetByteArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4178,9 +4080,7 @@ public final class JniFunctions {
 
         try {
             final byte[] a = (byte[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                a[start + i] = buffer.getByte(i);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.BYTE, buffer, false);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4194,7 +4094,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void SetCharArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1517
+        // Source: JniFunctionsSource.java:1417
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.SetCharArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4202,9 +4102,7 @@ public final class JniFunctions {
 
         try {
             final char[] a = (char[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                a[start + i] = buffer.getChar(i);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.CHAR, buffer, false);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4218,7 +4116,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void SetShortArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1525
+        // Source: JniFunctionsSource.java:1423
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.SetShortArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4226,9 +4124,7 @@ public final class JniFunctions {
 
         try {
             final short[] a = (short[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                a[start + i] = buffer.getShort(i);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.SHORT, buffer, false);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4242,7 +4138,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void SetIntArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1533
+        // Source: JniFunctionsSource.java:1429
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.SetIntArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4250,9 +4146,7 @@ public final class JniFunctions {
 
         try {
             final int[] a = (int[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                a[start + i] = buffer.getInt(i);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.INT, buffer, false);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4266,7 +4160,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void SetLongArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1541
+        // Source: JniFunctionsSource.java:1435
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.SetLongArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4274,9 +4168,7 @@ public final class JniFunctions {
 
         try {
             final long[] a = (long[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                a[start + i] = buffer.getLong(i);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.LONG, buffer, false);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4290,7 +4182,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void SetFloatArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1549
+        // Source: JniFunctionsSource.java:1441
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.SetFloatArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4298,9 +4190,7 @@ public final class JniFunctions {
 
         try {
             final float[] a = (float[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                a[start + i] = buffer.getFloat(i);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.FLOAT, buffer, false);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4314,7 +4204,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void SetDoubleArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1557
+        // Source: JniFunctionsSource.java:1447
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.SetDoubleArrayRegion.ordinal(), UPCALL_ENTRY, anchor, env, array, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4322,9 +4212,7 @@ public final class JniFunctions {
 
         try {
             final double[] a = (double[]) array.unhand();
-            for (int i = 0; i < length; i++) {
-                a[start + i] = buffer.getDouble(i);
-            }
+            copyArrayRegion(a, a.length, start, length, Kind.DOUBLE, buffer, false);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4346,7 +4234,7 @@ public final class JniFunctions {
      */
     @VM_ENTRY_POINT
     private static int RegisterNatives(Pointer env, JniHandle javaType, Pointer methods, int numberOfMethods) {
-        // Source: JniFunctionsSource.java:1573
+        // Source: JniFunctionsSource.java:1461
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.RegisterNatives.ordinal(), UPCALL_ENTRY, anchor, env, javaType, methods, Address.fromInt(numberOfMethods));
@@ -4401,7 +4289,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static int UnregisterNatives(Pointer env, JniHandle javaType) {
-        // Source: JniFunctionsSource.java:1611
+        // Source: JniFunctionsSource.java:1499
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.UnregisterNatives.ordinal(), UPCALL_ENTRY, anchor, env, javaType);
@@ -4433,7 +4321,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static int MonitorEnter(Pointer env, JniHandle object) {
-        // Source: JniFunctionsSource.java:1626
+        // Source: JniFunctionsSource.java:1514
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.MonitorEnter.ordinal(), UPCALL_ENTRY, anchor, env, object);
@@ -4456,7 +4344,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static int MonitorExit(Pointer env, JniHandle object) {
-        // Source: JniFunctionsSource.java:1632
+        // Source: JniFunctionsSource.java:1520
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.MonitorExit.ordinal(), UPCALL_ENTRY, anchor, env, object);
@@ -4479,11 +4367,11 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static native int GetJavaVM(Pointer env, Pointer vmPointerPointer);
-        // Source: JniFunctionsSource.java:1638
+        // Source: JniFunctionsSource.java:1526
 
     @VM_ENTRY_POINT
     private static void GetStringRegion(Pointer env, JniHandle string, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1641
+        // Source: JniFunctionsSource.java:1529
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetStringRegion.ordinal(), UPCALL_ENTRY, anchor, env, string, Address.fromInt(start), Address.fromInt(length), buffer);
@@ -4491,9 +4379,8 @@ public final class JniFunctions {
 
         try {
             final String s = (String) string.unhand();
-            for (int i = 0; i < length; i++) {
-                buffer.setChar(i, s.charAt(i + start));
-            }
+            checkStringRegion(s, start, length);
+            JniStrings.copyChars(s, start, length, buffer);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4507,17 +4394,17 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void GetStringUTFRegion(Pointer env, JniHandle string, int start, int length, Pointer buffer) {
-        // Source: JniFunctionsSource.java:1649
+        // Source: JniFunctionsSource.java:1536
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetStringUTFRegion.ordinal(), UPCALL_ENTRY, anchor, env, string, Address.fromInt(start), Address.fromInt(length), buffer);
         }
 
         try {
-            final String s = ((String) string.unhand()).substring(start, start + length);
-            final byte[] utf = Utf8.stringToUtf8(s);
-            Memory.writeBytes(utf, utf.length, buffer);
-            buffer.setByte(utf.length, (byte) 0); // zero termination
+            final String s = (String) string.unhand();
+            checkStringRegion(s, start, length);
+            final int n = JniStrings.toUtf8(s, start, length, buffer);
+            buffer.setByte(n, (byte) 0); // zero termination
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4531,7 +4418,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static Pointer GetPrimitiveArrayCritical(Pointer env, JniHandle array, Pointer isCopy) {
-        // Source: JniFunctionsSource.java:1657
+        // Source: JniFunctionsSource.java:1544
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetPrimitiveArrayCritical.ordinal(), UPCALL_ENTRY, anchor, env, array, isCopy);
@@ -4576,7 +4463,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void ReleasePrimitiveArrayCritical(Pointer env, JniHandle array, Pointer elements, int mode) {
-        // Source: JniFunctionsSource.java:1685
+        // Source: JniFunctionsSource.java:1572
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.ReleasePrimitiveArrayCritical.ordinal(), UPCALL_ENTRY, anchor, env, array, elements, Address.fromInt(mode));
@@ -4617,16 +4504,14 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static Pointer GetStringCritical(Pointer env, JniHandle string, Pointer isCopy) {
-        // Source: JniFunctionsSource.java:1710
+        // Source: JniFunctionsSource.java:1597
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetStringCritical.ordinal(), UPCALL_ENTRY, anchor, env, string, isCopy);
         }
 
         try {
-            // TODO(cwi): Implement optimized version for OptimizeJNICritical if a benchmark uses it frequently
-            setCopyPointer(isCopy, true);
-            return copyString((String) string.unhand());
+            return JniStrings.getCriticalChars((String) string.unhand(), isCopy);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
             return asPointer(0);
@@ -4639,24 +4524,16 @@ public final class JniFunctions {
         }
     }
 
-    private static Pointer copyString(String string) {
-        final Pointer pointer = Memory.mustAllocate(string.length() * Kind.CHAR.width.numberOfBytes);
-        for (int i = 0; i < string.length(); i++) {
-            pointer.setChar(i, string.charAt(i));
-        }
-        return pointer;
-    }
-
     @VM_ENTRY_POINT
     private static void ReleaseStringCritical(Pointer env, JniHandle string, Pointer chars) {
-        // Source: JniFunctionsSource.java:1725
+        // Source: JniFunctionsSource.java:1602
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.ReleaseStringCritical.ordinal(), UPCALL_ENTRY, anchor, env, string, chars);
         }
 
         try {
-            Memory.deallocate(chars);
+            JniStrings.releaseCriticalChars((String) string.unhand(), chars);
         } catch (Throwable t) {
             VmThread.fromJniEnv(env).setJniException(t);
         } finally {
@@ -4670,7 +4547,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static JniHandle NewWeakGlobalRef(Pointer env, JniHandle handle) {
-        // Source: JniFunctionsSource.java:1730
+        // Source: JniFunctionsSource.java:1607
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.NewWeakGlobalRef.ordinal(), UPCALL_ENTRY, anchor, env, handle);
@@ -4692,7 +4569,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static void DeleteWeakGlobalRef(Pointer env, JniHandle handle) {
-        // Source: JniFunctionsSource.java:1735
+        // Source: JniFunctionsSource.java:1612
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.DeleteWeakGlobalRef.ordinal(), UPCALL_ENTRY, anchor, env, handle);
@@ -4713,7 +4590,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static boolean ExceptionCheck(Pointer env) {
-        // Source: JniFunctionsSource.java:1740
+        // Source: JniFunctionsSource.java:1617
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.ExceptionCheck.ordinal(), UPCALL_ENTRY, anchor, env);
@@ -4737,7 +4614,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static JniHandle NewDirectByteBuffer(Pointer env, Pointer address, long capacity) throws Exception {
-        // Source: JniFunctionsSource.java:1747
+        // Source: JniFunctionsSource.java:1624
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.NewDirectByteBuffer.ordinal(), UPCALL_ENTRY, anchor, env, address, Address.fromLong(capacity));
@@ -4760,7 +4637,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static Pointer GetDirectBufferAddress(Pointer env, JniHandle buffer) throws Exception {
-        // Source: JniFunctionsSource.java:1753
+        // Source: JniFunctionsSource.java:1630
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetDirectBufferAddress.ordinal(), UPCALL_ENTRY, anchor, env, buffer);
@@ -4787,7 +4664,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static long GetDirectBufferCapacity(Pointer env, JniHandle buffer) {
-        // Source: JniFunctionsSource.java:1763
+        // Source: JniFunctionsSource.java:1640
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetDirectBufferCapacity.ordinal(), UPCALL_ENTRY, anchor, env, buffer);
@@ -4813,7 +4690,7 @@ public final class JniFunctions {
 
     @VM_ENTRY_POINT
     private static int GetObjectRefType(Pointer env, JniHandle obj) {
-        // Source: JniFunctionsSource.java:1772
+        // Source: JniFunctionsSource.java:1649
         Pointer anchor = prologue(env);
         if (logger.enabled()) {
             logger.log(LogOperations.GetObjectRefType.ordinal(), UPCALL_ENTRY, anchor, env, obj);
@@ -4845,6 +4722,12 @@ public final class JniFunctions {
         }
     }
 
+    private static void checkStringRegion(String string, int start, int length) {
+        if (start < 0 || length < 0 || start > string.length() - length) {
+            throw new StringIndexOutOfBoundsException();
+        }
+    }
+
     private static void releaseElements(Pointer elements, int mode) {
         if (mode == 0 || mode == JNI_ABORT) {
             Memory.deallocate(elements);
@@ -4852,6 +4735,98 @@ public final class JniFunctions {
         assert mode == 0 || mode == JNI_COMMIT || mode == JNI_ABORT;
     }
 
+    /**
+     * Gets the address of the first element of a primitive array. This is only stable while the array is
+     * pinned, in the boot image, or no safepoint can occur.
+     */
+    @INLINE
+    private static Pointer arrayElements(Object array) {
+        return Reference.fromJava(array).toOrigin().plus(Layout.byteArrayLayout().getElementOffsetFromOrigin(0));
+    }
+
+    /**
+     * Ensures that a primitive array will not be moved by the GC so that native code can access its elements in place.
+     * This is the case if the heap scheme supports nested pinning or the array is in the boot image.
+     * GC is not disabled as in {@link #GetPrimitiveArrayCritical}, since the elements may be held across other JNI calls.
+     *
+     * @return {@code true} if the array's elements can be accessed in place until {@link #unpinArray} is called
+     */
+    private static boolean pinArray(Object array) {
+        final HeapScheme heapScheme = VMConfiguration.vmConfig().heapScheme();
+        if (heapScheme.supportsPinning(HeapScheme.PIN_SUPPORT_FLAG.CAN_NEST)) {
+            return heapScheme.pin(array);
+        }
+        return Heap.isInBootImage(array);
+    }
+
+    private static void unpinArray(Object array) {
+        final HeapScheme heapScheme = VMConfiguration.vmConfig().heapScheme();
+        if (heapScheme.supportsPinning(HeapScheme.PIN_SUPPORT_FLAG.CAN_NEST)) {
+            heapScheme.unpin(array);
+        }
+    }
+
+    /**
+     * Implements the Get&lt;PrimitiveType&gt;ArrayElements functions. The elements are returned in place if the array
+     * can be {@linkplain #pinArray pinned}, otherwise they are bulk copied to a malloc'ed buffer.
+     */
+    private static Pointer getArrayElements(Object array, int length, Kind kind, Pointer isCopy) throws OutOfMemoryError {
+        if (pinArray(array)) {
+            setCopyPointer(isCopy, false);
+            return arrayElements(array);
+        }
+        setCopyPointer(isCopy, true);
+        final Size size = Size.fromInt(length).times(kind.width.numberOfBytes);
+        final Pointer pointer = Memory.mustAllocate(size, Memory.Tag.JNI, false);
+        copyElements(array, 0, pointer, size, true);
+        return pointer;
+    }
+
+    /**
+     * Implements the Release&lt;PrimitiveType&gt;ArrayElements functions.
+     */
+    private static void releaseArrayElements(Object array, int length, Kind kind, Pointer elements, int mode) {
+        if (elements.equals(arrayElements(array))) {
+            // The elements were accessed in place
+            if (mode != JNI_COMMIT) {
+                unpinArray(array);
+            }
+            return;
+        }
+        if (mode == 0 || mode == JNI_COMMIT) {
+            copyElements(array, 0, elements, Size.fromInt(length).times(kind.width.numberOfBytes), false);
+        }
+        releaseElements(elements, mode);
+    }
+
+    /**
+     * Implements the Get&lt;PrimitiveType&gt;ArrayRegion and Set&lt;PrimitiveType&gt;ArrayRegion functions.
+     */
+    private static void copyArrayRegion(Object array, int arrayLength, int start, int length, Kind kind, Pointer buffer, boolean toBuffer) {
+        if (start < 0 || length < 0 || start > arrayLength - length) {
+            throw new ArrayIndexOutOfBoundsException();
+        }
+        final int width = kind.width.numberOfBytes;
+        copyElements(array, start * width, buffer, Size.fromInt(length).times(width), toBuffer);
+    }
+
+    /**
+     * Bulk copies between the elements of a primitive array and a native buffer. The array's address is only
+     * valid as long as no GC can occur, hence there must be no safepoint between computing it and the copy.
+     *
+     * @param offset the offset in bytes of the first element to copy
+     * @param toBuffer specifies if the copy is from the array to {@code buffer} or vice versa
+     */
+    @NO_SAFEPOINT_POLLS("the array must not move during the copy")
+    private static void copyElements(Object array, int offset, Pointer buffer, Size size, boolean toBuffer) {
+        final Pointer elements = arrayElements(array).plus(offset);
+        if (toBuffer) {
+            Memory.bulkCopyBytes(elements, buffer, size);
+        } else {
+            Memory.bulkCopyBytes(buffer, elements, size);
+        }
+    }
+
     public static enum LogOperations {
         /* 0 */ DefineClass,
         /* 1 */ FindClass,
@@ -1095,7 +1095,7 @@ public final class JniFunctionsSource {
     @VM_ENTRY_POINT
     private static Pointer GetStringChars(Pointer env, JniHandle string, Pointer isCopy) {
         setCopyPointer(isCopy, true);
-        return copyString((String) string.unhand());
+        return JniStrings.copyChars((String) string.unhand());
     }
 
     @VM_ENTRY_POINT
@@ -1106,7 +1106,7 @@ public final class JniFunctionsSource {
     @VM_ENTRY_POINT
     private static JniHandle NewStringUTF(Pointer env, Pointer utf) {
         try {
-            return JniHandles.createLocalHandle(CString.utf8ToJava(utf));
+            return JniHandles.createLocalHandle(JniStrings.fromUtf8(utf));
         } catch (Utf8Exception utf8Exception) {
             return JniHandle.zero();
         }
@@ -1114,13 +1114,13 @@ public final class JniFunctionsSource {
 
     @VM_ENTRY_POINT
     private static int GetStringUTFLength(Pointer env, JniHandle string) {
-        return Utf8.utf8Length((String) string.unhand());
+        return JniStrings.utf8Length((String) string.unhand());
     }
 
     @VM_ENTRY_POINT
     private static Pointer GetStringUTFChars(Pointer env, JniHandle string, Pointer isCopy) {
         setCopyPointer(isCopy, true);
-        return CString.utf8FromJava((String) string.unhand());
+        return JniStrings.toUtf8((String) string.unhand());
     }
 
     @VM_ENTRY_POINT
@@ -1199,13 +1199,8 @@ public final class JniFunctionsSource {
     }
 
     private static Pointer getBooleanArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final boolean[] a = (boolean[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setBoolean(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.BOOLEAN, isCopy);
     }
 
     @VM_ENTRY_POINT
@@ -1214,13 +1209,8 @@ public final class JniFunctionsSource {
     }
 
     private static Pointer getByteArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final byte[] a = (byte[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.BYTE.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setByte(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.BYTE, isCopy);
     }
 
     @VM_ENTRY_POINT
@@ -1229,13 +1219,8 @@ public final class JniFunctionsSource {
     }
 
     private static Pointer getCharArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final char[] a = (char[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.CHAR.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setChar(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.CHAR, isCopy);
     }
 
     @VM_ENTRY_POINT
@@ -1244,13 +1229,8 @@ public final class JniFunctionsSource {
     }
 
     private static Pointer getShortArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final short[] a = (short[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.SHORT.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setShort(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.SHORT, isCopy);
     }
 
     @VM_ENTRY_POINT
@@ -1259,13 +1239,8 @@ public final class JniFunctionsSource {
     }
 
     private static Pointer getIntArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final int[] a = (int[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.INT.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setInt(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.INT, isCopy);
     }
 
     @VM_ENTRY_POINT
@@ -1274,13 +1249,8 @@ public final class JniFunctionsSource {
     }
 
     private static Pointer getLongArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final long[] a = (long[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.LONG.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setLong(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.LONG, isCopy);
     }
 
     @VM_ENTRY_POINT
@@ -1289,13 +1259,8 @@ public final class JniFunctionsSource {
     }
 
     private static Pointer getFloatArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final float[] a = (float[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.FLOAT.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setFloat(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.FLOAT, isCopy);
     }
 
     @VM_ENTRY_POINT
@@ -1304,13 +1269,8 @@ public final class JniFunctionsSource {
     }
 
     private static Pointer getDoubleArrayElements(JniHandle array, Pointer isCopy) throws OutOfMemoryError {
-        setCopyPointer(isCopy, true);
         final double[] a = (double[]) array.unhand();
-        final Pointer pointer = Memory.mustAllocate(a.length * Kind.DOUBLE.width.numberOfBytes);
-        for (int i = 0; i < a.length; i++) {
-            pointer.setDouble(i, a[i]);
-        }
-        return pointer;
+        return getArrayElements(a, a.length, Kind.DOUBLE, isCopy);
     }
 
     @VM_ENTRY_POINT
@@ -1320,12 +1280,7 @@ public final class JniFunctionsSource {
 
     private static void releaseBooleanArrayElements(JniHandle array, Pointer elements, int mode) {
         final boolean[] a = (boolean[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getBoolean(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.BOOLEAN, elements, mode);
     }
 
     @VM_ENTRY_POINT
@@ -1335,12 +1290,7 @@ public final class JniFunctionsSource {
 
     private static void releaseByteArrayElements(JniHandle array, Pointer elements, int mode) {
         final byte[] a = (byte[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getByte(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.BYTE, elements, mode);
     }
 
     @VM_ENTRY_POINT
@@ -1350,12 +1300,7 @@ public final class JniFunctionsSource {
 
     private static void releaseCharArrayElements(JniHandle array, Pointer elements, int mode) {
         final char[] a = (char[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getChar(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.CHAR, elements, mode);
     }
 
     @VM_ENTRY_POINT
@@ -1365,12 +1310,7 @@ public final class JniFunctionsSource {
 
     private static void releaseShortArrayElements(JniHandle array, Pointer elements, int mode) {
         final short[] a = (short[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getShort(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.SHORT, elements, mode);
     }
 
     @VM_ENTRY_POINT
@@ -1380,12 +1320,7 @@ public final class JniFunctionsSource {
 
     private static void releaseIntArrayElements(JniHandle array, Pointer elements, int mode) {
         final int[] a = (int[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getInt(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.INT, elements, mode);
     }
 
     @VM_ENTRY_POINT
@@ -1395,12 +1330,7 @@ public final class JniFunctionsSource {
 
     private static void releaseLongArrayElements(JniHandle array, Pointer elements, int mode) {
         final long[] a = (long[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getLong(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.LONG, elements, mode);
     }
 
     @VM_ENTRY_POINT
@@ -1410,12 +1340,7 @@ public final class JniFunctionsSource {
 
     private static void releaseFloatArrayElements(JniHandle array, Pointer elements, int mode) {
         final float[] a = (float[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getFloat(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.FLOAT, elements, mode);
     }
 
     @VM_ENTRY_POINT
@@ -1425,140 +1350,103 @@ public final class JniFunctionsSource {
 
     private static void releaseDoubleArrayElements(JniHandle array, Pointer elements, int mode) {
         final double[] a = (double[]) array.unhand();
-        if (mode == 0 || mode == JNI_COMMIT) {
-            for (int i = 0; i < a.length; i++) {
-                a[i] = elements.getDouble(i);
-            }
-        }
-        releaseElements(elements, mode);
+        releaseArrayElements(a, a.length, Kind.DOUBLE, elements, mode);
     }
 
     @VM_ENTRY_POINT
     private static void GetBooleanArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final boolean[] a = (boolean[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            buffer.setBoolean(i, a[start + i]);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.BOOLEAN, buffer, true);
     }
 
     @VM_ENTRY_POINT
     private static void GetByteArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final byte[] a = (byte[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            buffer.setByte(i, a[start + i]);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.BYTE, buffer, true);
     }
 
     @VM_ENTRY_POINT
     private static void GetCharArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final char[] a = (char[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            buffer.setChar(i, a[start + i]);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.CHAR, buffer, true);
     }
 
     @VM_ENTRY_POINT
     private static void GetShortArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final short[] a = (short[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            buffer.setShort(i, a[start + i]);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.SHORT, buffer, true);
     }
 
     @VM_ENTRY_POINT
     private static void GetIntArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final int[] a = (int[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            buffer.setInt(i, a[start + i]);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.INT, buffer, true);
     }
 
     @VM_ENTRY_POINT
     private static void GetLongArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final long[] a = (long[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            buffer.setLong(i, a[start + i]);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.LONG, buffer, true);
     }
 
     @VM_ENTRY_POINT
     private static void GetFloatArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final float[] a = (float[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            buffer.setFloat(i, a[start + i]);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.FLOAT, buffer, true);
     }
 
     @VM_ENTRY_POINT
     private static void GetDoubleArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final double[] a = (double[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            buffer.setDouble(i, a[start + i]);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.DOUBLE, buffer, true);
     }
 
     @VM_ENTRY_POINT
     private static void SetBooleanArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final boolean[] a = (boolean[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            a[start + i] = buffer.getBoolean(i);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.BOOLEAN, buffer, false);
     }
 
     @VM_ENTRY_POINT
     private static void SetByteArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final byte[] a = (byte[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            a[start + i] = buffer.getByte(i);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.BYTE, buffer, false);
     }
 
     @VM_ENTRY_POINT
     private static void SetCharArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final char[] a = (char[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            a[start + i] = buffer.getChar(i);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.CHAR, buffer, false);
     }
 
     @VM_ENTRY_POINT
     private static void SetShortArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final short[] a = (short[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            a[start + i] = buffer.getShort(i);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.SHORT, buffer, false);
     }
 
     @VM_ENTRY_POINT
     private static void SetIntArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final int[] a = (int[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            a[start + i] = buffer.getInt(i);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.INT, buffer, false);
     }
 
     @VM_ENTRY_POINT
     private static void SetLongArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final long[] a = (long[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            a[start + i] = buffer.getLong(i);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.LONG, buffer, false);
     }
 
     @VM_ENTRY_POINT
     private static void SetFloatArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final float[] a = (float[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            a[start + i] = buffer.getFloat(i);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.FLOAT, buffer, false);
     }
 
     @VM_ENTRY_POINT
     private static void SetDoubleArrayRegion(Pointer env, JniHandle array, int start, int length, Pointer buffer) {
         final double[] a = (double[]) array.unhand();
-        for (int i = 0; i < length; i++) {
-            a[start + i] = buffer.getDouble(i);
-        }
+        copyArrayRegion(a, a.length, start, length, Kind.DOUBLE, buffer, false);
     }
 
     /**
@@ -1640,17 +1528,16 @@ public final class JniFunctionsSource {
     @VM_ENTRY_POINT
     private static void GetStringRegion(Pointer env, JniHandle string, int start, int length, Pointer buffer) {
         final String s = (String) string.unhand();
-        for (int i = 0; i < length; i++) {
-            buffer.setChar(i, s.charAt(i + start));
-        }
+        checkStringRegion(s, start, length);
+        JniStrings.copyChars(s, start, length, buffer);
     }
 
     @VM_ENTRY_POINT
     private static void GetStringUTFRegion(Pointer env, JniHandle string, int start, int length, Pointer buffer) {
-        final String s = ((String) string.unhand()).substring(start, start + length);
-        final byte[] utf = Utf8.stringToUtf8(s);
-        Memory.writeBytes(utf, utf.length, buffer);
-        buffer.setByte(utf.length, (byte) 0); // zero termination
+        final String s = (String) string.unhand();
+        checkStringRegion(s, start, length);
+        final int n = JniStrings.toUtf8(s, start, length, buffer);
+        buffer.setByte(n, (byte) 0); // zero termination
     }
 
     @VM_ENTRY_POINT
@@ -1708,22 +1595,12 @@ public final class JniFunctionsSource {
 
     @VM_ENTRY_POINT
     private static Pointer GetStringCritical(Pointer env, JniHandle string, Pointer isCopy) {
-        // TODO(cwi): Implement optimized version for OptimizeJNICritical if a benchmark uses it frequently
-        setCopyPointer(isCopy, true);
-        return copyString((String) string.unhand());
-    }
-
-    private static Pointer copyString(String string) {
-        final Pointer pointer = Memory.mustAllocate(string.length() * Kind.CHAR.width.numberOfBytes);
-        for (int i = 0; i < string.length(); i++) {
-            pointer.setChar(i, string.charAt(i));
-        }
-        return pointer;
+        return JniStrings.getCriticalChars((String) string.unhand(), isCopy);
     }
 
     @VM_ENTRY_POINT
     private static void ReleaseStringCritical(Pointer env, JniHandle string, Pointer chars) {
-        Memory.deallocate(chars);
+        JniStrings.releaseCriticalChars((String) string.unhand(), chars);
     }
 
     @VM_ENTRY_POINT
@@ -1785,6 +1662,12 @@ public final class JniFunctionsSource {
         }
     }
 
+    private static void checkStringRegion(String string, int start, int length) {
+        if (start < 0 || length < 0 || start > string.length() - length) {
+            throw new StringIndexOutOfBoundsException();
+        }
+    }
+
     private static void releaseElements(Pointer elements, int mode) {
         if (mode == 0 || mode == JNI_ABORT) {
             Memory.deallocate(elements);
@@ -1792,4 +1675,96 @@ public final class JniFunctionsSource {
         assert mode == 0 || mode == JNI_COMMIT || mode == JNI_ABORT;
     }
 
+    /**
+     * Gets the address of the first element of a primitive array. This is only stable while the array is
+     * pinned, in the boot image, or no safepoint can occur.
+     */
+    @INLINE
+    private static Pointer arrayElements(Object array) {
+        return Reference.fromJava(array).toOrigin().plus(Layout.byteArrayLayout().getElementOffsetFromOrigin(0));
+    }
+
+    /**
+     * Ensures that a primitive array will not be moved by the GC so that native code can access its elements in place.
+     * This is the case if the heap scheme supports nested pinning or the array is in the boot image.
+     * GC is not disabled as in {@link #GetPrimitiveArrayCritical}, since the elements may be held across other JNI calls.
+     *
+     * @return {@code true} if the array's elements can be accessed in place until {@link #unpinArray} is called
+     */
+    private static boolean pinArray(Object array) {
+        final HeapScheme heapScheme = VMConfiguration.vmConfig().heapScheme();
+        if (heapScheme.supportsPinning(HeapScheme.PIN_SUPPORT_FLAG.CAN_NEST)) {
+            return heapScheme.pin(array);
+        }
+        return Heap.isInBootImage(array);
+    }
+
+    private static void unpinArray(Object array) {
+        final HeapScheme heapScheme = VMConfiguration.vmConfig().heapScheme();
+        if (heapScheme.supportsPinning(HeapScheme.PIN_SUPPORT_FLAG.CAN_NEST)) {
+            heapScheme.unpin(array);
+        }
+    }
+
+    /**
+     * Implements the Get&lt;PrimitiveType&gt;ArrayElements functions. The elements are returned in place if the array
+     * can be {@linkplain #pinArray pinned}, otherwise they are bulk copied to a malloc'ed buffer.
+     */
+    private static Pointer getArrayElements(Object array, int length, Kind kind, Pointer isCopy) throws OutOfMemoryError {
+        if (pinArray(array)) {
+            setCopyPointer(isCopy, false);
+            return arrayElements(array);
+        }
+        setCopyPointer(isCopy, true);
+        final Size size = Size.fromInt(length).times(kind.width.numberOfBytes);
+        final Pointer pointer = Memory.mustAllocate(size, Memory.Tag.JNI, false);
+        copyElements(array, 0, pointer, size, true);
+        return pointer;
+    }
+
+    /**
+     * Implements the Release&lt;PrimitiveType&gt;ArrayElements functions.
+     */
+    private static void releaseArrayElements(Object array, int length, Kind kind, Pointer elements, int mode) {
+        if (elements.equals(arrayElements(array))) {
+            // The elements were accessed in place
+            if (mode != JNI_COMMIT) {
+                unpinArray(array);
+            }
+            return;
+        }
+        if (mode == 0 || mode == JNI_COMMIT) {
+            copyElements(array, 0, elements, Size.fromInt(length).times(kind.width.numberOfBytes), false);
+        }
+        releaseElements(elements, mode);
+    }
+
+    /**
+     * Implements the Get&lt;PrimitiveType&gt;ArrayRegion and Set&lt;PrimitiveType&gt;ArrayRegion functions.
+     */
+    private static void copyArrayRegion(Object array, int arrayLength, int start, int length, Kind kind, Pointer buffer, boolean toBuffer) {
+        if (start < 0 || length < 0 || start > arrayLength - length) {
+            throw new ArrayIndexOutOfBoundsException();
+        }
+        final int width = kind.width.numberOfBytes;
+        copyElements(array, start * width, buffer, Size.fromInt(length).times(width), toBuffer);
+    }
+
+    /**
+     * Bulk copies between the elements of a primitive array and a native buffer. The array's address is only
+     * valid as long as no GC can occur, hence there must be no safepoint between computing it and the copy.
+     *
+     * @param offset the offset in bytes of the first element to copy
+     * @param toBuffer specifies if the copy is from the array to {@code buffer} or vice versa
+     */
+    @NO_SAFEPOINT_POLLS("the array must not move during the copy")
+    private static void copyElements(Object array, int offset, Pointer buffer, Size size, boolean toBuffer) {
+        final Pointer elements = arrayElements(array).plus(offset);
+        if (toBuffer) {
+            Memory.bulkCopyBytes(elements, buffer, size);
+        } else {
+            Memory.bulkCopyBytes(buffer, elements, size);
+        }
+    }
+
 }
@@ -0,0 +1,254 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.sun.max.vm.jni;
+
+import com.sun.max.atomic.*;
+import com.sun.max.unsafe.*;
+import com.sun.max.vm.layout.*;
+import com.sun.max.vm.reference.*;
+
+/**
+ * A table of global or weak global JNI handles from which any number of threads can allocate
+ * and free handles without locking.
+ *
+ * The handles are stored in fixed size chunks that never move once allocated, so the index of a
+ * handle is stable and a handle can be dereferenced without synchronization. Each chunk is an
+ * ordinary object reachable from the table, so a garbage collector sees the table as a set of
+ * independent, equally sized arrays that can be scanned in parallel.
+ *
+ * Freed indexes are recycled through a small {@linkplain FreeCache per-thread cache} first,
+ * backed by a shared lock-free stack. Only adding a chunk takes a lock, which happens once
+ * every {@link #CHUNK_SIZE} net allocations.
+ */
+final class JniHandleTable {
+
+    static final int CHUNK_SHIFT = 8;
+    static final int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+    static final int CHUNK_MASK = CHUNK_SIZE - 1;
+
+    /**
+     * The number of freed indexes a thread caches before returning some of them to the shared free list.
+     */
+    static final int FREE_CACHE_SIZE = 32;
+
+    static final class Chunk {
+        final Object[] slots = new Object[CHUNK_SIZE];
+
+        /**
+         * Links of the shared free list. The entry for a free slot is one more than the index of the next free slot, or 0.
+         */
+        final int[] links = new int[CHUNK_SIZE];
+    }
+
+    /**
+     * Freed indexes that can be reused by a single thread without any atomic operation.
+     */
+    static final class FreeCache {
+        final int[] indexes = new int[FREE_CACHE_SIZE];
+        int count;
+    }
+
+    private volatile Chunk[] chunks = new Chunk[16];
+
+    /**
+     * The number of slots backed by {@link #chunks}. This is only updated after the chunk has been published.
+     */
+    private volatile int capacity;
+
+    /**
+     * The index of the next slot that has never been allocated.
+     */
+    private final AtomicInteger top = new AtomicInteger();
+
+    /**
+     * The head of the shared free list. The low 32 bits are one more than the index of the first free slot (0 if
+     * the list is empty) and the high 32 bits are a stamp that is incremented by every update to avoid ABA problems.
+     */
+    private final AtomicWord freeList = new AtomicWord();
+
+    private final AtomicInteger live = new AtomicInteger();
+    private final AtomicInteger peak = new AtomicInteger();
+    private final AtomicInteger allocated = new AtomicInteger();
+
+    /**
+     * Gets the number of handles currently allocated from this table.
+     */
+    int live() {
+        return live.get();
+    }
+
+    /**
+     * Gets the greatest number of handles that have been simultaneously allocated from this table.
+     */
+    int peak() {
+        return peak.get();
+    }
+
+    /**
+     * Gets the total number of handles that have been allocated from this table.
+     */
+    int allocated() {
+        return allocated.get();
+    }
+
+    /**
+     * Gets the number of chunks currently held by this table.
+     */
+    int numberOfChunks() {
+        return capacity >> CHUNK_SHIFT;
+    }
+
+    private Chunk chunk(int index) {
+        return chunks[index >> CHUNK_SHIFT];
+    }
+
+    /**
+     * Gets the object stored at a given index.
+     */
+    Object get(int index) {
+        return chunk(index).slots[index & CHUNK_MASK];
+    }
+
+    /**
+     * Stores an object in a free slot of this table.
+     *
+     * @param object the object to store
+     * @param cache the current thread's cache of freed indexes for this table or {@code null}
+     * @return the index of the slot
+     */
+    int allocate(Object object, FreeCache cache) {
+        assert object != null;
+        int index;
+        if (cache != null && cache.count != 0) {
+            index = cache.indexes[--cache.count];
+        } else {
+            index = pop();
+            if (index < 0) {
+                index = top.getAndAdd(1);
+                if (index >= capacity) {
+                    grow(index);
+                }
+            }
+        }
+        chunk(index).slots[index & CHUNK_MASK] = object;
+
+        allocated.getAndAdd(1);
+        final int newLive = live.getAndAdd(1) + 1;
+        int oldPeak = peak.get();
+        while (newLive > oldPeak && !peak.compareAndSet(oldPeak, newLive)) {
+            oldPeak = peak.get();
+        }
+        return index;
+    }
+
+    /**
+     * Frees the slot at a given index. Freeing a slot that is already free has no effect, even if
+     * several threads race to free the same slot: only the one that clears it recycles its index.
+     *
+     * @param index the index of the slot
+     * @param cache the current thread's cache of freed indexes for this table or {@code null}
+     */
+    void free(int index, FreeCache cache) {
+        final Reference slots = Reference.fromJava(chunk(index).slots);
+        final Offset offset = Layout.referenceArrayLayout().getElementOffsetFromOrigin(index & CHUNK_MASK);
+        final Reference object = slots.readReference(offset);
+        if (object.isZero() || slots.compareAndSwapReference(offset, object, Reference.zero()) != object) {
+            return;
+        }
+        live.getAndAdd(-1);
+
+        if (cache == null) {
+            push(index);
+            return;
+        }
+        if (cache.count == FREE_CACHE_SIZE) {
+            // Return the older half of the cache so that other threads can reuse those slots
+            final int half = FREE_CACHE_SIZE / 2;
+            for (int i = 0; i != half; ++i) {
+                push(cache.indexes[i]);
+                cache.indexes[i] = cache.indexes[i + half];
+            }
+            cache.count = half;
+        }
+        cache.indexes[cache.count++] = index;
+    }
+
+    /**
+     * Returns all the indexes in a thread's cache to the shared free list.
+     */
+    void flush(FreeCache cache) {
+        while (cache.count != 0) {
+            push(cache.indexes[--cache.count]);
+        }
+    }
+
+    private synchronized void grow(int index) {
+        while (index >= capacity) {
+            final int n = capacity >> CHUNK_SHIFT;
+            Chunk[] c = chunks;
+            if (n == c.length) {
+                final Chunk[] newChunks = new Chunk[n * 2];
+                // Can't use System.arraycopy - it's a native method which may require allocating JNI handles!
+                for (int i = 0; i != n; ++i) {
+                    newChunks[i] = c[i];
+                }
+                c = newChunks;
+            }
+            c[n] = new Chunk();
+            chunks = c;
+            capacity = (n + 1) << CHUNK_SHIFT;
+        }
+    }
+
+    private void push(int index) {
+        final int[] links = chunk(index).links;
+        while (true) {
+            final long head = freeList.get().asAddress().toLong();
+            links[index & CHUNK_MASK] = (int) head;
+            final long newHead = ((head >>> 32) + 1) << 32 | (index + 1);
+            if (freeList.compareAndSet(Address.fromLong(head), Address.fromLong(newHead))) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * Removes an index from the shared free list.
+     *
+     * @return the removed index or -1 if the list is empty
+     */
+    private int pop() {
+        while (true) {
+            final long head = freeList.get().asAddress().toLong();
+            final int index = (int) head - 1;
+            if (index < 0) {
+                return -1;
+            }
+            final int next = chunk(index).links[index & CHUNK_MASK];
+            final long newHead = ((head >>> 32) + 1) << 32 | (next & 0xFFFFFFFFL);
+            if (freeList.compareAndSet(Address.fromLong(head), Address.fromLong(newHead))) {
+                return index;
+            }
+        }
+    }
+}
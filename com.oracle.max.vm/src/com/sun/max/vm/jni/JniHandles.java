@@ -40,11 +40,12 @@ import com.sun.max.vm.type.*;
  *
  * The first type of handle is implemented as the address of an object on the thread's stack.
  * The second type of handle is allocated from a pool of JNI handles. There is one pool of
- * JNI handles per thread that is used to allocate local JNI references, a
- * global pool per VM (or isolate?) for global references and
- * another global pool for weak global references.
+ * JNI handles per thread that is used to allocate local JNI references. Global and weak
+ * global references are allocated from two {@linkplain JniHandleTable tables} shared by all threads.
  *
- * This class implements a pool of JNI handles.
+ * This class implements a pool of JNI handles. A pool is a stack of fixed size chunks
+ * so that pushing and popping local frames never copies handles and so that the chunks
+ * left over from a large burst of local references can be released.
  *
  * In the Maxine VM, we need to take into account that objects may be allocated
  * in a hardware object memory where one cannot take the address of an element or field within
@@ -89,34 +90,62 @@ public final class JniHandles {
         public static final int BITS = 2;
     }
 
-    static final class Frame {
-        final int start;
-        final Frame previous;
-        public Frame(int start, Frame previous) {
-            this.start = start;
-            this.previous = previous;
-        }
+    /**
+     * The number of handles in a chunk, expressed as a power of 2.
+     */
+    public static final int CHUNK_SHIFT = 5;
+    public static final int CHUNK_SIZE = 1 << CHUNK_SHIFT;
+    private static final int CHUNK_MASK = CHUNK_SIZE - 1;
+
+    /**
+     * The number of empty chunks above the live chunks that are kept for reuse when a pool shrinks.
+     */
+    public static final int RETAINED_SPARE_CHUNKS = 2;
+
+    public static final int INITIAL_NUMBER_OF_HANDLES = CHUNK_SIZE;
+
+    static boolean PrintJniHandleStatistics;
+    static {
+        VMOptions.addFieldOption("-XX:", "PrintJniHandleStatistics", JniHandles.class,
+            "Print the local JNI handle usage of each thread when it terminates.", MaxineVM.Phase.PRISTINE);
     }
 
-    public static final int INITIAL_NUMBER_OF_HANDLES = 32;
+    private static final JniHandleTable globalHandles = new JniHandleTable();
+    private static final JniHandleTable weakGlobalHandles = new JniHandleTable();
+
+    /**
+     * This thread's cache of freed global handle indexes.
+     */
+    private final JniHandleTable.FreeCache globalFreeCache = new JniHandleTable.FreeCache();
 
-    private static final JniHandles globalHandles = new JniHandles();
-    private static final JniHandles weakGlobalHandles = new JniHandles();
+    /**
+     * This thread's cache of freed weak global handle indexes.
+     */
+    private final JniHandleTable.FreeCache weakGlobalFreeCache = new JniHandleTable.FreeCache();
 
     /**
-     * The objects exposed to native code via handles.
+     * The objects exposed to native code via handles, stored in fixed size chunks.
+     * The handle at index {@code i} is {@code chunks[i >> CHUNK_SHIFT][i & CHUNK_MASK]}.
      *
-     * Note that this representation simplifies handle allocation and dereferencing
-     * (in the context of a "JNI handle is an index" implementation)
-     * at the cost of expanding an array (allocation plus copy). It will be replaced
-     * with a better representation if this expansion cost proves to be too high.
+     * Chunks never move once allocated, so growing the pool only appends a chunk (and
+     * occasionally expands this directory of chunk references) instead of copying every handle.
+     * When the pool shrinks, all but {@link #RETAINED_SPARE_CHUNKS} of the chunks above {@link #top}
+     * are dropped so that a burst of local references in one native call does not leave
+     * a large, empty array to be scanned by every subsequent garbage collection.
      */
-    private Object[] handles = new Object[INITIAL_NUMBER_OF_HANDLES];
+    private Object[][] chunks = new Object[4][];
 
     /**
-     * The frames pushed by {@link JniFunctions#PushLocalFrame}.
+     * The number of non-null entries at the start of {@link #chunks}.
      */
-    private Frame frames;
+    private int numberOfChunks;
+
+    /**
+     * The values of {@link #top} saved by {@link JniFunctions#PushLocalFrame}, with the
+     * most recently pushed frame at {@code frames[frameDepth - 1]}.
+     */
+    private int[] frames;
+    private int frameDepth;
 
     /**
      * Denotes the indexes of handles that have been {@linkplain #freeHandle(int) freed}.
@@ -134,14 +163,33 @@ public final class JniHandles {
 
     /**
      * Number of handles allocated from this pool that are (potentially) still in use.
-     * This value also denotes the index of next unused handle in {@link #handles}.
+     * This value also denotes the index of next unused handle.
      * The name of this field also gives some indication of how handles can be allocated
      * and freed in a stack like fashion.
      *
-     * Invariant: All elements in {@link #handles} at an index greater than or equal to {@link #top} are null.
+     * Invariant: All handles at an index greater than or equal to {@link #top} are null.
      */
     private int top;
 
+    /**
+     * The greatest value {@link #top} has had.
+     */
+    private int highWaterMark;
+
+    /**
+     * The greatest value {@link #numberOfChunks} has had.
+     */
+    private int peakChunks;
+
+    /**
+     * The number of chunks allocated for this pool, including those allocated to replace dropped chunks.
+     */
+    private int chunksAllocated;
+
+    public JniHandles() {
+        addChunk();
+    }
+
     /**
      * Return the "top" (i.e. current size) of this handle pool. This value can be given
      * as the parameter to the {@link #resetTop(int)} method to free handles in a stack
@@ -152,6 +200,34 @@ public final class JniHandles {
         return top;
     }
 
+    /**
+     * Gets the greatest number of handles that have been simultaneously allocated from this pool.
+     */
+    public int highWaterMark() {
+        return highWaterMark;
+    }
+
+    /**
+     * Gets the greatest number of chunks that have been simultaneously held by this pool.
+     */
+    public int peakChunks() {
+        return peakChunks;
+    }
+
+    /**
+     * Gets the total number of chunks that have been allocated for this pool.
+     */
+    public int chunksAllocated() {
+        return chunksAllocated;
+    }
+
+    /**
+     * Gets the number of chunks currently held by this pool.
+     */
+    public int numberOfChunks() {
+        return numberOfChunks;
+    }
+
     /**
      * Resets the "top" (i.e. current size) of this handle pool to a value
      * equal to or less than its current size.
@@ -164,7 +240,7 @@ public final class JniHandles {
 
         if (newTop != this.top) {
             for (int i = newTop; i != this.top; ++i) {
-                handles[i] = null;
+                set(i, null);
             }
             int freeLength = freedHandles.length();
             if (freeLength >= newTop) {
@@ -175,14 +251,34 @@ public final class JniHandles {
 
             lastFreedIndex = 0;
             this.top = newTop;
+
+            // Drop the chunks that are no longer needed, keeping a few for the next call
+            final int retainedChunks = Math.max(1, ((newTop + CHUNK_MASK) >> CHUNK_SHIFT) + RETAINED_SPARE_CHUNKS);
+            while (numberOfChunks > retainedChunks) {
+                chunks[--numberOfChunks] = null;
+            }
         }
     }
 
     /**
      * Gets the handle at a given index.
      */
+    @INLINE
     private Object get(int index) {
-        return handles[index];
+        return chunks[index >> CHUNK_SHIFT][index & CHUNK_MASK];
+    }
+
+    @INLINE
+    private void set(int index, Object object) {
+        chunks[index >> CHUNK_SHIFT][index & CHUNK_MASK] = object;
+    }
+
+    /**
+     * Gets the number of handles that can be allocated from this pool without adding a chunk.
+     */
+    @INLINE
+    private int capacity() {
+        return numberOfChunks << CHUNK_SHIFT;
     }
 
     /**
@@ -191,48 +287,59 @@ public final class JniHandles {
      * @param index the index of the handle to free
      */
     private void freeHandle(int index) {
-        handles[index] = null;
+        set(index, null);
         freedHandles.grow(index + 1);
         freedHandles.set(index);
         lastFreedIndex = index;
     }
 
-    private static Object[] expandHandles(Object[] handles, int newLength) {
-        final int currentLength = handles.length;
-        final Object[] newHandles = new Object[newLength];
-        // Can't use System.arraycopy - it's a native method which may require allocating JNI handles!
-        for (int i = 0; i != currentLength; ++i) {
-            newHandles[i] = handles[i];
+    /**
+     * Appends an empty chunk to this pool.
+     */
+    private void addChunk() {
+        if (numberOfChunks == chunks.length) {
+            final Object[][] newChunks = new Object[chunks.length * 2][];
+            // Can't use System.arraycopy - it's a native method which may require allocating JNI handles!
+            for (int i = 0; i != numberOfChunks; ++i) {
+                newChunks[i] = chunks[i];
+            }
+            chunks = newChunks;
+        }
+        chunks[numberOfChunks++] = new Object[CHUNK_SIZE];
+        chunksAllocated++;
+        if (numberOfChunks > peakChunks) {
+            peakChunks = numberOfChunks;
         }
-        return newHandles;
     }
 
     private JniHandle allocateHandle(Object object, int tag) {
         assert object != null;
 
-        // Try to get a handle from the logical end of the array
-        if (top < handles.length) {
-            assert handles[top] == null;
-            handles[top] = object;
+        // Try to get a handle from the logical end of the pool
+        if (top < capacity()) {
+            assert get(top) == null;
+            set(top, object);
+            if (top >= highWaterMark) {
+                highWaterMark = top + 1;
+            }
             return indexToJniHandle(top++, tag);
         }
 
         // Now look for a handle in the free set
         int index = freedHandles.nextSetBit(lastFreedIndex);
         if (index == -1 && lastFreedIndex != 0) {
-            // Wrap around and search from the beginning of the array
+            // Wrap around and search from the beginning of the pool
             index = freedHandles.nextSetBit(0);
         }
         if (index != -1) {
-            assert handles[index] == null;
-            handles[index] = object;
+            assert get(index) == null;
+            set(index, object);
             freedHandles.clear(index);
             return indexToJniHandle(index, tag);
         }
 
-        // No space available, the handle array is expanded
-        // to be double its current size.
-        handles = expandHandles(handles, handles.length * 2);
+        // No space available, another chunk is added
+        addChunk();
 
         // Retry - guaranteed to succeed
         return allocateHandle(object, tag);
@@ -252,7 +359,16 @@ public final class JniHandles {
 
     private void pushFrame(int capacity) {
         ensureCapacity(capacity);
-        frames = new Frame(top, frames);
+        if (frames == null) {
+            frames = new int[4];
+        } else if (frameDepth == frames.length) {
+            final int[] newFrames = new int[frameDepth * 2];
+            for (int i = 0; i != frameDepth; ++i) {
+                newFrames[i] = frames[i];
+            }
+            frames = newFrames;
+        }
+        frames[frameDepth++] = top;
     }
 
     private JniHandle popFrame(JniHandle result) {
@@ -260,21 +376,48 @@ public final class JniHandles {
 
         // This test means PopLocalFrame will work even if there was
         // not a corresponding call to PushLocalFrame
-        if (frames != null) {
-            resetTop(frames.start);
-            frames = frames.previous;
+        if (frameDepth != 0) {
+            resetTop(frames[--frameDepth]);
         }
         return (object != null) ? allocateHandle(object, Tag.LOCAL) : result;
     }
 
     /**
-     * Ensures that <i>at least</i> a given number of local references can be created in this pool of handles.
+     * Ensures that <i>at least</i> a given number of local references can be created in this pool of handles
+     * without adding a chunk. Handles that have been freed below {@link #top} are not counted.
      */
     private void ensureCapacity(int capacity) {
-        final int available = (handles.length - top) + freedHandles.cardinality();
-        final int extraNeeded = capacity - available;
-        if (extraNeeded > 0) {
-            handles = expandHandles(handles, handles.length + extraNeeded);
+        final long needed = (long) top + capacity;
+        while (capacity() < needed) {
+            addChunk();
+        }
+    }
+
+    /**
+     * Releases the global handle indexes cached by a terminating thread and prints the statistics
+     * of its local handles if {@code -XX:+PrintJniHandleStatistics} is enabled.
+     */
+    public static void threadTerminated(VmThread thread) {
+        final JniHandles jniHandles = thread.jniHandles();
+        if (jniHandles == null) {
+            return;
+        }
+        globalHandles.flush(jniHandles.globalFreeCache);
+        weakGlobalHandles.flush(jniHandles.weakGlobalFreeCache);
+        if (PrintJniHandleStatistics) {
+            final boolean lockDisabledSafepoints = Log.lock();
+            Log.print("JNI local handles [thread=\"");
+            Log.print(thread.getName());
+            Log.print("\", high water mark=");
+            Log.print(jniHandles.highWaterMark);
+            Log.print(", peak chunks=");
+            Log.print(jniHandles.peakChunks);
+            Log.print(", chunks allocated=");
+            Log.print(jniHandles.chunksAllocated);
+            Log.print(", chunks held=");
+            Log.print(jniHandles.numberOfChunks);
+            Log.println("]");
+            Log.unlock(lockDisabledSafepoints);
         }
     }
 
@@ -339,18 +482,14 @@ public final class JniHandles {
         if (object == null) {
             return JniHandle.zero();
         }
-        synchronized (globalHandles) {
-            return globalHandles.allocateHandle(object, Tag.GLOBAL);
-        }
+        return indexToJniHandle(globalHandles.allocate(object, freeCache(false)), Tag.GLOBAL);
     }
 
     public static JniHandle createWeakGlobalHandle(Object object) {
         if (object == null) {
             return JniHandle.zero();
         }
-        synchronized (weakGlobalHandles) {
-            return weakGlobalHandles.allocateHandle(new WeakReference<Object>(object), Tag.WEAK_GLOBAL);
-        }
+        return indexToJniHandle(weakGlobalHandles.allocate(new WeakReference<Object>(object), freeCache(true)), Tag.WEAK_GLOBAL);
     }
 
     public static void destroyLocalHandle(JniHandle jniHandle) {
@@ -373,19 +512,69 @@ public final class JniHandles {
     public static void destroyGlobalHandle(JniHandle jniHandle) {
         if (!jniHandle.isZero()) {
             assert tag(jniHandle) == Tag.GLOBAL;
-            synchronized (globalHandles) {
-                globalHandles.freeHandle(jniHandleToIndex(jniHandle));
-            }
+            globalHandles.free(jniHandleToIndex(jniHandle), freeCache(false));
         }
     }
 
     public static void destroyWeakGlobalHandle(JniHandle jniHandle) {
         if (!jniHandle.isZero()) {
             assert tag(jniHandle) == Tag.WEAK_GLOBAL;
-            synchronized (weakGlobalHandles) {
-                weakGlobalHandles.freeHandle(jniHandleToIndex(jniHandle));
-            }
+            weakGlobalHandles.free(jniHandleToIndex(jniHandle), freeCache(true));
+        }
+    }
+
+    /**
+     * Gets the current thread's cache of freed global or weak global handle indexes.
+     */
+    private static JniHandleTable.FreeCache freeCache(boolean weak) {
+        if (MaxineVM.isHosted()) {
+            return null;
         }
+        final JniHandles jniHandles = VmThread.current().makeJniHandles();
+        return weak ? jniHandles.weakGlobalFreeCache : jniHandles.globalFreeCache;
+    }
+
+    /**
+     * Gets the number of live global JNI references. A number that keeps growing is a sign that
+     * native code is leaking global references.
+     */
+    public static int liveGlobalHandles() {
+        return globalHandles.live();
+    }
+
+    /**
+     * Gets the greatest number of global JNI references that have been live at the same time.
+     */
+    public static int peakGlobalHandles() {
+        return globalHandles.peak();
+    }
+
+    /**
+     * Gets the total number of global JNI references that have been created.
+     */
+    public static int allocatedGlobalHandles() {
+        return globalHandles.allocated();
+    }
+
+    /**
+     * Gets the number of live weak global JNI references, including those whose referent has been collected.
+     */
+    public static int liveWeakGlobalHandles() {
+        return weakGlobalHandles.live();
+    }
+
+    /**
+     * Gets the greatest number of weak global JNI references that have been live at the same time.
+     */
+    public static int peakWeakGlobalHandles() {
+        return weakGlobalHandles.peak();
+    }
+
+    /**
+     * Gets the total number of weak global JNI references that have been created.
+     */
+    public static int allocatedWeakGlobalHandles() {
+        return weakGlobalHandles.allocated();
     }
 
     public static void ensureLocalHandleCapacity(int capacity) {
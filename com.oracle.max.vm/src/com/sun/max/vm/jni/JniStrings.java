@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.sun.max.vm.jni;
+
+import static com.sun.max.vm.intrinsics.MaxineIntrinsicIDs.*;
+
+import com.sun.max.annotate.*;
+import com.sun.max.memory.*;
+import com.sun.max.unsafe.*;
+import com.sun.max.util.*;
+import com.sun.max.vm.heap.*;
+import com.sun.max.vm.layout.*;
+import com.sun.max.vm.reference.*;
+
+/**
+ * Support for the JNI string functions. The characters of a string are accessed in place in its backing
+ * {@code char[]} and transcoded to and from modified UTF-8 by native kernels (see {@code utf8.c}),
+ * which are vectorized for runs of ASCII characters.
+ * <p>
+ * The address of a string's characters is only valid while its backing array cannot move. The methods
+ * that compute and use such an address therefore have no safepoints, and neither have the native functions
+ * they call.
+ */
+final class JniStrings {
+
+    private JniStrings() {
+    }
+
+    static class StringAlias {
+        @ALIAS(declaringClass = String.class)
+        char[] value;
+        @ALIAS(declaringClass = String.class, optional = true)
+        int offset;
+    }
+
+    @INTRINSIC(UNSAFE_CAST)
+    private static native StringAlias asStringAlias(String s);
+
+    /**
+     * Starting with JDK 7 update 6, the String class no longer has the offset and count fields.
+     */
+    @FOLD
+    private static boolean stringHasOffset() {
+        try {
+            String.class.getDeclaredField("offset");
+        } catch (NoSuchFieldException e) {
+            return false;
+        }
+        return true;
+    }
+
+    private static final int CHAR_ARRAY_BASE_OFFSET = Layout.charArrayLayout().getElementOffsetFromOrigin(0).toInt();
+
+    private static final int CHAR_SIZE = 2;
+
+    /**
+     * Gets the array backing a string's characters.
+     */
+    @INLINE
+    private static char[] value(String string) {
+        return asStringAlias(string).value;
+    }
+
+    /**
+     * Gets the address of the {@code index}th character of a string.
+     */
+    @INLINE
+    private static Pointer chars(String string, int index) {
+        final StringAlias s = asStringAlias(string);
+        final int offset = stringHasOffset() ? s.offset : 0;
+        return Reference.fromJava(s.value).toOrigin().plus(CHAR_ARRAY_BASE_OFFSET + (offset + index) * CHAR_SIZE);
+    }
+
+    /**
+     * Copies the characters of a string to a malloc'ed buffer.
+     */
+    static Pointer copyChars(String string) throws OutOfMemoryError {
+        final Pointer buffer = Memory.mustAllocate(string.length() * CHAR_SIZE, Memory.Tag.JNI, false);
+        copyChars(string, 0, string.length(), buffer);
+        return buffer;
+    }
+
+    /**
+     * Copies {@code length} characters of a string, starting at {@code start}, to a given buffer.
+     */
+    @NO_SAFEPOINT_POLLS("the string's characters must not move during the copy")
+    static void copyChars(String string, int start, int length, Pointer buffer) {
+        Memory.bulkCopyBytes(chars(string, start), buffer, Size.fromInt(length * CHAR_SIZE));
+    }
+
+    /**
+     * Gets a pointer to the characters of a string for GetStringCritical, accessing them in place if
+     * the heap allows it as for {@link Heap#useDirectPointer GetPrimitiveArrayCritical}.
+     */
+    static Pointer getCriticalChars(String string, Pointer isCopy) throws OutOfMemoryError {
+        if (Heap.useDirectPointer(value(string))) {
+            if (!isCopy.isZero()) {
+                isCopy.setBoolean(false);
+            }
+            return chars(string, 0);
+        }
+        if (!isCopy.isZero()) {
+            isCopy.setBoolean(true);
+        }
+        return copyChars(string);
+    }
+
+    static void releaseCriticalChars(String string, Pointer chars) {
+        if (!Heap.releasedDirectPointer(value(string))) {
+            Memory.deallocate(chars);
+        }
+    }
+
+    /**
+     * Gets the length in bytes of the modified UTF-8 encoding of a string.
+     */
+    @NO_SAFEPOINT_POLLS("the string's characters must not move during the scan")
+    static int utf8Length(String string) {
+        return utf8_lengthOfUtf16(chars(string, 0), string.length());
+    }
+
+    /**
+     * Creates a zero terminated, malloc'ed modified UTF-8 encoding of a string.
+     */
+    static Pointer toUtf8(String string) throws OutOfMemoryError {
+        final int length = utf8Length(string);
+        final Pointer utf = Memory.mustAllocate(length + 1, Memory.Tag.JNI, false);
+        toUtf8(string, 0, string.length(), utf);
+        utf.setByte(length, (byte) 0);
+        return utf;
+    }
+
+    /**
+     * Encodes {@code length} characters of a string, starting at {@code start}, in modified UTF-8.
+     * The result is not zero terminated.
+     *
+     * @return the number of bytes written to {@code utf}
+     */
+    @NO_SAFEPOINT_POLLS("the string's characters must not move during the encoding")
+    static int toUtf8(String string, int start, int length, Pointer utf) {
+        return utf8_fromUtf16(chars(string, start), length, utf);
+    }
+
+    /**
+     * Creates a string from a zero terminated modified UTF-8 encoding.
+     */
+    static String fromUtf8(Pointer utf) throws Utf8Exception {
+        final int n = CString.length(utf).toInt();
+        final int length = utf8_utf16Length(utf, n);
+        if (length < 0) {
+            throw new Utf8Exception();
+        }
+        final char[] chars = new char[length];
+        fromUtf8(utf, n, chars);
+        return new String(chars);
+    }
+
+    @NO_SAFEPOINT_POLLS("the array must not move during the decoding")
+    private static void fromUtf8(Pointer utf, int n, char[] chars) {
+        utf8_toUtf16(utf, n, Reference.fromJava(chars).toOrigin().plus(CHAR_ARRAY_BASE_OFFSET));
+    }
+
+    @C_FUNCTION
+    private static native int utf8_lengthOfUtf16(Pointer chars, int length);
+
+    @C_FUNCTION
+    private static native int utf8_fromUtf16(Pointer chars, int length, Pointer utf);
+
+    @C_FUNCTION
+    private static native int utf8_utf16Length(Pointer utf, int length);
+
+    @C_FUNCTION
+    private static native void utf8_toUtf16(Pointer utf, int length, Pointer chars);
+}
@@ -44,6 +44,7 @@ import com.sun.max.vm.jni.JniFunctionsGenerator.Customizer;
 import com.sun.max.vm.jni.JniFunctionsGenerator.JniCustomizer;
 import com.sun.max.vm.runtime.*;
 import com.sun.max.vm.ti.*;
+import com.sun.max.vm.type.*;
 
 /**
  * This class encapsulates the Java side of the native interfaces such as JNI, JVMTI and JMM supported by the VM.
@@ -57,6 +58,50 @@ public final class NativeInterfaces {
         return VMTI.handler().nativeCallNeedsPrologueAndEpilogue(ma) && ma != Snippets.blockOnThreadLockMethod();
     }
 
+    /**
+     * Enables binding of static native methods to critical implementations.
+     */
+    public static boolean CriticalJNINatives = true;
+
+    static {
+        VMOptions.addFieldOption("-XX:", "CriticalJNINatives", NativeInterfaces.class,
+            "Bind eligible static native methods to JavaCritical_ implementations when present.", MaxineVM.Phase.PRISTINE);
+    }
+
+    /**
+     * Determines if the stub for a given native method should use the critical calling convention. This is the case
+     * if the method is a static, unsynchronized method whose parameters are primitives or primitive arrays, whose
+     * return type is not a reference and for which a {@linkplain NativeFunction#linkCritical() critical
+     * implementation} can be found. A critical implementation is passed neither the JNIEnv nor the class and
+     * receives each primitive array as its length followed by a pointer to its elements (or 0 and {@code NULL} for a
+     * null array). The thread stays in the 'in Java' state for the duration of the call so that the arrays cannot
+     * move. As such, a critical implementation must not block, call back into the VM or run for long.
+     */
+    public static boolean isCriticalNative(ClassMethodActor classMethodActor) {
+        if (!CriticalJNINatives || MaxineVM.isHosted() || classMethodActor.isCFunction() || !classMethodActor.isStatic() || classMethodActor.isSynchronized()) {
+            return false;
+        }
+        final SignatureDescriptor sig = classMethodActor.descriptor();
+        if (sig.resultKind().isReference) {
+            return false;
+        }
+        for (int i = 0; i < sig.numberOfParameters(); i++) {
+            final TypeDescriptor parameterDescriptor = sig.parameterDescriptorAt(i);
+            if (parameterDescriptor.toKind().isReference && !isPrimitiveArray(parameterDescriptor)) {
+                return false;
+            }
+        }
+        return classMethodActor.nativeFunction.linkCritical();
+    }
+
+    /**
+     * Determines if a given type is a one dimensional array of a primitive type.
+     */
+    public static boolean isPrimitiveArray(TypeDescriptor descriptor) {
+        final TypeDescriptor componentType = descriptor.componentTypeDescriptor();
+        return componentType != null && JavaTypeDescriptor.isPrimitive(componentType);
+    }
+
     private NativeInterfaces() {
     }
 
@@ -63,6 +63,11 @@ import com.sun.max.vm.jni.JniFunctions.JxxFunctionsLogger;
  *   <li>Return the result to the caller.</li>
  * </ol>
  * <p>
+ * A static native method that is bound to a {@linkplain NativeInterfaces#isCriticalNative critical} implementation
+ * gets a stub that omits the JNI environment, class, handle and exception steps above and performs the same minimal
+ * transition as a {@code C_FUNCTION} stub. Each primitive array parameter is passed as its length followed by
+ * a pointer to its elements. Such a stub links the native function and executes the prologue before it takes
+ * the addresses of the array elements, so that no safepoint can intervene between taking them and the call.
  */
 public final class NativeStubGenerator extends BytecodeAssembler {
 
@@ -70,7 +75,8 @@ public final class NativeStubGenerator extends BytecodeAssembler {
         super(constantPoolEditor);
         this.classMethodActor = classMethodActor;
         allocateParameters(classMethodActor.isStatic(), classMethodActor.descriptor());
-        generateCode(classMethodActor.isCFunction(), classMethodActor.isStatic(), classMethodActor.holder(), classMethodActor.descriptor());
+        final boolean isCritical = NativeInterfaces.isCriticalNative(classMethodActor);
+        generateCode(classMethodActor.isCFunction() || isCritical, isCritical, classMethodActor.isStatic(), classMethodActor.holder(), classMethodActor.descriptor());
     }
 
     private final SeekableByteArrayOutputStream codeStream = new SeekableByteArrayOutputStream();
@@ -127,6 +133,9 @@ public final class NativeStubGenerator extends BytecodeAssembler {
     private static final ClassMethodRefConstant nativeCallEpilogue = createClassMethodConstant(Snippets.class, makeSymbol("nativeCallEpilogue"));
     private static final ClassMethodRefConstant nativeCallEpilogueForC = createClassMethodConstant(Snippets.class, makeSymbol("nativeCallEpilogueForC"));
 
+    private static final ClassMethodRefConstant criticalArrayLength = createClassMethodConstant(Snippets.class, makeSymbol("criticalArrayLength"), Object.class);
+    private static final ClassMethodRefConstant criticalArrayElements = createClassMethodConstant(Snippets.class, makeSymbol("criticalArrayElements"), Object.class);
+
     private static final ClassMethodRefConstant writeObject = createClassMethodConstant(Pointer.class, makeSymbol("writeObject"), int.class, Object.class);
 
     private int methodIDAsInt;
@@ -185,7 +194,13 @@ public final class NativeStubGenerator extends BytecodeAssembler {
     }
 
 
-    private void generateCode(boolean isCFunction, boolean isStatic, ClassActor holder, SignatureDescriptor sig) {
+    /**
+     * Generates the stub code.
+     *
+     * @param isCFunction specifies if the native function is called without the JNI environment, class and handles
+     * @param isCritical specifies if primitive array parameters are to be passed as a length and element pointer pair
+     */
+    private void generateCode(boolean isCFunction, boolean isCritical, boolean isStatic, ClassActor holder, SignatureDescriptor sig) {
         final TypeDescriptor resultDescriptor = sig.resultDescriptor();
         final Kind resultKind = resultDescriptor.toKind();
         final StringBuilder nativeFunctionDescriptor = new StringBuilder("(");
@@ -235,7 +250,23 @@ public final class NativeStubGenerator extends BytecodeAssembler {
             assert isStatic;
         }
 
+        ObjectConstant nf = createObjectConstant(classMethodActor.nativeFunction);
+        int nativeFunctionAddress = -1;
+        if (isCritical) {
+            // Linking and the prologue may reach a safepoint at which the arrays could move,
+            // so both are done before the addresses of the array elements are taken.
+            ldc(nf);
+            invokevirtual(link, 1, 1);
+            nativeFunctionAddress = allocateLocal(Kind.WORD);
+            astore(nativeFunctionAddress);
+            if (NativeInterfaces.needsPrologueAndEpilogue(classMethodActor)) {
+                ldc(nf);
+                invokestatic(nativeCallPrologueForC, 1, 0);
+            }
+        }
+
         // Push the remaining parameters, wrapping reference parameters in JNI handles
+        // or splitting them into a length and element pointer for a critical native
         int parameterLocalIndex = isStatic ? 0 : 1;
         for (int i = 0; i < sig.numberOfParameters(); i++) {
             final TypeDescriptor parameterDescriptor = sig.parameterDescriptorAt(i);
@@ -268,6 +299,17 @@ public final class NativeStubGenerator extends BytecodeAssembler {
                     break;
                 }
                 case REFERENCE: {
+                    if (isCritical) {
+                        aload(parameterLocalIndex);
+                        invokestatic(criticalArrayLength, 1, 1);
+                        nativeFunctionDescriptor.append(JavaTypeDescriptor.INT);
+                        nativeFunctionArgSlots += Kind.INT.stackSlots;
+
+                        aload(parameterLocalIndex);
+                        invokestatic(criticalArrayElements, 1, 1);
+                        nativeParameterDescriptor = JavaTypeDescriptor.WORD;
+                        break;
+                    }
                     assert !isCFunction;
 
                     aload(handles);
@@ -289,14 +331,17 @@ public final class NativeStubGenerator extends BytecodeAssembler {
             ++parameterLocalIndex;
         }
 
-        // Link native function
-        ObjectConstant nf = createObjectConstant(classMethodActor.nativeFunction);
-        ldc(nf);
-        invokevirtual(link, 1, 1);
-
-        if (NativeInterfaces.needsPrologueAndEpilogue(classMethodActor)) {
+        if (isCritical) {
+            aload(nativeFunctionAddress);
+        } else {
+            // Link native function
             ldc(nf);
-            invokestatic(!isCFunction ? nativeCallPrologue : nativeCallPrologueForC, 1, 0);
+            invokevirtual(link, 1, 1);
+
+            if (NativeInterfaces.needsPrologueAndEpilogue(classMethodActor)) {
+                ldc(nf);
+                invokestatic(!isCFunction ? nativeCallPrologue : nativeCallPrologueForC, 1, 0);
+            }
         }
 
         // Invoke the native function
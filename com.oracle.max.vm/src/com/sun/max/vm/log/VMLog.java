@@ -205,6 +205,13 @@ public abstract class VMLog implements Heap.GCCallback {
             setHeader(FREE);
         }
 
+        /**
+         * Called by {@link VMLogger} once the header and arguments have been set.
+         * Logs that must not expose a partially written record defer storing the header until this is called.
+         */
+        public void commit() {
+        }
+
         public int getThreadId() {
             return getThreadId(getHeader());
         }
@@ -345,7 +352,7 @@ public abstract class VMLog implements Heap.GCCallback {
 
     /**
      * Phase specific initialization.
-     * Only called for BOOTSTRAPPING, PRIMORDIAL, TERMINATING.
+     * Only called for BOOTSTRAPPING, PRIMORDIAL, STARTING (once the VM options have been parsed), TERMINATING.
      * @param phase the phase
      */
     public void initialize(MaxineVM.Phase phase) {
@@ -419,6 +426,13 @@ public abstract class VMLog implements Heap.GCCallback {
         return loggers[id - 1];
     }
 
+    /**
+     * Gets the registered loggers, indexed by {@link VMLogger#loggerId} {@code - 1}.
+     */
+    protected final VMLogger[] loggers() {
+        return loggers;
+    }
+
     /**
      * Called when a new thread is started so any thread-specific log state can be setup.
      */
@@ -459,6 +473,7 @@ public abstract class VMLog implements Heap.GCCallback {
                 vmLog.loggers[i].checkOptions();
             }
         }
+        vmLog.initialize(MaxineVM.Phase.STARTING);
     }
 
     /**
@@ -515,6 +530,23 @@ public abstract class VMLog implements Heap.GCCallback {
      */
     protected abstract boolean isPerThread();
 
+    /**
+     * Are the records of a per-thread log ordered by timestamp rather than by a unique id?
+     * If so, {@link #flush(int)} flushes all the per-thread logs as one, using {@link #flushMerged()}.
+     * @return {@code true} iff the records are ordered by timestamp.
+     */
+    protected boolean isTimeOrdered() {
+        return false;
+    }
+
+    /**
+     * Flush the records of all the per-thread logs, merged into timestamp order, using the {@link #flusher},
+     * which is guaranteed not {@code null}. Called with {@link VmThreadMap#THREAD_LOCK} held.
+     * Only called if {@link #isTimeOrdered()}.
+     */
+    protected void flushMerged() {
+    }
+
     /**
      * Flush the records of the log using the {@link #flusher}, which is guaranteed not {@code null}.
      * In the case of per-thread logs, this flushes the log for the given thread.
@@ -659,7 +691,16 @@ public abstract class VMLog implements Heap.GCCallback {
         if (flusher == null || (mode & flushMode) == 0) {
             return;
         }
-        if (isPerThread()) {
+        if (isTimeOrdered()) {
+            synchronized (VmThreadMap.THREAD_LOCK) {
+                try {
+                    flusher.start(null);
+                    flushMerged();
+                } finally {
+                    flusher.end(null);
+                }
+            }
+        } else if (isPerThread()) {
             Pointer.Procedure proc = new Pointer.Procedure() {
                 public void run(Pointer tla) {
                     VmThread vmThread = VmThread.fromTLA(tla);
@@ -737,6 +778,14 @@ public abstract class VMLog implements Heap.GCCallback {
          */
         public abstract void flushRecord(VmThread vmThread, Record r, int uuid);
 
+        /**
+         * Called by a flush that {@linkplain VMLog#flushMerged() merges} the per-thread logs, after {@link #start}
+         * and before any record is flushed, once for each thread whose log contributes records.
+         * @param vmThread thread owning one of the merged logs
+         */
+        public void mergedThread(VmThread vmThread) {
+        }
+
         /**
          * Called after all flushes.
          * Allows any tear down to be done by flusher.
@@ -768,10 +817,18 @@ public abstract class VMLog implements Heap.GCCallback {
                 Log.println(vmLog.getClass().getSimpleName());
             }
             if (vmThread != null) {
-                Log.print("VMLog contents for thread: "); Log.printThread(vmThread, true);
+                mergedThread(vmThread);
             }
         }
 
+        /**
+         * Emits a {@link #THREAD_MARKER} so that offline views can map the thread ids in the records to names.
+         */
+        @Override
+        public void mergedThread(VmThread vmThread) {
+            Log.print(THREAD_MARKER); Log.printThread(vmThread, true);
+        }
+
         @Override
         public void flushRecord(VmThread vmThread, Record r, int uuid) {
             Log.print(r.getHeader()); Log.print(' ');
@@ -208,6 +208,20 @@ public class VMLogger {
         return "Op " + Integer.toString(op);
     }
 
+    /**
+     * Gets the number of distinct operations of this logger.
+     */
+    public int numOps() {
+        return numOps;
+    }
+
+    /**
+     * Gets the bitmap of reference valued arguments of operation {@code op}, bit {@code n} denoting argument {@code n + 1}.
+     */
+    public int operationRefMap(int op) {
+        return operationRefMaps == null ? 0 : operationRefMaps[op];
+    }
+
     /**
      * Provides a custom string decoding of an argument value. Intended for simple Inspector use only.
      * @param op the operation id
@@ -428,6 +442,9 @@ public class VMLogger {
 
     public void log(int op) {
         Record r = logSetup(op, 0);
+        if (r != null) {
+            r.commit();
+        }
         if (r != null && traceEnabled) {
             doTrace(r);
         }
@@ -437,6 +454,7 @@ public class VMLogger {
         Record r = logSetup(op, 1);
         if (r != null) {
             r.setArgs(arg1);
+            r.commit();
         }
         if (r != null && traceEnabled) {
             doTrace(r);
@@ -447,6 +465,7 @@ public class VMLogger {
         Record r = logSetup(op, 2);
         if (r != null) {
             r.setArgs(arg1, arg2);
+            r.commit();
         }
         if (r != null && traceEnabled) {
             doTrace(r);
@@ -457,6 +476,7 @@ public class VMLogger {
         Record r = logSetup(op, 3);
         if (r != null) {
             r.setArgs(arg1, arg2, arg3);
+            r.commit();
         }
         if (r != null && traceEnabled) {
             doTrace(r);
@@ -467,6 +487,7 @@ public class VMLogger {
         Record r = logSetup(op, 4);
         if (r != null) {
             r.setArgs(arg1, arg2, arg3, arg4);
+            r.commit();
         }
         if (r != null && traceEnabled) {
             doTrace(r);
@@ -477,6 +498,7 @@ public class VMLogger {
         Record r = logSetup(op, 5);
         if (r != null) {
             r.setArgs(arg1, arg2, arg3, arg4, arg5);
+            r.commit();
         }
         if (r != null && traceEnabled) {
             doTrace(r);
@@ -487,6 +509,7 @@ public class VMLogger {
         Record r = logSetup(op, 6);
         if (r != null) {
             r.setArgs(arg1, arg2, arg3, arg4, arg5, arg6);
+            r.commit();
         }
         if (r != null && traceEnabled) {
             doTrace(r);
@@ -497,6 +520,7 @@ public class VMLogger {
         Record r = logSetup(op, 7);
         if (r != null) {
             r.setArgs(arg1, arg2, arg3, arg4, arg5, arg6, arg7);
+            r.commit();
         }
         if (r != null && traceEnabled) {
             doTrace(r);
@@ -507,6 +531,7 @@ public class VMLogger {
         Record r = logSetup(op, 8);
         if (r != null) {
             r.setArgs(arg1, arg2, arg3, arg4, arg5, arg6, arg7, arg8);
+            r.commit();
         }
         if (r != null && traceEnabled) {
             doTrace(r);
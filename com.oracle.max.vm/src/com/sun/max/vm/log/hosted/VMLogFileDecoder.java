@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.sun.max.vm.log.hosted;
+
+import static com.sun.max.vm.log.nat.mapped.VMLogNativeMapped.*;
+
+import java.io.*;
+import java.nio.*;
+import java.nio.channels.FileChannel.MapMode;
+import java.util.*;
+
+import com.sun.max.annotate.*;
+import com.sun.max.vm.log.*;
+import com.sun.max.vm.log.VMLog.Record;
+import com.sun.max.vm.log.nat.mapped.*;
+
+/**
+ * Decodes a file written by {@link VMLogNativeMapped} without access to the VM or its boot image,
+ * using the logger and operation metadata recorded in the file. The records are printed in id order,
+ * one per line, either decoded as {@code id [thread] Logger.Operation(args)}, with reference valued
+ * arguments prefixed by {@code @}, or, with {@code -raw}, in the format of {@link VMLog.RawDumpFlusher},
+ * which the Inspector reads with {@code -vmlog=file}.
+ * <p>
+ * Usage: {@code VMLogFileDecoder [-raw] file}
+ */
+@HOSTED_ONLY
+public class VMLogFileDecoder {
+
+    private static class LoggerInfo {
+        final String name;
+        final int[] refMaps;
+        final String[] operationNames;
+
+        LoggerInfo(String name, int numOps) {
+            this.name = name;
+            this.refMaps = new int[numOps];
+            this.operationNames = new String[numOps];
+        }
+    }
+
+    private final ByteBuffer buffer;
+    private final int wordSize;
+    private final int recordSize;
+    private final int logEntries;
+    private final int dataOffset;
+    private final Map<Integer, LoggerInfo> loggers = new HashMap<Integer, LoggerInfo>();
+
+    public VMLogFileDecoder(File file) throws IOException {
+        final RandomAccessFile raf = new RandomAccessFile(file, "r");
+        try {
+            buffer = raf.getChannel().map(MapMode.READ_ONLY, 0, raf.length());
+        } finally {
+            raf.close();
+        }
+        if (buffer.capacity() < FILE_HEADER_SIZE) {
+            throw new IOException(file + " is too short to be a VMLog file");
+        }
+        buffer.order(ByteOrder.LITTLE_ENDIAN);
+        if (buffer.getInt(MAGIC_OFFSET) != MAGIC) {
+            buffer.order(ByteOrder.BIG_ENDIAN);
+            if (buffer.getInt(MAGIC_OFFSET) != MAGIC) {
+                throw new IOException(file + " is not a VMLog file, or the VM died before it was initialized");
+            }
+        }
+        if (buffer.getInt(VERSION_OFFSET) != VERSION) {
+            throw new IOException(file + " has unsupported version " + buffer.getInt(VERSION_OFFSET));
+        }
+        wordSize = buffer.getInt(WORD_SIZE_OFFSET);
+        recordSize = buffer.getInt(RECORD_SIZE_OFFSET);
+        logEntries = buffer.getInt(LOG_ENTRIES_OFFSET);
+        dataOffset = buffer.getInt(DATA_OFFSET_OFFSET);
+        if ((long) dataOffset + (long) logEntries * recordSize > buffer.capacity()) {
+            throw new IOException(file + " is truncated");
+        }
+        readMetadata(buffer.getInt(METADATA_OFFSET_OFFSET));
+    }
+
+    private void readMetadata(int offset) {
+        buffer.position(offset);
+        int count = buffer.getInt();
+        for (int i = 0; i < count; i++) {
+            final int loggerId = buffer.getInt();
+            final String name = readString();
+            final LoggerInfo logger = new LoggerInfo(name, buffer.getInt());
+            for (int op = 0; op < logger.operationNames.length; op++) {
+                logger.refMaps[op] = buffer.getInt();
+                logger.operationNames[op] = readString();
+            }
+            loggers.put(loggerId, logger);
+        }
+    }
+
+    private String readString() {
+        final byte[] bytes = new byte[buffer.getInt()];
+        buffer.get(bytes);
+        buffer.position((buffer.position() + 3) & ~3);
+        try {
+            return new String(bytes, "UTF-8");
+        } catch (UnsupportedEncodingException ex) {
+            throw new InternalError();
+        }
+    }
+
+    /**
+     * Gets the offsets of the complete records in the file, sorted by id.
+     * Slots that were never written, or whose record was being written when the VM died, are omitted.
+     */
+    public Integer[] recordOffsets() {
+        final ArrayList<Integer> offsets = new ArrayList<Integer>(logEntries);
+        for (int i = 0; i < logEntries; i++) {
+            final int offset = dataOffset + i * recordSize;
+            if (isWellFormed(buffer.getInt(offset))) {
+                offsets.add(offset);
+            }
+        }
+        final Integer[] result = offsets.toArray(new Integer[offsets.size()]);
+        Arrays.sort(result, new Comparator<Integer>() {
+            public int compare(Integer o1, Integer o2) {
+                final int id1 = id(o1);
+                final int id2 = id(o2);
+                return id1 < id2 ? -1 : (id1 == id2 ? 0 : 1);
+            }
+        });
+        return result;
+    }
+
+    /**
+     * Determines if {@code header} belongs to a complete record. The header of a record is cleared when its slot
+     * is acquired and only stored again once the arguments have been written, so a zero header denotes a slot that
+     * was never written or a record that was torn by the death of the VM.
+     */
+    private boolean isWellFormed(int header) {
+        if (header == 0 || Record.isFree(header) || Record.getArgCount(header) > Record.MAX_ARGS) {
+            return false;
+        }
+        final LoggerInfo logger = loggers.get(Record.getLoggerId(header));
+        return logger != null && Record.getOperation(header) < logger.operationNames.length;
+    }
+
+    private int id(int offset) {
+        return buffer.getInt(offset + ID_OFFSET);
+    }
+
+    private long arg(int offset, int n) {
+        final int argOffset = offset + ARGS_OFFSET + (n - 1) * wordSize;
+        return wordSize == 8 ? buffer.getLong(argOffset) : buffer.getInt(argOffset) & 0xFFFFFFFFL;
+    }
+
+    public void printDecoded(int offset, PrintStream out) {
+        final int header = buffer.getInt(offset);
+        final LoggerInfo logger = loggers.get(Record.getLoggerId(header));
+        final int op = Record.getOperation(header);
+        final int refMap = logger.refMaps[op];
+        out.print(id(offset));
+        out.print(" [");
+        out.print(Record.getThreadId(header));
+        out.print("] ");
+        out.print(logger.name);
+        out.print('.');
+        out.print(logger.operationNames[op]);
+        out.print('(');
+        final int argCount = Record.getArgCount(header);
+        for (int n = 1; n <= argCount; n++) {
+            if (n > 1) {
+                out.print(", ");
+            }
+            if ((refMap & (1 << (n - 1))) != 0) {
+                out.print('@');
+            }
+            out.print("0x");
+            out.print(Long.toHexString(arg(offset, n)));
+        }
+        out.println(')');
+    }
+
+    public void printRaw(int offset, PrintStream out) {
+        final int header = buffer.getInt(offset);
+        final int argCount = Record.getArgCount(header);
+        out.print(header); out.print(' ');
+        out.print(id(offset)); out.print(' ');
+        out.print(argCount);
+        for (int n = 1; n <= argCount; n++) {
+            out.print(" 0x");
+            out.print(Long.toHexString(arg(offset, n)));
+        }
+        out.println();
+    }
+
+    public static void main(String[] args) throws IOException {
+        boolean raw = false;
+        String fileName = null;
+        for (String arg : args) {
+            if (arg.equals("-raw")) {
+                raw = true;
+            } else {
+                fileName = arg;
+            }
+        }
+        if (fileName == null) {
+            System.err.println("usage: VMLogFileDecoder [-raw] file");
+            System.exit(1);
+        }
+        final VMLogFileDecoder decoder = new VMLogFileDecoder(new File(fileName));
+        final PrintStream out = new PrintStream(new BufferedOutputStream(System.out));
+        if (raw) {
+            out.print(VMLog.RawDumpFlusher.LOGCLASS_MARKER);
+            out.println(VMLogNativeMapped.class.getSimpleName());
+        }
+        for (int offset : decoder.recordOffsets()) {
+            if (raw) {
+                decoder.printRaw(offset, out);
+            } else {
+                decoder.printDecoded(offset, out);
+            }
+        }
+        out.flush();
+    }
+}
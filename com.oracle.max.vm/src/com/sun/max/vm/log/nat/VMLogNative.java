@@ -168,7 +168,7 @@ public abstract class VMLogNative extends VMLog {
      */
     @CONSTANT_WHEN_NOT_ZERO
     @INSPECTED
-    private int nativeRecordArgsOffset;
+    protected int nativeRecordArgsOffset;
 
     /**
      * Since we must log before it is even possible to call any native functions,
@@ -207,7 +207,7 @@ public abstract class VMLogNative extends VMLog {
         if (phase == MaxineVM.Phase.BOOTSTRAPPING) {
             byteDataOffset = VMConfiguration.vmConfig().layoutScheme().byteArrayLayout.getElementOffsetFromOrigin(0);
             nativeRecordArgsOffset = getArgsOffset();
-            primordialNativeRecord = new NativeRecord(nativeRecordArgsOffset);
+            primordialNativeRecord = newNativeRecord();
             defaultNativeRecordSize = primordialNativeRecord.defaultSize();
             logSize = getLogSize();
             primordialLogBufferArray = new byte[logSize];
@@ -227,7 +227,7 @@ public abstract class VMLogNative extends VMLog {
             if (PinNativeRecord) {
                 Heap.enableImmortalMemoryAllocation();
             }
-            nativeRecordRef = Reference.fromJava(new NativeRecord(getArgsOffset()));
+            nativeRecordRef = Reference.fromJava(newNativeRecord());
         } finally {
             if (PinNativeRecord) {
                 Heap.disableImmortalMemoryAllocation();
@@ -248,6 +248,13 @@ public abstract class VMLogNative extends VMLog {
         return record;
     }
 
+    /**
+     * Creates the per-thread {@link NativeRecord} used to access the records in the log buffer.
+     */
+    protected NativeRecord newNativeRecord() {
+        return new NativeRecord(getArgsOffset());
+    }
+
     /**
      * The offset (in bytes) to the start of the arguments in the native record.
      */
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ */
+package com.sun.max.vm.log.nat.mapped;
+
+import com.oracle.max.cri.intrinsics.*;
+import com.sun.max.annotate.*;
+import com.sun.max.lang.*;
+import com.sun.max.memory.*;
+import com.sun.max.platform.*;
+import com.sun.max.unsafe.*;
+import com.sun.max.util.*;
+import com.sun.max.vm.*;
+import com.sun.max.vm.heap.*;
+import com.sun.max.vm.log.*;
+import com.sun.max.vm.log.nat.*;
+import com.sun.max.vm.thread.*;
+
+/**
+ * A global log of fixed size records, stored in a shared mapping of a file named by the {@code -XX:VMLogFile} option.
+ * Since the records are written straight into the page cache, the last {@link #logEntries} records survive
+ * the VM process however it terminates (including {@code kill -9}) and can be decoded offline by
+ * {@link com.sun.max.vm.log.hosted.VMLogFileDecoder}. Until the file is mapped in the {@code STARTING} phase,
+ * or if the option is not given, records are kept in the primordial buffer; these are copied into the file
+ * when it is mapped.
+ * <p>
+ * Acquiring a record costs one compare and swap on {@link #nextId}. The record slot is selected by masking
+ * the id, the number of entries being rounded up to a power of two. The id is stored in the record so
+ * that the decoder can recover the global order. The header is cleared before the id is written and is only
+ * stored again by {@link MappedRecord#commit()}, after the arguments, so that a record that was being written
+ * when the VM died is recognized (by its zero header) and skipped.
+ * <p>
+ * The file starts with a header of {@link #FILE_HEADER_SIZE} bytes, written in native byte order, followed
+ * by the metadata needed to decode the records without the boot image and then, at {@link #DATA_OFFSET_OFFSET},
+ * the records themselves. The metadata comprises the number of loggers and, for each logger, its id, name,
+ * number of operations and, for each operation, the reference map of its arguments and its name.
+ * Strings are stored as a length followed by their UTF-8 bytes, padded to a multiple of four bytes.
+ * The {@link #MAGIC} value is written last, so a file without it was not completely initialized.
+ */
+public class VMLogNativeMapped extends VMLogNative {
+    public static final String VMLOG_MAPPED_RECORD_NAME = "VMLOG_MAPPED_RECORD";
+    public static final String VMLOG_MAPPED_THREADSTATE_NAME = "VMLOG_MAPPED_THREADSTATE";
+    public static final VmThreadLocal VMLOG_MAPPED_RECORD = new VmThreadLocal(VMLOG_MAPPED_RECORD_NAME, true, "VMLog.Record");
+    public static final VmThreadLocal VMLOG_MAPPED_THREADSTATE = new VmThreadLocal(VMLOG_MAPPED_THREADSTATE_NAME, false, "VMLog state");
+
+    public static final int MAGIC = 0x4c56584d; // "MXVL" when read in little endian order
+    public static final int VERSION = 1;
+
+    public static final int MAGIC_OFFSET = 0;
+    public static final int VERSION_OFFSET = 4;
+    public static final int WORD_SIZE_OFFSET = 8;
+    public static final int RECORD_SIZE_OFFSET = 12;
+    public static final int LOG_ENTRIES_OFFSET = 16;
+    public static final int METADATA_OFFSET_OFFSET = 20;
+    public static final int DATA_OFFSET_OFFSET = 24;
+    public static final int FILE_HEADER_SIZE = 32;
+
+    public static final int ID_OFFSET = Ints.SIZE;
+    public static final int ARGS_OFFSET = 2 * Ints.SIZE;
+
+    private static final VMStringOption vmLogFileOption = VMOptions.register(new VMStringOption("-XX:VMLogFile=", false, null,
+        "write the VMLog to the given file as a memory-mapped ring that survives a VM crash"), MaxineVM.Phase.STARTING);
+
+    /**
+     * Used to walk the records in {@link #scanLog} and {@link #flushRecords}, neither of which may allocate.
+     */
+    private static final class WalkRecord extends NativeRecord {
+        WalkRecord() {
+            super(ARGS_OFFSET);
+        }
+    }
+
+    /**
+     * The per-thread record, which holds back the header until the arguments have been written.
+     */
+    private static final class MappedRecord extends NativeRecord {
+        private int pendingHeader;
+
+        MappedRecord() {
+            super(ARGS_OFFSET);
+        }
+
+        @Override
+        public void setHeader(int header) {
+            pendingHeader = header;
+        }
+
+        @Override
+        public void commit() {
+            MemoryBarriers.barrier(MemoryBarriers.STORE_STORE);
+            address.setInt(pendingHeader);
+        }
+    }
+
+    @CONSTANT_WHEN_NOT_ZERO
+    private int entryMask;
+
+    @CONSTANT_WHEN_NOT_ZERO
+    private WalkRecord scanRecord;
+
+    @CONSTANT_WHEN_NOT_ZERO
+    private WalkRecord flushRecord;
+
+    private int idAtLastFlush;
+
+    @Override
+    public void initialize(MaxineVM.Phase phase) {
+        super.initialize(phase);
+        if (MaxineVM.isHosted() && phase == MaxineVM.Phase.BOOTSTRAPPING) {
+            setNativeRecordThreadLocal(VMLOG_MAPPED_RECORD);
+            entryMask = logEntries - 1;
+            scanRecord = new WalkRecord();
+            flushRecord = new WalkRecord();
+        } else if (phase == MaxineVM.Phase.STARTING) {
+            String path = vmLogFileOption.getValue();
+            if (path != null) {
+                mapFile(path);
+            }
+        }
+    }
+
+    @Override
+    protected void setLogEntries() {
+        super.setLogEntries();
+        final int entries = Integer.highestOneBit(logEntries);
+        logEntries = entries < logEntries ? entries << 1 : entries;
+    }
+
+    @Override
+    protected NativeRecord newNativeRecord() {
+        return new MappedRecord();
+    }
+
+    @Override
+    protected final int getArgsOffset() {
+        return ARGS_OFFSET;
+    }
+
+    @Override
+    protected final int getLogSize() {
+        return logEntries * defaultNativeRecordSize;
+    }
+
+    @Override
+    protected boolean isPerThread() {
+        return false;
+    }
+
+    @Override
+    @NO_SAFEPOINT_POLLS("atomic")
+    protected Record getRecord(int argCount) {
+        int uuid = getUniqueId();
+        if (flusher != null && uuid - idAtLastFlush >= logEntries) {
+            flush(FLUSHMODE_FULL);
+        }
+        Pointer recordAddress = logBuffer.plus((uuid & entryMask) * defaultNativeRecordSize).asPointer();
+        recordAddress.writeInt(0, 0);
+        MemoryBarriers.barrier(MemoryBarriers.STORE_STORE);
+        recordAddress.writeInt(ID_OFFSET, uuid);
+        NativeRecord record = getNativeRecord(VmThread.currentTLA());
+        record.address = recordAddress;
+        return record;
+    }
+
+    @Override
+    public boolean setThreadState(boolean state) {
+        Word old = VMLOG_MAPPED_THREADSTATE.load(VmThread.currentTLA());
+        VMLOG_MAPPED_THREADSTATE.store3(state ? Word.zero() : Word.allOnes());
+        return old.isZero();
+    }
+
+    @Override
+    public boolean threadIsEnabled() {
+        return VMLOG_MAPPED_THREADSTATE.load(VmThread.currentTLA()).isZero();
+    }
+
+    /**
+     * Called to scan/update the log buffer, once per-thread.
+     * Since we have a global log, we only need to scan once.
+     */
+    @Override
+    public void scanLog(Pointer tla, PointerIndexVisitor visitor) {
+        if (isRepeatScanLogVisitor(visitor)) {
+            return;
+        }
+        // order doesn't matter, just how many entries are in use
+        int hwm = nextId >= 0 && nextId < logEntries ? nextId : logEntries;
+        for (int i = 0; i < hwm; i++) {
+            scanRecord.address = logBuffer.plus(i * defaultNativeRecordSize).asPointer();
+            if (scanRecord.getLoggerId() != 0) {
+                scanArgs(scanRecord, scanRecord.address.plus(ARGS_OFFSET), visitor);
+            }
+        }
+    }
+
+    @Override
+    protected void flushRecords(VmThread vmThread) {
+        // The assumption is that we can safely read "nextId" without
+        // interference from concurrent activity.
+        int myId = nextId;
+        for (int id = idAtLastFlush; id != myId; id++) {
+            flushRecord.address = logBuffer.plus((id & entryMask) * defaultNativeRecordSize).asPointer();
+            if (flushRecord.getLoggerId() != 0) {
+                flusher.flushRecord(null, flushRecord, id);
+            }
+        }
+        idAtLastFlush = myId;
+    }
+
+    /**
+     * Creates and maps the log file, writes the header and metadata and moves the log into it.
+     * Records logged concurrently by other threads while the log is being moved may be lost.
+     */
+    private void mapFile(String path) {
+        final int pageSize = Platform.platform().pageSize;
+        final int metadataSize = writeMetadata(Pointer.zero());
+        final int dataOffset = (FILE_HEADER_SIZE + metadataSize + pageSize - 1) & ~(pageSize - 1);
+        final Pointer cPath = CString.utf8FromJava(path);
+        final Pointer file = VirtualMemory.mapSharedFile(cPath, Size.fromInt(dataOffset).plus(logSize));
+        Memory.deallocate(cPath);
+        if (file.isZero()) {
+            Log.print("could not map VMLog file ");
+            Log.println(path);
+            return;
+        }
+        file.writeInt(VERSION_OFFSET, VERSION);
+        file.writeInt(WORD_SIZE_OFFSET, Word.size());
+        file.writeInt(RECORD_SIZE_OFFSET, defaultNativeRecordSize);
+        file.writeInt(LOG_ENTRIES_OFFSET, logEntries);
+        file.writeInt(METADATA_OFFSET_OFFSET, FILE_HEADER_SIZE);
+        file.writeInt(DATA_OFFSET_OFFSET, dataOffset);
+        writeMetadata(file.plus(FILE_HEADER_SIZE));
+
+        final Pointer data = file.plus(dataOffset);
+        Memory.copyBytes(logBuffer.asPointer(), data, Size.fromInt(logSize));
+        logBuffer = data;
+        file.writeInt(MAGIC_OFFSET, MAGIC);
+    }
+
+    /**
+     * Writes the logger metadata at {@code p}, or just computes its size if {@code p} is zero.
+     *
+     * @return the size of the metadata in bytes
+     */
+    private int writeMetadata(Pointer p) {
+        final VMLogger[] loggers = loggers();
+        int count = 0;
+        for (VMLogger logger : loggers) {
+            if (logger != null) {
+                count++;
+            }
+        }
+        int offset = writeInt(p, 0, count);
+        for (VMLogger logger : loggers) {
+            if (logger == null) {
+                continue;
+            }
+            offset = writeInt(p, offset, logger.loggerId);
+            offset = writeString(p, offset, logger.name);
+            final int numOps = logger.numOps();
+            offset = writeInt(p, offset, numOps);
+            for (int op = 0; op < numOps; op++) {
+                offset = writeInt(p, offset, logger.operationRefMap(op));
+                offset = writeString(p, offset, logger.operationName(op));
+            }
+        }
+        return offset;
+    }
+
+    private static int writeInt(Pointer p, int offset, int value) {
+        if (p.isNotZero()) {
+            p.writeInt(offset, value);
+        }
+        return offset + Ints.SIZE;
+    }
+
+    private static int writeString(Pointer p, int offset, String s) {
+        final byte[] bytes = Utf8.stringToUtf8(s);
+        offset = writeInt(p, offset, bytes.length);
+        if (p.isNotZero()) {
+            Memory.writeBytes(bytes, p.plus(offset));
+        }
+        return offset + ((bytes.length + Ints.SIZE - 1) & ~(Ints.SIZE - 1));
+    }
+
+}
@@ -55,6 +55,13 @@ import com.sun.max.vm.thread.*;
  *
  * Note that in order for the Inspector to be able to recreate a globally ordered
  * set of records (by id), we must store the id in the record itself.
+ * <p>
+ * Allocating the id is a compare and swap on the shared {@link #nextId}, which becomes a contended
+ * cache line when many threads log. A log can instead be {@link #timestamped}, in which case a record
+ * carries the {@link MaxineVM#native_nanoTime() time} at which it was created, at {@link #TIMESTAMP_OFFSET},
+ * logging touches no shared state, and readers recreate the global order by merging the per-thread buffers
+ * by timestamp (see {@link #flushMerged()}). The int at {@link #ID_OFFSET} is then unused, keeping the
+ * timestamp and the arguments word aligned. Records logged before native calls are possible have a zero timestamp.
  *
  */
 public abstract class VMLogNativeThread extends VMLogNative {
@@ -62,6 +69,8 @@ public abstract class VMLogNativeThread extends VMLogNative {
 
     public static final int ID_OFFSET = Ints.SIZE;
     public static final int ARGS_OFFSET = 2 * Ints.SIZE;
+    public static final int TIMESTAMP_OFFSET = 2 * Ints.SIZE;
+    public static final int TIMESTAMPED_ARGS_OFFSET = TIMESTAMP_OFFSET + Longs.SIZE;
     public static final int NEXT_OFFSET_MASK = 0x7FFFFFFE;
     public static final int FIRST_OFFSET_SHIFT = 32;
     public static final int SHIFTED_FIRST_OFFSET_MASK = 0x7FFFFFE;
@@ -80,11 +89,29 @@ public abstract class VMLogNativeThread extends VMLogNative {
     @CONSTANT
     protected VmThreadLocal vmLogBufferOffsetsTL;
 
+    /**
+     * Records are ordered by timestamp rather than by a globally unique id.
+     */
+    protected final boolean timestamped;
+
+    protected VMLogNativeThread() {
+        this(false);
+    }
+
+    protected VMLogNativeThread(boolean timestamped) {
+        this.timestamped = timestamped;
+    }
+
     @Override
     protected boolean isPerThread() {
         return true;
     }
 
+    @Override
+    protected boolean isTimeOrdered() {
+        return timestamped;
+    }
+
     /**
      * Sets the specific thread locals used to control this log.
      * @param vmLogBufferTL
@@ -105,10 +132,30 @@ public abstract class VMLogNativeThread extends VMLogNative {
 
     @Override
     /**
-     * Space for header and the id.
+     * Space for header and the id, plus the timestamp if {@link #timestamped}.
      */
     protected final int getArgsOffset() {
-        return ARGS_OFFSET;
+        return timestamped ? TIMESTAMPED_ARGS_OFFSET : ARGS_OFFSET;
+    }
+
+    /**
+     * Stamps a newly allocated record with its id or, if {@link #timestamped}, the current time.
+     */
+    @INLINE
+    protected final void stampRecord(Pointer recordAddress) {
+        if (timestamped) {
+            recordAddress.writeLong(TIMESTAMP_OFFSET, MaxineVM.isPrimordialOrPristine() ? 0L : MaxineVM.native_nanoTime());
+        } else {
+            recordAddress.writeInt(ID_OFFSET, getUniqueId());
+        }
+    }
+
+    /**
+     * Gets the id to pass to the {@link #flusher} for the record at {@code recordAddress}. Timestamped records
+     * do not have one, so they are numbered in the order they are flushed.
+     */
+    protected final int flushId(Pointer recordAddress) {
+        return timestamped ? getUniqueId() : recordAddress.readInt(ID_OFFSET);
     }
 
     @Override
@@ -118,7 +165,7 @@ public abstract class VMLogNativeThread extends VMLogNative {
 
     @NEVER_INLINE
     private Pointer allocateBuffer() {
-        Pointer buffer = Memory.allocate(Size.fromInt(logSize));
+        Pointer buffer = Memory.allocate(Size.fromInt(logSize), Memory.Tag.LOG, true);
         vmLogBufferTL.store3(buffer);
         return buffer;
     }
@@ -50,6 +50,9 @@ import com.sun.max.vm.thread.*;
  * A log with a {@link com.sun.max.vm.log.VMLog.Flusher} will only overwrite records after they have been passed to the flusher.
  * The records are all flushed at once and then the log is then reset to empty.
  *
+ * If the log is {@link #timestamped}, records are stamped with the time rather than a shared id, and flushing
+ * all the logs (other than on a full buffer or thread exit) merges them by timestamp, see {@link #flushMerged()}.
+ *
  * This class is abstract because it does not define the specific thread locals that are used to control
  * the buffer. That is left to a concrete subclass, thereby allowing multiple instances of this log to co-exist
  * for a thread at runtime.
@@ -57,6 +60,13 @@ import com.sun.max.vm.thread.*;
  */
 public abstract class VMLogNativeThreadVariableUnbound extends VMLogNativeThread {
 
+    protected VMLogNativeThreadVariableUnbound() {
+    }
+
+    protected VMLogNativeThreadVariableUnbound(boolean timestamped) {
+        super(timestamped);
+    }
+
     @Override
     public void threadStart() {
         // we want to allocate the NativeRecord early;
@@ -70,7 +80,6 @@ public abstract class VMLogNativeThreadVariableUnbound extends VMLogNativeThread
     @NO_SAFEPOINT_POLLS("atomic")
     protected Record getRecord(int argCount) {
         Pointer holeAddress = Pointer.zero();
-        int uuid = getUniqueId();
         Pointer tla = VmThread.currentTLA();
         Pointer buffer = getBuffer(tla);
         Address offsets = vmLogBufferOffsetsTL.load(tla);
@@ -78,7 +87,7 @@ public abstract class VMLogNativeThreadVariableUnbound extends VMLogNativeThread
         long firstOffsetAndWrap = offsets.toLong() & FIRST_OFFSET_WRAP_MASK;
         long wrap = firstOffsetAndWrap & WRAPPED;
         Pointer recordAddress = buffer.plus(nextOffset);
-        int recordSize = ARGS_OFFSET + argCount * Word.size();
+        int recordSize = nativeRecordArgsOffset + argCount * Word.size();
         int newNextOffset = nextOffset + recordSize;
 
         if (newNextOffset >= logSize) {
@@ -122,7 +131,7 @@ public abstract class VMLogNativeThreadVariableUnbound extends VMLogNativeThread
         }
         vmLogBufferOffsetsTL.store3(Address.fromLong(firstOffsetAndWrap | modLogSize(newNextOffset)));
 
-        recordAddress.writeInt(ID_OFFSET, uuid);
+        stampRecord(recordAddress);
         NativeRecord record = getNativeRecord(tla);
         record.address = recordAddress;
 
@@ -136,8 +145,16 @@ public abstract class VMLogNativeThreadVariableUnbound extends VMLogNativeThread
      * @param offset
      */
     private int nextRecordOffset(Pointer buffer, int offset) {
-        int argCount = Record.getArgCount(buffer.plus(modLogSize(offset)).getInt());
-        return offset + ARGS_OFFSET + argCount * Word.size();
+        return offset + recordSizeFromHeader(buffer.plus(modLogSize(offset)).getInt());
+    }
+
+    /**
+     * Returns the size of the record with the given header. Holes are filled with one
+     * word {@link Record#FREE} records, as a timestamped record is larger than a word.
+     */
+    @INLINE
+    private int recordSizeFromHeader(int header) {
+        return Record.isFree(header) ? Word.size() : nativeRecordArgsOffset + Record.getArgCount(header) * Word.size();
     }
 
     @Override
@@ -196,9 +213,9 @@ public abstract class VMLogNativeThreadVariableUnbound extends VMLogNativeThread
             int header = r.getHeader();
             // variable length records can cause holes
             if (!Record.isFree(header)) {
-                flusher.flushRecord(vmThread, r, r.address.readInt(ID_OFFSET));
+                flusher.flushRecord(vmThread, r, flushId(r.address));
             }
-            offset = modLogSize(offset + ARGS_OFFSET + r.getArgCount() * Word.size());
+            offset = modLogSize(offset + recordSizeFromHeader(header));
         }
         flusher.end(vmThread);
         FatalError.breakpoint();
@@ -239,12 +256,12 @@ public abstract class VMLogNativeThreadVariableUnbound extends VMLogNativeThread
             // variable length records can cause holes
             if (!Record.isFree(header)) {
                 if (scanning) {
-                    scanArgs(r, r.address.plus(ARGS_OFFSET), visitor);
+                    scanArgs(r, r.address.plus(nativeRecordArgsOffset), visitor);
                 } else {
-                    flusher.flushRecord(vmThread, r, r.address.readInt(ID_OFFSET));
+                    flusher.flushRecord(vmThread, r, flushId(r.address));
                 }
             }
-            offset = modLogSize(offset + ARGS_OFFSET + r.getArgCount() * Word.size());
+            offset = modLogSize(offset + recordSizeFromHeader(header));
         }
 
         if (scanning) {
@@ -255,6 +272,123 @@ public abstract class VMLogNativeThreadVariableUnbound extends VMLogNativeThread
         }
     }
 
+    /**
+     * Gathers the TLAs of the threads with a non-empty log; counts them if {@link #tlas} is {@code null}.
+     */
+    private final class NonEmptyLogGatherer implements Pointer.Procedure {
+        int count;
+        long[] tlas;
+
+        public void run(Pointer tla) {
+            long offsets = vmLogBufferOffsetsTL.load(tla).toLong();
+            if (nextOffset(offsets) == 0 && !isWrapped(offsets)) {
+                return;
+            }
+            if (tlas != null) {
+                tlas[count] = tla.toLong();
+            }
+            count++;
+        }
+    }
+
+    /**
+     * Returns {@code offset}, or the offset of the first record after it if it is a hole,
+     * or -1 if that reaches {@code end}.
+     */
+    private int skipHoles(Pointer buffer, int offset, int end) {
+        while (offset != end) {
+            if (!Record.isFree(buffer.plus(offset).getInt())) {
+                return offset;
+            }
+            offset = modLogSize(offset + Word.size());
+        }
+        return -1;
+    }
+
+    /**
+     * Merges the logs of all threads by repeatedly flushing the oldest record at the head of any log.
+     * The logs are kept in a min-heap keyed on the timestamp of their head record, so each record costs
+     * {@code O(log threads)}. The flusher is told about every {@linkplain Flusher#mergedThread participating thread}
+     * first. The logs are then reset.
+     */
+    @Override
+    protected void flushMerged() {
+        final NonEmptyLogGatherer gatherer = new NonEmptyLogGatherer();
+        VmThreadMap.ACTIVE.forAllThreadLocals(null, gatherer);
+        final int n = gatherer.count;
+        gatherer.tlas = new long[n];
+        gatherer.count = 0;
+        VmThreadMap.ACTIVE.forAllThreadLocals(null, gatherer);
+        final long[] tlas = gatherer.tlas;
+        final int[] cursors = new int[n];
+        final int[] ends = new int[n];
+        final long[] timestamps = new long[n];
+        final int[] heap = new int[n];
+        int heapSize = 0;
+        for (int i = 0; i < n; i++) {
+            final Pointer tla = Pointer.fromLong(tlas[i]);
+            final Pointer buffer = getBuffer(tla);
+            final long offsets = vmLogBufferOffsetsTL.load(tla).toLong();
+            ends[i] = nextOffset(offsets);
+            cursors[i] = skipHoles(buffer, firstOffset(offsets), ends[i]);
+            if (cursors[i] >= 0) {
+                timestamps[i] = buffer.readLong(cursors[i] + TIMESTAMP_OFFSET);
+                heap[heapSize++] = i;
+                flusher.mergedThread(VmThread.fromTLA(tla));
+            }
+        }
+        for (int i = heapSize / 2 - 1; i >= 0; i--) {
+            siftDown(heap, heapSize, i, timestamps);
+        }
+
+        final NativeRecord r = getNativeRecord(VmThread.currentTLA());
+        final Pointer saveAddress = r.address;
+        while (heapSize > 0) {
+            final int oldest = heap[0];
+            final Pointer tla = Pointer.fromLong(tlas[oldest]);
+            final Pointer buffer = getBuffer(tla);
+            r.address = buffer.plus(cursors[oldest]);
+            final int header = r.getHeader();
+            flusher.flushRecord(VmThread.fromTLA(tla), r, getUniqueId());
+            cursors[oldest] = skipHoles(buffer, modLogSize(cursors[oldest] + recordSizeFromHeader(header)), ends[oldest]);
+            if (cursors[oldest] >= 0) {
+                timestamps[oldest] = buffer.readLong(cursors[oldest] + TIMESTAMP_OFFSET);
+            } else {
+                heap[0] = heap[--heapSize];
+            }
+            siftDown(heap, heapSize, 0, timestamps);
+        }
+        r.address = saveAddress;
+
+        for (int i = 0; i < n; i++) {
+            vmLogBufferOffsetsTL.store3(Pointer.fromLong(tlas[i]), Address.zero());
+        }
+    }
+
+    /**
+     * Restores the min-heap property of the first {@code size} entries of {@code heap}, which index
+     * {@code timestamps}, below the entry at {@code index}.
+     */
+    private static void siftDown(int[] heap, int size, int index, long[] timestamps) {
+        final int entry = heap[index];
+        int i = index;
+        while (true) {
+            int child = 2 * i + 1;
+            if (child >= size) {
+                break;
+            }
+            if (child + 1 < size && timestamps[heap[child + 1]] < timestamps[heap[child]]) {
+                child++;
+            }
+            if (timestamps[heap[child]] >= timestamps[entry]) {
+                break;
+            }
+            heap[i] = heap[child];
+            i = child;
+        }
+        heap[i] = entry;
+    }
+
     @Override
     protected void flushRecords(VmThread vmThread) {
         Pointer tla = vmThread.tla();
@@ -35,6 +35,13 @@ public class VMLogNativeThreadVariableStd extends VMLogNativeThreadVariableUnbou
     public static final VmThreadLocal VMLOG_BUFFER = new VmThreadLocal(VMLOG_BUFFER_NAME, false, "VMLog buffer");
     public static final VmThreadLocal VMLOG_BUFFER_OFFSETS = new VmThreadLocal(VMLOG_BUFFER_OFFSETS_NAME, false, "VMLog buffer first/next offsets");
 
+    public VMLogNativeThreadVariableStd() {
+    }
+
+    protected VMLogNativeThreadVariableStd(boolean timestamped) {
+        super(timestamped);
+    }
+
     @Override
     public void initialize(MaxineVM.Phase phase) {
         super.initialize(phase);
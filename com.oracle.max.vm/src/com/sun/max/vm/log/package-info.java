@@ -283,6 +283,12 @@
  * {@code max.vmlog.class} system property to {@code java.fix.VMLogArrayFixed}. This is an all-Java implementation
  * that uses a global buffer comprising an array of fixed length {@link com.sun.max.vm.log.VMLog.Record} instances.
  * It should be used as a check if there is a suspicion that the default implementation is manifesting a bug.
+ * <p>
+ * A third implementation, {@link com.sun.max.vm.log.nat.mapped.VMLogNativeMapped}, enabled by setting {@code max.vmlog.class}
+ * to {@code nat.mapped.VMLogNativeMapped}, stores fixed length records in a global buffer that, given the
+ * {@code -XX:VMLogFile=file} option, is a shared mapping of {@code file}. The most recent records therefore
+ * survive a VM crash or kill, and can be decoded offline with {@code mx vmlog file}, or converted with
+ * {@code mx vmlog -raw file} into the format read by the Inspector (see below).
  *
  * <h3>VMLog Flushing</h3>
  * By default, older log records are overwritten when the circular buffer wraps around. In normal use this is not a problem,
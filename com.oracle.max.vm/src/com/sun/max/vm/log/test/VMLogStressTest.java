@@ -32,6 +32,7 @@ import com.sun.max.vm.log.VMLog.Flusher;
 import com.sun.max.vm.log.VMLog.Record;
 import com.sun.max.vm.log.hosted.*;
 import com.sun.max.vm.log.nat.VMLogNative.NativeRecord;
+import com.sun.max.vm.log.nat.thread.*;
 import com.sun.max.vm.log.nat.thread.var.*;
 import com.sun.max.vm.thread.*;
 import com.sun.max.vm.ti.*;
@@ -40,6 +41,17 @@ import com.sun.max.vm.ti.*;
  * A stress test for {@link VMLog}.
  * Must be included in the boot image, which is controlled by the "max.vmlog.stresstest" property.
  * Registers as a {@link VMTI} handler as a way of getting control.
+ * <p>
+ * At runtime the property is a comma separated list of:
+ * <ul>
+ * <li>{@code t=n}: the number of logging threads (default 1)</li>
+ * <li>{@code c=n}: the number of records each thread logs (default 1000000)</li>
+ * <li>{@code timed}: log to a {@link VMLogNativeThread#timestamped timestamped} log instead of one using unique ids</li>
+ * <li>{@code m}: measure the cost of logging instead of checking the logged data; each thread logs
+ * records with constant arguments and the average cost per record is reported once all threads finish</li>
+ * </ul>
+ * Comparing the cost reported for increasing numbers of threads, with and without {@code timed},
+ * shows the effect of contention on the shared id.
  */
 public class VMLogStressTest {
 
@@ -52,30 +64,44 @@ public class VMLogStressTest {
     private static final XFlusherDebugLogger xFlusherDebugLogger = new XFlusherDebugLogger();
 
     private static class XFlusher extends Flusher {
+        private final XVMLogger xLogger;
+
+        XFlusher(XVMLogger xLogger) {
+            this.xLogger = xLogger;
+        }
 
         @Override
         public void flushRecord(VmThread vmThread, Record r, int uuid) {
             NativeRecord nativeRecord = (NativeRecord) r;
             xFlusherDebugLogger.log(0, nativeRecord.address);
-            logger.trace(r);
+            xLogger.trace(r);
         }
 
     }
 
     private static class XVMLog extends VMLogNativeThreadVariableUnbound {
-        private static final String X_RECORD_NAME = "X_RECORD";
-        private static final String X_BUFFER_NAME = "X_BUFFER";
-        private static final String X_BUFFER_OFFSETS_NAME = "X_BUFFER_OFFSETS";
-        private static final VmThreadLocal X_RECORD = new VmThreadLocal(X_RECORD_NAME, true, "VMLog Stress Test Record");
-        private static final VmThreadLocal X_BUFFER = new VmThreadLocal(X_BUFFER_NAME, false, "VMLog Stress Test  buffer");
-        private static final VmThreadLocal X_BUFFER_OFFSETS = new VmThreadLocal(X_BUFFER_OFFSETS_NAME, false, "VMLog Stress Test buffer first/next offsets");
+        private static final VmThreadLocal X_RECORD = new VmThreadLocal("X_RECORD", true, "VMLog Stress Test Record");
+        private static final VmThreadLocal X_BUFFER = new VmThreadLocal("X_BUFFER", false, "VMLog Stress Test  buffer");
+        private static final VmThreadLocal X_BUFFER_OFFSETS = new VmThreadLocal("X_BUFFER_OFFSETS", false, "VMLog Stress Test buffer first/next offsets");
+        private static final VmThreadLocal XT_RECORD = new VmThreadLocal("XT_RECORD", true, "VMLog Stress Test timed Record");
+        private static final VmThreadLocal XT_BUFFER = new VmThreadLocal("XT_BUFFER", false, "VMLog Stress Test timed buffer");
+        private static final VmThreadLocal XT_BUFFER_OFFSETS = new VmThreadLocal("XT_BUFFER_OFFSETS", false, "VMLog Stress Test timed buffer first/next offsets");
+
+        XVMLog(boolean timestamped) {
+            super(timestamped);
+        }
 
         @Override
         public void initialize(MaxineVM.Phase phase) {
             super.initialize(phase);
             if (MaxineVM.isHosted() && phase == MaxineVM.Phase.BOOTSTRAPPING) {
-                setNativeRecordThreadLocal(X_RECORD);
-                setBufferThreadLocals(X_BUFFER, X_BUFFER_OFFSETS);
+                if (timestamped) {
+                    setNativeRecordThreadLocal(XT_RECORD);
+                    setBufferThreadLocals(XT_BUFFER, XT_BUFFER_OFFSETS);
+                } else {
+                    setNativeRecordThreadLocal(X_RECORD);
+                    setBufferThreadLocals(X_BUFFER, X_BUFFER_OFFSETS);
+                }
             }
         }
 
@@ -88,6 +114,11 @@ public class VMLogStressTest {
         private Random rand;
         private LoggedData loggedData;
 
+        /**
+         * Time taken to log the records when {@link VMLogStressTest#measure measuring}.
+         */
+        long elapsedNanos;
+
         Tester(int i) {
             rand = new Random(46713 + i);
             setName("Tester-" + i);
@@ -95,6 +126,10 @@ public class VMLogStressTest {
 
         @Override
         public void run() {
+            if (measure) {
+                measure();
+                return;
+            }
             loggedData = new LoggedData();
             loggedDataMap.put(VmThread.fromJava(this).id(), loggedData);
             long uuid = 0;
@@ -110,16 +145,16 @@ public class VMLogStressTest {
                     int index = loggedData.save(new Data(uuid, args));
                     switch (argc) {
                         case 0:
-                            logger.logFoo1(uuid, index, args[0]);
+                            activeLogger.logFoo1(uuid, index, args[0]);
                             break;
                         case 1:
-                            logger.logFoo2(uuid, index, args[0], args[1]);
+                            activeLogger.logFoo2(uuid, index, args[0], args[1]);
                             break;
                         case 2:
-                            logger.logFoo3(uuid, index, args[0], args[1], args[2]);
+                            activeLogger.logFoo3(uuid, index, args[0], args[1], args[2]);
                             break;
                         case 3:
-                            logger.logFoo4(uuid, index, args[0], args[1], args[2], args[3]);
+                            activeLogger.logFoo4(uuid, index, args[0], args[1], args[2], args[3]);
                     }
                     uuid++;
                     myIterations--;
@@ -130,6 +165,16 @@ public class VMLogStressTest {
             }
         }
 
+        private void measure() {
+            final XVMLogger xLogger = activeLogger;
+            final int myIterations = iterations;
+            final long start = System.nanoTime();
+            for (int i = 0; i < myIterations; i++) {
+                xLogger.logFoo1(i, 0, 0);
+            }
+            elapsedNanos = System.nanoTime() - start;
+        }
+
     }
 
     private static class Data {
@@ -201,6 +246,11 @@ public class VMLogStressTest {
 
     private static int iterations = 1000000;
 
+    /**
+     * Measure the cost of logging, rather than checking the logged data.
+     */
+    private static volatile boolean measure;
+
     private static class VMTIHandler extends NullVMTIHandler {
         @Override
         public void vmInitialized() {
@@ -214,20 +264,37 @@ public class VMLogStressTest {
             for (int i = 0; i < args.length; i++) {
                 String arg = args[i];
                 if (arg.startsWith("t=")) {
-                    // TODO
+                    numThreads = getValue(arg);
                 } else if (arg.startsWith("c=")) {
                     iterations = getValue(arg);
+                } else if (arg.equals("timed")) {
+                    activeLogger = timedLogger;
+                } else if (arg.equals("m")) {
+                    measure = true;
                 }
             }
 
-            logger.enable(true);
+            activeLogger.enable(true);
 
-            Thread[] threads = new Thread[numThreads];
+            Tester[] threads = new Tester[numThreads];
             for (int t = 0; t < numThreads; t++) {
                 threads[t] = new Tester(t);
                 threads[t].start();
             }
 
+            if (measure) {
+                long totalNanos = 0;
+                for (int t = 0; t < numThreads; t++) {
+                    try {
+                        threads[t].join();
+                    } catch (InterruptedException ex) {
+                    }
+                    totalNanos += threads[t].elapsedNanos;
+                }
+                activeLogger.enable(false);
+                System.out.println("VMLogStressTest: " + numThreads + " threads, " + (activeLogger == timedLogger ? "timestamped" : "unique id") +
+                                   " log: " + totalNanos / ((long) numThreads * iterations) + " ns per record");
+            }
         }
 
         private static int getValue(String arg) {
@@ -236,12 +303,21 @@ public class VMLogStressTest {
         }
     }
 
-    private static final XVMLogger logger = new XVMLogger();
-    private static final XVMLog xvmLog = new XVMLog();
+    private static final XVMLogger logger = new XVMLogger("Stress Tester");
+    private static final XVMLog xvmLog = new XVMLog(false);
+    private static final XVMLogger timedLogger = new XVMLogger("Timed Stress Tester");
+    private static final XVMLog timedXvmLog = new XVMLog(true);
+
+    /**
+     * The logger used by the {@link Tester} threads.
+     */
+    private static XVMLogger activeLogger = logger;
 
     static {
         xvmLog.initialize(MaxineVM.Phase.BOOTSTRAPPING);
-        xvmLog.registerCustom(logger, new XFlusher());
+        xvmLog.registerCustom(logger, new XFlusher(logger));
+        timedXvmLog.initialize(MaxineVM.Phase.BOOTSTRAPPING);
+        timedXvmLog.registerCustom(timedLogger, new XFlusher(timedLogger));
         VMTI.registerEventHandler(new VMTIHandler());
     }
 
@@ -250,8 +326,8 @@ public class VMLogStressTest {
     private static Map<Integer, LoggedData> loggedDataMap = new ConcurrentHashMap<Integer, LoggedData>();
 
     private static class XVMLogger extends XVMLoggerAuto {
-        XVMLogger() {
-            super("Stress Tester");
+        XVMLogger(String name) {
+            super(name);
         }
 
         @NEVER_INLINE
@@ -264,7 +340,9 @@ public class VMLogStressTest {
         @Override
         @NEVER_INLINE
         protected void traceFoo1(int threadId, long uuid, long index, long arg1) {
-            getLoggedData(threadId).check(uuid, index, new long[] {arg1});
+            if (!measure) {
+                getLoggedData(threadId).check(uuid, index, new long[] {arg1});
+            }
         }
 
         @Override
@@ -25,80 +25,208 @@ package com.sun.max.vm.management;
 import static com.sun.max.vm.VMConfiguration.*;
 
 import java.lang.management.*;
+import java.lang.reflect.*;
 import java.util.*;
 
+import com.sun.management.GcInfo;
+import com.sun.max.vm.*;
 import com.sun.max.vm.code.*;
 import com.sun.max.vm.heap.*;
 
 /**
  * This class provides the entry point to all the memory management functions in Maxine.
+ *
+ * The memory managers and their pools are created once, when the VM starts running, so that
+ * the statistics they accumulate survive across queries. Every garbage collection
+ * reports the start and end of each collection with {@link #gcStarted()} and {@link #gcFinished()},
+ * which only update primitive fields and therefore neither allocate nor take locks.
  */
 
 public class MemoryManagement {
 
-    public static MemoryPoolMXBean[] getMemoryPools() {
+    private static MemoryManagerMXBean[] memoryManagers;
+    private static MemoryPoolMXBeanAdaptor[] memoryPools;
+
+    private static long collectionCount;
+    private static long collectionTimeNanos;
+    private static long lastGCStartNanos;
+    private static long lastGCStartTime;
+    private static long lastGCEndTime;
+
+    /**
+     * Creates the memory managers and pools. This is called once the heap and code regions have been initialized.
+     * It is synchronized as the management API may call it concurrently from several threads before then.
+     */
+    public static synchronized void initialize() {
+        if (memoryManagers != null) {
+            return;
+        }
+        /*
+         * In a complete implementation there would be a manager for code, non-heap data and heap data.
+         * Currently, we only support code and heap.
+         */
+        final MemoryManagerMXBean[] managers = new MemoryManagerMXBean[3];
+        managers[0] = Code.getMemoryManagerMXBean();
+        managers[1] = ImmortalHeap.getMemoryManagerMXBean();
+        managers[2] = vmConfig().heapScheme().getGarbageCollectorMXBean();
+
         /*
          * It is somewhat annoying that a MemoryManagerMXBean only provides access to the names
          * of its managed pools, not the pool instances themselves. So Maxine uses subclasses
          * of MemoryManagerMXBean and GarbageCollectorMXBean that implement the
          * MemoryManagerMXBeanPools interface, which provides this information.
          */
-        final MemoryManagerMXBean[] theMemoryManagers = getMemoryManagers();
-        final ArrayList<MemoryPoolMXBean> theMemoryPoolMXBeans = new ArrayList<MemoryPoolMXBean>();
-        for (MemoryManagerMXBean memoryManagerMXBean : theMemoryManagers) {
-            MemoryManagerMXBeanPools memoryManagerMXBeanPools = (MemoryManagerMXBeanPools) memoryManagerMXBean;
-            theMemoryPoolMXBeans.addAll(memoryManagerMXBeanPools.getAll());
+        final ArrayList<MemoryPoolMXBeanAdaptor> pools = new ArrayList<MemoryPoolMXBeanAdaptor>();
+        for (MemoryManagerMXBean memoryManagerMXBean : managers) {
+            for (MemoryPoolMXBean pool : getMemoryManagerMXBeanPools(memoryManagerMXBean).getAll()) {
+                pools.add((MemoryPoolMXBeanAdaptor) pool);
+            }
         }
-        return theMemoryPoolMXBeans.toArray(new MemoryPoolMXBean[theMemoryPoolMXBeans.size()]);
-    }
-
-    public static MemoryManagerMXBean[] getMemoryManagers() {
-        /*
-         * In a complete implementation there would be a manager for code, non-heap data and heap data.
-         * Currently, we only support code and heap. This information probably could be cached safely.
-         */
-        final MemoryManagerMXBean[] result = new MemoryManagerMXBean[3];
-        result[0] = Code.getMemoryManagerMXBean();
-        result[1] = ImmortalHeap.getMemoryManagerMXBean();
-        result[2] = vmConfig().heapScheme().getGarbageCollectorMXBean();
-        return result;
+        memoryPools = pools.toArray(new MemoryPoolMXBeanAdaptor[pools.size()]);
+        memoryManagers = managers;
     }
 
-    public static MemoryUsage getMemoryUsage(boolean heap) {
-        List<MemoryPoolMXBean> pools = null;
-        if (heap) {
-            pools = new ArrayList<MemoryPoolMXBean>();
-            pools.addAll(getMemoryManagerMXBeanPools(ImmortalHeap.getMemoryManagerMXBean()).getAll());
-            pools.addAll(getMemoryManagerMXBeanPools(vmConfig().heapScheme().getGarbageCollectorMXBean()).getAll());
-        } else {
-            pools = getMemoryManagerMXBeanPools(Code.getMemoryManagerMXBean()).getAll();
-        }
-        return sum(pools);
+    public static MemoryPoolMXBean[] getMemoryPools() {
+        initialize();
+        return memoryPools.clone();
     }
 
-    private static MemoryManagerMXBeanPools getMemoryManagerMXBeanPools(MemoryManagerMXBean memoryManagerMXBean) {
-        return (MemoryManagerMXBeanPools) memoryManagerMXBean;
+    public static MemoryManagerMXBean[] getMemoryManagers() {
+        initialize();
+        return memoryManagers.clone();
     }
 
-    private static MemoryUsage sum(List<MemoryPoolMXBean> pools) {
+    public static MemoryUsage getMemoryUsage(boolean heap) {
+        initialize();
         long init = 0;
         long committed = 0;
         long max = 0;
         long used = 0;
-
-        for (MemoryPoolMXBean pool : pools) {
-            final MemoryUsage poolUsage = pool.getUsage();
-            init += poolUsage.getInit();
-            committed += poolUsage.getCommitted();
-            max += poolUsage.getMax();
-            used += poolUsage.getUsed();
+        for (MemoryPoolMXBeanAdaptor pool : memoryPools) {
+            if ((pool.getType() == MemoryType.HEAP) == heap) {
+                final MemoryUsage poolUsage = pool.getUsage();
+                init += poolUsage.getInit();
+                committed += poolUsage.getCommitted();
+                max += poolUsage.getMax();
+                used += poolUsage.getUsed();
+            }
         }
         return new MemoryUsage(init, used, committed, max);
     }
 
+    private static MemoryManagerMXBeanPools getMemoryManagerMXBeanPools(MemoryManagerMXBean memoryManagerMXBean) {
+        return (MemoryManagerMXBeanPools) memoryManagerMXBean;
+    }
+
     public static boolean setVerboseGC(boolean value) {
         final boolean result = Heap.verbose();
         Heap.setVerbose(value);
         return result;
     }
+
+    /**
+     * Records the start of a garbage collection. This must not allocate.
+     */
+    public static void gcStarted() {
+        lastGCStartNanos = MaxineVM.native_nanoTime();
+        lastGCStartTime = MaxineVM.native_currentTimeMillis();
+        final MemoryPoolMXBeanAdaptor[] pools = memoryPools;
+        if (pools != null) {
+            for (MemoryPoolMXBeanAdaptor pool : pools) {
+                pool.recordBeforeGC();
+            }
+        }
+    }
+
+    /**
+     * Records the end of a garbage collection. This must not allocate.
+     */
+    public static void gcFinished() {
+        final MemoryPoolMXBeanAdaptor[] pools = memoryPools;
+        if (pools != null) {
+            for (MemoryPoolMXBeanAdaptor pool : pools) {
+                pool.recordAfterGC();
+            }
+        }
+        collectionTimeNanos += MaxineVM.native_nanoTime() - lastGCStartNanos;
+        lastGCEndTime = MaxineVM.native_currentTimeMillis();
+        collectionCount++;
+    }
+
+    /**
+     * Gets the number of garbage collections that have completed.
+     */
+    public static long getCollectionCount() {
+        return collectionCount;
+    }
+
+    /**
+     * Gets the accumulated time spent in garbage collection, in milliseconds.
+     */
+    public static long getCollectionTime() {
+        return collectionTimeNanos / 1000000;
+    }
+
+    /**
+     * Gets the start time of the most recent garbage collection, in milliseconds since the VM started.
+     */
+    public static long getLastGCStartTime() {
+        return lastGCStartTime - MaxineVM.getStartupTime();
+    }
+
+    /**
+     * Gets the end time of the most recent garbage collection, in milliseconds since the VM started.
+     */
+    public static long getLastGCEndTime() {
+        return lastGCEndTime - MaxineVM.getStartupTime();
+    }
+
+    /**
+     * Gets the usage of every {@linkplain #getMemoryPools() pool} before or after the most recent garbage collection.
+     */
+    public static MemoryUsage[] getLastGCUsage(boolean before) {
+        initialize();
+        final MemoryUsage[] result = new MemoryUsage[memoryPools.length];
+        for (int i = 0; i < result.length; i++) {
+            result[i] = before ? memoryPools[i].getUsageBeforeLastGC() : memoryPools[i].getUsageAfterLastGC();
+        }
+        return result;
+    }
+
+    /**
+     * Support for creating {@link GcInfo} objects by reflection.
+     */
+    private static Constructor<?> gcInfoBuilderConstructor;
+    private static Constructor<?> gcInfoConstructor;
+
+    /**
+     * Gets the information about the most recent garbage collection performed by a given collector.
+     *
+     * @return {@code null} if there has been no collection or the JDK's {@link GcInfo} cannot be created
+     */
+    public static GcInfo getLastGcInfo(GarbageCollectorMXBean gc) {
+        if (collectionCount == 0) {
+            return null;
+        }
+        initialize();
+        try {
+            if (gcInfoConstructor == null) {
+                final Class<?> builderClass = Class.forName("sun.management.GcInfoBuilder");
+                gcInfoBuilderConstructor = builderClass.getDeclaredConstructor(GarbageCollectorMXBean.class, String[].class);
+                gcInfoBuilderConstructor.setAccessible(true);
+                gcInfoConstructor = GcInfo.class.getDeclaredConstructor(builderClass, long.class, long.class, long.class,
+                    MemoryUsage[].class, MemoryUsage[].class, Object[].class);
+                gcInfoConstructor.setAccessible(true);
+            }
+            final String[] poolNames = new String[memoryPools.length];
+            for (int i = 0; i < poolNames.length; i++) {
+                poolNames[i] = memoryPools[i].getName();
+            }
+            final Object builder = gcInfoBuilderConstructor.newInstance(gc, poolNames);
+            return (GcInfo) gcInfoConstructor.newInstance(builder, collectionCount, getLastGCStartTime(), getLastGCEndTime(),
+                getLastGCUsage(true), getLastGCUsage(false), new Object[0]);
+        } catch (Exception e) {
+            return null;
+        }
+    }
 }
@@ -33,23 +33,127 @@ import com.sun.max.memory.*;
  * Each instance has an associated MemoryRegion and an associated manager (MemoryManagerMXBean).
  * The management API supports multiple managers for a given memory pool but we don't exploit that currently.
  *
+ * The usage of a pool is obtained from {@link #usedBytes()}, {@link #committedBytes()} and {@link #maxBytes()},
+ * which must not allocate as they are also {@linkplain #recordBeforeGC() sampled} during garbage collection.
+ * Peak usage and the usage before and after the last collection are kept in primitive fields for the same reason.
  */
 
 public class MemoryPoolMXBeanAdaptor implements MemoryPoolMXBean {
     protected MemoryManagerMXBean manager;
     protected MemoryRegion region;
     private MemoryType type;
+    private String name;
+
+    private long initBytes = -1;
+    private long peakUsed;
+    private long peakCommitted;
+    private long beforeGCUsed;
+    private long beforeGCCommitted;
+    private long afterGCUsed;
+    private long afterGCCommitted;
+    private boolean collected;
 
     private MemoryPoolMXBeanAdaptor() {
     }
 
     public MemoryPoolMXBeanAdaptor(MemoryType type, MemoryRegion region, MemoryManagerMXBean manager) {
-        this.type = type;
+        this(type, region.regionName(), manager);
         this.region = region;
     }
 
+    public MemoryPoolMXBeanAdaptor(MemoryType type, String name, MemoryManagerMXBean manager) {
+        this.type = type;
+        this.name = name;
+        this.manager = manager;
+    }
+
+    /**
+     * Gets the number of bytes in use in this pool.
+     */
+    protected long usedBytes() {
+        if (region instanceof LinearAllocationMemoryRegion) {
+            return ((LinearAllocationMemoryRegion) region).used().toLong();
+        }
+        return committedBytes();
+    }
+
+    /**
+     * Gets the number of bytes committed to this pool.
+     */
+    protected long committedBytes() {
+        return region.size().toLong();
+    }
+
+    /**
+     * Gets the maximum number of bytes this pool can grow to.
+     */
+    protected long maxBytes() {
+        return region.size().toLong();
+    }
+
+    /**
+     * Samples the current usage of this pool, updating its peak usage.
+     *
+     * @return the number of bytes used
+     */
+    private long sample() {
+        final long used = usedBytes();
+        final long committed = committedBytes();
+        if (initBytes < 0) {
+            initBytes = committed;
+        }
+        if (used > peakUsed) {
+            peakUsed = used;
+        }
+        if (committed > peakCommitted) {
+            peakCommitted = committed;
+        }
+        return used;
+    }
+
+    /**
+     * Records the usage of this pool at the start of a garbage collection. This does not allocate.
+     */
+    public void recordBeforeGC() {
+        beforeGCUsed = sample();
+        beforeGCCommitted = committedBytes();
+    }
+
+    /**
+     * Records the usage of this pool at the end of a garbage collection. This does not allocate.
+     */
+    public void recordAfterGC() {
+        afterGCUsed = sample();
+        afterGCCommitted = committedBytes();
+        collected = true;
+    }
+
+    /**
+     * Gets the usage of this pool at the start of the most recent garbage collection.
+     */
+    public MemoryUsage getUsageBeforeLastGC() {
+        return new MemoryUsage(initBytes(), beforeGCUsed, beforeGCCommitted, maxBytes());
+    }
+
+    /**
+     * Gets the usage of this pool at the end of the most recent garbage collection.
+     */
+    public MemoryUsage getUsageAfterLastGC() {
+        return new MemoryUsage(initBytes(), afterGCUsed, afterGCCommitted, maxBytes());
+    }
+
+    private long initBytes() {
+        return initBytes < 0 ? -1 : initBytes;
+    }
+
     public MemoryUsage getCollectionUsage() {
-        return null;
+        if (type != MemoryType.HEAP) {
+            return null;
+        }
+        if (!collected) {
+            return new MemoryUsage(initBytes(), 0, 0, maxBytes());
+        }
+        return getUsageAfterLastGC();
     }
 
     public long getCollectionUsageThreshold() {
@@ -65,11 +169,12 @@ public class MemoryPoolMXBeanAdaptor implements MemoryPoolMXBean {
     }
 
     public String getName() {
-        return region.regionName();
+        return name;
     }
 
     public MemoryUsage getPeakUsage() {
-        return null;
+        sample();
+        return new MemoryUsage(initBytes(), peakUsed, peakCommitted, maxBytes());
     }
 
     public MemoryType getType() {
@@ -77,7 +182,8 @@ public class MemoryPoolMXBeanAdaptor implements MemoryPoolMXBean {
     }
 
     public MemoryUsage getUsage() {
-        return region.getUsage();
+        final long used = sample();
+        return new MemoryUsage(initBytes(), used, committedBytes(), maxBytes());
     }
 
     public long getUsageThreshold() {
@@ -109,6 +215,8 @@ public class MemoryPoolMXBeanAdaptor implements MemoryPoolMXBean {
     }
 
     public void resetPeakUsage() {
+        peakUsed = usedBytes();
+        peakCommitted = committedBytes();
     }
 
     public void setCollectionUsageThreshold(long threhsold) {
@@ -26,6 +26,7 @@ import java.lang.management.*;
 import java.lang.reflect.*;
 import java.util.*;
 
+import com.sun.max.annotate.*;
 import com.sun.max.unsafe.*;
 import com.sun.max.vm.jdk.*;
 import com.sun.max.vm.runtime.*;
@@ -43,6 +44,26 @@ public class ThreadManagement {
      */
     private static Constructor<?> threadInfoConstructor;
 
+    /**
+     * Determines if thread CPU time measurement is enabled. As in HotSpot, it is enabled by default.
+     */
+    private static boolean threadCpuTimeEnabled = true;
+
+    /**
+     * Records the contention monitoring setting. Contention statistics are not gathered and jmm_GetOptionalSupport
+     * does not report contention monitoring as supported, so {@link java.lang.management.ThreadMXBean} never
+     * enables it and {@link ThreadInfo}s carry no blocked or waited counts or times.
+     */
+    private static boolean threadContentionMonitoringEnabled;
+
+    // Values of the JVMTI thread state flags expected by sun.management.ManagementFactory.toThreadState()
+    private static final int JVMTI_THREAD_STATE_ALIVE = 0x0001;
+    private static final int JVMTI_THREAD_STATE_TERMINATED = 0x0002;
+    private static final int JVMTI_THREAD_STATE_RUNNABLE = 0x0004;
+    private static final int JVMTI_THREAD_STATE_WAITING_INDEFINITELY = 0x0010;
+    private static final int JVMTI_THREAD_STATE_WAITING_WITH_TIMEOUT = 0x0020;
+    private static final int JVMTI_THREAD_STATE_BLOCKED_ON_MONITOR_ENTER = 0x0400;
+
     public static Thread[] getThreads() {
         return VmThreadMap.getThreads(false);
     }
@@ -67,16 +88,91 @@ public class ThreadManagement {
         return VmThreadMap.getLiveTheadCount();
     }
 
+    /**
+     * Enables or disables thread CPU time measurement.
+     *
+     * @return the previous setting
+     */
     public static boolean setThreadCpuTimeEnabled(boolean enable) {
-        // TODO
-        return false;
+        final boolean previous = threadCpuTimeEnabled;
+        threadCpuTimeEnabled = enable;
+        return previous;
+    }
+
+    public static boolean isThreadCpuTimeEnabled() {
+        return threadCpuTimeEnabled;
     }
 
     public static boolean setThreadContentionMonitoringEnabled(boolean enable) {
-        // TODO
-        return false;
+        final boolean previous = threadContentionMonitoringEnabled;
+        threadContentionMonitoringEnabled = enable;
+        return previous;
+    }
+
+    public static boolean isThreadContentionMonitoringEnabled() {
+        return threadContentionMonitoringEnabled;
+    }
+
+    /**
+     * Gets the CPU time consumed by a thread.
+     *
+     * @param id the {@linkplain Thread#getId() id} of the thread or 0 for the current thread
+     * @param userOnly specifies if only the time spent in user mode is returned
+     * @return the CPU time in nanoseconds or -1 if CPU time measurement is disabled, the thread is not alive
+     *         or its CPU time is not available
+     */
+    public static long getThreadCpuTime(long id, boolean userOnly) {
+        if (!threadCpuTimeEnabled) {
+            return -1;
+        }
+        if (id == 0) {
+            return native_threadCpuTime(VmThread.current().nativeThread(), userOnly);
+        }
+        final FindProcedure proc = new FindProcedure(id);
+        final long handle;
+        synchronized (VmThreadMap.THREAD_LOCK) {
+            VmThreadMap.ACTIVE.forAllThreadLocals(null, proc);
+            if (proc.result == null) {
+                return -1;
+            }
+            // The native thread cannot exit while its VmThread is in the thread map and the lock is held
+            handle = native_threadCpuTimeHandle(VmThread.fromJava(proc.result).nativeThread());
+        }
+        if (handle == 0) {
+            return -1;
+        }
+        // Reading the time may involve file I/O, so it is done after the lock is released.
+        // If the thread has exited in the meantime, the read fails unless its handle has been
+        // reused by a newer thread. The thread being still alive after the read rules that out.
+        final Thread thread = proc.result;
+        final long time = native_threadCpuTimeOfHandle(handle, userOnly);
+        synchronized (VmThreadMap.THREAD_LOCK) {
+            proc.result = null;
+            VmThreadMap.ACTIVE.forAllThreadLocals(null, proc);
+            if (proc.result != thread) {
+                return -1;
+            }
+        }
+        return time;
     }
 
+    @C_FUNCTION
+    private static native long native_threadCpuTime(Word nativeThread, boolean userOnly);
+
+    @C_FUNCTION
+    private static native long native_threadCpuTimeHandle(Word nativeThread);
+
+    @C_FUNCTION
+    private static native long native_threadCpuTimeOfHandle(long handle, boolean userOnly);
+
+    /**
+     * Gets information about a number of threads. The stack traces of all the threads are gathered
+     * in a single {@link VmOperation}.
+     *
+     * @param ids the {@linkplain Thread#getId() ids} of the threads
+     * @param maxDepth the maximum number of frames in each stack trace, with -1 denoting the entire stack
+     * @param result the array in which the information is returned. The entry for a thread that is not alive is {@code null}.
+     */
     public static void getThreadInfo(long[] ids, int maxDepth, ThreadInfo[] result) {
         // The ids are java.lang.Thread ids from getId()
         // maxDepth is -1 when the entire stack is requested, not MAX_VALUE as in API call (see sun.management.ThreadImpl)
@@ -85,18 +181,25 @@ public class ThreadManagement {
         if (maxDepth < 0) {
             maxDepth = Integer.MAX_VALUE;
         }
+        final Thread[] threads = findThreads(ids);
+        final StackTraceElement[][] traces = maxDepth == 0 ? null : getStackTrace(threads, maxDepth);
         for (int i = 0; i < ids.length; i++) {
-            final Thread thread = findThread(ids[i]);
-            if (thread == null || thread.getState() == Thread.State.TERMINATED) {
+            final Thread thread = threads[i];
+            final Thread.State state = thread == null ? Thread.State.TERMINATED : thread.getState();
+            if (state == Thread.State.TERMINATED) {
                 result[i] = null;
             } else {
+                StackTraceElement[] trace = traces == null ? null : traces[i];
+                if (trace == null) {
+                    trace = new StackTraceElement[0];
+                }
                 // we don't handle any of the lock information yet
                 try {
                     final Object obj = threadInfoConstructor.newInstance(new Object[] {
-                        thread, thread.getState().ordinal(), null, null,
+                        thread, jvmtiThreadState(state), null, null,
                         0, 0,
                         0, 0,
-                        maxDepth == 0 ? new StackTraceElement[0] : getStackTrace(thread, maxDepth),
+                        trace,
                         null,
                         null,
                         null
@@ -109,6 +212,26 @@ public class ThreadManagement {
         }
     }
 
+    /**
+     * Converts a thread state to the JVMTI thread state flags expected by {@link ThreadInfo}.
+     */
+    private static int jvmtiThreadState(Thread.State state) {
+        switch (state) {
+            case NEW:
+                return 0;
+            case RUNNABLE:
+                return JVMTI_THREAD_STATE_ALIVE | JVMTI_THREAD_STATE_RUNNABLE;
+            case BLOCKED:
+                return JVMTI_THREAD_STATE_ALIVE | JVMTI_THREAD_STATE_BLOCKED_ON_MONITOR_ENTER;
+            case WAITING:
+                return JVMTI_THREAD_STATE_ALIVE | JVMTI_THREAD_STATE_WAITING_INDEFINITELY;
+            case TIMED_WAITING:
+                return JVMTI_THREAD_STATE_ALIVE | JVMTI_THREAD_STATE_WAITING_WITH_TIMEOUT;
+            default:
+                return JVMTI_THREAD_STATE_TERMINATED;
+        }
+    }
+
     /**
      * Support method for {@link Thread#getAllStackTraces}.
      * @param threads
@@ -137,6 +260,41 @@ public class ThreadManagement {
         return threadInfoArray;
     }
 
+    /**
+     * Finds the live threads with a given set of ids in a single pass over the thread map.
+     *
+     * @return an array whose i'th entry is the thread whose id is {@code ids[i]} or {@code null}
+     */
+    public static Thread[] findThreads(long[] ids) {
+        // Everything is allocated up front as allocation is not allowed while holding the thread lock
+        final long[] sortedIds = ids.clone();
+        Arrays.sort(sortedIds);
+        final Thread[] sortedThreads = new Thread[sortedIds.length];
+        final Pointer.Procedure proc = new Pointer.Procedure() {
+            public void run(Pointer tla) {
+                final Thread t = VmThread.fromTLA(tla).javaThread();
+                int index = Arrays.binarySearch(sortedIds, t.getId());
+                if (index >= 0) {
+                    // Fill in every duplicate of the id
+                    while (index > 0 && sortedIds[index - 1] == sortedIds[index]) {
+                        index--;
+                    }
+                    while (index < sortedIds.length && sortedIds[index] == t.getId()) {
+                        sortedThreads[index++] = t;
+                    }
+                }
+            }
+        };
+        synchronized (VmThreadMap.THREAD_LOCK) {
+            VmThreadMap.ACTIVE.forAllThreadLocals(null, proc);
+        }
+        final Thread[] result = new Thread[ids.length];
+        for (int i = 0; i < ids.length; i++) {
+            result[i] = sortedThreads[Arrays.binarySearch(sortedIds, ids[i])];
+        }
+        return result;
+    }
+
     public static Thread findThread(long id) {
         FindProcedure proc = new FindProcedure(id);
         synchronized (VmThreadMap.THREAD_LOCK) {
@@ -159,21 +317,14 @@ public class ThreadManagement {
         }
     }
 
-    private static StackTraceElement[] getStackTrace(Thread thread, int maxDepth) {
-        assert maxDepth > 0;
-        Thread[] threads = {thread};
-        return getStackTrace(threads, maxDepth)[0];
-    }
-
     private static StackTraceElement[][] getStackTrace(Thread[] threads, int maxDepth) {
         final StackTraceElement[][] traces = new StackTraceElement[threads.length][];
-        int currentThreadIndex = -1;
+        final Thread[] otherThreads = threads.clone();
         for (int i = 0; i < threads.length; i++) {
             if (threads[i] == Thread.currentThread()) {
                 // special case of current thread
-                currentThreadIndex = i;
                 // null it out so StackTraceGatherer will not try to stop it
-                threads[i] = null;
+                otherThreads[i] = null;
                 StackTraceElement[] trace = new Exception().getStackTrace();
                 if (maxDepth < trace.length) {
                     trace = Arrays.copyOf(trace, maxDepth);
@@ -181,10 +332,7 @@ public class ThreadManagement {
                 traces[i] = trace;
             }
         }
-        VmOperationThread.submit(new StackTraceGatherer(Arrays.asList(threads), traces, maxDepth));
-        if (currentThreadIndex >= 0) {
-            threads[currentThreadIndex] = Thread.currentThread();
-        }
+        VmOperationThread.submit(new StackTraceGatherer(Arrays.asList(otherThreads), traces, maxDepth));
         return traces;
     }
 
@@ -211,11 +359,18 @@ public class ThreadManagement {
         @Override
         public void doThread(VmThread vmThread, Pointer ip, Pointer sp, Pointer fp) {
             Thread thread = vmThread.javaThread();
+            final StackTraceElement[] trace;
             if (ip.isZero()) {
-                traces[threads.indexOf(thread)] = new StackTraceElement[0];
+                trace = new StackTraceElement[0];
             } else {
                 VmStackFrameWalker sfw = new VmStackFrameWalker(vmThread.tla());
-                traces[threads.indexOf(thread)] = JDK_java_lang_Throwable.getStackTrace(sfw, ip, sp, fp, null, maxDepth);
+                trace = JDK_java_lang_Throwable.getStackTrace(sfw, ip, sp, fp, null, maxDepth);
+            }
+            // A thread may be requested more than once
+            for (int i = 0; i < traces.length; i++) {
+                if (threads.get(i) == thread) {
+                    traces[i] = trace;
+                }
             }
         }
     }
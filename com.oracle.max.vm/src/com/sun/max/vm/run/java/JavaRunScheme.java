@@ -38,6 +38,7 @@ import java.util.jar.*;
 import sun.misc.*;
 
 import com.sun.max.annotate.*;
+import com.sun.max.memory.*;
 import com.sun.max.program.*;
 import com.sun.max.vm.*;
 import com.sun.max.vm.MaxineVM.Phase;
@@ -243,6 +244,8 @@ public class JavaRunScheme extends AbstractVMScheme implements RunScheme {
 
             // Install the signal handler for dumping threads when SIGHUP is received
             Signal.handle(new Signal("QUIT"), new PrintThreads(false));
+
+            NativeMemoryTracking.initialize();
         }
     }
 
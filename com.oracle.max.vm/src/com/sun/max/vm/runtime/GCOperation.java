@@ -29,6 +29,7 @@ import com.sun.max.annotate.*;
 import com.sun.max.unsafe.*;
 import com.sun.max.vm.*;
 import com.sun.max.vm.heap.*;
+import com.sun.max.vm.management.*;
 import com.sun.max.vm.monitor.*;
 import com.sun.max.vm.stack.*;
 import com.sun.max.vm.thread.*;
@@ -192,7 +193,9 @@ public abstract class GCOperation extends VmOperation {
             Log.unlock(lockDisabledSafepoints);
         }
 
+        MemoryManagement.gcStarted();
         collect(invocationCount);
+        MemoryManagement.gcFinished();
 
         if (Heap.verbose()) {
             final long afterUsed = Heap.reportUsedSpace();
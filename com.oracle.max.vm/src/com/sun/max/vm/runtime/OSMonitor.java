@@ -69,9 +69,9 @@ public class OSMonitor {
         Size size = Size.fromInt(getMutexSize());
         Word mutex;
         if (mustAllocate) {
-            mutex = Memory.mustAllocate(size);
+            mutex = Memory.mustAllocate(size, Memory.Tag.MONITOR, true);
         } else {
-            mutex = Memory.allocate(size);
+            mutex = Memory.allocate(size, Memory.Tag.MONITOR, true);
         }
         if (!mutex.isZero()) {
             nativeMutexInitialize(mutex);
@@ -87,9 +87,9 @@ public class OSMonitor {
         Size size = Size.fromInt(getConditionSize());
         Word condition;
         if (mustAllocate) {
-            condition = Memory.mustAllocate(size);
+            condition = Memory.mustAllocate(size, Memory.Tag.MONITOR, true);
         } else {
-            condition = Memory.allocate(size);
+            condition = Memory.allocate(size, Memory.Tag.MONITOR, true);
         }
         if (!condition.isZero()) {
             nativeConditionInitialize(condition);
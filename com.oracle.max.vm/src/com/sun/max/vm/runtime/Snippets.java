@@ -42,8 +42,10 @@ import com.sun.max.vm.actor.member.*;
 import com.sun.max.vm.classfile.constant.*;
 import com.sun.max.vm.compiler.*;
 import com.sun.max.vm.heap.*;
+import com.sun.max.vm.layout.*;
 import com.sun.max.vm.object.*;
 import com.sun.max.vm.profile.*;
+import com.sun.max.vm.reference.*;
 import com.sun.max.vm.runtime.ResolutionGuard.InAccessingClass;
 import com.sun.max.vm.runtime.ResolutionGuard.InPool;
 import com.sun.max.vm.stack.*;
@@ -646,6 +648,33 @@ public class Snippets {
         LAST_JAVA_FRAME_ANCHOR.store(etla, PREVIOUS.get(anchor));
     }
 
+    /**
+     * Gets the length of a primitive array passed to a critical native method.
+     *
+     * @return the length of {@code array} or 0 if it is {@code null}
+     */
+    @INLINE
+    public static int criticalArrayLength(Object array) {
+        if (array == null) {
+            return 0;
+        }
+        return ArrayAccess.readArrayLength(array);
+    }
+
+    /**
+     * Gets the address of the first element of a primitive array passed to a critical native method. The address is
+     * only valid while the calling thread remains in the 'in Java' state.
+     *
+     * @return the address of the elements of {@code array} or zero if it is {@code null}
+     */
+    @INLINE
+    public static Pointer criticalArrayElements(Object array) {
+        if (array == null) {
+            return Pointer.zero();
+        }
+        return Reference.fromJava(array).toOrigin().plus(Layout.byteArrayLayout().getElementOffsetFromOrigin(0));
+    }
+
     @INLINE
     public static void checkArrayDimension(int length) {
         if (length < 0) {
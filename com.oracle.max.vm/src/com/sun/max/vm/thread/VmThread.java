@@ -805,6 +805,7 @@ public class VmThread {
         }
 
         thread.traceThreadAfterTermination();
+        JniHandles.threadTerminated(thread);
 
         // GC may now reclaim or prepare any of its resources before the thread vanishes forever.
         vmConfig().heapScheme().notifyCurrentThreadDetach();
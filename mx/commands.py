@@ -440,6 +440,15 @@ def loggen(args):
 
     return mx.run_java(['-cp', mx.classpath('com.oracle.max.vm'), 'com.sun.max.vm.log.hosted.VMLoggerGenerator'])
 
+def vmlog(args):
+    """decode a VMLog file written by the VMLogNativeMapped log
+
+    Print the records in a file written with -XX:VMLogFile by a VM built with
+    -Dmax.vmlog.class=nat.mapped.VMLogNativeMapped. With -raw, the records are
+    printed in the format read by the Inspector's -vmlog option."""
+
+    return mx.run_java(['-cp', mx.classpath('com.oracle.max.vm'), 'com.sun.max.vm.log.hosted.VMLogFileDecoder'] + args)
+
 def makejdk(args):
     """create a JDK directory based on the Maxine VM
 
@@ -745,6 +754,7 @@ def mx_init():
         'verify': [verify, '[options] patterns...', _patternHelp],
         'view': [view, '[options]'],
         'vm': [vm, '[options] [class | -jar jarfile]  [args...]'],
+        'vmlog': [vmlog, '[-raw] file'],
         'wikidoc': [wikidoc, '[options]']
     }
     mx.commands.update(commands)